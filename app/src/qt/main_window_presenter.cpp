@@ -18,6 +18,8 @@
 */
 #include "main_window_presenter.h"
 
+#include <algorithm>
+
 #include <QShortcut>
 
 #include "kanban_column_presenter.h"
@@ -222,6 +224,11 @@ MainWindowPresenter::MainWindowPresenter(MainWindowView& view)
 
     // let Mind to learn active repository & preserve desired state
     mind->learn();
+
+    // learn files changed outside of MindForger (Memory must be modified by UI thread)
+    repositoryWatcherTimer = new QTimer(this);
+    QObject::connect(repositoryWatcherTimer, SIGNAL(timeout()), this, SLOT(slotRepositoryWatcher()));
+    repositoryWatcherTimer->start(500);
 }
 
 MainWindowPresenter::~MainWindowPresenter()
@@ -785,6 +792,21 @@ void MainWindowPresenter::doActionMindRelearn(QString path)
 
 void MainWindowPresenter::doActionExit()
 {
+    // Os are written behind - make sure they are on disk
+    vector<string> unwritten = mind->remind().flush();
+    if(!unwritten.empty()) {
+        QMessageBox::StandardButton choice;
+        choice = QMessageBox::question(
+            &view,
+            tr("Exit"),
+            QString(tr("Unable to write %1 notebook(s) e.g. '%2' - changes will be lost. Do you really want to exit?"))
+                .arg(unwritten.size())
+                .arg(QString::fromStdString(unwritten[0]))
+        );
+        if(choice != QMessageBox::Yes) {
+            return;
+        }
+    }
     QApplication::quit();
 }
 
@@ -858,6 +880,68 @@ void MainWindowPresenter::slotMainToolbarVisibilityChanged(bool visibility)
     mdConfigRepresentation->save(config);
 }
 
+void MainWindowPresenter::slotRepositoryWatcher()
+{
+    // Os are written behind > failed writes are reported once the writer gets to them
+    vector<string> unwritten = mind->remind().takeUnwrittenOutlines();
+    if(!unwritten.empty()) {
+        statusBar->showError(
+            QString(tr("Unable to write %1 notebook(s) e.g. '%2' - save them again"))
+                .arg(unwritten.size())
+                .arg(QString::fromStdString(unwritten[0])));
+    }
+
+    // IMPROVE changes of the edited O are learned once the editor is closed
+    if(orloj->isFacetActiveOutlineOrNoteEdit()) {
+        return;
+    }
+
+    Mind::RepositoryChanges changes{};
+    unsigned count = mind->learnRepositoryChanges(changes);
+    if(changes.rescan) {
+        // learn() deletes all Os > views must not keep them (like on manual relearn)
+        mind->learn();
+        showInitialView();
+        statusBar->showInfo(tr("Relearned workspace changed outside of MindForger"));
+        return;
+    }
+
+    if(count) {
+        // previous versions of changed Os are deleted on the next learning of changes > views must drop them
+        Outline* currentOutline = orloj->getOutlineView()->getCurrentOutline();
+        bool currentOutlineChanged = currentOutline
+            && std::find(
+                   changes.outlineKeys.begin(),
+                   changes.outlineKeys.end(),
+                   currentOutline->getKey()) != changes.outlineKeys.end();
+        if(orloj->isFacetActiveOutlineOrNoteView()) {
+            if(currentOutlineChanged) {
+                Outline* o = mind->remind().getOutline(currentOutline->getKey());
+                if(o) {
+                    orloj->showFacetOutline(o);
+                } else {
+                    orloj->showFacetOutlineList(mind->getOutlines());
+                }
+            }
+        } else if(orloj->isFacetActive(OrlojPresenterFacets::FACET_LIST_OUTLINES)) {
+            orloj->showFacetOutlineList(mind->getOutlines());
+        } else if(orloj->isFacetActive(OrlojPresenterFacets::FACET_FTS_VIEW_NOTE)
+                    ||
+                  orloj->isFacetActive(OrlojPresenterFacets::FACET_RECENT_NOTES)
+                    ||
+                  orloj->isFacetActive(OrlojPresenterFacets::FACET_NAVIGATOR)
+                    ||
+                  orloj->isFacetActive(OrlojPresenterFacets::FACET_ORGANIZER)
+                    ||
+                  orloj->isFacetActive(OrlojPresenterFacets::FACET_KANBAN))
+        {
+            // facets w/ Ns of any O
+            showInitialView();
+        }
+        statusBar->showInfo(QString(tr("Learned %1 notebook(s) changed outside of MindForger")).arg(count));
+    }
+}
+
 void MainWindowPresenter::doActionFindOutlineByName(const std::string& phrase)
 {
     // IMPROVE rebuild model ONLY if dirty i.e. an outline name was changed on save
@@ -3354,6 +3438,8 @@ void MainWindowPresenter::handleMindPreferences()
 
 void MainWindowPresenter::doActionViewTerminal()
 {
+    // commands (git, ...) must see Os saved so far
+    mind->remind().flush();
     terminalDialog->show();
 }
 
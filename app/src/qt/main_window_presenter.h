@@ -145,6 +145,9 @@ private:
     ExportFileDialog* exportOutlineToHtmlDialog;
     ExportCsvFileDialog* exportMemoryToCsvDialog;
 
+    // polls repository watcher for files changed outside of MindForger
+    QTimer* repositoryWatcherTimer;
+
 public:
     explicit MainWindowPresenter(MainWindowView& view);
     MainWindowPresenter(const MainWindowPresenter&) = delete;
@@ -382,6 +385,7 @@ public slots:
 
     void slotHandleFts();
     void slotMainToolbarVisibilityChanged(bool visibility);
+    void slotRepositoryWatcher();
 
 private:
     void injectMarkdownText(const QString& text, bool newline=false, int offset=0);
@@ -71,6 +71,8 @@
 #include "node.h"
 
 #include <math.h>
+#include <chrono>
+#include <unordered_map>
 
 #include <QKeyEvent>
 
@@ -84,7 +86,12 @@ NavigatorView::NavigatorView(QWidget* parent, bool isDashboardlet)
       w{},
       h{},
       garbageItems{},
-      subgraph{}
+      subgraph{},
+      layoutNodes{},
+      layoutNodesChanged{false},
+      layout{},
+      layoutScheduler{1},
+      layoutStep{}
 {
     // scene is peephole rectangle to the whole view (QGraphicsView)
     navigatorScene = new QGraphicsScene(this);
@@ -104,6 +111,7 @@ NavigatorView::NavigatorView(QWidget* parent, bool isDashboardlet)
 
 NavigatorView::~NavigatorView()
 {
+    waitForLayoutStep();
     navigatorScene->clear();
     clearGarbageItems();
 }
@@ -126,6 +134,9 @@ void NavigatorView::cleanupBeforeHide() {
     lock_guard<mutex> criticalSection{refreshMutex};
 
     // TODO codereview to ensure that there are no memory leaks
+    waitForLayoutStep();
+    layoutNodes.clear();
+    layoutNodesChanged = true;
     clearGarbageItems();
     navigatorScene->clear();
 
@@ -145,6 +156,54 @@ void NavigatorView::updateNavigatorView()
     //setMinimumSize(WIDTH, HEIGHT);
 }
 
+void NavigatorView::waitForLayoutStep()
+{
+    if(layoutStep.valid()) {
+        layoutStep.wait();
+        layoutStep = shared_future<bool>{};
+    }
+}
+
+void NavigatorView::updateLayout()
+{
+    if(layoutNodesChanged) {
+        layoutNodes.clear();
+        layout.clear();
+        unordered_map<NavigatorNode*,size_t> bodies{};
+        foreach(QGraphicsItem* item, navigatorScene->items()) {
+            if(NavigatorNode* node = qgraphicsitem_cast<NavigatorNode*>(item)) {
+                bodies[node] = layout.addBody(node->pos().x(), node->pos().y());
+                layoutNodes.push_back(node);
+            }
+        }
+        for(NavigatorNode* node:layoutNodes) {
+            foreach(NavigatorEdge* edge, node->edges()) {
+                if(edge->getSrcNode() == node) {
+                    layout.addEdge(bodies[edge->getSrcNode()], bodies[edge->getDstNode()]);
+                }
+            }
+        }
+        layoutNodesChanged = false;
+    } else {
+        // nodes might be dragged or shuffled since the last step
+        for(size_t i=0; i<layoutNodes.size(); i++) {
+            layout.setPosition(i, layoutNodes[i]->pos().x(), layoutNodes[i]->pos().y());
+        }
+    }
+
+    for(size_t i=0; i<layoutNodes.size(); i++) {
+        layout.setPinned(i, navigatorScene->mouseGrabberItem() == layoutNodes[i]);
+    }
+    layout.setEdgeLength(initialEdgeLenght);
+    // ensure nodes fit in scene
+    QRectF sceneRect = navigatorScene->sceneRect();
+    layout.setBounds(
+        sceneRect.left() + 10,
+        sceneRect.top() + 10,
+        sceneRect.right() - 10,
+        sceneRect.bottom() - 10);
+}
+
 void NavigatorView::itemMoved()
 {
     if(!timerId) {
@@ -216,6 +275,9 @@ void NavigatorView::timerEvent(QTimerEvent *event)
 
     // if subgraph != nullptr then it's a request to draw new scene
     if(subgraph) {
+        // layout step (if running) must not be published to the new scene
+        waitForLayoutStep();
+        layoutNodesChanged = true;
 
         //  REMOVE old nodes
 
@@ -276,6 +338,9 @@ void NavigatorView::timerEvent(QTimerEvent *event)
 
         NavigatorNode* n;
         NavigatorEdge* e;
+        // knowledge graph node > its navigator node (to connect nodes which are 2+ hops away)
+        unordered_map<KnowledgeGraphNode*,NavigatorNode*> navigatorNodes{};
+        navigatorNodes[subgraph->getCentralNode()] = selectedNode;
         std::vector<KnowledgeGraphNode*>& children = subgraph->getChildren();
         MF_DEBUG("  ADD children[" << children.size() << "]" << endl);
         // TODO QColor(t->getColor().asLong())
@@ -283,6 +348,7 @@ void NavigatorView::timerEvent(QTimerEvent *event)
             // newly created nodes and edges will be destroyed by garbage items collector
             n = new NavigatorNode(kn, this, QColor(kn->getColor()));
             navigatorScene->addItem(n);
+            navigatorNodes[kn] = n;
             e = new NavigatorEdge(selectedNode, n);
             navigatorScene->addItem(e);
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
@@ -304,6 +370,7 @@ void NavigatorView::timerEvent(QTimerEvent *event)
             // newly created nodes and edges will be destroyed by garbage items collector
             n = new NavigatorNode(kn, this, QColor(kn->getColor()));
             navigatorScene->addItem(n);
+            navigatorNodes[kn] = n;
             e = new NavigatorEdge(n, selectedNode);
             navigatorScene->addItem(e);
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
@@ -319,6 +386,30 @@ void NavigatorView::timerEvent(QTimerEvent *event)
 #endif
         }
 
+        std::vector<KnowledgeGraphNode*>& others = subgraph->getOthers();
+        std::vector<std::pair<KnowledgeGraphNode*,KnowledgeGraphNode*>>& edges = subgraph->getEdges();
+        MF_DEBUG("  ADD others[" << others.size() << "]" << endl);
+        for(size_t i=0; i<others.size(); i++) {
+            // newly created nodes and edges will be destroyed by garbage items collector
+            n = new NavigatorNode(others[i], this, QColor(others[i]->getColor()));
+            navigatorScene->addItem(n);
+            navigatorNodes[others[i]] = n;
+            // edge source/destination was added before the node
+            e = new NavigatorEdge(navigatorNodes[edges[i].first], navigatorNodes[edges[i].second]);
+            navigatorScene->addItem(e);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+            n->setPos(
+                QRandomGenerator::global()->generate() % w/2,
+                QRandomGenerator::global()->generate() % h/2
+            );
+#else
+            n->setPos(
+                qrand() % w/2,
+                qrand() % h/2
+            );
+#endif
+        }
+
         subgraph = nullptr;
 
         MF_DEBUG("  DONE scene[" << navigatorScene->items().size() << "]" << endl);
@@ -326,24 +417,33 @@ void NavigatorView::timerEvent(QTimerEvent *event)
 
     // RENDER scene
 
-    QList<NavigatorNode*> nodes;
-    foreach(QGraphicsItem *item, navigatorScene->items()) {
-        if(NavigatorNode *node = qgraphicsitem_cast<NavigatorNode *>(item))
-            nodes << node;
-    }
-
-    foreach(NavigatorNode *node, nodes) {
-        node->calculateForces();
-    }
+    bool itemsMoved = true;
+    if(layoutStep.valid()) {
+        if(layoutStep.wait_for(chrono::seconds(0)) != future_status::ready) {
+            // skip frame - layout step is still running
+            return;
+        }
 
-    bool itemsMoved = false;
-    foreach(NavigatorNode *node, nodes) {
-        if(node->moved()) {
-            itemsMoved = true;
+        // publish positions calculated by the last layout step
+        itemsMoved = layoutStep.get() || layoutNodesChanged;
+        layoutStep = shared_future<bool>{};
+        if(!layoutNodesChanged) {
+            for(size_t i=0; i<layoutNodes.size(); i++) {
+                if(!layout.isPinned(i)) {
+                    layoutNodes[i]->setPos(layout.getX(i), layout.getY(i));
+                }
+            }
         }
     }
 
-    if(!itemsMoved) {
+    if(itemsMoved) {
+        // calculate the next layout step in background
+        updateLayout();
+        layoutStep = layoutScheduler.submit<bool>(
+            [this](const TaskScheduler::Token&) { return layout.step(); },
+            TaskScheduler::Priority::INTERACTIVE
+        );
+    } else {
         killTimer(timerId);
         timerId = 0;
     }
@@ -69,10 +69,14 @@
 #ifndef M8R_NAVIGATOR_VIEW_H
 #define M8R_NAVIGATOR_VIEW_H
 
+#include <future>
 #include <mutex>
+#include <vector>
 
 #include <QGraphicsView>
 
+#include "../../../../lib/src/gear/force_layout.h"
+#include "../../../../lib/src/gear/task_scheduler.h"
 #include "../../../../lib/src/mind/knowledge_graph.h"
 #include "../../../../lib/src/model/outline.h"
 #include "../look_n_feel.h"
@@ -92,6 +96,11 @@ class NavigatorNode;
  * Synchronization & UI threads: selected node sets subgraph, timerEvent()
  * then refreshes view which avoids the need for extra synchronization.
  *
+ * Layout is calculated off the UI thread: timerEvent() publishes positions
+ * calculated by the previous layout step to the scene, copies node positions
+ * (which might be dragged by user) back to the layout and submits the next step.
+ * Frame is skipped if the step is still running.
+ *
  * @see http://doc.qt.io/qt-5/qtwidgets-graphicsview-elasticnodes-example.html
  */
 class NavigatorView : public QGraphicsView
@@ -121,6 +130,14 @@ private:
 
     bool isDashboardlet;
 
+    // nodes in the order of layout bodies
+    std::vector<NavigatorNode*> layoutNodes;
+    bool layoutNodesChanged;
+    ForceDirectedLayout layout;
+    // declared after layout to be shut down before layout is destroyed
+    TaskScheduler layoutScheduler;
+    std::shared_future<bool> layoutStep;
+
 public:
     NavigatorView(QWidget* parent, bool isDashboardlet=false);
     ~NavigatorView();
@@ -158,6 +175,8 @@ protected:
 private:
     void updateNavigatorView();
     void clearGarbageItems();
+    void waitForLayoutStep();
+    void updateLayout();
 
 signals:
     void nodeSelectedSignal(NavigatorNode* selectedNode);
@@ -131,11 +131,17 @@ void NoteViewPresenter::refreshLivePreview()
 // IMPROVE first decorate MD with HTML colors > then MD to HTML conversion
 void NoteViewPresenter::refresh(Note* note)
 {
-    note->makeRead();
+    mind->remind().read(note);
     this->currentNote = note;
 
     // HTML
-    htmlRepresentation->to(note, &html, Configuration::getInstance().isAutolinking());
+    htmlRepresentation->to(
+        note,
+        &html,
+        Configuration::getInstance().isAutolinking(),
+        0,
+        true
+    );
     view->setHtml(QString::fromStdString(html));
 
     // leaderboard
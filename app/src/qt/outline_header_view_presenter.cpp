@@ -130,6 +130,8 @@ void OutlineHeaderViewPresenter::refresh(Outline* outline)
         false,
         Configuration::getInstance().isAutolinking(),
         Configuration::getInstance().isUiFullOPreview(),
+        true,
+        0,
         true
     );
 
@@ -23,6 +23,7 @@ namespace m8r {
 OutlineViewPresenter::OutlineViewPresenter(OutlineViewSplitter* view, OrlojPresenter* orloj)
     : QObject(orloj), currentOutline{nullptr}
 {
+    this->mind = orloj->getMind();
     this->view = view;
     this->outlineTreePresenter
         = new OutlineTreePresenter(view->getOutlineTree(), orloj->getMainPresenter(), this);
@@ -44,7 +45,8 @@ OutlineViewPresenter::~OutlineViewPresenter()
 
 void OutlineViewPresenter::refresh(Outline* outline)
 {
-    outline->makeRead();
+    // reads are journaled instead of rewriting O's Markdown file
+    mind->remind().read(outline);
 
     currentOutline = outline;
     view->refreshHeader(outline->getName());
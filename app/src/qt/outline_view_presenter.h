@@ -40,6 +40,7 @@ class OutlineViewPresenter : public QObject
     Q_OBJECT
 
 private:
+    Mind* mind;
     Outline* currentOutline;
 
     OutlineViewSplitter* view;
@@ -80,7 +80,11 @@ win32{
 
 SOURCES += \
     ./src/repository_indexer.cpp \
+    ./src/repository_watcher.cpp \
     ./src/gear/datetime_utils.cpp \
+    ./src/gear/directory_walker.cpp \
+    ./src/gear/task_scheduler.cpp \
+    ./src/gear/force_layout.cpp \
     ./src/gear/file_utils.cpp \
     ./src/gear/string_utils.cpp \
     ./src/mind/ontology/ontology.cpp \
@@ -92,6 +96,7 @@ SOURCES += \
     ./src/model/tag.cpp \
     ./src/persistence/filesystem_persistence.cpp \
     ./src/representations/html/html_outline_representation.cpp \
+    ./src/representations/html/html_cache.cpp \
     ./src/representations/markdown/markdown_ast_node.cpp \
     ./src/representations/markdown/markdown_lexem.cpp \
     ./src/representations/markdown/markdown_lexer_sections.cpp \
@@ -104,6 +109,10 @@ SOURCES += \
     ./src/mind/galaxy.cpp \
     ./src/mind/memory_dwell.cpp \
     ./src/mind/memory.cpp \
+    ./src/mind/fts_index.cpp \
+    ./src/mind/tag_index.cpp \
+    ./src/mind/knowledge_graph_index.cpp \
+    ./src/mind/memory_statistics.cpp \
     ./src/mind/mind.cpp \
     ./src/mind/working_memory.cpp \
     ./src/config/configuration.cpp \
@@ -129,6 +138,8 @@ SOURCES += \
     src/model/organizer.cpp \
     src/persistence/configuration_persistence.cpp \
     src/persistence/persistence.cpp \
+    src/persistence/repository_snapshot.cpp \
+    src/persistence/statistics_journal.cpp \
     src/representations/markdown/markdown_document.cpp \
     src/representations/html/html_document.cpp \
     src/mind/ai/ai.cpp \
@@ -142,10 +153,12 @@ SOURCES += \
     src/mind/ai/nn/genann.c \
     src/mind/ai/nlp/word_frequency_list.cpp \
     src/gear/trie.cpp \
+    src/gear/aho_corasick.cpp \
     src/mind/ai/nlp/stemmer/stemmer.cpp \
     src/mind/ai/ai_aa_bow.cpp \
     src/mind/ai/ai_aa_weighted_fts.cpp \
     src/mind/ai/aa_notes_feature.cpp \
+    src/mind/ai/aa_top_k_matrix.cpp \
     src/mind/ai/nlp/common_words_blacklist.cpp \
     src/mind/aspect/tag_scope_aspect.cpp \
     src/mind/aspect/mind_scope_aspect.cpp \
@@ -171,6 +184,7 @@ HEADERS += \
     ./src/debug.h \
     ./src/exceptions.h \
     ./src/repository_indexer.h \
+    ./src/repository_watcher.h \
     ./src/3rdparty/hoedown/autolink.h \
     ./src/3rdparty/hoedown/buffer.h \
     ./src/3rdparty/hoedown/document.h \
@@ -179,6 +193,9 @@ HEADERS += \
     ./src/3rdparty/hoedown/stack.h \
     ./src/3rdparty/hoedown/version.h \
     ./src/gear/datetime_utils.h \
+    ./src/gear/directory_walker.h \
+    ./src/gear/task_scheduler.h \
+    ./src/gear/force_layout.h \
     ./src/gear/file_utils.h \
     ./src/gear/hash_map.h \
     ./src/gear/lang_utils.h \
@@ -194,7 +211,10 @@ HEADERS += \
     ./src/model/tag.h \
     ./src/persistence/filesystem_persistence.h \
     ./src/persistence/persistence.h \
+    ./src/persistence/repository_snapshot.h \
+    ./src/persistence/statistics_journal.h \
     ./src/representations/html/html_outline_representation.h \
+    ./src/representations/html/html_cache.h \
     ./src/representations/markdown/markdown_ast_node.h \
     ./src/representations/markdown/markdown_lexem.h \
     ./src/representations/markdown/markdown_lexer_sections.h \
@@ -208,6 +228,10 @@ HEADERS += \
     ./src/mind/galaxy.h \
     ./src/mind/memory_dwell.h \
     ./src/mind/memory.h \
+    ./src/mind/fts_index.h \
+    ./src/mind/tag_index.h \
+    ./src/mind/knowledge_graph_index.h \
+    ./src/mind/memory_statistics.h \
     ./src/mind/mind.h \
     ./src/mind/working_memory.h \
     ./src/mind/mind_listener.h \
@@ -253,6 +277,7 @@ HEADERS += \
     src/mind/ai/nn/genann.h \
     src/mind/ai/nlp/word_frequency_list.h \
     src/gear/trie.h \
+    src/gear/aho_corasick.h \
     src/mind/ai/nlp/char_provider.h \
     src/mind/ai/nlp/stemmer/stemmer.h \
     src/mind/ai/nlp/stemmer/stemming/danish_stem.h \
@@ -277,6 +302,7 @@ HEADERS += \
     src/mind/ai/ai_aa_weighted_fts.h \
     src/mind/ai/aa_model.h \
     src/mind/ai/aa_notes_feature.h \
+    src/mind/ai/aa_top_k_matrix.h \
     src/mind/ai/ai_aa.h \
     src/mind/ai/nlp/common_words_blacklist.h \
     src/mind/aspect/tag_scope_aspect.h \
@@ -56,6 +56,11 @@ Configuration::Configuration()
       wingmanLlmModel{DEFAULT_WINGMAN_LLM_MODEL_OPENAI},
       md2HtmlOptions{},
       distributorSleepInterval{DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL},
+      learnThreads{DEFAULT_LEARN_THREADS},
+      repositorySnapshot{DEFAULT_REPOSITORY_SNAPSHOT},
+      repositoryWatcher{DEFAULT_REPOSITORY_WATCHER},
+      indexerIgnorePatterns{},
+      statisticsJournal{DEFAULT_STATISTICS_JOURNAL},
       markdownQuoteSections{},
       recentIncludeOs{DEFAULT_RECENT_INCLUDE_OS},
       uiNerdTargetAudience{DEFAULT_UI_NERD_MENU},
@@ -77,6 +82,7 @@ Configuration::Configuration()
       uiEditorTabsAsSpaces{},
       uiEditorAutosave{DEFAULT_EDITOR_AUTOSAVE},
       uiFullOPreview{DEFAULT_FULL_O_PREVIEW},
+      uiHtmlFragments{DEFAULT_UI_HTML_FRAGMENTS},
       uiShowToolbar{DEFAULT_UI_SHOW_TOOLBAR},
       uiExpertMode{DEFAULT_UI_EXPERT_MODE},
       uiAppFontSize{DEFAULT_UI_APP_FONT_SIZE},
@@ -111,6 +117,25 @@ Configuration::Configuration()
     userDocPath = string{userHomePath};
 #endif //_WIN32
 
+    // cache: %LOCALAPPDATA%\mindforger, ~/Library/Caches/mindforger or $XDG_CACHE_HOME/mindforger
+#if defined(_WIN32)
+    const char* cacheHome = getenv(ENV_VAR_LOCALAPPDATA);
+    cachePath = cacheHome && *cacheHome ? string{cacheHome} : userHomePath;
+#elif defined(__APPLE__)
+    cachePath = userHomePath;
+    cachePath += "/Library/Caches";
+#else
+    const char* cacheHome = getenv(ENV_VAR_XDG_CACHE_HOME);
+    if(cacheHome && *cacheHome) {
+        cachePath = cacheHome;
+    } else {
+        cachePath = userHomePath;
+        cachePath += "/.cache";
+    }
+#endif
+    cachePath += FILE_PATH_SEPARATOR;
+    cachePath += DIRNAME_M8R_CACHE;
+
     clear();
 }
 
@@ -177,6 +202,11 @@ void Configuration::clear()
     }
 
     distributorSleepInterval = DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL;
+    learnThreads = DEFAULT_LEARN_THREADS;
+    repositorySnapshot = DEFAULT_REPOSITORY_SNAPSHOT;
+    repositoryWatcher = DEFAULT_REPOSITORY_WATCHER;
+    indexerIgnorePatterns.clear();
+    statisticsJournal = DEFAULT_STATISTICS_JOURNAL;
 
     // GUI
     uiNerdTargetAudience = false;
@@ -187,6 +217,7 @@ void Configuration::clear()
     uiEditorLineNumbers = true;
     uiEditorTabsAsSpaces = DEFAULT_EDITOR_TABS_AS_SPACES;
     uiEditorAutosave = DEFAULT_EDITOR_AUTOSAVE;
+    uiHtmlFragments = DEFAULT_UI_HTML_FRAGMENTS;
     uiEditorTabWidth = DEFAULT_EDITOR_TAB_WIDTH;
     uiEditorSmartEditor = DEFAULT_EDITOR_SMART_EDITOR;
     uiEditorSpaceSectionEscaping = DEFAULT_EDITOR_SPACE_SECTION_ESCAPING;
@@ -54,16 +54,24 @@ enum WingmanLlmProviders {
 
 // const in constexpr makes value const
 constexpr const auto ENV_VAR_HOME = "HOME";
+constexpr const auto ENV_VAR_XDG_CACHE_HOME = "XDG_CACHE_HOME";
+constexpr const auto ENV_VAR_LOCALAPPDATA = "LOCALAPPDATA";
 constexpr const auto ENV_VAR_DISPLAY = "DISPLAY";
 constexpr const auto ENV_VAR_M8R_REPOSITORY = "MINDFORGER_REPOSITORY";
 constexpr const auto ENV_VAR_M8R_EDITOR = "MINDFORGER_EDITOR";
 
 constexpr const auto DIRNAME_M8R_REPOSITORY = "mindforger-repository";
+constexpr const auto DIRNAME_M8R_CACHE = "mindforger";
 // IMPROVE :-Z C++
 constexpr const auto FILE_PATH_M8R_REPOSITORY = "~/mindforger-repository";
 
 constexpr const auto FILENAME_M8R_CONFIGURATION = ".mindforger.md";
 constexpr const auto FILENAME_OUTLINES_MAP = "outlines-map.md";
+// snapshot file name is suffixed w/ hash of repository path
+constexpr const auto FILENAME_REPOSITORY_SNAPSHOT = "repository-snapshot-";
+constexpr const auto FILENAME_STATISTICS_JOURNAL = ".mindforger-journal";
+// file is written to path + extension and atomically renamed once complete
+constexpr const auto FILE_EXTENSION_TEMPORARY = ".mindforger-tmp";
 constexpr const auto DIRNAME_MEMORY = "memory";
 constexpr const auto DIRNAME_MIND = "mind";
 constexpr const auto DIRNAME_LIMBO = "limbo";
@@ -255,6 +263,11 @@ public:
     static constexpr const int DEFAULT_ASYNC_MIND_THRESHOLD_BOW = 200;
     static constexpr const int DEFAULT_ASYNC_MIND_THRESHOLD_WEIGHTED_FTS = 20000;
     static constexpr const int DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL = 500;
+    static constexpr const int DEFAULT_LEARN_THREADS = 0;
+    static constexpr const int MAX_LEARN_THREADS = 64;
+    static constexpr const bool DEFAULT_REPOSITORY_SNAPSHOT = true;
+    static constexpr const bool DEFAULT_REPOSITORY_WATCHER = true;
+    static constexpr const bool DEFAULT_STATISTICS_JOURNAL = false;
 
     static const std::string DEFAULT_ACTIVE_REPOSITORY_PATH;
     static const std::string DEFAULT_TIME_SCOPE;
@@ -286,6 +299,7 @@ public:
     static constexpr const bool DEFAULT_EDITOR_TABS_AS_SPACES = true;
     static constexpr const bool DEFAULT_EDITOR_AUTOSAVE = false;
     static constexpr const bool DEFAULT_FULL_O_PREVIEW = false;
+    static constexpr const bool DEFAULT_UI_HTML_FRAGMENTS = false;
     static constexpr const bool DEFAULT_MD_QUOTE_SECTIONS = true;
     static constexpr const bool DEFAULT_RECENT_INCLUDE_OS= false;
     static constexpr const bool DEFAULT_SPELLCHECK_LIVE = true;
@@ -313,6 +327,8 @@ private:
     std::string userHomePath;
     // some platforms, e.g. Windows, distinquishes user home and user documents
     std::string userDocPath;
+    // per user cache of data derived from repositories (e.g. repository snapshots)
+    std::string cachePath;
     std::string configFilePath;
 
     Repository* activeRepository;
@@ -382,6 +398,16 @@ private:
     unsigned int md2HtmlOptions;
     AssociationAssessmentAlgorithm aaAlgorithm;
     int distributorSleepInterval;
+    // threads used to lex and parse Markdown files on learn: 0 ~ detect # of CPUs, 1 ~ sequential
+    int learnThreads;
+    // restore unchanged Markdown files from repository snapshot instead of parsing them on learn
+    bool repositorySnapshot;
+    // learn files created/modified/deleted outside of MindForger (e.g. by git pull) w/o relearning repository
+    bool repositoryWatcher;
+    // names of files and directories (w/ * and ? wildcards) which are NOT indexed e.g. .git
+    std::vector<std::string> indexerIgnorePatterns;
+    // journal O/N reads to repository journal file instead of rewriting Markdown file on every read
+    bool statisticsJournal;
 
     bool markdownQuoteSections;
     /**
@@ -420,6 +446,8 @@ private:
     bool uiEditorTabsAsSpaces;
     bool uiEditorAutosave;
     bool uiFullOPreview;
+    // assemble whole O HTML from per N cached HTML fragments instead of rendering it in a single pass
+    bool uiHtmlFragments;
     bool uiShowToolbar;
     bool uiExpertMode;
     int uiAppFontSize;
@@ -451,8 +479,10 @@ public:
     MindState getDesiredMindState() const { return desiredMindState; }
     void setDesiredMindState(MindState mindState) { this->desiredMindState = mindState; }
     unsigned int getAsyncMindThreshold() const { return asyncMindThreshold; }
+    void setAsyncMindThreshold(unsigned int threshold) { asyncMindThreshold = threshold; }
 
     std::string& getConfigFilePath() { return configFilePath; }
+    const std::string& getCachePath() const { return cachePath; }
     void setConfigFilePath(const std::string customConfigFilePath) {
         configFilePath = customConfigFilePath;
     }
@@ -536,6 +566,16 @@ public:
     void setAaAlgorithm(AssociationAssessmentAlgorithm aaa) { aaAlgorithm = aaa; }
     int getDistributorSleepInterval() const { return distributorSleepInterval; }
     void setDistributorSleepInterval(int sleepInterval) { distributorSleepInterval = sleepInterval; }
+    int getLearnThreads() const { return learnThreads; }
+    void setLearnThreads(int learnThreads) { this->learnThreads = learnThreads; }
+    bool isRepositorySnapshot() const { return repositorySnapshot; }
+    void setRepositorySnapshot(bool repositorySnapshot) { this->repositorySnapshot = repositorySnapshot; }
+    bool isRepositoryWatcher() const { return repositoryWatcher; }
+    void setRepositoryWatcher(bool repositoryWatcher) { this->repositoryWatcher = repositoryWatcher; }
+    const std::vector<std::string>& getIndexerIgnorePatterns() const { return indexerIgnorePatterns; }
+    void setIndexerIgnorePatterns(const std::vector<std::string>& patterns) { indexerIgnorePatterns = patterns; }
+    bool isStatisticsJournal() const { return statisticsJournal; }
+    void setStatisticsJournal(bool statisticsJournal) { this->statisticsJournal = statisticsJournal; }
     bool isMarkdownQuoteSections() const { return markdownQuoteSections; }
     void setMarkdownQuoteSections(bool markdownQuoteSections) { this->markdownQuoteSections = markdownQuoteSections; }
     bool isRecentIncludeOs() const { return recentIncludeOs; }
@@ -723,6 +763,8 @@ public:
     void setUiEditorAutosave(bool uiEditorAutosave){ this->uiEditorAutosave = uiEditorAutosave; }
     bool isUiFullOPreview() const { return uiFullOPreview; }
     void setUiFullOPreview(bool fullPreview){ this->uiFullOPreview = fullPreview; }
+    bool isUiHtmlFragments() const { return uiHtmlFragments; }
+    void setUiHtmlFragments(bool htmlFragments){ this->uiHtmlFragments = htmlFragments; }
     bool isUiShowToolbar() const { return uiShowToolbar; }
     void setUiShowToolbar(bool showToolbar){ this->uiShowToolbar = showToolbar; }
     bool isUiExpertMode() const { return uiExpertMode; }
@@ -0,0 +1,209 @@
+/*
+ aho_corasick.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "aho_corasick.h"
+
+#include <algorithm>
+
+namespace m8r {
+
+using namespace std;
+
+AhoCorasick::AhoCorasick()
+    : words{},
+      dirty{false},
+      nodes{},
+      edgeChars{},
+      edgeTargets{}
+{
+}
+
+AhoCorasick::~AhoCorasick()
+{
+}
+
+void AhoCorasick::clear()
+{
+    words.clear();
+    nodes.clear();
+    edgeChars.clear();
+    edgeTargets.clear();
+    dirty = false;
+}
+
+void AhoCorasick::addWord(const string& s)
+{
+    // support of empty words is NOT desired
+    if(s.size()) {
+        ++words[s];
+        dirty = true;
+    }
+}
+
+bool AhoCorasick::removeWord(const string& s, bool decRefCountOnly)
+{
+    auto i = words.find(s);
+    if(i == words.end()) {
+        return false;
+    }
+
+    if(decRefCountOnly && i->second > 1) {
+        --i->second;
+    } else {
+        words.erase(i);
+        dirty = true;
+    }
+    return true;
+}
+
+uint32_t AhoCorasick::findChild(uint32_t node, unsigned char c) const
+{
+    const Node& n = nodes[node];
+    const unsigned char* begin = edgeChars.data() + n.edgesOffset;
+    const unsigned char* end = begin + n.edgesCount;
+    const unsigned char* edge = std::lower_bound(begin, end, c);
+    if(edge != end && *edge == c) {
+        return edgeTargets[edge - edgeChars.data()];
+    }
+    return NO_NODE;
+}
+
+void AhoCorasick::compile()
+{
+    nodes.clear();
+    edgeChars.clear();
+    edgeTargets.clear();
+    dirty = false;
+
+    // build trie w/ sorted children
+    vector<map<unsigned char,uint32_t>> trie(1);
+    vector<uint32_t> wordLengths(1, 0);
+    for(auto& w:words) {
+        uint32_t current = 0;
+        for(char c:w.first) {
+            auto child = trie[current].find(static_cast<unsigned char>(c));
+            if(child != trie[current].end()) {
+                current = child->second;
+            } else {
+                uint32_t n = static_cast<uint32_t>(trie.size());
+                trie[current][static_cast<unsigned char>(c)] = n;
+                trie.push_back(map<unsigned char,uint32_t>{});
+                wordLengths.push_back(0);
+                current = n;
+            }
+        }
+        wordLengths[current] = static_cast<uint32_t>(w.first.size());
+    }
+
+    // renumber nodes in BFS order so that parents precede children and edges are contiguous
+    vector<uint32_t> bfs{0};
+    vector<uint32_t> index(trie.size(), 0);
+    for(size_t i=0; i<bfs.size(); i++) {
+        for(auto& e:trie[bfs[i]]) {
+            index[e.second] = static_cast<uint32_t>(bfs.size());
+            bfs.push_back(e.second);
+        }
+    }
+    nodes.resize(trie.size());
+    edgeChars.reserve(trie.size()-1);
+    edgeTargets.reserve(trie.size()-1);
+    for(size_t i=0; i<bfs.size(); i++) {
+        Node& n = nodes[i];
+        n.edgesOffset = static_cast<uint32_t>(edgeChars.size());
+        n.edgesCount = static_cast<uint32_t>(trie[bfs[i]].size());
+        n.failure = 0;
+        n.output = 0;
+        n.wordLength = wordLengths[bfs[i]];
+        for(auto& e:trie[bfs[i]]) {
+            edgeChars.push_back(e.first);
+            edgeTargets.push_back(index[e.second]);
+        }
+    }
+
+    // failure and output links - failure of a node is shallower, i.e. already linked in BFS order
+    for(uint32_t u=0; u<nodes.size(); u++) {
+        for(uint32_t e=nodes[u].edgesOffset; e<nodes[u].edgesOffset+nodes[u].edgesCount; e++) {
+            const unsigned char c = edgeChars[e];
+            const uint32_t v = edgeTargets[e];
+            uint32_t failure = 0;
+            if(u) {
+                uint32_t f = nodes[u].failure;
+                while((failure = findChild(f, c)) == NO_NODE && f) {
+                    f = nodes[f].failure;
+                }
+                if(failure == NO_NODE) {
+                    failure = 0;
+                }
+            }
+            nodes[v].failure = failure;
+            nodes[v].output = nodes[failure].wordLength ? failure : nodes[failure].output;
+        }
+    }
+
+    MF_DEBUG("Aho-Corasick automaton compiled: " << words.size() << " words, " << nodes.size() << " nodes" << endl);
+}
+
+void AhoCorasick::findWholeWords(
+        const string& text,
+        const string& delimiters,
+        vector<Match>& matches) const
+{
+    if(nodes.size() < 2 || text.empty()) {
+        return;
+    }
+
+    bool isDelimiter[256] = {};
+    for(char c:delimiters) {
+        isDelimiter[static_cast<unsigned char>(c)] = true;
+    }
+    auto delimiterAt = [&](size_t i) {
+        return isDelimiter[static_cast<unsigned char>(text[i])];
+    };
+
+    // longest whole word match by begin offset
+    vector<uint32_t> longest(text.size(), 0);
+    uint32_t state = 0;
+    for(size_t i=0; i<text.size(); i++) {
+        const unsigned char c = static_cast<unsigned char>(text[i]);
+        uint32_t next;
+        while((next = findChild(state, c)) == NO_NODE && state) {
+            state = nodes[state].failure;
+        }
+        state = next == NO_NODE ? 0 : next;
+
+        // words are checked only where a whole word might end
+        if(i+1 == text.size() || delimiterAt(i+1)) {
+            for(uint32_t o = nodes[state].wordLength ? state : nodes[state].output; o; o = nodes[o].output) {
+                const size_t begin = i + 1 - nodes[o].wordLength;
+                if((begin == 0 || delimiterAt(begin-1)) && !delimiterAt(begin)) {
+                    longest[begin] = std::max(longest[begin], nodes[o].wordLength);
+                }
+            }
+        }
+    }
+
+    // leftmost longest non-overlapping matches
+    for(size_t i=0; i<text.size(); i++) {
+        if(longest[i]) {
+            matches.push_back(Match{i, longest[i]});
+            i += longest[i] - 1;
+        }
+    }
+}
+
+} // m8r namespace
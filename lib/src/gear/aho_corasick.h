@@ -0,0 +1,124 @@
+/*
+ aho_corasick.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_AHO_CORASICK_H
+#define M8R_AHO_CORASICK_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <string>
+
+#include "../debug.h"
+
+namespace m8r {
+
+/**
+ * @brief Aho-Corasick automaton.
+ *
+ * Automaton finds all occurrences of all words in a text in a single pass:
+ * it's a trie w/ failure links (longest proper suffix of node's prefix which
+ * is in the trie) and output links (longest proper suffix which is a word).
+ *
+ * Words are kept w/ reference counts and the automaton is compiled from them:
+ * once a word is added or removed, the automaton must be compiled before search.
+ * Compiled automaton is stored in arrays: nodes are in BFS order and edges of every
+ * node are sorted by character so that transitions are found by binary search.
+ */
+class AhoCorasick
+{
+public:
+    /**
+     * @brief Occurrence of a word in the text.
+     */
+    struct Match {
+        size_t begin;
+        size_t length;
+    };
+
+private:
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+    struct Node {
+        uint32_t edgesOffset;
+        uint32_t edgesCount;
+        uint32_t failure;
+        // nearest node on failure links path which is a word (0 ~ none)
+        uint32_t output;
+        // length of word which ends in this node (0 ~ not a word)
+        uint32_t wordLength;
+    };
+
+    // words w/ reference counts
+    std::map<std::string,int> words;
+    bool dirty;
+
+    // compiled automaton - root has index 0
+    std::vector<Node> nodes;
+    std::vector<unsigned char> edgeChars;
+    std::vector<uint32_t> edgeTargets;
+
+public:
+    explicit AhoCorasick();
+    AhoCorasick(const AhoCorasick&) = delete;
+    AhoCorasick(const AhoCorasick&&) = delete;
+    AhoCorasick& operator=(const AhoCorasick&) = delete;
+    AhoCorasick& operator=(const AhoCorasick&&) = delete;
+    ~AhoCorasick();
+
+    bool empty() const { return words.empty(); }
+    size_t size() const { return words.size(); }
+    size_t getNodesCount() const { return nodes.size(); }
+    /**
+     * @brief Has the automaton to be compiled before search?
+     */
+    bool isDirty() const { return dirty; }
+
+    void clear();
+    void addWord(const std::string& s);
+    /**
+     * @brief Remove word (or decrease its reference count).
+     */
+    bool removeWord(const std::string& s, bool decRefCountOnly=false);
+
+    /**
+     * @brief Build automaton from words.
+     */
+    void compile();
+
+    /**
+     * @brief Find whole words in the text.
+     *
+     * Word matches only if it's delimited by delimiter chars (or text begin/end) and
+     * it doesn't start with a delimiter. Matches do NOT overlap - leftmost match wins
+     * and the longest one of matches which begin at the same position wins. Matches
+     * are sorted by begin offset.
+     *
+     * Search is linear in the length of text (plus number of candidate matches).
+     */
+    void findWholeWords(
+            const std::string& text,
+            const std::string& delimiters,
+            std::vector<Match>& matches) const;
+
+private:
+    uint32_t findChild(uint32_t node, unsigned char c) const;
+};
+
+}
+#endif // M8R_AHO_CORASICK_H
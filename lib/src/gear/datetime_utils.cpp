@@ -99,7 +99,14 @@ char* datetimeTo(const struct tm* datetime, char* result)
 std::string datetimeToString(const time_t ts)
 {
     char to[50];
-    if(datetimeTo(localtime(&ts), to)) {
+    // localtime() reloads time zone on every call (stat of /etc/localtime) > use reentrant variant
+    tm t;
+#ifndef _WIN32
+    localtime_r(&ts, &t);
+#else
+    localtime_s(&t, &ts);
+#endif
+    if(datetimeTo(&t, to)) {
         return string{to};
     }
     return "";
@@ -129,8 +136,16 @@ std::string datetimeToPrettyHtml(const time_t* seconds)
     time_t now;
     time(&now);
 
-    tm tsS = *localtime(seconds);
-    tm* nowS = localtime(&now);
+    // reentrant localtime doesn't reload time zone on every call
+    tm tsS, nowTm;
+#ifndef _WIN32
+    localtime_r(seconds, &tsS);
+    localtime_r(&now, &nowTm);
+#else
+    localtime_s(&tsS, seconds);
+    localtime_s(&nowTm, &now);
+#endif
+    tm* nowS = &nowTm;
 
     Pretty pretty = Pretty::LONG_TIME_AGO;
 
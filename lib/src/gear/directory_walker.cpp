@@ -0,0 +1,254 @@
+/*
+ directory_walker.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "directory_walker.h"
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
+#include "../definitions.h"
+#include "file_utils.h"
+
+using namespace std;
+
+namespace m8r {
+
+constexpr unsigned DirectoryWalker::MAX_OPEN_DIRECTORIES;
+
+DirectoryWalker::DirectoryWalker(unsigned threads)
+    : threads{threads ? threads : 1},
+      ignorePatterns{}
+{
+}
+
+DirectoryWalker::~DirectoryWalker()
+{
+}
+
+bool DirectoryWalker::matchPattern(const char* pattern, const char* name)
+{
+    // iterative wildcard matching w/ backtracking to the last *
+    const char* star = nullptr;
+    const char* starName = nullptr;
+    while(*name) {
+        if(*pattern == '?' || *pattern == *name) {
+            pattern++;
+            name++;
+        } else if(*pattern == '*') {
+            star = pattern++;
+            starName = name;
+        } else if(star) {
+            pattern = star+1;
+            name = ++starName;
+        } else {
+            return false;
+        }
+    }
+    while(*pattern == '*') {
+        pattern++;
+    }
+    return !*pattern;
+}
+
+bool DirectoryWalker::isIgnored(const char* name) const
+{
+    for(const string& pattern:ignorePatterns) {
+        if(matchPattern(pattern.c_str(), name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DirectoryWalker::walkSequential(const string& directory, vector<string>& files) const
+{
+    DIR* dir;
+    if((dir = opendir(directory.c_str()))) {
+        const struct dirent* entry;
+        string path{};
+        while((entry = readdir(dir)) != nullptr) {
+            if(strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0
+                 || isIgnored(entry->d_name))
+            {
+                continue;
+            }
+            path.assign(directory);
+            path += FILE_PATH_SEPARATOR;
+            path += entry->d_name;
+            if(entry->d_type == DT_DIR) {
+                walkSequential(path, files);
+            } else {
+                files.push_back(path);
+            }
+        }
+        closedir(dir);
+    }
+}
+
+#ifndef _WIN32
+namespace {
+
+struct QueuedDirectory {
+    // -1 if the directory must be opened by path
+    int fd;
+    string path;
+};
+
+} // anonymous namespace
+#endif
+
+void DirectoryWalker::walk(const string& directory, vector<string>& files) const
+{
+#ifdef _WIN32
+    size_t offset = files.size();
+    walkSequential(directory, files);
+    std::sort(files.begin()+offset, files.end());
+#else
+    int rootFd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if(rootFd < 0) {
+        MF_DEBUG("Walker: unable to open directory " << directory << endl);
+        return;
+    }
+
+    deque<QueuedDirectory> queue{};
+    queue.push_back(QueuedDirectory{rootFd, directory});
+    // directories being listed by workers
+    unsigned busy{0};
+    mutex queueMutex{};
+    condition_variable queueChanged{};
+    // open descriptors are bounded to keep far from the process limit
+    atomic<unsigned> openDirectories{1};
+    vector<vector<string>> found(threads);
+
+    auto worker = [&](unsigned t) {
+        vector<string>& workerFiles = found[t];
+        vector<QueuedDirectory> subdirectories{};
+        string path{};
+        while(true) {
+            QueuedDirectory d{};
+            {
+                unique_lock<mutex> lock{queueMutex};
+                queueChanged.wait(lock, [&]{ return !queue.empty() || !busy; });
+                if(queue.empty()) {
+                    // nothing queued and nobody listing > done
+                    return;
+                }
+                d = std::move(queue.front());
+                queue.pop_front();
+                busy++;
+            }
+
+            if(d.fd < 0) {
+                d.fd = open(d.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+                if(d.fd >= 0) {
+                    openDirectories++;
+                }
+            }
+            DIR* dir = d.fd >= 0 ? fdopendir(d.fd) : nullptr;
+            if(dir) {
+                const struct dirent* entry;
+                while((entry = readdir(dir)) != nullptr) {
+                    if(strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0
+                         || isIgnored(entry->d_name))
+                    {
+                        continue;
+                    }
+
+                    unsigned char type = entry->d_type;
+                    if(type == DT_UNKNOWN) {
+                        // some filesystems (XFS, NFS, ...) don't provide type
+                        struct stat entryStat;
+                        if(!fstatat(dirfd(dir), entry->d_name, &entryStat, AT_SYMLINK_NOFOLLOW)
+                             && S_ISDIR(entryStat.st_mode))
+                        {
+                            type = DT_DIR;
+                        }
+                    }
+
+                    path.assign(d.path);
+                    path += FILE_PATH_SEPARATOR;
+                    path += entry->d_name;
+                    if(type == DT_DIR) {
+                        int fd = -1;
+                        if(openDirectories < MAX_OPEN_DIRECTORIES) {
+                            fd = openat(dirfd(dir), entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+                            if(fd >= 0) {
+                                openDirectories++;
+                            }
+                        }
+                        subdirectories.push_back(QueuedDirectory{fd, path});
+                    } else {
+                        workerFiles.push_back(path);
+                    }
+                }
+                // closes the descriptor too
+                closedir(dir);
+                openDirectories--;
+            } else if(d.fd >= 0) {
+                close(d.fd);
+                openDirectories--;
+            }
+
+            {
+                lock_guard<mutex> lock{queueMutex};
+                for(QueuedDirectory& s:subdirectories) {
+                    queue.push_back(std::move(s));
+                }
+                busy--;
+            }
+            subdirectories.clear();
+            queueChanged.notify_all();
+        }
+    };
+
+    vector<thread> workers{};
+    for(unsigned t=1; t<threads; t++) {
+        workers.push_back(thread{worker, t});
+    }
+    // calling thread is one of the workers
+    worker(0);
+    for(thread& w:workers) {
+        w.join();
+    }
+
+    size_t offset = files.size();
+    size_t count{};
+    for(const vector<string>& f:found) {
+        count += f.size();
+    }
+    files.reserve(offset+count);
+    for(vector<string>& f:found) {
+        std::move(f.begin(), f.end(), std::back_inserter(files));
+    }
+    std::sort(files.begin()+offset, files.end());
+#endif
+}
+
+} // m8r namespace
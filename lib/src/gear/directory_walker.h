@@ -0,0 +1,88 @@
+/*
+ directory_walker.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_DIRECTORY_WALKER_H_
+#define M8R_DIRECTORY_WALKER_H_
+
+#include <string>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Parallel recursive directory walker.
+ *
+ * Directories are listed by a pool of threads which share a work queue
+ * of directories - wide and deep trees (e.g. on network mounted home
+ * directories) are listed in parallel instead of one readdir() at a time.
+ * Subdirectories are opened relative to the descriptor of their parent
+ * directory (openat/fstatat) so that paths are not resolved again and again
+ * by the kernel.
+ *
+ * Everything what is not a directory is reported as a file (symbolic links
+ * are not followed). Entries whose name matches an ignore pattern (* and ?
+ * wildcards) are skipped - both files and directories.
+ *
+ * The result is deterministic: paths are sorted regardless the number
+ * of threads.
+ */
+class DirectoryWalker
+{
+public:
+    // directories queued w/ an open descriptor (the rest is reopened by path)
+    static constexpr unsigned MAX_OPEN_DIRECTORIES = 256;
+
+private:
+    unsigned threads;
+    std::vector<std::string> ignorePatterns;
+
+public:
+    explicit DirectoryWalker(unsigned threads=1);
+    DirectoryWalker(const DirectoryWalker&) = delete;
+    DirectoryWalker(const DirectoryWalker&&) = delete;
+    DirectoryWalker& operator=(const DirectoryWalker&) = delete;
+    DirectoryWalker& operator=(const DirectoryWalker&&) = delete;
+    ~DirectoryWalker();
+
+    unsigned getThreads() const { return threads; }
+    void setThreads(unsigned threads) { this->threads = threads ? threads : 1; }
+    const std::vector<std::string>& getIgnorePatterns() const { return ignorePatterns; }
+    void setIgnorePatterns(const std::vector<std::string>& patterns) { ignorePatterns = patterns; }
+
+    /**
+     * @brief Is file/directory name matching an ignore pattern?
+     */
+    bool isIgnored(const char* name) const;
+
+    /**
+     * @brief Get sorted paths of all files in the directory and its subdirectories.
+     */
+    void walk(const std::string& directory, std::vector<std::string>& files) const;
+
+    /**
+     * @brief Match name against pattern w/ * and ? wildcards.
+     */
+    static bool matchPattern(const char* pattern, const char* name);
+
+private:
+    void walkSequential(const std::string& directory, std::vector<std::string>& files) const;
+};
+
+} // m8r namespace
+
+#endif /* M8R_DIRECTORY_WALKER_H_ */
@@ -21,6 +21,11 @@
 #ifdef _WIN32
   #include <ShlObj.h>
   #include <KnownFolders.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
+  #include <cerrno>
 #endif // _WIN32
 
 using namespace std;
@@ -308,6 +313,132 @@ bool fileToLines(const string* filename, vector<string*>& lines, size_t &fileSiz
     return fileSize>0;
 }
 
+bool bufferToLineSpans(const char* buffer, size_t size, vector<LineSpan>& lines)
+{
+    if(buffer && size) {
+        const char* end = buffer+size;
+        const char* begin = buffer;
+        const char* eol;
+        while(begin<end && (eol=static_cast<const char*>(memchr(begin, '\n', end-begin)))!=nullptr) {
+            lines.push_back(LineSpan{begin, static_cast<size_t>(eol-begin)});
+            begin = eol+1;
+        }
+        if(begin<end) {
+            // last line w/o EOL
+            lines.push_back(LineSpan{begin, static_cast<size_t>(end-begin)});
+        }
+        return true;
+    }
+
+    return false;
+}
+
+MappedFile::MappedFile()
+    : buffer{nullptr},
+      bufferSize{0},
+      mapped{false}
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const string& filename, bool map)
+{
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd<0) {
+        return false;
+    }
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) || fileStat.st_size<=0) {
+        ::close(fd);
+        return false;
+    }
+
+    if(map) {
+        void* address = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // mapping stays valid after the descriptor is closed
+        ::close(fd);
+        if(address==MAP_FAILED) {
+            return false;
+        }
+#ifdef MADV_SEQUENTIAL
+        madvise(address, fileStat.st_size, MADV_SEQUENTIAL);
+#endif
+        buffer = static_cast<const char*>(address);
+        bufferSize = fileStat.st_size;
+        mapped = true;
+        return true;
+    }
+
+    // file might be truncated/appended by another process while it's read
+    size_t capacity = static_cast<size_t>(fileStat.st_size);
+    char* data = new char[capacity];
+    size_t length = 0;
+    while(length<capacity) {
+        ssize_t r = ::read(fd, data+length, capacity-length);
+        if(r<0 && errno==EINTR) {
+            continue;
+        }
+        if(r<=0) {
+            break;
+        }
+        length += static_cast<size_t>(r);
+    }
+    ::close(fd);
+    if(!length) {
+        delete[] data;
+        return false;
+    }
+    buffer = data;
+    bufferSize = length;
+    return true;
+#else
+    UNUSED_ARG(map);
+    ifstream is(filename, ios::binary);
+    if(!is) {
+        return false;
+    }
+    is.seekg(0, ios::end);
+    streamoff length = is.tellg();
+    if(length<=0) {
+        return false;
+    }
+    is.seekg(0, ios::beg);
+    char* data = new char[length];
+    if(!is.read(data, length)) {
+        delete[] data;
+        return false;
+    }
+    buffer = data;
+    bufferSize = length;
+    return true;
+#endif
+}
+
+void MappedFile::close()
+{
+    if(buffer) {
+#ifndef _WIN32
+        if(mapped) {
+            munmap(const_cast<char*>(buffer), bufferSize);
+        } else {
+            delete[] buffer;
+        }
+#else
+        delete[] buffer;
+#endif
+        buffer = nullptr;
+        bufferSize = 0;
+        mapped = false;
+    }
+}
+
 string* fileToString(const string& filename)
 {
     ifstream is(filename);
@@ -43,6 +43,7 @@
 
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
 #include <iostream>
 #include <iterator>
 #include <string>
@@ -191,6 +192,73 @@ namespace filesystem {
 
 } // namespace: filesystem
 
+/**
+ * @brief Line of a text buffer - pointer to its first character and length.
+ *
+ * Line span does NOT own the buffer (string_view-like), therefore buffer must
+ * outlive the span. Line delimiter is not part of the line.
+ */
+class LineSpan
+{
+private:
+    const char* text;
+    size_t length;
+
+public:
+    LineSpan() : text{nullptr}, length{0} {}
+    LineSpan(const char* text, size_t length) : text{text}, length{length} {}
+
+    const char* data() const { return text; }
+    size_t size() const { return length; }
+    bool empty() const { return length==0; }
+    char operator[](size_t i) const { return text[i]; }
+    char at(size_t i) const {
+        if(i>=length) {
+            throw std::out_of_range("LineSpan::at() index out of range");
+        }
+        return text[i];
+    }
+    std::string substr(size_t pos, size_t n) const {
+        return std::string(text+pos, n<length-pos?n:length-pos);
+    }
+    std::string toString() const { return std::string(text, length); }
+};
+
+/**
+ * @brief Read-only file content in a single buffer.
+ *
+ * File is read to a single heap buffer by default. Mapping using mmap() on
+ * POSIX systems is opt-in and it's safe only for files which are replaced
+ * atomically (renamed): if another process truncates a mapped file (sync
+ * tools, editors and git rewriting repository files), then the reader is
+ * killed by SIGBUS. Either way data() is valid while the object lives.
+ */
+class MappedFile
+{
+private:
+    const char* buffer;
+    size_t bufferSize;
+    bool mapped;
+
+public:
+    explicit MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(const MappedFile&&) = delete;
+    MappedFile &operator=(const MappedFile&) = delete;
+    MappedFile &operator=(const MappedFile&&) = delete;
+    ~MappedFile();
+
+    /**
+     * @brief Read (or map) file - returns false if file cannot be read or it's empty.
+     */
+    bool open(const std::string& filename, bool map=false);
+    void close();
+
+    const char* data() const { return buffer; }
+    size_t size() const { return bufferSize; }
+    bool isMapped() const { return mapped; }
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -231,6 +299,10 @@ std::string platformSpecificPath(const char* path);
 std::string getNewTempFilePath(const std::string& extension);
 bool stringToLines(const std::string* text, std::vector<std::string*>& lines);
 bool fileToLines(const std::string* filename, std::vector<std::string*>& lines, size_t& filesize);
+/**
+ * @brief Split buffer to line spans (getline() semantics) - spans point to the buffer.
+ */
+bool bufferToLineSpans(const char* buffer, size_t size, std::vector<LineSpan>& lines);
 std::string* fileToString(const std::string& filename);
 void stringToFile(const std::string& filename, const std::string& content);
 time_t fileModificationTime(const std::string* filename);
@@ -0,0 +1,245 @@
+/*
+ force_layout.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "force_layout.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace m8r {
+
+constexpr double ForceDirectedLayout::THETA_DEFAULT;
+constexpr double ForceDirectedLayout::VELOCITY_THRESHOLD;
+constexpr int32_t ForceDirectedLayout::NO_CELL;
+constexpr int32_t ForceDirectedLayout::NO_BODY;
+
+ForceDirectedLayout::ForceDirectedLayout(double theta)
+    : theta{theta},
+      edgeLength{300.0},
+      left{-1e9},
+      top{-1e9},
+      right{1e9},
+      bottom{1e9},
+      x{},
+      y{},
+      pinned{},
+      degree{},
+      edges{},
+      xVelocity{},
+      yVelocity{},
+      cells{},
+      nextBody{}
+{
+}
+
+ForceDirectedLayout::~ForceDirectedLayout()
+{
+}
+
+void ForceDirectedLayout::clear()
+{
+    x.clear();
+    y.clear();
+    pinned.clear();
+    degree.clear();
+    edges.clear();
+}
+
+size_t ForceDirectedLayout::addBody(double x, double y)
+{
+    this->x.push_back(x);
+    this->y.push_back(y);
+    pinned.push_back(false);
+    degree.push_back(0);
+    return this->x.size()-1;
+}
+
+void ForceDirectedLayout::addEdge(size_t source, size_t destination)
+{
+    edges.push_back(make_pair(static_cast<uint32_t>(source), static_cast<uint32_t>(destination)));
+    degree[source]++;
+    degree[destination]++;
+}
+
+void ForceDirectedLayout::setBounds(double left, double top, double right, double bottom)
+{
+    this->left = left;
+    this->top = top;
+    this->right = right;
+    this->bottom = bottom;
+}
+
+int32_t ForceDirectedLayout::addCell(double left, double top, double size)
+{
+    Cell c{};
+    c.left = left;
+    c.top = top;
+    c.size = size;
+    c.children[0] = c.children[1] = c.children[2] = c.children[3] = NO_CELL;
+    c.firstBody = NO_BODY;
+    cells.push_back(c);
+    return static_cast<int32_t>(cells.size()-1);
+}
+
+void ForceDirectedLayout::buildQuadtree()
+{
+    cells.clear();
+    nextBody.assign(x.size(), NO_BODY);
+
+    // square root cell covering all bodies
+    double minX = *min_element(x.begin(), x.end());
+    double minY = *min_element(y.begin(), y.end());
+    double size = max(
+        *max_element(x.begin(), x.end()) - minX,
+        *max_element(y.begin(), y.end()) - minY);
+    addCell(minX, minY, size > 0 ? size*1.0001 : 1.0);
+
+    for(size_t b=0; b<x.size(); b++) {
+        insert(static_cast<int32_t>(b));
+    }
+}
+
+void ForceDirectedLayout::insert(int32_t body)
+{
+    int32_t c = 0;
+    for(unsigned depth=0; ; depth++) {
+        cells[c].mass++;
+        cells[c].massX += x[body];
+        cells[c].massY += y[body];
+
+        if(cells[c].children[0] == NO_CELL) {
+            if(cells[c].firstBody == NO_BODY || depth == MAX_DEPTH) {
+                nextBody[body] = cells[c].firstBody;
+                cells[c].firstBody = body;
+                return;
+            }
+
+            // split leaf: its (single) body is moved to a child
+            double half = cells[c].size/2.0;
+            for(int q=0; q<4; q++) {
+                // cells may be reallocated
+                int32_t child = addCell(cells[c].left + (q&1)*half, cells[c].top + (q>>1)*half, half);
+                cells[c].children[q] = child;
+            }
+            int32_t moved = cells[c].firstBody;
+            cells[c].firstBody = NO_BODY;
+            int q = (x[moved] >= cells[c].left+half ? 1 : 0) + (y[moved] >= cells[c].top+half ? 2 : 0);
+            Cell& child = cells[cells[c].children[q]];
+            child.mass = 1;
+            child.massX = x[moved];
+            child.massY = y[moved];
+            child.firstBody = moved;
+        }
+
+        double half = cells[c].size/2.0;
+        int q = (x[body] >= cells[c].left+half ? 1 : 0) + (y[body] >= cells[c].top+half ? 2 : 0);
+        c = cells[c].children[q];
+    }
+}
+
+void ForceDirectedLayout::repulse(int32_t body, double& xForce, double& yForce) const
+{
+    int32_t stack[4*MAX_DEPTH+4];
+    int top = 0;
+    stack[top++] = 0;
+    while(top) {
+        const Cell& c = cells[stack[--top]];
+        if(c.children[0] == NO_CELL) {
+            for(int32_t b=c.firstBody; b!=NO_BODY; b=nextBody[b]) {
+                if(b != body) {
+                    addRepulsion(x[body]-x[b], y[body]-y[b], 1.0, xForce, yForce);
+                }
+            }
+        } else if(c.mass) {
+            double dx = x[body] - c.massX/c.mass;
+            double dy = y[body] - c.massY/c.mass;
+            bool inside
+                = x[body] >= c.left && x[body] < c.left+c.size
+                  && y[body] >= c.top && y[body] < c.top+c.size;
+            // distant cell acts as a single body in its center of mass
+            if(!inside && c.size*c.size < theta*theta*(dx*dx + dy*dy)) {
+                addRepulsion(dx, dy, c.mass, xForce, yForce);
+            } else {
+                for(int q=0; q<4; q++) {
+                    if(cells[c.children[q]].mass) {
+                        stack[top++] = c.children[q];
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool ForceDirectedLayout::step()
+{
+    size_t n = x.size();
+    xVelocity.assign(n, 0.0);
+    yVelocity.assign(n, 0.0);
+    if(!n) {
+        return false;
+    }
+
+    // BODIES ~ REPULSE MAGNETS: sum up all forces pushing body AWAY
+    if(theta > 0) {
+        buildQuadtree();
+        for(size_t b=0; b<n; b++) {
+            repulse(static_cast<int32_t>(b), xVelocity[b], yVelocity[b]);
+        }
+    } else {
+        for(size_t b=0; b<n; b++) {
+            for(size_t o=0; o<n; o++) {
+                addRepulsion(x[b]-x[o], y[b]-y[o], 1.0, xVelocity[b], yVelocity[b]);
+            }
+        }
+    }
+
+    // EDGES ~ RUBBER BANDS: substract forces pulling bodies TOGETHER
+    for(const pair<uint32_t,uint32_t>& e:edges) {
+        double dx = x[e.first] - x[e.second];
+        double dy = y[e.first] - y[e.second];
+        double sourceWeight = (degree[e.first] + 1) * 10.0;
+        double destinationWeight = (degree[e.second] + 1) * 10.0;
+        xVelocity[e.first] -= dx / sourceWeight;
+        yVelocity[e.first] -= dy / sourceWeight;
+        xVelocity[e.second] += dx / destinationWeight;
+        yVelocity[e.second] += dy / destinationWeight;
+    }
+
+    bool moved = false;
+    for(size_t b=0; b<n; b++) {
+        if(pinned[b]) {
+            continue;
+        }
+        // round velocity to avoid moving FOREVER
+        if(fabs(xVelocity[b]) < VELOCITY_THRESHOLD && fabs(yVelocity[b]) < VELOCITY_THRESHOLD) {
+            continue;
+        }
+        double newX = min(max(x[b] + xVelocity[b], left), right);
+        double newY = min(max(y[b] + yVelocity[b], top), bottom);
+        if(newX != x[b] || newY != y[b]) {
+            x[b] = newX;
+            y[b] = newY;
+            moved = true;
+        }
+    }
+    return moved;
+}
+
+} // m8r namespace
@@ -0,0 +1,140 @@
+/*
+ force_layout.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_FORCE_LAYOUT_H
+#define M8R_FORCE_LAYOUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Force-directed graph layout - repulse magnets and rubber bands.
+ *
+ * Bodies (graph nodes) repulse each other and edges pull bodies together.
+ * Repulsion is approximated using Barnes-Hut quadtree: distant group
+ * of bodies acts as a single body in its center of mass, therefore a step
+ * is O(n*log(n)) instead of O(n^2). Theta 0 stands for exact calculation.
+ *
+ * Layout works on plain position arrays and it's not thread safe: it is expected
+ * to be stepped by a background task, while (GUI) thread reads and updates
+ * bodies only in between steps.
+ */
+class ForceDirectedLayout
+{
+public:
+    static constexpr double THETA_DEFAULT = 0.7;
+    // velocity below threshold is rounded to zero to avoid moving forever
+    static constexpr double VELOCITY_THRESHOLD = 0.3;
+
+private:
+    static constexpr int32_t NO_CELL = -1;
+    static constexpr int32_t NO_BODY = -1;
+    // coincident bodies are kept in a leaf at max depth
+    static constexpr unsigned MAX_DEPTH = 32;
+
+    /**
+     * @brief Quadtree cell - leaf cell has a list of bodies, inner cell has 4 children.
+     */
+    struct Cell {
+        double left;
+        double top;
+        double size;
+        double massX;
+        double massY;
+        unsigned mass;
+        int32_t children[4];
+        int32_t firstBody;
+    };
+
+    double theta;
+    double edgeLength;
+    double left, top, right, bottom;
+
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<char> pinned;
+    std::vector<unsigned> degree;
+    std::vector<std::pair<uint32_t,uint32_t>> edges;
+
+    // step workspace
+    std::vector<double> xVelocity;
+    std::vector<double> yVelocity;
+    std::vector<Cell> cells;
+    std::vector<int32_t> nextBody;
+
+public:
+    explicit ForceDirectedLayout(double theta=THETA_DEFAULT);
+    ForceDirectedLayout(const ForceDirectedLayout&) = delete;
+    ForceDirectedLayout(const ForceDirectedLayout&&) = delete;
+    ForceDirectedLayout& operator=(const ForceDirectedLayout&) = delete;
+    ForceDirectedLayout& operator=(const ForceDirectedLayout&&) = delete;
+    ~ForceDirectedLayout();
+
+    void clear();
+    size_t addBody(double x, double y);
+    void addEdge(size_t source, size_t destination);
+    size_t getBodiesCount() const { return x.size(); }
+    size_t getEdgesCount() const { return edges.size(); }
+
+    double getX(size_t body) const { return x[body]; }
+    double getY(size_t body) const { return y[body]; }
+    void setPosition(size_t body, double x, double y) { this->x[body] = x; this->y[body] = y; }
+    /**
+     * @brief Pinned body (e.g. dragged by mouse) is not moved by forces.
+     */
+    void setPinned(size_t body, bool pinned) { this->pinned[body] = pinned; }
+    bool isPinned(size_t body) const { return pinned[body]; }
+
+    double getTheta() const { return theta; }
+    void setTheta(double theta) { this->theta = theta; }
+    double getEdgeLength() const { return edgeLength; }
+    void setEdgeLength(double edgeLength) { this->edgeLength = edgeLength; }
+    /**
+     * @brief Bodies are kept in bounds.
+     */
+    void setBounds(double left, double top, double right, double bottom);
+
+    /**
+     * @brief Calculate forces and move bodies.
+     *
+     * @return true if any body moved.
+     */
+    bool step();
+
+private:
+    void buildQuadtree();
+    void insert(int32_t body);
+    int32_t addCell(double left, double top, double size);
+    void repulse(int32_t body, double& xForce, double& yForce) const;
+    void addRepulsion(double dx, double dy, double mass, double& xForce, double& yForce) const {
+        // formula that calculates and ADDs forces driving body away in X and Y direction
+        double l = 2.0 * (dx*dx + dy*dy);
+        // if bodies have DIFFERENT coordinates, then add AWAY forces
+        if(l > 0) {
+            xForce += mass * dx * edgeLength / l;
+            yForce += mass * dy * edgeLength / l;
+        }
+    }
+};
+
+}
+#endif // M8R_FORCE_LAYOUT_H
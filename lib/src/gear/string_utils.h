@@ -77,9 +77,12 @@ static inline bool stringistring(const std::string& a, const std::string& b)
 
 static inline void stringToLower(const std::string& s, std::string& lowerS)
 {
-    static const std::locale locale;
-    for(std::string::size_type i=0; i<s.length(); ++i) {
-        lowerS += std::tolower(s[i],locale);
+    // std::tolower(c,locale) looks up the facet for every character > lookup it once
+    static const std::ctype<char>& ctype = std::use_facet<std::ctype<char>>(std::locale{});
+    std::string::size_type offset = lowerS.size();
+    lowerS += s;
+    if(!s.empty()) {
+        ctype.tolower(&lowerS[offset], &lowerS[offset]+s.size());
     }
 }
 
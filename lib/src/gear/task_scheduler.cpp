@@ -0,0 +1,262 @@
+/*
+ task_scheduler.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "task_scheduler.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace m8r {
+
+// worker (if any) of the current thread - tasks submitted by a task are queued to its worker
+static thread_local TaskScheduler* currentScheduler = nullptr;
+static thread_local void* currentWorker = nullptr;
+
+TaskScheduler::TaskScheduler(unsigned maxThreads)
+    : maxThreads{maxThreads ? maxThreads : std::max(2u, std::thread::hardware_concurrency())},
+      workers{},
+      threads{0},
+      idle{0},
+      pending{0},
+      enqueued{0},
+      stopping{false}
+{
+    for(unsigned i=0; i<this->maxThreads; i++) {
+        workers.push_back(unique_ptr<Worker>{new Worker{}});
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    shutdown();
+}
+
+void TaskScheduler::enqueue(Job& job, Priority priority, const void* supersede)
+{
+    Worker* self = currentScheduler == this ? static_cast<Worker*>(currentWorker) : nullptr;
+
+    {
+        unique_lock<std::mutex> criticalSection{mutex};
+        if(supersede) {
+            auto s = superseded.find(supersede);
+            if(s != superseded.end()) {
+                s->second.cancel();
+                s->second = job.token;
+            } else {
+                superseded.insert(make_pair(supersede, job.token));
+            }
+        }
+
+        if(!self && stopping) {
+            criticalSection.unlock();
+            job.token.cancel();
+            job.run();
+            return;
+        }
+
+        // job is counted before it's visible > worker which takes it cannot decrement pending first
+        pending++;
+        enqueued++;
+        if(self) {
+            lock_guard<std::mutex> workerCriticalSection{self->mutex};
+            self->queues[priority].push_back(job);
+        } else {
+            queues[priority].push_back(job);
+        }
+
+        // start a new worker only if idle workers cannot take all queued tasks
+        if(pending > idle && threads < maxThreads) {
+            Worker* worker = workers[threads++].get();
+            worker->thread = std::thread{&TaskScheduler::work, this, worker};
+        }
+    }
+    wakeup.notify_one();
+}
+
+bool TaskScheduler::take(Worker* self, Job& job)
+{
+    for(unsigned p=0; p<PRIORITIES; p++) {
+        // own tasks LIFO
+        if(self) {
+            lock_guard<std::mutex> criticalSection{self->mutex};
+            if(!self->queues[p].empty()) {
+                job = self->queues[p].back();
+                self->queues[p].pop_back();
+                return true;
+            }
+        }
+        // shared tasks FIFO
+        {
+            lock_guard<std::mutex> criticalSection{mutex};
+            if(!queues[p].empty()) {
+                job = queues[p].front();
+                queues[p].pop_front();
+                return true;
+            }
+        }
+        // steal tasks of other workers FIFO
+        for(unique_ptr<Worker>& w:workers) {
+            if(w.get() != self) {
+                lock_guard<std::mutex> criticalSection{w->mutex};
+                if(!w->queues[p].empty()) {
+                    job = w->queues[p].front();
+                    w->queues[p].pop_front();
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::work(Worker* self)
+{
+    currentScheduler = this;
+    currentWorker = self;
+
+    Job job{};
+    size_t seen;
+    while(true) {
+        {
+            lock_guard<std::mutex> criticalSection{mutex};
+            seen = enqueued;
+        }
+        if(take(self, job)) {
+            {
+                lock_guard<std::mutex> criticalSection{mutex};
+                pending--;
+            }
+            job.run();
+            job = Job{};
+            continue;
+        }
+
+        // all jobs queued before the scan were taken by other workers > wait for a new one
+        unique_lock<std::mutex> criticalSection{mutex};
+        if(enqueued != seen) {
+            continue;
+        }
+        if(stopping) {
+            break;
+        }
+        idle++;
+        wakeup.wait(criticalSection, [this, seen]{ return enqueued != seen || stopping; });
+        idle--;
+    }
+
+    currentScheduler = nullptr;
+    currentWorker = nullptr;
+}
+
+void TaskScheduler::parallel(
+        unsigned helpers,
+        const function<void()>& helper,
+        const function<void()>& task,
+        Priority priority)
+{
+    struct Helpers {
+        std::mutex mutex;
+        std::condition_variable finished;
+        unsigned running;
+        bool done;
+
+        Helpers() : mutex{}, finished{}, running{0}, done{false} {}
+    };
+    shared_ptr<Helpers> state = make_shared<Helpers>();
+
+    helpers = std::min(helpers, maxThreads);
+    for(unsigned i=0; i<helpers; i++) {
+        // helper is referenced > jobs which start after the call returns must not touch it
+        submit<void>(
+            [state, &helper](const Token& token) {
+                {
+                    lock_guard<std::mutex> criticalSection{state->mutex};
+                    if(state->done || token.isCancelled()) {
+                        return;
+                    }
+                    state->running++;
+                }
+                helper();
+                {
+                    lock_guard<std::mutex> criticalSection{state->mutex};
+                    state->running--;
+                }
+                state->finished.notify_all();
+            },
+            priority);
+    }
+
+    task();
+
+    unique_lock<std::mutex> criticalSection{state->mutex};
+    state->done = true;
+    state->finished.wait(criticalSection, [&state]{ return state->running == 0; });
+}
+
+void TaskScheduler::cancel(const void* supersede)
+{
+    lock_guard<std::mutex> criticalSection{mutex};
+    auto s = superseded.find(supersede);
+    if(s != superseded.end()) {
+        s->second.cancel();
+    }
+}
+
+void TaskScheduler::shutdown()
+{
+    {
+        lock_guard<std::mutex> criticalSection{mutex};
+        stopping = true;
+        for(deque<Job>& q:queues) {
+            for(Job& j:q) {
+                j.token.cancel();
+            }
+        }
+        for(unique_ptr<Worker>& w:workers) {
+            lock_guard<std::mutex> workerCriticalSection{w->mutex};
+            for(deque<Job>& q:w->queues) {
+                for(Job& j:q) {
+                    j.token.cancel();
+                }
+            }
+        }
+    }
+    wakeup.notify_all();
+
+    // queued (cancelled) tasks are run by workers before they stop
+    for(unique_ptr<Worker>& w:workers) {
+        if(w->thread.joinable()) {
+            w->thread.join();
+        }
+    }
+}
+
+unsigned TaskScheduler::getThreadsCount()
+{
+    lock_guard<std::mutex> criticalSection{mutex};
+    return threads;
+}
+
+size_t TaskScheduler::getPendingCount()
+{
+    lock_guard<std::mutex> criticalSection{mutex};
+    return pending;
+}
+
+} // m8r namespace
@@ -0,0 +1,176 @@
+/*
+ task_scheduler.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_TASK_SCHEDULER_H
+#define M8R_TASK_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Bounded work-stealing scheduler of background tasks.
+ *
+ * Worker threads are started lazily (up to the limit) and reused by all
+ * tasks. Every worker has its own deques of tasks - tasks submitted by
+ * a task (worker thread) are queued to worker's deque and taken LIFO by
+ * the owner, idle workers steal them FIFO. Tasks submitted by other threads
+ * are queued to a shared queue. Tasks w/ higher priority are always taken
+ * first, running tasks are never preempted.
+ *
+ * Data parallel loops are run by parallel() - the calling thread works
+ * and scheduler workers help it, so that loops run from a task don't
+ * oversubscribe CPUs w/ their own threads.
+ *
+ * Cancellation is cooperative: task gets a token and it's expected to check
+ * it and return early. Cancelled tasks are still run (to release resources
+ * and to satisfy their futures). Task submitted w/ a supersede key cancels
+ * previous task w/ the same key - e.g. leaderboard of N user navigated away
+ * from is not needed anymore.
+ */
+class TaskScheduler
+{
+public:
+    enum Priority {
+        INTERACTIVE = 0,
+        BACKGROUND = 1,
+        PREFETCH = 2
+    };
+    static constexpr unsigned PRIORITIES = 3;
+
+    /**
+     * @brief Cancellation token shared by scheduler and task.
+     */
+    class Token
+    {
+        std::shared_ptr<std::atomic<bool>> cancelled;
+
+    public:
+        explicit Token() : cancelled{std::make_shared<std::atomic<bool>>(false)} {}
+
+        bool isCancelled() const { return cancelled->load(); }
+        void cancel() const { cancelled->store(true); }
+    };
+
+private:
+    struct Job {
+        std::function<void()> run;
+        Token token;
+
+        Job() : run{}, token{} {}
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> queues[PRIORITIES];
+        std::thread thread;
+    };
+
+    unsigned maxThreads;
+    // allocated upfront, threads are started on demand
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // guards everything below
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::deque<Job> queues[PRIORITIES];
+    std::unordered_map<const void*,Token> superseded;
+    unsigned threads;
+    unsigned idle;
+    // jobs queued in shared and worker queues
+    size_t pending;
+    // jobs ever queued - idle worker waits for a change
+    size_t enqueued;
+    bool stopping;
+
+public:
+    /**
+     * @brief Create scheduler w/ given max number of threads (0 ~ hardware concurrency, at least 2).
+     */
+    explicit TaskScheduler(unsigned maxThreads=0);
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler(const TaskScheduler&&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&&) = delete;
+    ~TaskScheduler();
+
+    /**
+     * @brief Submit task - callable w/ const Token& parameter returning R.
+     *
+     * If scheduler is shut down, then task is run synchronously w/ cancelled token.
+     */
+    template<typename R, typename F>
+    std::shared_future<R> submit(F task, Priority priority=BACKGROUND, const void* supersede=nullptr)
+    {
+        Token token{};
+        std::shared_ptr<std::packaged_task<R()>> packagedTask
+            = std::make_shared<std::packaged_task<R()>>([task, token]() mutable { return task(token); });
+        std::shared_future<R> result = packagedTask->get_future().share();
+        Job job{};
+        job.run = [packagedTask]() { (*packagedTask)(); };
+        job.token = token;
+        enqueue(job, priority, supersede);
+        return result;
+    }
+
+    /**
+     * @brief Run task in the calling thread w/ the help of up to helpers scheduler workers.
+     *
+     * Helper and task are expected to take work items from a shared source
+     * (e.g. atomic counter) and both of them must be able to finish all the
+     * work alone. Helpers which did not start by the time task finished
+     * are skipped, so the caller never waits for a busy scheduler - it waits
+     * only for the helpers which are still running.
+     */
+    void parallel(
+            unsigned helpers,
+            const std::function<void()>& helper,
+            const std::function<void()>& task,
+            Priority priority=BACKGROUND);
+
+    /**
+     * @brief Cancel the last task submitted w/ the key.
+     */
+    void cancel(const void* supersede);
+
+    /**
+     * @brief Cancel queued tasks, wait for all tasks to finish and stop threads.
+     */
+    void shutdown();
+
+    unsigned getMaxThreads() const { return maxThreads; }
+    unsigned getThreadsCount();
+    size_t getPendingCount();
+
+private:
+    void enqueue(Job& job, Priority priority, const void* supersede);
+    bool take(Worker* self, Job& job);
+    void work(Worker* self);
+};
+
+}
+#endif // M8R_TASK_SCHEDULER_H
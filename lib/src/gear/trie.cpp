@@ -18,57 +18,97 @@
 */
 #include "trie.h"
 
+#include <algorithm>
+
 namespace m8r {
 
 using namespace std;
 
 Trie::Trie()
+    : nodes{},
+      frozen{false},
+      labels{}
 {
-    root = new Node();
+    newNode(' ');
 }
 
 Trie::~Trie()
 {
-    // delete nodes using backtracking
-    destroy(root);
 }
 
-void Trie::destroy(Node* n)
+uint32_t Trie::newNode(char c)
+{
+    nodes.push_back(Node{NO_NODE, NO_NODE, 0, 0, c});
+    return static_cast<uint32_t>(nodes.size()-1);
+}
+
+uint32_t Trie::findChild(uint32_t n, char c) const
 {
-    for(Node* c:n->mChildren) {
-        destroy(c);
+    const Node& parent = nodes[n];
+    if(frozen) {
+        // children are contiguous and sorted
+        if(!parent.childrenCount) {
+            return NO_NODE;
+        }
+        if(parent.childrenCount <= LINEAR_SEARCH_THRESHOLD) {
+            // few children (typically chain of single child nodes) follow parent in DFS layout
+            for(uint32_t i=parent.firstChild; i<parent.firstChild+parent.childrenCount; i++) {
+                if(nodes[i].content == c) {
+                    return i;
+                }
+            }
+            return NO_NODE;
+        }
+        const unsigned char* begin = labels.data() + parent.firstChild;
+        const unsigned char* end = begin + parent.childrenCount;
+        const unsigned char* label = std::lower_bound(begin, end, static_cast<unsigned char>(c));
+        return label != end && *label == static_cast<unsigned char>(c)
+            ? static_cast<uint32_t>(label - labels.data())
+            : NO_NODE;
+    } else {
+        for(uint32_t i=parent.firstChild; i!=NO_NODE; i=nodes[i].nextSibling) {
+            if(nodes[i].content == c) {
+                return i;
+            }
+        }
+        return NO_NODE;
     }
-    delete n;
 }
 
 void Trie::addWord(const string& s)
 {
     //MF_DEBUG("trie.add(" << s << ")" << endl);
     if(s.size()) {
-        Node* current = root;
-
-        if(!s.size()) {
-            // support of empty words is NOT desired
-            // current->setWordMarker();
-            return;
-        }
-
+        uint32_t current = 0;
         for(size_t i=0; i<s.size(); i++) {
-            Node* child = current->findChild(s[i]);
-
-            if(child != nullptr) {
-                current = child;
-            } else {
-                Node* n = new Node();
-                n->setContent(s[i]);
-                current->appendChild(n);
-                current = n;
+            // siblings are searched by links which are valid in both arena and frozen trie
+            uint32_t child = nodes[current].firstChild;
+            uint32_t last = NO_NODE;
+            while(child != NO_NODE && nodes[child].content != s[i]) {
+                last = child;
+                child = nodes[child].nextSibling;
             }
 
-            if(i == s.size()-1) {
-                current->setWordMarker();
+            if(child == NO_NODE) {
+                // new node breaks contiguous children of frozen trie
+                if(frozen) {
+                    frozen = false;
+                    labels.clear();
+                    labels.shrink_to_fit();
+                }
+
+                // append child to siblings
+                child = newNode(s[i]);
+                if(last == NO_NODE) {
+                    nodes[current].firstChild = child;
+                } else {
+                    nodes[last].nextSibling = child;
+                }
+                nodes[current].childrenCount++;
             }
+            current = child;
         }
+        ++nodes[current].refCount;
     }
 }
 
@@ -81,101 +121,139 @@ void Trie::addWord(const string& s)
  * to trie.
  *
  * The method is suboptimal in a sense that nodes
- * are not destroyed immediately, but when the whole trie
- * is destroyed.
+ * are not destroyed immediately, but when the trie
+ * is frozen or destroyed.
  */
 bool Trie::removeWord(const string& s, bool decRefCountOnly)
 {
     MF_DEBUG("trie.remove(" << s << ")" << endl);
-    if(s.size()) {
-        if(root->children().empty()) {
-            return false;
-        } else {
-            Node* current = root;
-            while(current != nullptr) {
-                for(size_t i=0; i<s.size(); i++) {
-                    Node* n = current->findChild(s[i]);
-                    if(n == nullptr) {
-                        return false;
-                    }
-                    current = n;
-                }
+    if(s.size() && !empty()) {
+        uint32_t current = 0;
+        for(size_t i=0; i<s.size(); i++) {
+            current = findChild(current, s[i]);
+            if(current == NO_NODE) {
+                return false;
+            }
+        }
 
-                if(current->wordMarker()) {
-                    if(decRefCountOnly) {
-                        current->decRefCount();
-                    } else {
-                        current->setRefCount(0);
-                    }
-                    return true;
-                }
+        Node& n = nodes[current];
+        if(n.wordMarker()) {
+            if(decRefCountOnly) {
+                n.refCount--;
+            } else {
+                n.refCount = 0;
             }
+            return true;
         }
     }
 
     return false;
 }
 
-bool Trie::findWord(string& s) const
+bool Trie::findWord(const string& s) const
 {
-    if(root->children().empty()) {
-        return false;
-    } else {
-        Node* current = root;
-        while(current != nullptr) {
-            for(size_t i=0; i<s.size(); i++) {
-                Node* n = current->findChild(s[i]);
-                if(n == nullptr) {
-                    return false;
-                }
-                current = n;
-            }
-
-            return current->wordMarker();
+    uint32_t current = 0;
+    for(size_t i=0; i<s.size(); i++) {
+        current = findChild(current, s[i]);
+        if(current == NO_NODE) {
+            return false;
         }
-        return false;
     }
+    return current && nodes[current].wordMarker();
 }
 
 bool Trie::findLongestPrefixWord(const string& s, string& r) const
 {
-    if(root->children().empty()) {
-        return false;
+    size_t longestWordSize{};
+
+    uint32_t current = 0;
+    for(size_t i=0; i<s.size(); i++) {
+        current = findChild(current, s[i]);
+        if(current == NO_NODE) {
+            break;
+        }
+        if(nodes[current].wordMarker()) {
+            longestWordSize = i+1;
+        }
+    }
+
+    if(longestWordSize) {
+        r.append(s, 0, longestWordSize);
+        return true;
     } else {
-        size_t longestWordSize{};
-
-        Node* current = root;
-        if(current != nullptr) {
-            for(size_t i=0; i<s.size(); i++) {
-                Node* n = current->findChild(s[i]);
-                if(n == nullptr) {
-                    // TODO make this method
-                    if(longestWordSize) {
-                        r = r.substr(0, longestWordSize);
-                        return true;
-                    } else {
-                        return false;
-                    }
-                }
+        return false;
+    }
+}
 
-                current = n;
-                r += s[i];
-                if(current->wordMarker()) {
-                    longestWordSize = r.size();
-                }
+bool Trie::isAlive(uint32_t n, vector<uint8_t>& alive) const
+{
+    bool a = nodes[n].wordMarker();
+    for(uint32_t c=nodes[n].firstChild; c!=NO_NODE; c=nodes[c].nextSibling) {
+        a = isAlive(c, alive) || a;
+    }
+    alive[n] = a;
+    return a;
+}
+
+void Trie::freeze()
+{
+    if(frozen) {
+        return;
+    }
+
+    // nodes w/o any word in subtree (removed words) are dropped
+    vector<uint8_t> alive(nodes.size(), 0);
+    isAlive(0, alive);
+    alive[0] = 1;
+
+    // DFS layout w/ contiguous sorted children: node's children block is followed by
+    // subtree of its 1st child i.e. chains of single child nodes are sequential
+    vector<Node> frozenNodes{};
+    frozenNodes.reserve(nodes.size());
+    frozenNodes.push_back(nodes[0]);
+    // (node, frozen node) to be laid out
+    vector<pair<uint32_t,uint32_t>> stack{{0,0}};
+    vector<uint32_t> children{};
+    while(!stack.empty()) {
+        const uint32_t n = stack.back().first;
+        const uint32_t f = stack.back().second;
+        stack.pop_back();
+
+        children.clear();
+        for(uint32_t c=nodes[n].firstChild; c!=NO_NODE; c=nodes[c].nextSibling) {
+            if(alive[c]) {
+                children.push_back(c);
             }
+        }
+        std::sort(children.begin(), children.end(), [this](uint32_t c1, uint32_t c2) {
+            return static_cast<unsigned char>(nodes[c1].content) < static_cast<unsigned char>(nodes[c2].content);
+        });
 
-            // TODO make this method
-            if(longestWordSize) {
-                r = r.substr(0, longestWordSize);
-                return true;
-            } else {
-                return false;
+        const uint32_t first = static_cast<uint32_t>(frozenNodes.size());
+        for(uint32_t c:children) {
+            if(frozenNodes.size() > first) {
+                frozenNodes.back().nextSibling = static_cast<uint32_t>(frozenNodes.size());
             }
-        } else {
-            return false;
+            frozenNodes.push_back(nodes[c]);
+            frozenNodes.back().nextSibling = NO_NODE;
+        }
+        frozenNodes[f].firstChild = children.empty() ? NO_NODE : first;
+        frozenNodes[f].childrenCount = static_cast<uint16_t>(children.size());
+
+        // 1st child to be laid out first
+        for(size_t i=children.size(); i>0; i--) {
+            stack.push_back(make_pair(children[i-1], first+static_cast<uint32_t>(i-1)));
         }
     }
+
+    frozenNodes.shrink_to_fit();
+    nodes.swap(frozenNodes);
+
+    labels.resize(nodes.size());
+    for(size_t i=0; i<nodes.size(); i++) {
+        labels[i] = static_cast<unsigned char>(nodes[i].content);
+    }
+    frozen = true;
 }
 
 int Trie::print() const
@@ -183,29 +261,28 @@ int Trie::print() const
     MF_DEBUG("Trie:" << endl);
 
     int count = 1;
-    if(root->children().empty()) {
+    if(empty()) {
         MF_DEBUG("  EMPTY" << endl);
     } else {
         string prefix{};
-        count = resursivePrint(prefix, root, count);
+        count = resursivePrint(prefix, 0, count);
     }
 
     MF_DEBUG("Trie nodes: " << count << endl);
     return count;
 }
 
-int Trie::resursivePrint(string prefix, const Node* n, int count) const
+int Trie::resursivePrint(string& prefix, uint32_t n, int count) const
 {
     MF_DEBUG(
-        (n->wordMarker()?" >":"  ") <<
+        (nodes[n].wordMarker()?" >":"  ") <<
         "'" << prefix << "' " <<
-        (n->wordMarker()?std::to_string(n->refCount()):"") << endl);
+        (nodes[n].wordMarker()?std::to_string(nodes[n].refCount):"") << endl);
 
-    std::vector<Node*> children = n->children();
-    for(Node* n:children) {
-        prefix += n->content();
-        count = resursivePrint(prefix, n, ++count);
-        prefix = prefix.substr(0, prefix.size()-1);
+    for(uint32_t c=nodes[n].firstChild; c!=NO_NODE; c=nodes[c].nextSibling) {
+        prefix += nodes[c].content;
+        count = resursivePrint(prefix, c, ++count);
+        prefix.pop_back();
     }
 
     return count;
@@ -19,6 +19,7 @@
 #ifndef M8R_TRIE_H
 #define M8R_TRIE_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -30,47 +31,37 @@ namespace m8r {
  * @brief Trie.
  *
  * This implementation has been inspired by an http://www.sourcetricks.com example.
+ *
+ * Nodes are allocated in an arena (contiguous array) and referenced by index. Children
+ * of a node are kept as a list of siblings in order of insertion. Trie which is read
+ * mostly can be frozen: nodes are laid out in DFS order so that children of every
+ * node are contiguous and sorted, and their characters are kept in a compact array
+ * to be searched w/o touching nodes (nodes of removed words are dropped). Adding
+ * a word w/ new nodes to the frozen trie thaws it.
  */
 class Trie
 {
 private:
-    class Node {
-        friend class Trie;
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+    // frozen trie: children are searched in labels by binary search only if there are more of them
+    static constexpr uint16_t LINEAR_SEARCH_THRESHOLD = 4;
 
-    private:
-        char mContent;
+    struct Node {
+        uint32_t firstChild;
+        uint32_t nextSibling;
         // >1 it is word with given references, 0 it's char inside a word
-        int mRefCount;
-        std::vector<Node*> mChildren;
-
-    public:
-        explicit Node() {
-            mContent = ' ';
-            mRefCount = 0;
-        }
-        ~Node() {}
-        char content() const { return mContent; }
-        void setContent(char c) { mContent = c; }
-        bool wordMarker() const { return mRefCount>0; }
-        int refCount() const { return mRefCount; }
-        int decRefCount() { if(mRefCount > 0) { mRefCount--; }; return mRefCount; }
-        void setRefCount(int refCount) { mRefCount=refCount; }
-        void setWordMarker() { ++mRefCount; }
-        void appendChild(Node* child) { mChildren.push_back(child); }
-        std::vector<Node*> children() const { return mChildren; }
-
-        // IMPROVE sort children once trie filled AND use binary search here O(n) -> O(log(n))
-        Node* findChild(char c) {
-            for(Node* n:mChildren) {
-                if(n->content()==c) {
-                    return n;
-                }
-            }
-            return nullptr;
-        }
+        int refCount;
+        uint16_t childrenCount;
+        char content;
+
+        bool wordMarker() const { return refCount>0; }
     };
 
-    Node* root;
+    // root has index 0
+    std::vector<Node> nodes;
+    bool frozen;
+    // frozen trie: characters of nodes (children of a node are contiguous and sorted)
+    std::vector<unsigned char> labels;
 
 public:
     explicit Trie();
@@ -80,13 +71,15 @@ public:
     Trie& operator=(const Trie&&) = delete;
     ~Trie();
 
-    bool empty() const { return root->children().empty(); }
+    bool empty() const { return !nodes[0].childrenCount; }
+    size_t getNodesCount() const { return nodes.size(); }
+    bool isFrozen() const { return frozen; }
 
     void addWord(const std::string& s);
     /**
      * @brief Is the word known to trie?
      */
-    bool findWord(std::string& s) const;
+    bool findWord(const std::string& s) const;
     /**
      * @brief Find longest word which is prefix of s.
      */
@@ -96,14 +89,21 @@ public:
      */
     bool removeWord(const std::string& s, bool decRefCountOnly=false);
 
+    /**
+     * @brief Compact trie for fast search once filled.
+     */
+    void freeze();
+
     /**
      * @brief Print trie (backgracking).
      */
     int print() const;
 
 private:
-    int resursivePrint(std::string prefix, const Node* n, int count) const;
-    void destroy(Node* n);
+    uint32_t findChild(uint32_t n, char c) const;
+    uint32_t newNode(char c);
+    int resursivePrint(std::string& prefix, uint32_t n, int count) const;
+    bool isAlive(uint32_t n, std::vector<uint8_t>& alive) const;
 };
 
 }
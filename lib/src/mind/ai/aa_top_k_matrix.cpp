@@ -0,0 +1,174 @@
+/*
+ aa_top_k_matrix.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "aa_top_k_matrix.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace m8r {
+
+AssociationAssessmentTopKMatrix::AssociationAssessmentTopKMatrix(size_t k)
+    : k{k},
+      rows{},
+      calculated{}
+{
+}
+
+AssociationAssessmentTopKMatrix::~AssociationAssessmentTopKMatrix()
+{
+}
+
+size_t AssociationAssessmentTopKMatrix::size() const
+{
+    lock_guard<mutex> criticalSection{rowsMutex};
+    return rows.size();
+}
+
+size_t AssociationAssessmentTopKMatrix::getCellsCount() const
+{
+    lock_guard<mutex> criticalSection{rowsMutex};
+    size_t count = 0;
+    for(const vector<Cell>& row:rows) {
+        count += row.size();
+    }
+    return count;
+}
+
+void AssociationAssessmentTopKMatrix::clear()
+{
+    lock_guard<mutex> criticalSection{rowsMutex};
+    rows.clear();
+    calculated.clear();
+}
+
+void AssociationAssessmentTopKMatrix::resize(size_t n)
+{
+    lock_guard<mutex> criticalSection{rowsMutex};
+    rows.resize(n);
+    calculated.resize(n, 0);
+}
+
+bool AssociationAssessmentTopKMatrix::isCalculated(size_t row) const
+{
+    lock_guard<mutex> criticalSection{rowsMutex};
+    return row < calculated.size() && calculated[row];
+}
+
+void AssociationAssessmentTopKMatrix::keepTopK(vector<Cell>& cells) const
+{
+    if(cells.size() > k) {
+        std::partial_sort(cells.begin(), cells.begin()+k, cells.end(), isBetter);
+        cells.resize(k);
+    } else {
+        std::sort(cells.begin(), cells.end(), isBetter);
+    }
+}
+
+void AssociationAssessmentTopKMatrix::setRow(size_t row, vector<Cell>& candidates)
+{
+    // select K best outside of critical section
+    keepTopK(candidates);
+
+    lock_guard<mutex> criticalSection{rowsMutex};
+    if(row < rows.size()) {
+        rows[row].assign(candidates.begin(), candidates.end());
+        rows[row].shrink_to_fit();
+        calculated[row] = 1;
+    }
+}
+
+bool AssociationAssessmentTopKMatrix::getRow(size_t row, vector<Cell>& cells) const
+{
+    lock_guard<mutex> criticalSection{rowsMutex};
+    if(row < rows.size() && calculated[row]) {
+        cells.insert(cells.end(), rows[row].begin(), rows[row].end());
+        return true;
+    }
+    return false;
+}
+
+void AssociationAssessmentTopKMatrix::invalidate(size_t row)
+{
+    lock_guard<mutex> criticalSection{rowsMutex};
+    if(row < rows.size()) {
+        rows[row].clear();
+        calculated[row] = 0;
+    }
+}
+
+void AssociationAssessmentTopKMatrix::update(size_t row, uint32_t column, float aa)
+{
+    lock_guard<mutex> criticalSection{rowsMutex};
+    if(row >= rows.size() || !calculated[row]) {
+        return;
+    }
+
+    vector<Cell>& cells = rows[row];
+    const Cell cell{column, aa};
+    auto existing = std::find_if(
+        cells.begin(),
+        cells.end(),
+        [column](const Cell& c) { return c.first == column; });
+    if(existing != cells.end()) {
+        if(cells.size() == k && isBetter(cells.back(), cell)) {
+            // column sinks below the K-th cell > cells outside of top K might be better
+            cells.clear();
+            calculated[row] = 0;
+            return;
+        }
+        *existing = cell;
+    } else if(cells.size() < k) {
+        cells.push_back(cell);
+    } else if(isBetter(cell, cells.back())) {
+        cells.back() = cell;
+    } else {
+        return;
+    }
+    std::sort(cells.begin(), cells.end(), isBetter);
+}
+
+void AssociationAssessmentTopKMatrix::forget(uint32_t column)
+{
+    lock_guard<mutex> criticalSection{rowsMutex};
+    for(size_t row=0; row<rows.size(); row++) {
+        if(calculated[row]) {
+            vector<Cell>& cells = rows[row];
+            for(const Cell& c:cells) {
+                if(c.first == column) {
+                    if(cells.size() < k) {
+                        // row has all columns > just drop the cell
+                        cells.erase(
+                            std::remove_if(
+                                cells.begin(),
+                                cells.end(),
+                                [column](const Cell& cc) { return cc.first == column; }),
+                            cells.end());
+                    } else {
+                        cells.clear();
+                        calculated[row] = 0;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+}
+
+} // m8r namespace
@@ -0,0 +1,120 @@
+/*
+ aa_top_k_matrix.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_ASSOCIATION_ASSESSMENT_TOP_K_MATRIX_H
+#define M8R_ASSOCIATION_ASSESSMENT_TOP_K_MATRIX_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Sparse associations assessment matrix which keeps K best associations per row.
+ *
+ * Dense N x N matrix of AA rankings does not scale (30k Ns ~ 3.6GB of floats),
+ * while leaderboard of a N needs just its K best associations. Therefore every
+ * row keeps at most K (column, AA) cells sorted by AA in descending order.
+ *
+ * Row is either calculated (it contains K best cells across ALL columns) or not
+ * (it must be calculated before it's used). Once a single cell changes, the row
+ * is updated in place if the result is still exact, else it's invalidated to be
+ * recalculated on demand - cells outside of the top K are not known.
+ *
+ * Rows are read and written under a mutex, therefore rows can be calculated
+ * in parallel.
+ */
+class AssociationAssessmentTopKMatrix
+{
+public:
+    /**
+     * @brief Matrix cell: column (N index) and AA ranking.
+     */
+    typedef std::pair<uint32_t,float> Cell;
+
+    /**
+     * @brief Cell comparator: higher AA first, lower column first on tie.
+     */
+    static bool isBetter(const Cell& c1, const Cell& c2) {
+        return c1.second > c2.second || (c1.second == c2.second && c1.first < c2.first);
+    }
+
+private:
+    size_t k;
+
+    std::vector<std::vector<Cell>> rows;
+    std::vector<uint8_t> calculated;
+
+    mutable std::mutex rowsMutex;
+
+public:
+    explicit AssociationAssessmentTopKMatrix(size_t k);
+    AssociationAssessmentTopKMatrix(const AssociationAssessmentTopKMatrix&) = delete;
+    AssociationAssessmentTopKMatrix(const AssociationAssessmentTopKMatrix&&) = delete;
+    AssociationAssessmentTopKMatrix &operator=(const AssociationAssessmentTopKMatrix&) = delete;
+    AssociationAssessmentTopKMatrix &operator=(const AssociationAssessmentTopKMatrix&&) = delete;
+    ~AssociationAssessmentTopKMatrix();
+
+    size_t getK() const { return k; }
+    size_t size() const;
+    size_t getCellsCount() const;
+
+    void clear();
+
+    /**
+     * @brief Resize matrix - new rows are NOT calculated, existing rows are kept.
+     */
+    void resize(size_t n);
+
+    bool isCalculated(size_t row) const;
+
+    /**
+     * @brief Set row to K best cells from candidates (candidates are modified).
+     */
+    void setRow(size_t row, std::vector<Cell>& candidates);
+
+    /**
+     * @brief Copy calculated row cells (best first) - returns false if row is not calculated.
+     */
+    bool getRow(size_t row, std::vector<Cell>& cells) const;
+
+    /**
+     * @brief Invalidate row i.e. clear it and mark it as not calculated.
+     */
+    void invalidate(size_t row);
+
+    /**
+     * @brief Update AA of column in row (if calculated).
+     *
+     * Row is invalidated if it had K cells and the column sinks below them
+     * as the new K-th best cell is not known.
+     */
+    void update(size_t row, uint32_t column, float aa);
+
+    /**
+     * @brief Forget column in all rows - rows which had it in top K are invalidated.
+     */
+    void forget(uint32_t column);
+
+private:
+    void keepTopK(std::vector<Cell>& cells) const;
+};
+
+}
+#endif // M8R_ASSOCIATION_ASSESSMENT_TOP_K_MATRIX_H
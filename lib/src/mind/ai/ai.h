@@ -116,6 +116,24 @@ public:
         return aa->getAssociatedNotes(words, associations, self);
     }
 
+    /**
+     * @brief Update associations once O was remembered (created or modified).
+     *
+     * Synchronized by caller ~ Mind.
+     */
+    bool remember(Outline* outline) {
+        return aa->remember(outline);
+    }
+
+    /**
+     * @brief Forget associations of O's Ns.
+     *
+     * Synchronized by caller ~ Mind.
+     */
+    bool forget(Outline* outline) {
+        return aa->forget(outline);
+    }
+
     /**
      * @brief Clear, but don't deallocate.
      *
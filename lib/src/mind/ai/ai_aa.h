@@ -73,6 +73,16 @@ public:
      */
     virtual std::shared_future<bool> getAssociatedNotes(const std::string& words, std::vector<std::pair<Note*,float>>& associations, const Note* self) = 0;
 
+    /**
+     * @brief Update associations of O's Ns once O was remembered (created or modified).
+     */
+    virtual bool remember(Outline* outline) = 0;
+
+    /**
+     * @brief Forget associations of O's Ns.
+     */
+    virtual bool forget(Outline* outline) = 0;
+
     /**
      * @brief Clear.
      */
@@ -18,6 +18,10 @@
 */
 #include "ai_aa_bow.h"
 
+#include <algorithm>
+#include <atomic>
+#include <set>
+
 namespace m8r {
 
 using namespace std;
@@ -27,34 +31,18 @@ AiAaBoW::AiAaBoW(Memory& memory, Mind& mind)
       memory(memory),
       lexicon{},
       wordBlacklist{},
-      tokenizer{lexicon,wordBlacklist}
+      bow{AA_WORD_RELEVANCY_THRESHOLD},
+      tokenizer{lexicon,wordBlacklist},
+      titleLexicon{},
+      titleTokenizer{titleLexicon,wordBlacklist},
+      aaMatrix{AA_LEADERBOARD_SIZE},
+      aaLearning{false},
+      aaPendingOutlines{}
 {
 }
 
 AiAaBoW::~AiAaBoW()
 {
-    // delete dead threads
-    auto zombieIterator
-        = std::remove_if(runningWorkers.begin(),
-                         runningWorkers.end(),
-                         [](const thread* t) { if(!t->joinable()) { delete t; return true; } else return false; });
-    runningWorkers.erase(zombieIterator, runningWorkers.end());
-}
-
-void AiAaBoW::addWorkerAndCleanZombies(thread* t)
-{
-    lock_guard<mutex> criticalSection{runningWorkersMutex};
-    MF_DEBUG("AA.BoW: workers+zombies " << runningWorkers.size() << endl);
-
-    // IMPROVE: if zombies is erased > future/promise is deleted as well > frontend that has future calls a method on it > crash
-    //   - temporal SOLUTION: threads are deleted on MF exit (i.e. finished threads are kept in memory for whole MF run)
-    //     (see destructor for dead threads code to move in here)
-    //   - IDEA: frontend could use a thread hook to indicate that it got future and t can be freed
-
-    // add new one
-    runningWorkers.push_back(t);
-
-    MF_DEBUG("AA.BoW: workers " << runningWorkers.size() << endl);
 }
 
 // it's presumed that caller ensures the correct Mind state & synchronization
@@ -63,14 +51,9 @@ shared_future<bool> AiAaBoW::dream() {
         MF_DEBUG("AA.BoW: ASYNC dream..." << endl);
         mind.incActiveProcesses();
 
-        // packaged task is parametrized by function/method signature (not return type)
-        std::packaged_task<bool (AiAaBoW*,thread*)> learnMemoryTask([](AiAaBoW* a,thread* t) { return a->learnMemorySync(t); });
-        future<bool> result = learnMemoryTask.get_future(); // move
-        thread* t = new thread{};
-        *t = thread(std::move(learnMemoryTask), this, t);
-        addWorkerAndCleanZombies(t);
-
-        return shared_future<bool>(std::move(result));
+        return mind.getScheduler().submit<bool>(
+            [this](const TaskScheduler::Token&) { return learnMemorySync(); },
+            TaskScheduler::BACKGROUND);
     } else {
         MF_DEBUG("AA.BoW: SYNC dream..." << endl);
         promise<bool> p{};
@@ -83,59 +66,281 @@ shared_future<bool> AiAaBoW::dream() {
     }
 }
 
-bool AiAaBoW::learnMemorySync(thread* t)
+bool AiAaBoW::learnMemorySync()
 {
     MF_DEBUG("AA.BoW: LEARNING memory to BoW..." << endl);
-    notes.clear();
-    memory.getAllNotes(notes);
-    // let N know it's indexed in AI
-    for(size_t i=0; i<notes.size(); i++) {
-        notes[i]->setAiAaMatrixIndex(static_cast<int>(i));
-    }
+    {
+        lock_guard<mutex> criticalSection{aaMutex};
+
+        notes.clear();
+        notesModified.clear();
+        notesOutline.clear();
+        noteIndices.clear();
+        outlineIndices.clear();
+        memory.getAllNotes(notes);
+        // let N know it's indexed in AI
+        for(size_t i=0; i<notes.size(); i++) {
+            notes[i]->setAiAaMatrixIndex(static_cast<int>(i));
+            notesModified.push_back(notes[i]->getModified());
+            notesOutline.push_back(notes[i]->getOutline());
+            noteIndices[notes[i]] = static_cast<uint32_t>(i);
+            outlineIndices[notes[i]->getOutline()].push_back(static_cast<uint32_t>(i));
+        }
 
-    // build lexicon and BoW
-    lexicon.clear();
-    bow.clear();
-    for(Note* n:notes) {
-        NoteCharProvider chars{n};
-        WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
-        tokenizer.tokenize(chars, *wfl);
-        bow.add(n, wfl);
-    }
-    // prepare DATA to quickly create association assessment features
-    lexicon.recalculateWeights();
-    bow.reorderDocVectorsByWeight();
+        // build lexicon and BoW
+        lexicon.clear();
+        bow.clear();
+        titleLexicon.clear();
+        notesTitle.clear();
+        notesTitle.resize(notes.size());
+        notesType.assign(notes.size(), nullptr);
+        notesTags.clear();
+        notesTags.resize(notes.size());
+        for(size_t y=0; y<notes.size(); y++) {
+            learnNote(static_cast<uint32_t>(y));
+        }
+        // prepare DATA to quickly create association assessment features
+        lexicon.recalculateWeights();
+        bow.reweight(lexicon);
 
 #ifdef DO_MF_DEBUG
-    lexicon.print();
-    bow.print();
+        lexicon.print();
+        bow.print(lexicon);
 #endif
 
-    // AA to be built incrementally - just initialize it
-    if(notes.size() != aaMatrix.size()) {
+        {
+            lock_guard<mutex> leaderboardCriticalSection{leaderboardMutex};
+            leaderboardCache.clear();
+        }
+
+        // rows are calculated on demand by leaderboards until the precalculated matrix is swapped in
         aaMatrix.clear();
         aaMatrix.resize(notes.size());
-        for(size_t i=0; i<aaMatrix.size(); ++i) {
-            aaMatrix[i].resize(aaMatrix.size(),(float)AiAaBoW::AA_NOT_SET); // C++ :-Z constexpr w/ internal linkage does NOT have to be solved in compile time > workaround via temporary var
+        aaLearning = true;
+    }
+
+    // O(n^2) AA is precalculated outside of the critical section
+    vector<vector<AssociationAssessmentTopKMatrix::Cell>> rows{};
+    precalculateAa(rows);
+
+    {
+        lock_guard<mutex> criticalSection{aaMutex};
+        for(size_t y=0; y<rows.size(); y++) {
+            aaMatrix.setRow(y, rows[y]);
         }
-    } else {
-        for(size_t i=0; i<aaMatrix.size(); ++i) {
-            std::fill(aaMatrix[i].begin(), aaMatrix[i].end(), (float)AiAaBoW::AA_NOT_SET); // C++ :-Z constexpr w/ internal linkage does NOT have to be solved in compile time > workaround via temporary var
+        aaLearning = false;
+
+        MF_DEBUG("AA.BoW: applying " << aaPendingOutlines.size() << " Os remembered/forgotten while learning" << endl);
+        for(auto& o:aaPendingOutlines) {
+            if(o.second) {
+                rememberOutline(o.first);
+            } else {
+                forgetOutline(o.first);
+            }
         }
+        aaPendingOutlines.clear();
     }
+    aaLearned.notify_all();
 
     // NN to be trained on demand - just initialize it
 
     mind.persistMindState(Configuration::MindState::THINKING);
     mind.decActiveProcesses();
-    if(t) t->detach(); // indicate that thread finished
 
     MF_DEBUG("AA.BoW: memory LEARNED!" << endl);
     return true;
 }
 
+void AiAaBoW::forgetNoteWords(const Note* n)
+{
+    BagOfWords::Vector v;
+    if(bow.get(n, v)) {
+        for(size_t i=0; i<v.size; i++) {
+            lexicon.remove(v.ids[i], v.frequencies[i]);
+        }
+        bow.remove(n);
+    }
+}
+
+void AiAaBoW::learnNote(uint32_t y)
+{
+    Note* n = notes[y];
+    forgetNoteWords(n);
+
+    NoteCharProvider chars{n};
+    WordFrequencyList wfl{&lexicon};
+    tokenizer.tokenize(chars, wfl);
+    bow.add(n, wfl);
+
+    StringCharProvider titleChars{n->getName()};
+    WordFrequencyList titleWfl{&titleLexicon};
+    titleTokenizer.tokenize(titleChars, titleWfl, false, true, false);
+    // word frequency list is ordered by ID
+    vector<uint32_t>& title = notesTitle[y];
+    title.clear();
+    for(auto& e:titleWfl.iterable()) {
+        title.push_back(e.first);
+    }
+    title.shrink_to_fit();
+
+    notesType[y] = n->getType();
+    notesTags[y] = *n->getTags();
+}
+
+void AiAaBoW::forgetNote(uint32_t y)
+{
+    const Note* n = notes[y];
+    if(n) {
+        forgetNoteWords(n);
+        noteIndices.erase(n);
+        notes[y] = nullptr;
+        notesOutline[y] = nullptr;
+        notesTitle[y].clear();
+        notesType[y] = nullptr;
+        notesTags[y].clear();
+
+        aaMatrix.invalidate(y);
+        aaMatrix.forget(y);
+    }
+}
+
+// it's presumed that caller ensures the correct Mind state & synchronization
+bool AiAaBoW::remember(Outline* outline)
+{
+    if(!outline) {
+        return false;
+    }
+
+    lock_guard<mutex> criticalSection{aaMutex};
+    if(notes.empty()) {
+        // memory has not been learned yet
+        return false;
+    }
+    if(aaLearning) {
+        MF_DEBUG("AA.BoW: O '" << outline->getName() << "' will be remembered once memory is learned" << endl);
+        aaPendingOutlines.push_back(std::make_pair(outline, true));
+        return true;
+    }
+
+    rememberOutline(outline);
+    return true;
+}
+
+void AiAaBoW::rememberOutline(Outline* outline)
+{
+    MF_DEBUG("AA.BoW: remembering O '" << outline->getName() << "'..." << endl);
+
+    // forget deleted Ns (Ns moved to another O are owned by that O)
+    const vector<Note*>& outlineNotes = outline->getNotes();
+    set<const Note*> alive(outlineNotes.begin(), outlineNotes.end());
+    vector<uint32_t>& indices = outlineIndices[outline];
+    bool changed = false;
+    for(uint32_t y:indices) {
+        if(notesOutline[y] == outline && !alive.count(notes[y])) {
+            forgetNote(y);
+            changed = true;
+        }
+    }
+    indices.clear();
+
+    // learn new and modified Ns
+    vector<uint32_t> modified{};
+    for(Note* n:outlineNotes) {
+        if(!mind.getScopeAspect().isInScope(n)) {
+            continue;
+        }
+
+        uint32_t y;
+        auto i = noteIndices.find(n);
+        if(i == noteIndices.end()) {
+            y = static_cast<uint32_t>(notes.size());
+            notes.push_back(n);
+            notesModified.push_back(n->getModified());
+            notesOutline.push_back(outline);
+            notesTitle.push_back(vector<uint32_t>{});
+            notesType.push_back(nullptr);
+            notesTags.push_back(vector<const Tag*>{});
+            noteIndices[n] = y;
+        } else {
+            y = i->second;
+            if(notesModified[y] == n->getModified() && notesOutline[y] == outline) {
+                indices.push_back(y);
+                continue;
+            }
+            notesModified[y] = n->getModified();
+            notesOutline[y] = outline;
+        }
+        n->setAiAaMatrixIndex(static_cast<int>(y));
+        indices.push_back(y);
+        learnNote(y);
+        modified.push_back(y);
+    }
+
+    if(!modified.empty()) {
+        // IMPROVE weights of words from other Ns changed as well, but rows of other Ns are NOT recalculated
+        lexicon.recalculateWeights();
+        bow.reweight(lexicon);
+
+        aaMatrix.resize(notes.size());
+        for(uint32_t y:modified) {
+            aaMatrix.invalidate(y);
+        }
+        // calculate rows of modified Ns and update their rankings in (calculated) rows of other Ns
+        vector<AssociationAssessmentTopKMatrix::Cell> cells{};
+        for(uint32_t y:modified) {
+            cells.clear();
+            calculateAaRow(y, &cells);
+            for(auto& c:cells) {
+                aaMatrix.update(c.first, y, c.second);
+            }
+        }
+        changed = true;
+    }
+
+    if(changed) {
+        lock_guard<mutex> leaderboardCriticalSection{leaderboardMutex};
+        leaderboardCache.clear();
+    }
+
+    MF_DEBUG("AA.BoW: O remembered w/ " << modified.size() << " new/modified Ns" << endl);
+}
+
+// it's presumed that caller ensures the correct Mind state & synchronization
+bool AiAaBoW::forget(Outline* outline)
+{
+    lock_guard<mutex> criticalSection{aaMutex};
+    if(aaLearning) {
+        // O is NOT dereferenced once forgotten
+        aaPendingOutlines.erase(
+            std::remove(aaPendingOutlines.begin(), aaPendingOutlines.end(), std::make_pair(outline, true)),
+            aaPendingOutlines.end());
+        aaPendingOutlines.push_back(std::make_pair(outline, false));
+        return true;
+    }
+
+    forgetOutline(outline);
+    return true;
+}
+
+void AiAaBoW::forgetOutline(const Outline* outline)
+{
+    auto i = outlineIndices.find(outline);
+    if(i != outlineIndices.end()) {
+        for(uint32_t y:i->second) {
+            if(notesOutline[y] == outline) {
+                forgetNote(y);
+            }
+        }
+        outlineIndices.erase(i);
+
+        lock_guard<mutex> leaderboardCriticalSection{leaderboardMutex};
+        leaderboardCache.clear();
+    }
+}
+
 // it's presumed that caller ensures the correct Mind state & synchronization
 shared_future<bool> AiAaBoW::getAssociatedNotes(const Note* note, vector<pair<Note*,float>>& associations) {
+    unique_lock<mutex> criticalSection{leaderboardMutex};
     auto cachedLeaderboard = leaderboardCache.find(note);
     if(cachedLeaderboard != leaderboardCache.end()) {
         MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << note->getName() << "'" << endl);
@@ -156,169 +361,138 @@ shared_future<bool> AiAaBoW::getAssociatedNotes(const Note* note, vector<pair<No
             MF_DEBUG("AA.BoW: leaderboard WIP for '" << note->getName() << "'" << endl);
             return p.get_future(); // move
         } else {
-            mind.incActiveProcesses();
-            MF_DEBUG("AA.BoW: starting THREAD for '" << note->getName() << "'" << endl);
+            criticalSection.unlock();
 
-            // packaged task is parametrized by function/method signature (not return type)
-            packaged_task<bool (AiAaBoW*,const Note*,thread*)> calculateLeaderboardTask([](AiAaBoW* a, const Note* n, thread* t) { return a->calculateLeaderboardSync(n,t); });
-            future<bool> result = calculateLeaderboardTask.get_future(); // move
-            thread* t = new thread{};
-            *t = thread(std::move(calculateLeaderboardTask), this, note, t); // run task w/ handle to self thread
-            addWorkerAndCleanZombies(t);
+            mind.incActiveProcesses();
+            MF_DEBUG("AA.BoW: scheduling leaderboard TASK for '" << note->getName() << "'" << endl);
 
-            return shared_future<bool>(std::move(result));
+            // leaderboard of N user navigated away from is superseded by this one
+            return mind.getScheduler().submit<bool>(
+                [this, note](const TaskScheduler::Token& token) { return calculateLeaderboardSync(note, token); },
+                TaskScheduler::INTERACTIVE,
+                &leaderboardCache);
         }
     }
 }
 
-// Pre-calculate/calculate code CANNOT be reused as pre-calculate relies on rows w/ lower index
-// to fill the beginning of the line.
+float AiAaBoW::calculateAa(size_t x, size_t y, AssociationAssessmentNotesFeature& aaFeature)
+{
+    // rank N1/N2 tuple in the same order regardless of row/column to keep AA symmetric
+    if(x < y) {
+        std::swap(x, y);
+    }
+    // Ns are NOT dereferenced - they might be modified or deleted while AA is precalculated
+    aaFeature.setHaveMutualRel(false); // TODO
+    aaFeature.setTypeMatches(notesType[x]==notesType[y]);
+    aaFeature.setSimilaritySameOutline(notesOutline[x]==notesOutline[y]);
+    aaFeature.setSimilarityByTags(calculateSimilarityByTags(&notesTags[x],&notesTags[y]));
+    aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(notesTitle[x],notesTitle[y]));
+    BagOfWords::Vector v1, v2;
+    bow.get(notes[x], v1);
+    bow.get(notes[y], v2);
+    aaFeature.setSimilarityByDescription(calculateSimilarityByWords(v1, v2));
+    aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
+
+    return aaFeature.areNotesAssociatedMetric();
+}
+
 // This is a private method called from AI ~ AI state/async/critical sections handled by caller.
-void AiAaBoW::calculateAaRow(size_t y)
+void AiAaBoW::calculateAaRow(size_t y, vector<AssociationAssessmentTopKMatrix::Cell>* cells)
 {
     MF_DEBUG("AA.BoW: Calculating AA row " << y << "..." << endl);
-    // calculate row and column that cross diagonal on [y][y]
-
-    // check diagonal to find out whether the cross has been already calculated
-    if(aaMatrix[y][y] == 1.f) {
-        return;
-    }
 
-    float aa;
+    vector<AssociationAssessmentTopKMatrix::Cell> candidates{};
+    candidates.reserve(notes.size());
     AssociationAssessmentNotesFeature aaFeature{};
-
-    notes[y]->setAiAaMatrixIndex(y);
-    for(size_t x=0; x<aaMatrix.size(); x++) {
-        // set diagonal at the end
-        if(x!=y) {
-            // skip if value has been already calculated
-            if(aaMatrix[y][x] == AA_NOT_SET) {
-                Note* n1 = notes[x];
-                Note* n2 = notes[y];
-
-                aaFeature.setHaveMutualRel(false); // TODO
-                aaFeature.setTypeMatches(n1->getType()==n2->getType());
-                aaFeature.setSimilaritySameOutline(n1->getOutline()==n2->getOutline());
-                aaFeature.setSimilarityByTags(calculateSimilarityByTags(n1->getTags(),n2->getTags()));
-                aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(n1->getName(),n2->getName()));
-                aaFeature.setSimilarityByDescription(calculateSimilarityByWords(*bow.get(n1),*bow.get(n2),AA_WORD_RELEVANCY_THRESHOLD));
-                aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
-
-                aa = aaFeature.areNotesAssociatedMetric();
-
-                // set AA ranking both below and above diagonal - detection will be faster later (no check x>y needed)
-                aaMatrix[x][y] = aa;
-                aaMatrix[y][x] = aa;
-            }
+    for(size_t x=0; x<notes.size(); x++) {
+        if(x!=y && notes[x]) {
+            candidates.push_back(std::make_pair(static_cast<uint32_t>(x), calculateAa(x, y, aaFeature)));
         }
     }
 
-    // set diagonal at the end to indicate calculation is done (consider reentrancy)
-    aaMatrix[y][y] = 1.;
+    if(cells) {
+        *cells = candidates;
+    }
+    aaMatrix.setRow(y, candidates);
 
-#ifdef DO_MF_DEBUG
     MF_DEBUG("AA.BoW: AA row calculated!" << endl);
-    //printAa();
-    //assertAaSymmetry();
-#endif
 }
 
 // This is a private method called from AI ~ AI state/async/critical sections handled by caller.
-void AiAaBoW::precalculateAa()
+void AiAaBoW::precalculateAa(vector<vector<AssociationAssessmentTopKMatrix::Cell>>& rows)
 {
-#ifdef DO_MF_DEBUG
-    static const float UNIQUE_AA_CELLS = (float)(notes.size()*notes.size()/2.+notes.size()/2.);
-    MF_DEBUG("  Building AA matrix w/ " << UNIQUE_AA_CELLS << " UNIQUE rankings..." << endl);
-    float c=0;
-    float p;
-#endif
-
-    // calculate FULL matrix of Ns associativity assessment for every N1 and N2 tuple
-    float aa;
-    AssociationAssessmentNotesFeature aaFeature{};
-    for(size_t y=0; y<aaMatrix.size(); y++) {
-        notes[y]->setAiAaMatrixIndex(y); // sets index for ALL notes in notes vector
-
-#ifdef DO_MF_DEBUG
-        p = c/(UNIQUE_AA_CELLS/100.);
-        MF_DEBUG("    " << (int)p << "% AA matrix rankings for '" << notes[y]->getName() << "'" << endl);
-#endif
-
-        // calculate only values ABOVE diagonal i.e. initialize x=y
-        for(size_t x=y; x<aaMatrix.size(); x++) {
-#ifdef DO_MF_DEBUG
-            c++;
-#endif
-
-            if(x==y) {
-                aaMatrix[x][y] = 1.;
-            } else {
-                Note* n1 = notes[x];
-                Note* n2 = notes[y];
-
-                aaFeature.setHaveMutualRel(false); // TODO
-                aaFeature.setTypeMatches(n1->getType()==n2->getType());
-                aaFeature.setSimilaritySameOutline(n1->getOutline()==n2->getOutline());
-                aaFeature.setSimilarityByTags(calculateSimilarityByTags(n1->getTags(),n2->getTags()));
-                aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(n1->getName(),n2->getName()));
-                aaFeature.setSimilarityByDescription(calculateSimilarityByWords(*bow.get(n1),*bow.get(n2),AA_WORD_RELEVANCY_THRESHOLD));
-                aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
-
-                aa = aaFeature.areNotesAssociatedMetric();
-
-                // set AA ranking both below and above diagonal - detection will be faster later (no check x>y needed)
-                aaMatrix[x][y] = aa;
-                aaMatrix[y][x] = aa;
+    typedef AssociationAssessmentTopKMatrix::Cell Cell;
+
+    const size_t size = notes.size();
+    const size_t k = aaMatrix.getK();
+    MF_DEBUG("  Building AA matrix w/ " << (size*(size ? size-1 : 0)/2) << " UNIQUE rankings..." << endl);
+
+    // K best candidates of every row are kept in a heap w/ the worst candidate on the top
+    vector<vector<Cell>>& best = rows;
+    best.assign(size, vector<Cell>{});
+    vector<mutex> stripes(AA_ROW_LOCK_STRIPES);
+    auto offer = [&](size_t row, const Cell& cell) {
+        lock_guard<mutex> criticalSection{stripes[row%AA_ROW_LOCK_STRIPES]};
+        vector<Cell>& heap = best[row];
+        if(heap.size() < k) {
+            heap.push_back(cell);
+            std::push_heap(heap.begin(), heap.end(), AssociationAssessmentTopKMatrix::isBetter);
+        } else if(AssociationAssessmentTopKMatrix::isBetter(cell, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), AssociationAssessmentTopKMatrix::isBetter);
+            heap.back() = cell;
+            std::push_heap(heap.begin(), heap.end(), AssociationAssessmentTopKMatrix::isBetter);
+        }
+    };
+
+    // rows get shorter towards the end of the matrix - workers take rows one by one
+    atomic<size_t> nextRow{0};
+    auto worker = [&]() {
+        AssociationAssessmentNotesFeature aaFeature{};
+        size_t y;
+        while((y = nextRow++) < size) {
+            // calculate only values ABOVE diagonal and offer them to both row and column
+            for(size_t x=y+1; x<size; x++) {
+                float aa = calculateAa(x, y, aaFeature);
+                offer(y, Cell{static_cast<uint32_t>(x), aa});
+                offer(x, Cell{static_cast<uint32_t>(y), aa});
             }
         }
+    };
+
+    if(size >= AA_PARALLEL_THRESHOLD) {
+        // scheduler workers help the calling thread (which may be a scheduler worker itself)
+        TaskScheduler& scheduler = mind.getScheduler();
+        MF_DEBUG("  Using up to " << scheduler.getMaxThreads() << " AA workers" << endl);
+        scheduler.parallel(scheduler.getMaxThreads()-1, worker, worker);
+    } else {
+        worker();
     }
 
-#ifdef DO_MF_DEBUG
-    MF_DEBUG("  AA matrix built!" << endl);
-    //printAa();
-    assertAaSymmetry();
-#endif
+    MF_DEBUG("  AA matrix rows built!" << endl);
 }
 
-float AiAaBoW::calculateSimilarityByTitles(const string& t1, const string& t2)
+// Jaccard index of title word sets: merge of sorted arrays w/o branches in the loop body
+float AiAaBoW::calculateSimilarityByTitles(const vector<uint32_t>& t1, const vector<uint32_t>& t2)
 {
-    StringCharProvider cp1{t1};
-    WordFrequencyList v1{&lexicon};
-    tokenizer.tokenize(cp1, v1, false, true, false);
-    StringCharProvider cp2{t2};
-    WordFrequencyList v2{&lexicon};
-    tokenizer.tokenize(cp2, v2, false, true, false);
-
-    // calculate overlap
-    if(!v1.size() || !v2.size()) {
+    if(t1.empty() || t2.empty()) {
         return 0.;
-    } else {
-        // direct access for efficiency
-        WordFrequencyList intersection{&lexicon};
-        float iWeight=0, uWeight=0;
-
-        for(auto& e:v1.iterable()) {
-            uWeight += 1;
-            if(v2.contains(e.first)) {
-                iWeight += 1;
-                intersection.add(e.first);
-            }
-        }
-
-        for(auto& e:v2.iterable()) {
-            if(!intersection.contains(e.first)) {
-                uWeight += 1;
-                if(v1.contains(e.first)) {
-                    iWeight += 1;
-                    // no need to update iVector as it won't be needed
-                }
-            }
-        }
+    }
 
-        //MF_DEBUG("  titleSimilarity = "<<iWeight<<" / "<<uWeight << endl);
-        // intersection % of union
-        return (iWeight/(uWeight/100.))/100;
+    const uint32_t* i1 = t1.data();
+    const uint32_t* e1 = i1 + t1.size();
+    const uint32_t* i2 = t2.data();
+    const uint32_t* e2 = i2 + t2.size();
+    size_t intersection = 0;
+    while(i1 < e1 && i2 < e2) {
+        const uint32_t w1 = *i1;
+        const uint32_t w2 = *i2;
+        intersection += w1 == w2;
+        i1 += w1 <= w2;
+        i2 += w2 <= w1;
     }
+
+    // intersection % of union
+    return static_cast<float>(intersection) / static_cast<float>(t1.size() + t2.size() - intersection);
 }
 
 // algorithm is based on similarity by words (for now there are no weights - might be added later if needed by other lib functions)
@@ -362,157 +536,88 @@ float AiAaBoW::calculateSimilarityByTags(const vector<const Tag*>* t1, const vec
     }
 }
 
-// consider ONLY most valuable words via threshold - many irrelevat words would kill the score (irrelevant words make noise)
-float AiAaBoW::calculateSimilarityByWords(WordFrequencyList& v1, WordFrequencyList& v2, int threshold)
+// consider ONLY most valuable words - many irrelevat words would kill the score (irrelevant words make noise)
+float AiAaBoW::calculateSimilarityByWords(const BagOfWords::Vector& v1, const BagOfWords::Vector& v2)
 {
-    if(!v1.size() || !v2.size()) {
+    if(!v1.size || !v2.size) {
         return 0.;
     } else {
-        // direct access for efficiency
-        WordFrequencyList intersection{&lexicon};
-        float iWeight=0, uWeight=0;
-        int t=0;
-
-        // iterate at most *threshold* words from v1: all + to UNION, matching + to INTERSECTION
-        for(auto& e:v1.iterable()) {
-            if(t++>=threshold) break;
-
-            float w = lexicon.get(e.first)->weight;
-            uWeight += w;
-            if(v2.contains(e.first)) {
-                iWeight += w;
-                intersection.add(e.first);
-            }
-        }
-        // uWeight contains weight of 1st 10 v1's words, iWeight weight of v1 intersection v2
-
-        // iterate at most *threshold* words from v2: w in intersection HANDLED both u&i, w in v2&v1 > intersection else union
-        t=0;
-        for(auto& e:v2.iterable()) {
-            // consider at most threshold words from v2
-            if(++t>=threshold) break;
-
-            if(!intersection.contains(e.first)) {
-                float w = lexicon.get(e.first)->weight;
-                uWeight += w;
-                if(v1.contains(e.first)) {
-                    iWeight += w;
-                    // no need to update iVector as it won't be needed
-                }
-            }
-        }
+        // relevant words of v1 in v2 and relevant words of v2 in v1 (relevant words of both counted once)
+        float both = BagOfWords::weightOfIntersection(
+            v1.relevantIds, v1.relevantWeights, v1.relevantSize, v2.relevantIds, v2.relevantSize);
+        float iWeight
+            = BagOfWords::weightOfIntersection(v1.relevantIds, v1.relevantWeights, v1.relevantSize, v2.ids, v2.size)
+            + BagOfWords::weightOfIntersection(v2.relevantIds, v2.relevantWeights, v2.relevantSize, v1.ids, v1.size)
+            - both;
+        float uWeight = v1.relevantWeight + v2.relevantWeight - both;
 
         // intersection % of union
-        float result = (iWeight/(uWeight/100.))/100;
-        //MF_DEBUG("  wordSimilarity = "<<iWeight<<" / "<<uWeight <<" (t="<<t<<") -> " << result << endl);
+        float result = uWeight > 0 ? iWeight/uWeight : 0;
+        //MF_DEBUG("  wordSimilarity = "<<iWeight<<" / "<<uWeight << " -> " << result << endl);
         return result;
     }
 }
 
-bool AiAaBoW::calculateLeaderboardSync(const Note* n, thread* t)
+bool AiAaBoW::calculateLeaderboardSync(const Note* n, const TaskScheduler::Token& token)
 {
-    MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << n->getName() << "' in thread " << t << endl);
+    MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << n->getName() << "'" << (token.isCancelled()?" CANCELLED":"") << endl);
 
     // If N was REMOVED, then nobody will ask for leaderboard.
-    // If N was MODIFIED, then leaderboard will not be accurate (but it's not critical).
-    // If N was ADDED, then I don't have data - no leaderboard provided.
-    if(n->getAiAaMatrixIndex() != AA_NOT_SET) {
-        // check cache
-        auto cachedLeaderboard = leaderboardCache.find(n);
-        if(cachedLeaderboard != leaderboardCache.end()) {
-            return true;
-        }
-
-        // calculate row/column of AA matrix & build leaderboard
-        calculateAaRow(n->getAiAaMatrixIndex());
-
-        int aaLeaderboard[AA_LEADERBOARD_SIZE][2];
-        for(int i=0; i<AA_LEADERBOARD_SIZE; i++) {
-            aaLeaderboard[i][0] = aaLeaderboard[i][1] = AA_NOT_SET;
-        }
-
-        float aa;
-        for(size_t x=0, y=n->getAiAaMatrixIndex(); x<notes.size(); x++) {
-            if(x==y) continue; // self on diagonal
-
-            aa = aaMatrix[x][y];
-
-            if(aa > aaLeaderboard[AA_LEADERBOARD_SIZE-1][0]) { // covers also lb[][]==NOT_SET (== -1)
-                // find target leaderboard row
-                size_t target;
-                for(target=0; target<AA_LEADERBOARD_SIZE; target++) {
-                    if(aaLeaderboard[target][0] == AA_NOT_SET) {
-                        break; // fill empty row -> no shift needed
-                    } else {
-                        if(aa > aaMatrix[aaLeaderboard[target][0]][aaLeaderboard[target][1]]) {
-                            break;
-                        }
-                    }
-                }
+    // If N was MODIFIED or ADDED, then its row was updated when its O was remembered.
+    // If N is NOT remembered yet, then I don't have data - no leaderboard provided.
+    if(!token.isCancelled()) {
+        lock_guard<mutex> criticalSection{aaMutex};
+        auto i = noteIndices.find(n);
+        if(i != noteIndices.end()) {
+            const size_t y = i->second;
+
+            // row might be invalidated by changes of other Ns
+            if(!aaMatrix.isCalculated(y)) {
+                calculateAaRow(y);
+            }
 
-                /// empty row > no shift needed
-                if(aaLeaderboard[target][0] != AA_NOT_SET) {
-                    // shift leaderboard
-                    int sx = aaLeaderboard[target][0];
-                    int sy = aaLeaderboard[target][1];
-                    for(size_t ll=target; ll<AA_LEADERBOARD_SIZE; ll++) {
-                        if(aaLeaderboard[ll][0]!=AA_NOT_SET) {
-                            int tx=aaLeaderboard[ll][0];
-                            int ty=aaLeaderboard[ll][1];
-                            aaLeaderboard[ll][0]=sx;
-                            aaLeaderboard[ll][1]=sy;
-                            sx=tx;
-                            sy=ty;
-                        } else {
-                            aaLeaderboard[ll][0]=sx;
-                            aaLeaderboard[ll][1]=sy;
-                            break;
-                        }
-                    }
+            vector<AssociationAssessmentTopKMatrix::Cell> cells{};
+            aaMatrix.getRow(y, cells);
+
+            MF_DEBUG("Leaderboard of " << n->getName() << " (" << n->getOutline()->getName() << "):" << endl);
+            vector<pair<Note*,float>> leaderboard{};
+            for(auto& c:cells) {
+                if(notes[c.first]) {
+                    MF_DEBUG("  #" << leaderboard.size() << " " <<
+                             notes[c.first]->getName() << " (" << notes[c.first]->getOutline()->getName() << ")" <<
+                             " ~ " << c.second << endl);
+                    leaderboard.push_back(std::make_pair(notes[c.first], c.second));
                 }
-
-                // assign value
-                aaLeaderboard[target][0]=x;
-                aaLeaderboard[target][1]=y;
             }
-        }
 
-        MF_DEBUG("Leaderboard of " << n->getName() << " (" << n->getOutline()->getName() << "):" << endl);
-        vector<pair<Note*,float>> leaderboard{};
-        for(int i=0; i<AA_LEADERBOARD_SIZE && aaLeaderboard[i][0]!=AA_NOT_SET; i++) {
-            MF_DEBUG("  #" << i << " " <<
-                     notes[aaLeaderboard[i][0]]->getName() << " (" << notes[aaLeaderboard[i][0]]->getOutline()->getName() << ")" <<
-                     " ~ " << aaMatrix[aaLeaderboard[i][0]][aaLeaderboard[i][1]] << endl);
-            leaderboard.push_back(std::make_pair(notes[aaLeaderboard[i][0]],aaMatrix[aaLeaderboard[i][0]][aaLeaderboard[i][1]]));
+            // cache leaderboard (copied)
+            lock_guard<mutex> leaderboardCriticalSection{leaderboardMutex};
+            leaderboardCache[n] = leaderboard;
         }
-
-        // cache leaderboard (copied)
-        leaderboardCache[n] = leaderboard;
     }
 
-    leaderboardWip.erase(n);
-    mind.decActiveProcesses();
-    if(t) t->detach(); // indicate that thread finished
-    return true;
-}
-
-void AiAaBoW::assertAaSymmetry()
-{
-    MF_DEBUG("AI: checking AA symmetry..." << endl);
-    for(size_t i=0; i<aaMatrix.size(); ++i) {
-        for(size_t j=0; i<aaMatrix.size(); ++i) {
-            if(aaMatrix[i][j] != aaMatrix[j][i]) {
-                MF_DEBUG("  Symmetry ERROR: aa["<<i<<"]["<<j<<"]" << endl);
-            }
-        }
+    {
+        lock_guard<mutex> leaderboardCriticalSection{leaderboardMutex};
+        leaderboardWip.erase(n);
     }
-    MF_DEBUG("AI: AA symmetry checked!" << endl);
+    mind.decActiveProcesses();
+    return !token.isCancelled();
 }
 
 // it's presumed that caller ensures the correct Mind state & synchronization
 bool AiAaBoW::sleep() {
+    unique_lock<mutex> criticalSection{aaMutex};
+    aaLearned.wait(criticalSection, [this]{ return !aaLearning; });
     lexicon.clear();
+    titleLexicon.clear();
     notes.clear();
+    notesModified.clear();
+    notesOutline.clear();
+    notesTitle.clear();
+    notesType.clear();
+    notesTags.clear();
+    noteIndices.clear();
+    outlineIndices.clear();
     outlines.clear();
     bow.clear();
 
@@ -524,6 +629,9 @@ bool AiAaBoW::amnesia() {
     sleep();
     aaMatrix.clear();
 
+    lock_guard<mutex> criticalSection{leaderboardMutex};
+    leaderboardCache.clear();
+
     return true;
 }
 
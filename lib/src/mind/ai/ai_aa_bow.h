@@ -19,10 +19,15 @@
 #ifndef M8R_AI_ASSOCIATIONS_ASSESSMENT_BOW_H
 #define M8R_AI_ASSOCIATIONS_ASSESSMENT_BOW_H
 
+#include <condition_variable>
 #include <future>
+#include <mutex>
+#include <unordered_map>
 
 #include "../mind.h"
+#include "../../gear/task_scheduler.h"
 #include "ai_aa.h"
+#include "aa_top_k_matrix.h"
 #include "./nlp/markdown_tokenizer.h"
 #include "./nlp/note_char_provider.h"
 #include "./nlp/bag_of_words.h"
@@ -41,9 +46,10 @@ class Mind;
 class AiAaBoW : public AiAssociationsAssessment
 {
 private:
-    static constexpr int THREAD_POOL_SIZE = 2; // IMPROVE thread pool size to be either configured OR #CPU detected and 1/2 or 1/3 used
     static constexpr float AA_NOT_SET = -1.f;
-    static constexpr int AA_WORD_RELEVANCY_THRESHOLD = 10; // use 10 words w/ highest weight from vectors (and ignore others - irrelevant can bring noice with volume)
+    static constexpr size_t AA_ROW_LOCK_STRIPES = 64; // rows are locked by stripes when AA matrix is calculated in parallel
+    static constexpr size_t AA_PARALLEL_THRESHOLD = 256; // smaller AA matrices are calculated by a single thread
+    static constexpr size_t AA_WORD_RELEVANCY_THRESHOLD = 10; // use 10 words w/ highest weight from vectors (and ignore others - irrelevant can bring noice with volume)
     static constexpr float AA_TITLE_WORD_BONUS = 0.2f;
 
 private:
@@ -55,14 +61,31 @@ private:
     BagOfWords bow;
     MarkdownTokenizer tokenizer;
 
+    // N titles are tokenized once (when N is learned) to own lexicon so that title words
+    // don't skew description word weights
+    Lexicon titleLexicon;
+    MarkdownTokenizer titleTokenizer;
+
     /*
      * Data sets
      */
 
     // Os - vector index is used as ID through other data structures like similarity matrices
     std::vector<Outline*> outlines; // IMPROVE make O* pair where .second is O embedding w/ classifications/attributes
-    // Ns - vector index is used as ID through other data structures
+    // Ns - vector index is used as ID through other data structures (nullptr ~ forgotten N)
     std::vector<Note*> notes; // IMPROVE make N* pair where .second is N embedding w/ classifications/attributes
+    // N modification time when N was learned - unmodified Ns are skipped when O is remembered
+    std::vector<time_t> notesModified;
+    // O of N when N was learned - N moved to another O is owned by that O
+    std::vector<const Outline*> notesOutline;
+    // N title as sorted array of unique title lexicon word IDs
+    std::vector<std::vector<uint32_t>> notesTitle;
+    // N type and tags when N was learned - AA is calculated w/o dereferencing (possibly deleted) Ns
+    std::vector<const NoteType*> notesType;
+    std::vector<std::vector<const Tag*>> notesTags;
+    // N and O lookups - pointers are used as keys only (NOT dereferenced) as Ns/Os might be already deleted
+    std::unordered_map<const Note*,uint32_t> noteIndices;
+    std::unordered_map<const Outline*,std::vector<uint32_t>> outlineIndices;
 
     /*
      * Associations
@@ -72,14 +95,21 @@ private:
     // IMPROVE thing*,float - both O and N to be association
     std::map<const Note*,std::vector<std::pair<Note*,float>>> leaderboardCache;
     std::set<const Note*> leaderboardWip;
+    std::mutex leaderboardMutex;
 
     // associate as you WRITE: word(s) -> O/N
     // IMPROVE std::map<const Note*,std::vector<std::pair<string*,float>>> leaderboardCache;
 
-    // Associations assessment matrix w/ rankings for any N1/N2 tuple (diagonal symmetry).
-    // Changed from float** to vector<vector>> to enable row/col extension on new N/O
-    // (keep & avoid realloc)
-    std::vector<std::vector<float>> aaMatrix; // IMPROVE: notesAA and outlinesAA ~ Notes assocications assessment
+    // Associations assessment matrix w/ AA_LEADERBOARD_SIZE best rankings for every N
+    // (dense N x N matrix doesn't scale - leaderboard needs just the best associations)
+    AssociationAssessmentTopKMatrix aaMatrix; // IMPROVE: notesAA and outlinesAA ~ Notes assocications assessment
+    // guards data sets and BoWs - Ns are learned/remembered while leaderboards are calculated
+    std::mutex aaMutex;
+    // AA matrix is precalculated w/o aaMutex - data sets are read only meanwhile, therefore
+    // Os remembered (true) or forgotten (false) meanwhile are applied once the matrix is swapped in
+    bool aaLearning;
+    std::vector<std::pair<Outline*,bool>> aaPendingOutlines;
+    std::condition_variable aaLearned;
 
 public:
     explicit AiAaBoW(Memory& memory, Mind& mind);
@@ -121,36 +151,29 @@ public:
         return std::shared_future<bool>(p.get_future());
     }
 
-    virtual bool sleep();
+    virtual bool remember(Outline* outline);
 
-    virtual bool amnesia();
+    virtual bool forget(Outline* outline);
 
-private:
+    virtual bool sleep();
 
-    /*
-     * Worker threads:
-     *  1. packaged task is assigned to thread
-     *  2. thread performs the task and calls detach() on self when finishes
-     *     to indicate that it's ready to be deleted
-     *  3. if main thread detects that !thread.joinable(), then it can be deleted;
-     *     cleanup is done on any new thread launch AND/OR by this class destructor.
-     */
+    virtual bool amnesia();
 
-    // IMPROVE introduce a LIMIT on number of running threads in configuration
-    std::vector<std::thread*> runningWorkers;
-    std::mutex runningWorkersMutex;
+    size_t getAaCellsCount() const { return aaMatrix.getCellsCount(); }
 
 private:
 
     /**
      * @brief Learn Memory to start thinking.
      */
-    bool learnMemorySync(std::thread* t = nullptr);
+    bool learnMemorySync();
 
     /**
      * @brief Calculate leaderboard and indicate that it has been stored to cache.
+     *
+     * Nothing is calculated if the task was cancelled - superseded by leaderboard of another N.
      */
-    bool calculateLeaderboardSync(const Note* n, std::thread* t = nullptr);
+    bool calculateLeaderboardSync(const Note* n, const TaskScheduler::Token& token);
 
     /**
      * @brief Initialize blacklist using common words.
@@ -161,61 +184,90 @@ private:
     void initializeWordBlacklist();
 
     /**
-     * @brief Precalculate entire AA.
+     * @brief Tokenize description of N w/ given index to BoW and title to word IDs.
+     */
+    void learnNote(uint32_t y);
+
+    /**
+     * @brief Remove N's BoW and decrease frequencies of its words in lexicon - N is NOT dereferenced.
+     */
+    void forgetNoteWords(const Note* n);
+
+    /**
+     * @brief Forget N w/ given index - N is NOT dereferenced.
+     */
+    void forgetNote(uint32_t y);
+
+    /**
+     * @brief Learn new and modified Ns of O, forget its deleted Ns - caller holds aaMutex.
+     */
+    void rememberOutline(Outline* outline);
+
+    /**
+     * @brief Forget Ns of O - O is NOT dereferenced, caller holds aaMutex.
+     */
+    void forgetOutline(const Outline* outline);
+
+    /**
+     * @brief Precalculate entire AA to rows w/ the best rankings (AA matrix is NOT modified).
+     *
+     * Rows are calculated in parallel - every worker takes the next row which has
+     * not been taken yet, therefore workers which finished (shorter) rows steal
+     * work of others. Only rankings above diagonal are calculated and offered to
+     * both row and column.
      *
-     * LONG running method.
+     * LONG running method - data sets are only read, aaMutex is NOT held.
      */
-    void precalculateAa();
+    void precalculateAa(std::vector<std::vector<AssociationAssessmentTopKMatrix::Cell>>& rows);
 
     /**
-     * @brief Calculate AA row/column cross i.e. associations of N with *all* other Ns.
+     * @brief Calculate AA row i.e. associations of N with *all* other Ns.
+     *
+     * If cells is provided, then it's filled with rankings of all Ns (not just the best ones).
      *
      * LONG running method on bigger repositories.
      */
-    void calculateAaRow(size_t y);
+    void calculateAaRow(size_t y, std::vector<AssociationAssessmentTopKMatrix::Cell>* cells=nullptr);
 
     /**
-     * @brief Calculate similarity of two word vectors.
+     * @brief Calculate AA ranking of Ns w/ given indices.
      */
-    float calculateSimilarityByWords(WordFrequencyList& v1, WordFrequencyList& v2, int threshold=1000);
+    float calculateAa(size_t x, size_t y, AssociationAssessmentNotesFeature& aaFeature);
 
     /**
-     * @brief Calculate similarity of two tag lists.
+     * @brief Calculate similarity of two BoW vectors using their most relevant words.
      */
-    float calculateSimilarityByTags(const std::vector<const Tag*>* t1, const std::vector<const Tag*>* t2);
+    static float calculateSimilarityByWords(const BagOfWords::Vector& v1, const BagOfWords::Vector& v2);
 
     /**
-     * @brief Calculate similarity of two N/O names.
+     * @brief Calculate similarity of two tag lists.
      */
-    float calculateSimilarityByTitles(const std::string& t1, const std::string& t2);
+    float calculateSimilarityByTags(const std::vector<const Tag*>* t1, const std::vector<const Tag*>* t2);
 
     /**
-     * @brief Check AA matrix symmetry.
+     * @brief Calculate similarity of two N/O names given as sorted arrays of word IDs.
      */
-    void assertAaSymmetry();
+    static float calculateSimilarityByTitles(const std::vector<uint32_t>& t1, const std::vector<uint32_t>& t2);
 
     /**
      * @brief Get AA leaderboard from cache.
      */
     bool getCachedLeaderboard(const Note* n, std::vector<std::pair<Note*,float>>& leaderboard);
 
-    /**
-     * @brief Remove finished workers and add new one.
-     */
-    void addWorkerAndCleanZombies(std::thread* t);
-
 public:
 #ifdef DO_MF_DEBUG
     void printAa() {
         std::cout << "AA Matrix:" << std::endl;
+        std::vector<AssociationAssessmentTopKMatrix::Cell> cells{};
         for(size_t i=0; i<aaMatrix.size(); i++) {
             std::cout << "AA[" << i << "] = ";
-            for(size_t j=0; j<aaMatrix.size(); j++) {
-                if(aaMatrix[i][j] == -1) {
-                    std::cout << "_ ";
-                } else {
-                    std::cout << aaMatrix[i][j] << " ";
+            cells.clear();
+            if(aaMatrix.getRow(i, cells)) {
+                for(auto& c:cells) {
+                    std::cout << c.first << ":" << c.second << " ";
                 }
+            } else {
+                std::cout << "_";
             }
             std::cout << std::endl;
         }
@@ -82,6 +82,17 @@ public:
 
     virtual std::shared_future<bool> getAssociatedNotes(const std::string& words, std::vector<std::pair<Note*,float>>& associations, const Note* self);
 
+    // FTS is performed on the current memory - nothing to update
+    virtual bool remember(Outline* outline) {
+        UNUSED_ARG(outline);
+        return true;
+    }
+
+    virtual bool forget(Outline* outline) {
+        UNUSED_ARG(outline);
+        return true;
+    }
+
     virtual bool sleep() {
         notes.clear();
         return true;
@@ -30,7 +30,9 @@ const vector<string> AutolinkingMind::excludedWords({"http", "https"});
 
 AutolinkingMind::AutolinkingMind(Mind& mind)
     : mind{mind},
-      trie{nullptr}
+      trie{nullptr},
+      automaton{},
+      generation{}
 {
 }
 
@@ -82,7 +84,11 @@ void AutolinkingMind::updateTrieIndex()
     // Markdown structure (like e.g. http:// in links)
     for(const string& s:this->excludedWords) {
         trie->removeWord(s);
+        automaton.removeWord(s);
     }
+    trie->freeze();
+    automaton.compile();
+    generation++;
 
     // IMPROVE: add also tags
 
@@ -108,12 +114,20 @@ void AutolinkingMind::addThingToTrie(const Thing *t) {
     trie->addWord(getLowerName(t->getAutolinkingName()));
     // abbrev (if present)
     trie->addWord(t->getAutolinkingAbbr());
+
+    automaton.addWord(t->getAutolinkingName());
+    automaton.addWord(getLowerName(t->getAutolinkingName()));
+    automaton.addWord(t->getAutolinkingAbbr());
 }
 
 void AutolinkingMind::removeThingFromTrie(const Thing *t) {
     trie->removeWord(t->getAutolinkingName());
     trie->removeWord(getLowerName(t->getAutolinkingName()));
     trie->removeWord(t->getAutolinkingAbbr());
+
+    automaton.removeWord(t->getAutolinkingName());
+    automaton.removeWord(getLowerName(t->getAutolinkingName()));
+    automaton.removeWord(t->getAutolinkingAbbr());
 }
 
 void AutolinkingMind::update(const std::string& oldName, const std::string& newName)
@@ -129,17 +143,32 @@ void AutolinkingMind::update(const std::string& oldName, const std::string& newN
             Thing t{newName};
             addThingToTrie(&t);
         }
+        generation++;
     }
 
     MF_DEBUG("DONE autolink update: '" << oldName << "' > '" << newName << "'" << endl);
 }
 
+void AutolinkingMind::findWholeWords(
+        const string& text,
+        const string& delimiters,
+        vector<AhoCorasick::Match>& matches)
+{
+    if(automaton.isDirty()) {
+        // rebuild automaton once after (possibly many) updates
+        automaton.compile();
+    }
+    automaton.findWholeWords(text, delimiters, matches);
+}
+
 void AutolinkingMind::clear()
 {
     if(trie) {
         delete trie;
     }
     trie = new Trie{};
+    automaton.clear();
+    generation++;
 
     MF_DEBUG("[Autolinking] indices CLEARed" << endl);
 }
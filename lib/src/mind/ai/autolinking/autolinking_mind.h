@@ -27,6 +27,7 @@
 #include "../../../debug.h"
 #include "../../ontology/thing_class_rel_triple.h"
 #include "../../../gear/trie.h"
+#include "../../../gear/aho_corasick.h"
 
 namespace m8r {
 
@@ -41,6 +42,10 @@ private:
     Mind& mind;
 
     Trie* trie;
+    // Aho-Corasick automaton w/ the same words as trie - compiled lazily on search after update
+    AhoCorasick automaton;
+    // incremented on every change of indices (autolinked HTML must be re-rendered)
+    unsigned long generation;
 
     static const std::vector<std::string> excludedWords;
 public:
@@ -70,11 +75,21 @@ public:
         return trie->findLongestPrefixWord(s, r);
     }
 
+    /**
+     * @brief Find all (non overlapping) autolinking matches in the text in single pass.
+     */
+    void findWholeWords(
+            const std::string& text,
+            const std::string& delimiters,
+            std::vector<AhoCorasick::Match>& matches);
+
     /**
      * @brief Clear indices.
      */
    void clear();
 
+    unsigned long getGeneration() const { return generation; }
+
 protected:
     /**
      * @brief Comparator used to sort Os/Ns by name (w/ stripped abbreviation prefix).
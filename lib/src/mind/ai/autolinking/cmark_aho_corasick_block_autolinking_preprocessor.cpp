@@ -123,146 +123,51 @@ cmark_node* injectAstTxtNode(
     return txtNode;
 }
 
-void injectThingsLinks(cmark_node* srcNode, Mind& mind)
+/**
+ * @brief Inject O/N links to text node - returns false if node has no matches (and it's kept as is).
+ *
+ * All O/N names are found by Aho-Corasick automaton in single linear pass, then the text
+ * is split to text and link nodes in another linear pass.
+ */
+bool injectThingsLinks(cmark_node* srcNode, Mind& mind)
 {
-    // copy w to t as it will be chopped word/match by word/match from head to tail
-    string txt{cmark_node_get_literal(srcNode)};
-    string pre{}, at{}, chop{};
-    size_t preSize{};
-
-    cmark_node* node{};
+    const string txt{cmark_node_get_literal(srcNode)};
 
 #ifdef DO_MF_DEBUG
     MF_DEBUG("[Autolinking] Injecting links to: '" << txt << "'" << endl);
 #endif
 
-    while(txt.size()>0) {
-        // skip trailing chars and append them
-        preSize = 0;
-        while(preSize < txt.size()) {
-            // check $$ to detect begin/end of math (MathJax) section to ignore it
-            if(txt.size()>=2 && '$'==txt.at(0) && '$'==txt.at(1)) {
-                MF_DEBUG("MATH matched" << endl);
-                // TODO toggle math
-                preSize+=2;
-                if(txt.size()==2) {
-                    break;
-                }
-            }
+    vector<AhoCorasick::Match> matches{};
+    mind.autolinkFindWholeWords(txt, CmarkAhoCorasickBlockAutolinkingPreprocessor::TRAILING_CHARS, matches);
+    if(matches.empty()) {
+        return false;
+    }
 
-            if(CmarkAhoCorasickBlockAutolinkingPreprocessor::TRAILING_CHARS.find(txt.at(preSize)) != string::npos) {
-                preSize++;
-            } else {
-                break;
-            }
-        }
-        if(preSize) {
-            // chop trailing chars prefix from input and append it to result
-            at.append(txt.substr(0, preSize));
-            txt = txt.substr(preSize);
-
-            MF_DEBUG("  Skipping trailing chars: '" << txt.substr(0, preSize) << "'" << endl);
-            MF_DEBUG("     txt: '" << txt << "'" << endl);
-            MF_DEBUG("     at : '" << at  << "'" << endl);
+    cmark_node* node{};
+    string at{}, link{};
+    size_t offset{};
+    for(const AhoCorasick::Match& m:matches) {
+        MF_DEBUG("    Matched: '" << txt.substr(m.begin, m.length) << "'" << endl);
+
+        // AST: add text node w/ content preceding link
+        if(m.begin > offset) {
+            at.assign(txt, offset, m.begin-offset);
+            node = injectAstTxtNode(srcNode, node, at);
         }
 
-        // try to match word
-        pre.clear();
-
-        MF_DEBUG("  Trie search txt: '" << txt << "'" << endl);
-        if(mind.autolinkFindLongestPrefixWord(txt, pre)) {
-            MF_DEBUG("    Matched prefix: '" << pre << "'" << endl);
-
-            // avoid word PREFIX matches ~ ensure that WHOLE world is matched:
-            // - match followed by trailing char
-            // - match until EOL
-
-            // determine trailing char
-            char tChar{txt.size()==pre.size()?' ':txt.at(pre.size())};
-            MF_DEBUG("    Match's trailing char: '" << tChar << "'" << endl);
-            if(CmarkAhoCorasickBlockAutolinkingPreprocessor::TRAILING_CHARS.find(tChar) != string::npos
-               || txt.size() == pre.size()
-            ) {
-                // AST: add text node w/ content preceding link
-                // IMPROVE make this method
-                if(at.size()) {
-                    node = injectAstTxtNode(srcNode, node, at);
-                }
+        // AST: add link
+        link.assign(txt, m.begin, m.length);
+        node = injectAstLinkNode(srcNode, node, link);
 
-                // AST: add link
-                node = injectAstLinkNode(srcNode, node, pre);
-
-                // chop linked prefix word from input word w
-                if(txt.size() == pre.size()) {
-                    txt.clear();
-                } else {
-                    txt = txt.substr(pre.size());
-                }
-                // trailing char will be handled later
-                at.clear();
-
-                MF_DEBUG("    txt: '" << txt << "'" << endl);
-                MF_DEBUG("    at : '" << at  << "'" << endl);
-            } else {
-                // invalid trailing char > matched a NOT-whole-world prefix > skip and append one word
-
-                // TODO make it method
-                // current w prefix was NOT linked > chop it and append it
-                size_t begin = txt.find_first_of(" \t");
-                if(begin != string::npos) {
-                    chop = txt.substr(0, begin);
-                    txt = txt.substr(begin+1);
-                    at.append(chop);
-                    // TODO IMPORTANT append what was found - space or tab! simply index there
-                    at.append(" ");
-
-                    MF_DEBUG("  Skiping word: '" << chop << "'" << endl);
-                    MF_DEBUG("     txt: '" << txt << "'" << endl);
-                    MF_DEBUG("     at : '" << at  << "'" << endl);
-                } else {
-                    // no more words (prefix already checked) > DONE
-                    at.append(txt);
-
-                    MF_DEBUG("  DONE no-more words: '" << chop << "'" << endl);
-                    MF_DEBUG("     txt: '" << txt << "'" << endl);
-                    MF_DEBUG("     at : '" << at  << "'" << endl);
-
-                    break;
-                }
-            }
-        } else {
-            // didn't match prefix > skip and append one word
-
-            // TODO make it method
-            // current w prefix was NOT linked > chop it and append it
-            size_t begin = txt.find_first_of(" \t");
-            if(begin != string::npos) {
-                chop = txt.substr(0, begin);
-                txt = txt.substr(begin+1);
-                at.append(chop);
-                // TODO IMPORTANT append what was found - space or tab! simply index there
-                at.append(" ");
-
-                MF_DEBUG("  Skiping word: '" << chop << "'" << endl);
-                MF_DEBUG("     txt: '" << txt << "'" << endl);
-                MF_DEBUG("     at : '" << at  << "'" << endl);
-            } else {
-                // no more words (prefix already checked) > DONE
-                at.append(txt);
-
-                MF_DEBUG("  DONE no-more words: '" << chop << "'" << endl);
-                MF_DEBUG("     txt: '" << txt << "'" << endl);
-                MF_DEBUG("     at : '" << at  << "'" << endl);
-
-                break;
-            }
-        }
+        offset = m.begin + m.length;
     }
-
-    // AST: add text node w/ content preceding link
-    if(at.size()) {
-        node = injectAstTxtNode(srcNode, node, at);
+    // AST: add text node w/ content following the last link
+    if(offset < txt.size()) {
+        at.assign(txt, offset, string::npos);
+        injectAstTxtNode(srcNode, node, at);
     }
+
+    return true;
 }
 
 /*
@@ -326,8 +231,9 @@ void CmarkAhoCorasickBlockAutolinkingPreprocessor::process(
                CMARK_NODE_PARAGRAPH == cmark_node_get_type(cmark_node_parent(node)))
             {
                 MF_DEBUG("[Autolinking] text node: '" << cmark_node_get_literal(node) << "'" << endl);
-                injectThingsLinks(node, mind);
-                zombies.push_back(node);
+                if(injectThingsLinks(node, mind)) {
+                    zombies.push_back(node);
+                }
             }
         }
 
@@ -18,17 +18,158 @@
 */
 #include "bag_of_words.h"
 
+#include <algorithm>
+
+using namespace std;
+
 namespace m8r {
 
-BagOfWords::BagOfWords()
+BagOfWords::BagOfWords(size_t relevantWordsCount)
+    : relevantWordsCount{relevantWordsCount},
+      documents{},
+      wordIds{},
+      wordWeights{},
+      wordFrequencies{},
+      garbage{0}
+{
+}
+
+BagOfWords::~BagOfWords()
 {
 }
 
-void BagOfWords::reorderDocVectorsByWeight()
+void BagOfWords::clear()
 {
-    for(auto& e:bow) {
-        e.second->sort();
+    documents.clear();
+    wordIds.clear();
+    wordWeights.clear();
+    wordFrequencies.clear();
+    garbage = 0;
+}
+
+void BagOfWords::add(const Thing* t, const WordFrequencyList& wfl)
+{
+    remove(t);
+
+    Document d{};
+    d.offset = wordIds.size();
+    d.size = static_cast<uint32_t>(wfl.size());
+    d.relevantSize = static_cast<uint32_t>(std::min(relevantWordsCount, wfl.size()));
+    d.relevantWeight = 0;
+
+    // word frequency list is ordered by ID
+    for(auto& e:wfl.iterable()) {
+        wordIds.push_back(e.first);
+        wordFrequencies.push_back(e.second);
     }
+    // relevant words are chosen once weights are known
+    for(uint32_t i=0; i<d.relevantSize; i++) {
+        wordIds.push_back(wordIds[d.offset+i]);
+        wordFrequencies.push_back(wordFrequencies[d.offset+i]);
+    }
+    wordWeights.resize(wordIds.size(), 0);
+
+    documents[t] = d;
+}
+
+void BagOfWords::remove(const Thing* t)
+{
+    auto i = documents.find(t);
+    if(i != documents.end()) {
+        garbage += i->second.size + i->second.relevantSize;
+        documents.erase(i);
+
+        if(garbage > COMPACTION_THRESHOLD && garbage > wordIds.size()/2) {
+            compact();
+        }
+    }
+}
+
+bool BagOfWords::get(const Thing* t, Vector& v) const
+{
+    auto i = documents.find(t);
+    if(i == documents.end()) {
+        return false;
+    }
+
+    const Document& d = i->second;
+    v.ids = wordIds.data() + d.offset;
+    v.weights = wordWeights.data() + d.offset;
+    v.frequencies = wordFrequencies.data() + d.offset;
+    v.size = d.size;
+    v.relevantIds = v.ids + d.size;
+    v.relevantWeights = v.weights + d.size;
+    v.relevantSize = d.relevantSize;
+    v.relevantWeight = d.relevantWeight;
+    return true;
+}
+
+void BagOfWords::reweight(const Lexicon& lexicon)
+{
+    for(size_t i=0; i<wordIds.size(); i++) {
+        wordWeights[i] = lexicon.getWeight(wordIds[i]);
+    }
+
+    // heaviest words first, ties are broken by word (not ID) to be independent on lexicon history
+    auto isMoreRelevant = [&](size_t i1, size_t i2) {
+        return wordWeights[i1] > wordWeights[i2]
+            || (wordWeights[i1] == wordWeights[i2] && lexicon.get(wordIds[i1]).word < lexicon.get(wordIds[i2]).word);
+    };
+    vector<size_t> relevant{};
+    for(auto& e:documents) {
+        Document& d = e.second;
+        if(!d.relevantSize) {
+            continue;
+        }
+
+        relevant.clear();
+        for(size_t i=d.offset; i<d.offset+d.size; i++) {
+            relevant.push_back(i);
+        }
+        if(d.relevantSize < d.size) {
+            std::nth_element(relevant.begin(), relevant.begin()+d.relevantSize-1, relevant.end(), isMoreRelevant);
+            relevant.resize(d.relevantSize);
+        }
+
+        // keep relevant words sorted by ID (offsets of words sorted by ID are sorted as well)
+        std::sort(relevant.begin(), relevant.end());
+
+        d.relevantWeight = 0;
+        size_t r = d.offset + d.size;
+        for(size_t i:relevant) {
+            wordIds[r] = wordIds[i];
+            wordWeights[r] = wordWeights[i];
+            wordFrequencies[r] = wordFrequencies[i];
+            d.relevantWeight += wordWeights[i];
+            r++;
+        }
+    }
+}
+
+void BagOfWords::compact()
+{
+    vector<uint32_t> ids{};
+    vector<float> weights{};
+    vector<int> frequencies{};
+    size_t live = wordIds.size() - garbage;
+    ids.reserve(live);
+    weights.reserve(live);
+    frequencies.reserve(live);
+
+    for(auto& e:documents) {
+        Document& d = e.second;
+        size_t begin = d.offset;
+        size_t end = d.offset + d.size + d.relevantSize;
+        d.offset = ids.size();
+        ids.insert(ids.end(), wordIds.begin()+begin, wordIds.begin()+end);
+        weights.insert(weights.end(), wordWeights.begin()+begin, wordWeights.begin()+end);
+        frequencies.insert(frequencies.end(), wordFrequencies.begin()+begin, wordFrequencies.begin()+end);
+    }
+
+    wordIds.swap(ids);
+    wordWeights.swap(weights);
+    wordFrequencies.swap(frequencies);
+    garbage = 0;
 }
 
 } // m8r namespace
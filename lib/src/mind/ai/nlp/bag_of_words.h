@@ -19,7 +19,9 @@
 #ifndef M8R_BAG_OF_WORDS_H
 #define M8R_BAG_OF_WORDS_H
 
-#include <map>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 #ifdef DO_MF_DEBUG
 #include <iostream>
@@ -43,53 +45,132 @@ namespace m8r {
  * | N3       |     0 | ... |     1 |
  * ----------------------------------
  *
+ * The matrix is sparse, therefore it's stored in CSR (compressed sparse row) format:
+ * document vectors are slices of three contiguous arrays of word IDs, word weights
+ * and word frequencies. Vector of a document is its words sorted by ID followed
+ * by its most relevant (highest weight) words - also sorted by ID. Vectors can be
+ * compared by a merge of sorted arrays w/o any lookup.
+ *
+ * Removed documents leave garbage in arrays which is compacted once there is
+ * more garbage than live vectors.
  */
 class BagOfWords
 {
+public:
+    /**
+     * @brief Read only view of document vector - valid until BoW is modified.
+     */
+    struct Vector {
+        // all words sorted by ID
+        const uint32_t* ids;
+        const float* weights;
+        const int* frequencies;
+        size_t size;
+        // most relevant words sorted by ID
+        const uint32_t* relevantIds;
+        const float* relevantWeights;
+        size_t relevantSize;
+        // weight of most relevant words
+        float relevantWeight;
+    };
+
+    /**
+     * @brief Sum weights of words from the 1st vector which are also in the 2nd vector.
+     */
+    static float weightOfIntersection(
+            const uint32_t* ids1, const float* weights1, size_t size1,
+            const uint32_t* ids2, size_t size2)
+    {
+        const uint32_t* i1 = ids1;
+        const uint32_t* e1 = ids1 + size1;
+        const uint32_t* i2 = ids2;
+        const uint32_t* e2 = ids2 + size2;
+        float weight = 0;
+        // merge w/o branches in the loop body
+        while(i1 < e1 && i2 < e2) {
+            const uint32_t w1 = *i1;
+            const uint32_t w2 = *i2;
+            weight += static_cast<float>(w1 == w2) * weights1[i1-ids1];
+            i1 += w1 <= w2;
+            i2 += w2 <= w1;
+        }
+        return weight;
+    }
+
 private:
+    struct Document {
+        size_t offset;
+        uint32_t size;
+        uint32_t relevantSize;
+        float relevantWeight;
+    };
+
+    static constexpr size_t COMPACTION_THRESHOLD = 1<<16;
+
+    // number of most relevant words kept for every document
+    size_t relevantWordsCount;
+
     /**
-     * @brief Document (O/N) to words (w/ frequencies).
+     * @brief Document (O/N) to its vector - pointers are NOT dereferenced.
      */
-    std::map<Thing*,WordFrequencyList*> bow;
+    std::unordered_map<const Thing*,Document> documents;
+
+    std::vector<uint32_t> wordIds;
+    std::vector<float> wordWeights;
+    std::vector<int> wordFrequencies;
+
+    // array slots of removed documents
+    size_t garbage;
 
 public:
-    explicit BagOfWords();
+    explicit BagOfWords(size_t relevantWordsCount=10);
     BagOfWords(const BagOfWords&) = delete;
     BagOfWords(const BagOfWords&&) = delete;
     BagOfWords &operator=(const BagOfWords&) = delete;
     BagOfWords &operator=(const BagOfWords&&) = delete;
-    ~BagOfWords() {
-        clear();
-    }
+    ~BagOfWords();
 
-    size_t size() const { return bow.size(); }
-    void clear() {
-        for(auto p:bow) {
-            delete p.second;
-        }
-        bow.clear();
-    }
+    size_t size() const { return documents.size(); }
+    size_t getWordsCount() const { return wordIds.size() - garbage; }
+    void clear();
 
-    void add(Thing* t, WordFrequencyList* wfl) {
-        bow[t] = wfl;
-    }
+    /**
+     * @brief Add (or replace) document vector - word weights are set by reweight().
+     */
+    void add(const Thing* t, const WordFrequencyList& wfl);
 
-    WordFrequencyList* get(Thing* t) {
-        return bow[t];
-    }
+    /**
+     * @brief Remove document - thing is NOT dereferenced (it might be already deleted).
+     */
+    void remove(const Thing* t);
 
-    void reorderDocVectorsByWeight();
+    /**
+     * @brief Get document vector - returns false if there is no such document.
+     *
+     * Const method w/o any modification to allow concurrent reads from parallel AA calculation.
+     */
+    bool get(const Thing* t, Vector& v) const;
+
+    /**
+     * @brief Refresh word weights from lexicon and choose the most relevant words of every document.
+     */
+    void reweight(const Lexicon& lexicon);
 
 #ifdef DO_MF_DEBUG
-    void print() const {
-        MF_DEBUG("BoW[" << bow.size() << "]:" << std::endl);
-        for(auto& e:bow) {
-            MF_DEBUG("  '" << e.first->getName() << "' > ");
-            e.second->printFlat();
+    void print(const Lexicon& lexicon) const {
+        MF_DEBUG("BoW[" << documents.size() << "]:" << std::endl);
+        for(auto& e:documents) {
+            MF_DEBUG("  '" << e.first->getName() << "' >");
+            for(size_t i=0; i<e.second.size; i++) {
+                MF_DEBUG(" " << lexicon.get(wordIds[e.second.offset+i]).word << " [" << wordFrequencies[e.second.offset+i] << "]");
+            }
             MF_DEBUG(std::endl);
         }
     }
 #endif
+
+private:
+    void compact();
 };
 
 }
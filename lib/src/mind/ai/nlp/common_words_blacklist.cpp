@@ -106,6 +106,8 @@ CommonWordsBlacklist::CommonWordsBlacklist()
     wordBlacklist.addWord("did");
     wordBlacklist.addWord("those");
     wordBlacklist.addWord("want");
+
+    wordBlacklist.freeze();
 }
 
 CommonWordsBlacklist::~CommonWordsBlacklist()
@@ -36,7 +36,7 @@ public:
     CommonWordsBlacklist &operator=(const CommonWordsBlacklist&&) = delete;
     ~CommonWordsBlacklist();
 
-    bool findWord(std::string s) const {
+    bool findWord(const std::string& s) const {
         return wordBlacklist.findWord(s);
     }
     void addWord(std::string word) {
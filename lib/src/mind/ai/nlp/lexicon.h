@@ -19,9 +19,10 @@
 #ifndef M8R_LEXICON_H
 #define M8R_LEXICON_H
 
-#include <map>
-#include <vector>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #ifdef DO_MF_DEBUG
 #include <iostream>
@@ -36,16 +37,18 @@ namespace m8r {
  * @brief Lexicon of all words w/ global frequencies.
  *
  * Lexicon is the *only* data structure in MF's AI that keeps words by *value*.
- * Other data structures use either pointers or references to be memory efficient.
+ * Words are interned - every word gets dense ID which is index to contiguous
+ * vocabulary table. Other data structures use word IDs to be memory efficient
+ * and to compare words as integers.
  *
  */
 // IMPROVE Stanford GloVe lexicon w/ word attributes & semantic domains (configure > check existence > use OR skip)
 class Lexicon
 {
 public:
+    static constexpr uint32_t UNKNOWN_WORD = UINT32_MAX;
 
     struct WordEmbedding {
-        // IMPROVE consider use of ptr to map's key
         std::string word;
         int frequency;
         float weight;
@@ -63,14 +66,11 @@ public:
 
 
 private:
-    // map of word-to-frequency pairs for fast lookup and duplicity detection
-    // IMPROVE C++ SL uses map's comparator for string to do comparisons - thefore insert
-    //         complexity is O(log(n)) string comparisons. Consider TRIE data structure
-    //         instead.
-    std::map<std::string,WordEmbedding> m;
+    // word to ID for fast lookup and duplicity detection
+    std::unordered_map<std::string,uint32_t> ids;
 
-    // sorted/ordered words by weight/frequency/... referencing/pointing to map
-    //std::vector<WordEmbedding*> words;
+    // vocabulary table - word ID is index
+    std::vector<WordEmbedding> words;
 
     // keeping max word frequency for efficient weighs calculation
     int maxFrequency;
@@ -83,38 +83,64 @@ public:
     Lexicon &operator=(const Lexicon&&) = delete;
     ~Lexicon();
 
-    size_t size() const { return m.size(); }
-    void clear() { m.clear(); }
-    const std::map<std::string,WordEmbedding>& get() const { return m; }
+    size_t size() const { return words.size(); }
+    void clear() {
+        ids.clear();
+        words.clear();
+        maxFrequency = 1;
+    }
+    const std::vector<WordEmbedding>& get() const { return words; }
+
+    uint32_t getId(const std::string& word) const {
+        auto i = ids.find(word);
+        return i != ids.end() ? i->second : UNKNOWN_WORD;
+    }
 
+    /**
+     * @brief Get word - returned pointer is valid only until the next word is added.
+     */
     WordEmbedding* get(const std::string& word) {
-        std::map<std::string,WordEmbedding>::iterator i = m.find(word);
-        if(i != m.end()) {
-            return &i->second;
-        } else {
-            return nullptr;
-        }
+        uint32_t id = getId(word);
+        return id != UNKNOWN_WORD ? &words[id] : nullptr;
     }
     WordEmbedding* get(const std::string* word) {
         return get(*word);
     }
+    const WordEmbedding& get(uint32_t id) const { return words[id]; }
+    float getWeight(uint32_t id) const { return words[id].weight; }
 
-    WordEmbedding* add(const std::string& word) {
-        WordEmbedding* result;
-        if((result=get(word)) != nullptr) {
-            ++result->frequency;
-            if(result->frequency>maxFrequency) maxFrequency=result->frequency;
-            return result;
+    /**
+     * @brief Add word occurrence and return word ID.
+     */
+    uint32_t add(const std::string& word) {
+        auto i = ids.insert(std::make_pair(word, static_cast<uint32_t>(words.size())));
+        if(i.second) {
+            words.push_back(WordEmbedding{word,1,0});
         } else {
-            WordEmbedding we{word,1,0};
-            m[word] = we;
-            return &(m[word]);
+            ++words[i.first->second].frequency;
         }
+        if(words[i.first->second].frequency>maxFrequency) maxFrequency=words[i.first->second].frequency;
+        return i.first->second;
     }
-    WordEmbedding* add(const std::string* word) {
+    uint32_t add(const std::string* word) {
         return add(*word);
     }
 
+    /**
+     * @brief Decrease word frequency e.g. when document is forgotten (word is kept).
+     */
+    void remove(uint32_t id, int frequency) {
+        WordEmbedding& we = words[id];
+        bool wasMax = we.frequency == maxFrequency;
+        we.frequency = frequency < we.frequency ? we.frequency-frequency : 0;
+        if(wasMax) {
+            maxFrequency = 1;
+            for(const WordEmbedding& e:words) {
+                if(e.frequency > maxFrequency) maxFrequency = e.frequency;
+            }
+        }
+    }
+
     /**
      * @brief Recalculate word weights.
      *
@@ -130,20 +156,20 @@ public:
      *
      */
     void recalculateWeights() {
-        for(auto& e:m) {
-            e.second.weight =  1.f - ((((float)e.second.frequency)/100.f) / (((float)maxFrequency)/100.f));
+        for(WordEmbedding& e:words) {
+            e.weight =  1.f - ((((float)e.frequency)/100.f) / (((float)maxFrequency)/100.f));
 
             // IMPROVE fixed constant is eight too big or small
             // ensure max(w)'s weigh to be > 0
-            if(!e.second.weight) e.second.weight = 0.01f;
+            if(!e.weight) e.weight = 0.01f;
         }
     }
 
 #ifdef DO_MF_DEBUG
     void print() const {
-        MF_DEBUG("Lexicon[" << m.size() << "]:" << std::endl);
-        for(auto& e:m) {
-            MF_DEBUG("  " << e.second.word << "  " << e.second.frequency << "  " << e.second.weight << std::endl);
+        MF_DEBUG("Lexicon[" << words.size() << "]:" << std::endl);
+        for(size_t i=0; i<words.size(); i++) {
+            MF_DEBUG("  " << i << "  " << words[i].word << "  " << words[i].frequency << "  " << words[i].weight << std::endl);
         }
     }
 #endif
@@ -142,8 +142,6 @@ void MarkdownTokenizer::tokenize(CharProvider& md, WordFrequencyList& wfl, bool
             break;
         }
     }
-
-    lexicon.recalculateWeights();
 }
 
 void MarkdownTokenizer::handleWord(WordFrequencyList& wfl, string &w, bool stem, bool useBlacklist)
@@ -151,14 +149,13 @@ void MarkdownTokenizer::handleWord(WordFrequencyList& wfl, string &w, bool stem,
     if(w.size()>1) {
         // stem
         if(stem) {
-            w = stemmer.stem(w);
+            stemmer.stemInPlace(w);
         }
 
         // remove common words
         if(!useBlacklist || !blacklist.findWord(w)) {
             // increment token frequency
-            Lexicon::WordEmbedding* we = lexicon.add(w);
-            ++wfl[&(we->word)];
+            ++wfl[lexicon.add(w)];
         }
     }
     w.clear();
@@ -63,6 +63,8 @@ public:
     MarkdownTokenizer &operator=(const MarkdownTokenizer&&) = delete;
     ~MarkdownTokenizer();
 
+    Stemmer& getStemmer() { return stemmer; }
+
     /**
      * @brief Tokenize a stream of characters.
      */
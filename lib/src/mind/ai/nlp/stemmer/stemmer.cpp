@@ -22,7 +22,59 @@ namespace m8r {
 
 using namespace std;
 
+/*
+ * Cache
+ */
+
+bool Stemmer::Cache::find(const string& word, string& stem)
+{
+    Shard& shard = getShard(word);
+    lock_guard<mutex> lock{shard.mutex};
+    auto s = shard.stems.find(word);
+    if(s != shard.stems.end()) {
+        stem = s->second;
+        return true;
+    }
+    return false;
+}
+
+void Stemmer::Cache::put(const string& word, const string& stem)
+{
+    Shard& shard = getShard(word);
+    lock_guard<mutex> lock{shard.mutex};
+    if(shard.stems.size() >= SHARD_CAPACITY) {
+        shard.stems.clear();
+    }
+    shard.stems.emplace(word, stem);
+}
+
+void Stemmer::Cache::clear()
+{
+    for(Shard& shard:shards) {
+        lock_guard<mutex> lock{shard.mutex};
+        shard.stems.clear();
+    }
+}
+
+size_t Stemmer::Cache::size()
+{
+    size_t s = 0;
+    for(Shard& shard:shards) {
+        lock_guard<mutex> lock{shard.mutex};
+        s += shard.stems.size();
+    }
+    return s;
+}
+
+/*
+ * Stemmer
+ */
+
+Stemmer::Cache Stemmer::cache{};
+
 Stemmer::Stemmer()
+    : cached{true},
+      wide{}
 {
     language = ENGLISH;
 }
@@ -31,17 +83,63 @@ Stemmer::~Stemmer()
 {
 }
 
-string Stemmer::stem(string word)
+string Stemmer::stem(const string& word)
+{
+    string s{word};
+    stemInPlace(s);
+    return s;
+}
+
+void Stemmer::stemInPlace(string& word)
+{
+    if(cached) {
+        string stem{};
+        if(cache.find(word, stem)) {
+            word.swap(stem);
+        } else {
+            string w{word};
+            stemUncached(word);
+            cache.put(w, word);
+        }
+    } else {
+        stemUncached(word);
+    }
+}
+
+void Stemmer::stemUncached(string& word)
 {
     // IMPROVE: despite stemmer works in wstring mode, MindForger runs just in string mode - wstring to come later when entire application is switched
-    std::wstringstream swide;
-    swide << word.c_str();
-    wstring wide = swide.str();
+    bool ascii = true;
+    for(const char c:word) {
+        if(static_cast<unsigned char>(c) > 0x7F) {
+            ascii = false;
+            break;
+        }
+    }
+
+    if(ascii) {
+        wide.resize(word.size());
+        for(size_t i=0; i<word.size(); i++) {
+            wide[i] = static_cast<wchar_t>(word[i]);
+        }
 
-    // IMPROVE switch by language (configuration)
-    StemEnglish(wide);
+        // IMPROVE switch by language (configuration)
+        StemEnglish(wide);
 
-    return converter.to_bytes(wide);
+        // English stemmer only strips/replaces ASCII suffixes > stem stays ASCII
+        word.resize(wide.size());
+        for(size_t i=0; i<wide.size(); i++) {
+            word[i] = static_cast<char>(wide[i]);
+        }
+    } else {
+        try {
+            wstring w = converter.from_bytes(word);
+            StemEnglish(w);
+            word = converter.to_bytes(w);
+        } catch(const std::range_error&) {
+            // invalid UTF-8 > word is kept as is
+        }
+    }
 }
 
 } // m8r namespace
@@ -24,6 +24,8 @@
 #include <sstream>
 #include <locale>
 #include <codecvt>
+#include <mutex>
+#include <unordered_map>
 
 #include "stemming/english_stem.h"
 #include "stemming/french_stem.h"
@@ -40,6 +42,17 @@
 
 namespace m8r {
 
+/**
+ * @brief Word stemmer.
+ *
+ * Stems are memoized in a cache shared by all stemmers - a repository has
+ * far less distinct words than tokens, therefore most of the words are
+ * stemmed just once. Cache is split to shards w/ own lock to be usable
+ * from (AI) worker threads.
+ *
+ * ASCII words (vast majority of tokens) are widened/narrowed char by char
+ * to/from a reused buffer - UTF-8 conversion is used only for other words.
+ */
 class Stemmer
 {
 public:
@@ -47,8 +60,49 @@ public:
         ENGLISH
     };
 
+    /**
+     * @brief Sharded word to stem cache.
+     */
+    class Cache
+    {
+        static constexpr unsigned SHARDS = 16;
+        // shard is dropped when full to bound memory (vocabulary of a large repository fits)
+        static constexpr size_t SHARD_CAPACITY = 1<<16;
+
+        struct Shard {
+            std::mutex mutex;
+            std::unordered_map<std::string,std::string> stems;
+        };
+
+        Shard shards[SHARDS];
+
+    public:
+        explicit Cache() {}
+        Cache(const Cache&) = delete;
+        Cache(const Cache&&) = delete;
+        Cache &operator=(const Cache&) = delete;
+        Cache &operator=(const Cache&&) = delete;
+        ~Cache() {}
+
+        bool find(const std::string& word, std::string& stem);
+        void put(const std::string& word, const std::string& stem);
+        void clear();
+        size_t size();
+
+    private:
+        Shard& getShard(const std::string& word) {
+            return shards[std::hash<std::string>{}(word) % SHARDS];
+        }
+    };
+
 private:
+    static Cache cache;
+
     Language language;
+    bool cached;
+
+    // reused buffer of ASCII fast path
+    std::wstring wide;
 
     stemming::english_stem<> StemEnglish;
     stemming::german_stem<> StemGerman;
@@ -72,8 +126,23 @@ public:
     ~Stemmer();
 
     void setLanguage(Language lang) { this->language = lang; }
+    /**
+     * @brief Enable/disable stems cache (enabled by default).
+     */
+    void setCached(bool cached) { this->cached = cached; }
+    bool isCached() const { return cached; }
 
-    std::string stem(std::string word);
+    std::string stem(const std::string& word);
+    /**
+     * @brief Replace the word w/ its stem.
+     */
+    void stemInPlace(std::string& word);
+
+    static void clearCache() { cache.clear(); }
+    static size_t getCacheSize() { return cache.size(); }
+
+private:
+    void stemUncached(std::string& word);
 };
 
 }
@@ -48,9 +48,8 @@ void WordFrequencyList::sort() {
 float WordFrequencyList::recalculateWeight() {
     weight = 0;
     for(auto& w:word2Frequency) {
-        Lexicon::WordEmbedding* e = lexicon->get(w.first);
-        // IMPROVE if(e) result += e->weight * ((float)w.second); ... means min of weights in UNION and INTERSECTION
-        if(e) weight += e->weight;
+        // IMPROVE result += weight * ((float)w.second); ... means min of weights in UNION and INTERSECTION
+        weight += lexicon->getWeight(w.first);
     }
     return weight;
 }
@@ -19,6 +19,7 @@
 #ifndef M8R_WORD_FREQUENCY_LIST_H
 #define M8R_WORD_FREQUENCY_LIST_H
 
+#include <cstdint>
 #include <map>
 #include <vector>
 #include <string>
@@ -33,10 +34,9 @@
 namespace m8r {
 
 /**
- * @brief Word frequency list for a doc.
+ * @brief Word IDs (see Lexicon) w/ frequencies in a Thing.
  *
- * See:
- *   https://en.wikipedia.org/wiki/Word_lists_by_frequency
+ * List is used to collect words while Thing is tokenized - words are ordered by ID.
  */
 class WordFrequencyList
 {
@@ -47,10 +47,10 @@ class WordFrequencyList
 
         // functor to compare words by weight
         bool operator()(
-                const std::pair<const std::string* const,int>*const& p1,
-                const std::pair<const std::string* const,int>*const& p2
+                const std::pair<const uint32_t,int>*const& p1,
+                const std::pair<const uint32_t,int>*const& p2
         ) {
-            return l->get(p1->first)->weight > l->get(p2->first)->weight;
+            return l->getWeight(p1->first) > l->getWeight(p2->first);
         }
     };
 
@@ -88,12 +88,12 @@ private:
     /**
      * @brief List of words occuring in a Thing ordered by weight.
      */
-    std::vector<std::pair<const std::string *const,int>*> wordsByWeight;
+    std::vector<std::pair<const uint32_t,int>*> wordsByWeight;
 
     /**
-     * @brief TRANSIENT map used for quick inserts (can be cleared once list is built).
+     * @brief Word ID to frequency.
      */
-    std::map<const std::string*,int> word2Frequency;
+    std::map<uint32_t,int> word2Frequency;
 
 public:
     explicit WordFrequencyList(Lexicon* lexicon);
@@ -103,9 +103,9 @@ public:
     WordFrequencyList &operator=(const WordFrequencyList&&) = delete;
     ~WordFrequencyList();
 
-    int& operator[](std::string* key) { return word2Frequency[key]; }
+    int& operator[](uint32_t key) { return word2Frequency[key]; }
     size_t size() const { return word2Frequency.size(); }
-    const std::map<const std::string*,int>& iterable() const { return word2Frequency; }
+    const std::map<uint32_t,int>& iterable() const { return word2Frequency; }
 
     float getWeight() {
         if(weight==UNDEF_WEIGHT) {
@@ -115,29 +115,16 @@ public:
         }
     }
 
-    int contains(const std::string* word) {
-        std::map<const std::string*,int>::iterator i = word2Frequency.find(word);
-        if(i != word2Frequency.end()) {
-            return true;
-        } else {
-            return false;
-        }
+    bool contains(uint32_t word) const {
+        return word2Frequency.find(word) != word2Frequency.end();
     }
 
-    int add(const std::string* word) {
+    int add(uint32_t word) {
         weight = UNDEF_WEIGHT;
-
-        std::map<const std::string*,int>::iterator i = word2Frequency.find(word);
-        if(i != word2Frequency.end()) {
-            ++i->second;
-            return word2Frequency[word];
-        } else {
-            word2Frequency[word] = 1;
-            return 1;
-        }
+        return ++word2Frequency[word];
     }
 
-    void set(const std::string* word, int frequency) {
+    void set(uint32_t word, int frequency) {
         word2Frequency[word] = frequency;
     }
 
@@ -155,12 +142,12 @@ public:
     void print() const {
         std::cout << "WordFrequencyList[" << word2Frequency.size() << "]:" << std::endl;
         for(auto& w:wordsByWeight) {
-            std::cout << "  " << (*w->first) << " [" << w->second << "] " << std::endl;
+            std::cout << "  " << lexicon->get(w->first).word << " [" << w->second << "] " << std::endl;
         }
     }
     void printFlat() const {
         for(auto& w:wordsByWeight) {
-            std::cout << (*w->first) << " [" << w->second << "] ";
+            std::cout << lexicon->get(w->first).word << " [" << w->second << "] ";
         }
     }
 #endif
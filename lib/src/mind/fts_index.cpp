@@ -0,0 +1,300 @@
+/*
+ fts_index.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "fts_index.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace m8r {
+
+FtsIndex::FtsIndex()
+    : documents{},
+      outlineDocuments{},
+      postings{},
+      tombstones{0},
+      termsSeen{}
+{
+}
+
+FtsIndex::~FtsIndex()
+{
+}
+
+void FtsIndex::clear()
+{
+    documents.clear();
+    outlineDocuments.clear();
+    postings.clear();
+    tombstones = 0;
+}
+
+void FtsIndex::addTerms(const string& s, vector<uint32_t>& terms)
+{
+    if(s.size() >= TERM_LENGTH) {
+        string l{};
+        l.reserve(s.size());
+        stringToLower(s, l);
+        for(size_t i=0; i+TERM_LENGTH<=l.size(); i++) {
+            terms.push_back(toTerm(l.data()+i));
+        }
+    }
+}
+
+void FtsIndex::addDocument(const Outline* outline, const Note* note, vector<uint32_t>& terms)
+{
+    uint32_t id = static_cast<uint32_t>(documents.size());
+    documents.push_back(Document{outline, note});
+    outlineDocuments[outline].push_back(id);
+
+    // deduplication using bitmap is much faster than sort & unique of all document trigrams
+    static_assert(TERM_LENGTH==3, "terms bitmap requires 24b terms");
+    if(termsSeen.empty()) {
+        termsSeen.assign((1u<<24)/64, 0);
+    }
+    size_t unique = 0;
+    for(uint32_t t:terms) {
+        uint64_t bit = 1ULL<<(t&63);
+        if(!(termsSeen[t>>6] & bit)) {
+            termsSeen[t>>6] |= bit;
+            terms[unique++] = t;
+        }
+    }
+    terms.resize(unique);
+    // IDs are growing, therefore posting lists stay sorted
+    for(uint32_t t:terms) {
+        termsSeen[t>>6] &= ~(1ULL<<(t&63));
+        postings[t].push_back(id);
+    }
+    terms.clear();
+}
+
+void FtsIndex::index(const Outline* outline)
+{
+    if(!outline) {
+        return;
+    }
+
+    forget(outline);
+
+    vector<uint32_t> terms{};
+    addTerms(outline->getName(), terms);
+    for(string* d:outline->getDescription()) {
+        if(d) {
+            addTerms(*d, terms);
+        }
+    }
+    addDocument(outline, nullptr, terms);
+
+    for(Note* n:outline->getNotes()) {
+        addTerms(n->getName(), terms);
+        for(string* d:n->getDescription()) {
+            if(d) {
+                addTerms(*d, terms);
+            }
+        }
+        addDocument(outline, n, terms);
+    }
+}
+
+void FtsIndex::forget(const Outline* outline)
+{
+    auto entry = outlineDocuments.find(outline);
+    if(entry != outlineDocuments.end()) {
+        for(uint32_t id:entry->second) {
+            documents[id].outline = nullptr;
+            documents[id].note = nullptr;
+        }
+        tombstones += entry->second.size();
+        outlineDocuments.erase(entry);
+
+        if(tombstones > documents.size()/2) {
+            compact();
+        }
+    }
+}
+
+void FtsIndex::compact()
+{
+    // monotonic ID remapping keeps posting lists sorted
+    vector<uint32_t> remap(documents.size(), UINT32_MAX);
+    vector<Document> liveDocuments{};
+    liveDocuments.reserve(documents.size()-tombstones);
+    for(size_t id=0; id<documents.size(); id++) {
+        if(documents[id].outline) {
+            remap[id] = static_cast<uint32_t>(liveDocuments.size());
+            liveDocuments.push_back(documents[id]);
+        }
+    }
+
+    for(auto it=postings.begin(); it!=postings.end(); ) {
+        vector<uint32_t>& ids = it->second;
+        size_t w=0;
+        for(uint32_t id:ids) {
+            if(remap[id] != UINT32_MAX) {
+                ids[w++] = remap[id];
+            }
+        }
+        if(w) {
+            ids.resize(w);
+            ids.shrink_to_fit();
+            ++it;
+        } else {
+            it = postings.erase(it);
+        }
+    }
+    for(auto& entry:outlineDocuments) {
+        for(uint32_t& id:entry.second) {
+            id = remap[id];
+        }
+    }
+
+    documents.swap(liveDocuments);
+    tombstones = 0;
+}
+
+void FtsIndex::intersect(vector<uint32_t>& result, const vector<uint32_t>& postingList)
+{
+    size_t w=0;
+    auto p = postingList.begin();
+    for(size_t r=0; r<result.size() && p!=postingList.end(); r++) {
+        while(p!=postingList.end() && *p < result[r]) {
+            ++p;
+        }
+        if(p!=postingList.end() && *p == result[r]) {
+            result[w++] = result[r];
+            ++p;
+        }
+    }
+    result.resize(w);
+}
+
+bool FtsIndex::findCandidates(const vector<string>& literals, Candidates& candidates) const
+{
+    vector<uint32_t> terms{};
+    for(const string& literal:literals) {
+        addTerms(literal, terms);
+    }
+    if(terms.empty()) {
+        return false;
+    }
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    // intersect starting w/ the shortest posting list
+    vector<const vector<uint32_t>*> lists{};
+    for(uint32_t t:terms) {
+        auto entry = postings.find(t);
+        if(entry == postings.end()) {
+            return true;
+        }
+        lists.push_back(&entry->second);
+    }
+    std::sort(
+        lists.begin(),
+        lists.end(),
+        [](const vector<uint32_t>* a, const vector<uint32_t>* b) { return a->size() < b->size(); });
+
+    vector<uint32_t> ids{*lists[0]};
+    for(size_t i=1; i<lists.size() && !ids.empty(); i++) {
+        intersect(ids, *lists[i]);
+    }
+
+    for(uint32_t id:ids) {
+        const Document& d = documents[id];
+        if(d.outline) {
+            candidates[d.outline].insert(d.note);
+        }
+    }
+
+    return true;
+}
+
+bool FtsIndex::regexLiterals(const string& regex, vector<string>& literals)
+{
+    static const string QUANTIFIERS{"*?{"};
+    static const string ANCHORS{".^$+"};
+
+    string run{};
+    int depth=0;
+    for(size_t i=0; i<regex.size(); i++) {
+        char c = regex[i];
+        if(c == '\\') {
+            // escaped punctuation is a literal, escaped letter/digit is a class or assertion
+            if(i+1<regex.size() && !isalnum(static_cast<unsigned char>(regex[i+1]))) {
+                if(!depth) {
+                    run += regex[i+1];
+                }
+            } else {
+                literals.push_back(run);
+                run.clear();
+            }
+            i++;
+        } else if(c == '[') {
+            // skip character class
+            i++;
+            if(i<regex.size() && regex[i]=='^') i++;
+            if(i<regex.size() && regex[i]==']') i++;
+            while(i<regex.size() && regex[i]!=']') {
+                if(regex[i]=='\\') i++;
+                i++;
+            }
+            literals.push_back(run);
+            run.clear();
+        } else if(c == '(') {
+            depth++;
+            literals.push_back(run);
+            run.clear();
+        } else if(c == ')') {
+            depth--;
+        } else if(c == '|') {
+            if(!depth) {
+                // top level alternation - no literal is mandatory
+                literals.clear();
+                return false;
+            }
+        } else if(QUANTIFIERS.find(c) != string::npos) {
+            // quantified char is optional
+            if(!run.empty()) {
+                run.pop_back();
+            }
+            literals.push_back(run);
+            run.clear();
+            if(c == '{') {
+                while(i<regex.size() && regex[i]!='}') i++;
+            }
+        } else if(ANCHORS.find(c) != string::npos) {
+            literals.push_back(run);
+            run.clear();
+        } else if(!depth) {
+            run += c;
+        }
+    }
+    literals.push_back(run);
+
+    literals.erase(
+        std::remove_if(
+            literals.begin(),
+            literals.end(),
+            [](const string& l) { return l.size() < TERM_LENGTH; }),
+        literals.end());
+    return !literals.empty();
+}
+
+} // m8r namespace
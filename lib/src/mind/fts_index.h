@@ -0,0 +1,131 @@
+/*
+ fts_index.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_FTS_INDEX_H
+#define M8R_FTS_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../model/outline.h"
+#include "../gear/string_utils.h"
+
+namespace m8r {
+
+/**
+ * @brief Full-text search inverted index.
+ *
+ * FTS semantic is substring search (not word search) - pattern "ash" must
+ * find "hash". Therefore terms of the index are (lower case) character
+ * trigrams and postings are sorted lists of document IDs. Document is either
+ * Outline (name and description) or Note (name and description).
+ *
+ * Index is used as a PREFILTER: it returns candidate Os/Ns which contain all
+ * trigrams of the pattern and FTS verifies candidates using the original
+ * matching method (exact/ignore case/regexp). Because trigrams are lower case,
+ * the same index serves case sensitive and case insensitive searches.
+ *
+ * Index is incremental - (re)indexing or forgetting an O invalidates O's
+ * documents (tombstones) and adds new ones. Tombstones are garbage collected
+ * once they outnumber live documents.
+ */
+class FtsIndex
+{
+public:
+    static constexpr size_t TERM_LENGTH = 3;
+
+    /**
+     * @brief Candidate Ns per O, nullptr N stands for O name/description.
+     */
+    typedef std::unordered_map<const Outline*,std::unordered_set<const Note*>> Candidates;
+
+private:
+    /**
+     * @brief Indexed document - outline==nullptr indicates tombstone.
+     */
+    struct Document {
+        const Outline* outline;
+        const Note* note;
+    };
+
+    std::vector<Document> documents;
+    std::unordered_map<const Outline*,std::vector<uint32_t>> outlineDocuments;
+    std::unordered_map<uint32_t,std::vector<uint32_t>> postings;
+    size_t tombstones;
+    // bitmap of all (24b) terms used to deduplicate document terms - always zeroed between documents
+    std::vector<uint64_t> termsSeen;
+
+public:
+    explicit FtsIndex();
+    FtsIndex(const FtsIndex&) = delete;
+    FtsIndex(const FtsIndex&&) = delete;
+    FtsIndex& operator=(const FtsIndex&) = delete;
+    FtsIndex& operator=(const FtsIndex&&) = delete;
+    ~FtsIndex();
+
+    /**
+     * @brief Extract literal substrings which MUST be present in any match of the regexp.
+     *
+     * Returns false if no such literal can be determined e.g. if regexp
+     * uses top level alternation.
+     */
+    static bool regexLiterals(const std::string& regex, std::vector<std::string>& literals);
+
+    void clear();
+
+    /**
+     * @brief Index O and its Ns - O's documents from previous indexation are invalidated.
+     *
+     * Old Ns are NOT dereferenced, therefore it is safe to reindex O after its Ns were deleted.
+     */
+    void index(const Outline* outline);
+
+    /**
+     * @brief Remove O and its Ns from the index.
+     */
+    void forget(const Outline* outline);
+
+    /**
+     * @brief Find Os/Ns which may contain ALL given literals.
+     *
+     * Returns false if literals are too short to be searched in the index
+     * and caller must fallback to full scan.
+     */
+    bool findCandidates(const std::vector<std::string>& literals, Candidates& candidates) const;
+
+    size_t getDocumentsCount() const { return documents.size() - tombstones; }
+    size_t getTermsCount() const { return postings.size(); }
+
+private:
+    static uint32_t toTerm(const char* s) {
+        return (static_cast<uint32_t>(static_cast<unsigned char>(s[0])) << 16)
+             | (static_cast<uint32_t>(static_cast<unsigned char>(s[1])) << 8)
+             |  static_cast<uint32_t>(static_cast<unsigned char>(s[2]));
+    }
+    static void addTerms(const std::string& s, std::vector<uint32_t>& terms);
+    static void intersect(std::vector<uint32_t>& result, const std::vector<uint32_t>& postingList);
+
+    void addDocument(const Outline* outline, const Note* note, std::vector<uint32_t>& terms);
+    void compact();
+};
+
+}
+#endif // M8R_FTS_INDEX_H
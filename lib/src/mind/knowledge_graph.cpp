@@ -27,7 +27,14 @@ using namespace std;
  */
 
 KnowledgeSubGraph::KnowledgeSubGraph(KnowledgeGraphNode* centralNode, int maxSubgraphNodes)
-    : centralNode(centralNode), maxSubgraphNodes(maxSubgraphNodes)
+    : centralNode(centralNode),
+      parents{},
+      children{},
+      others{},
+      edges{},
+      all{},
+      maxSubgraphNodes(maxSubgraphNodes),
+      maxHops{1}
 {
     this->count = maxSubgraphNodes-1;
 }
@@ -43,7 +50,8 @@ KnowledgeGraph::KnowledgeGraph(
         long unsigned outlinesColor,
         long unsigned notesColor
         )
-    : mind{mind}
+    : mind{mind},
+      thingNodes{}
 {
     mindNode = new KnowledgeGraphNode{KnowledgeGraphNodeType::MIND, "MIND", mindColor, 5};
     tagsNode = new KnowledgeGraphNode{KnowledgeGraphNodeType::TAGS, "tags"};
@@ -65,6 +73,9 @@ KnowledgeGraph::~KnowledgeGraph()
     delete notesNode;
     //delete limboNode;
     //delete stencilsNode;
+    for(auto& k:thingNodes) {
+        delete k.second;
+    }
 }
 
 KnowledgeGraphNode* KnowledgeGraph::getNode(KnowledgeGraphNodeType type)
@@ -94,13 +105,29 @@ KnowledgeGraphNode* KnowledgeGraph::getNode(KnowledgeGraphNodeType type)
     return nullptr;
 }
 
+KnowledgeGraphNode* KnowledgeGraph::getThingNode(KnowledgeGraphNodeType type, const void* thing)
+{
+    KnowledgeGraphNode*& k = thingNodes[thing];
+    // thing address may be reused by a thing of another type
+    if(k && k->getType() != type) {
+        delete k;
+        k = nullptr;
+    }
+    if(!k) {
+        long unsigned color
+            = type==KnowledgeGraphNodeType::OUTLINE ? outlinesColor
+            : type==KnowledgeGraphNodeType::NOTE ? notesColor
+            : static_cast<const Tag*>(thing)->getColor().asLong();
+        k = new KnowledgeGraphNode{type, "", color};
+    }
+    return k;
+}
+
 KnowledgeGraphNode* KnowledgeGraph::getNode(Outline* o)
 {
-    KnowledgeGraphNode* k = new KnowledgeGraphNode{
-            KnowledgeGraphNodeType::OUTLINE,
-            o->getName(),
-            outlinesColor,
-            static_cast<unsigned int>(o->getNotesCount())};
+    KnowledgeGraphNode* k = getThingNode(KnowledgeGraphNodeType::OUTLINE, o);
+    k->setName(o->getName());
+    k->setCardinality(static_cast<unsigned int>(o->getNotesCount()));
     k->setThing(o);
 
     return k;
@@ -108,16 +135,77 @@ KnowledgeGraphNode* KnowledgeGraph::getNode(Outline* o)
 
 KnowledgeGraphNode* KnowledgeGraph::getNode(Note* n)
 {
-    KnowledgeGraphNode* k = new KnowledgeGraphNode{KnowledgeGraphNodeType::NOTE, n->getName(), notesColor};
-    k->setThing(n);
+    KnowledgeGraphNode* k = getThingNode(KnowledgeGraphNodeType::NOTE, n);
+    k->setName(n->getName());
     k->setCardinality(
         static_cast<unsigned int>(n->getOutline()->getDirectNoteChildrenCount(n))
     );
+    k->setThing(n);
 
     return k;
 }
 
-// TODO this method leaks a lot - knowledge graph nodes
+KnowledgeGraphNode* KnowledgeGraph::getNode(const Tag* t)
+{
+    KnowledgeGraphNode* k = getThingNode(KnowledgeGraphNodeType::TAG, t);
+    k->setName(t->getName());
+    k->setCardinality(static_cast<unsigned int>(mind->remind().getTagIndex().getCardinality(t)));
+    k->setThing(const_cast<Tag*>(t));
+
+    return k;
+}
+
+KnowledgeGraphNode* KnowledgeGraph::getNode(KnowledgeGraphIndex::NodeId node)
+{
+    const KnowledgeGraphIndex& index = mind->remind().getGraphIndex();
+    switch(index.getType(node)) {
+    case KnowledgeGraphIndex::NodeType::OUTLINE:
+        return getNode(index.getOutline(node));
+    case KnowledgeGraphIndex::NodeType::NOTE:
+        return getNode(index.getNote(node));
+    case KnowledgeGraphIndex::NodeType::TAG:
+        return getNode(index.getTag(node));
+    }
+
+    return nullptr;
+}
+
+void KnowledgeGraph::getRelatedThings(KnowledgeGraphIndex::NodeId node, KnowledgeSubGraph& subgraph)
+{
+    vector<KnowledgeGraphIndex::Reached> reached{};
+    mind->remind().getGraphIndex().expand(
+        node,
+        subgraph.getMaxHops(),
+        subgraph.getCapacity(),
+        reached,
+        &mind->getScopeAspect());
+
+    unordered_map<KnowledgeGraphIndex::NodeId,KnowledgeGraphNode*> reachedNodes{};
+    reachedNodes[node] = subgraph.getCentralNode();
+    for(const KnowledgeGraphIndex::Reached& r:reached) {
+        KnowledgeGraphNode* k = getNode(r.node);
+        reachedNodes[r.node] = k;
+        // edges point from parents and from linking things
+        bool toReachedFrom
+            = r.relation==KnowledgeGraphIndex::Relation::PARENT
+              || r.relation==KnowledgeGraphIndex::Relation::BACKLINK;
+        if(r.hops == 1) {
+            if(toReachedFrom) {
+                subgraph.addParent(k);
+            } else {
+                subgraph.addChild(k);
+            }
+        } else {
+            KnowledgeGraphNode* from = reachedNodes[r.from];
+            if(toReachedFrom) {
+                subgraph.addOther(k, k, from);
+            } else {
+                subgraph.addOther(k, from, k);
+            }
+        }
+    }
+}
+
 void KnowledgeGraph::getRelatedNodes(KnowledgeGraphNode* centralNode, KnowledgeSubGraph& subgraph)
 {
     subgraph.clear();
@@ -144,14 +232,8 @@ void KnowledgeGraph::getRelatedNodes(KnowledgeGraphNode* centralNode, KnowledgeS
         subgraph.setCentralNode(outlinesNode);
 
         const vector<Outline*>& outlines = mind->getOutlines();
-        if(outlines.size()) {
-            KnowledgeGraphNode* k;
-            for(Outline* o:outlines) {
-                // TODO: reuse and delete - map<Thing*,Node*>
-                k = new KnowledgeGraphNode{KnowledgeGraphNodeType::OUTLINE, o->getName(), outlinesColor, static_cast<unsigned int>(o->getNotesCount())};
-                k->setThing(o);
-                subgraph.addChild(k);
-            }
+        for(Outline* o:outlines) {
+            subgraph.addChild(getNode(o));
         }
 
         subgraph.addParent(mindNode);
@@ -163,18 +245,8 @@ void KnowledgeGraph::getRelatedNodes(KnowledgeGraphNode* centralNode, KnowledgeS
         // IMPROVE limit maximum number of Ns to be rendered - avoid MF trashing when rendering 1M of nodes
         vector<Note*> notes{};
         mind->getAllNotes(notes);
-        if(notes.size()) {
-            KnowledgeGraphNode* k;
-            std::vector<Note*> nc;
-            for(Note* n:notes) {
-                // TODO: reuse and delete - map<Thing*,Node*>
-                k = new KnowledgeGraphNode{KnowledgeGraphNodeType::NOTE, n->getName(), notesColor};
-                k->setThing(n);
-                k->setCardinality(
-                    static_cast<unsigned int>(n->getOutline()->getDirectNoteChildrenCount(n))
-                );
-                subgraph.addChild(k);
-            }
+        for(Note* n:notes) {
+            subgraph.addChild(getNode(n));
         }
 
         subgraph.addParent(mindNode);
@@ -189,8 +261,9 @@ void KnowledgeGraph::getRelatedNodes(KnowledgeGraphNode* centralNode, KnowledgeS
         KnowledgeGraphNode* n;
         vector<const Tag*>& tags = mind->getTags().values();
         for(const Tag* t:tags) {
-            // TODO: reuse and delete - map<Thing*,Node*>
-            n = new KnowledgeGraphNode{KnowledgeGraphNodeType::TAG, t->getName(), t->getColor().asLong(), static_cast<unsigned>(tagsCardinality[t])};
+            n = getNode(t);
+            // cardinality in scope
+            n->setCardinality(static_cast<unsigned>(tagsCardinality[t]));
             subgraph.addChild(n);
         }
 
@@ -211,31 +284,12 @@ void KnowledgeGraph::getRelatedNodes(KnowledgeGraphNode* centralNode, KnowledgeS
         return;
     } */
 
-    // things by type
+    // things by type ~ neighbourhood from the graph index
     if(centralNode->getType() == KnowledgeGraphNodeType::OUTLINE) {
         subgraph.setCentralNode(centralNode);
 
-        Outline* o = static_cast<Outline*>(centralNode->getThing());
-        KnowledgeGraphNode* k;
-        // child Ns only
-        vector<Note*> children{};
-        o->getDirectNoteChildren(children);
-        for(Note* n:children) {
-            // TODO: reuse and delete - map<Thing*,Node*>
-            k = new KnowledgeGraphNode{KnowledgeGraphNodeType::NOTE, n->getName(), notesColor};
-            k->setThing(n);
-            k->setCardinality(
-                static_cast<unsigned int>(n->getOutline()->getDirectNoteChildrenCount(n))
-            );
-            subgraph.addChild(k);
-        }
-
-        const std::vector<const Tag*>* tags = o->getTags();
-        for(const Tag* t:*tags) {
-            // TODO: reuse and delete - map<Thing*,Node*>
-            k = new KnowledgeGraphNode{KnowledgeGraphNodeType::TAG, t->getName(), t->getColor().asLong()};
-            subgraph.addChild(k);
-        }
+        // child Ns, tags and links
+        getRelatedThings(mind->remind().getGraphIndex().getNode(centralNode->getOutline()), subgraph);
 
         subgraph.addParent(outlinesNode);
 
@@ -243,29 +297,8 @@ void KnowledgeGraph::getRelatedNodes(KnowledgeGraphNode* centralNode, KnowledgeS
     } else if(centralNode->getType() == KnowledgeGraphNodeType::NOTE) {
         subgraph.setCentralNode(centralNode);
 
-        Note* n = static_cast<Note*>(centralNode->getThing());
-        KnowledgeGraphNode* k;
-        k = new KnowledgeGraphNode{KnowledgeGraphNodeType::OUTLINE, n->getOutline()->getName(), outlinesColor, static_cast<unsigned int>(n->getOutline()->getNotesCount())};
-        k->setThing(n->getOutline());
-        subgraph.addParent(k);
-
-        // child Ns
-        vector<Note*> children{};
-        n->getOutline()->getDirectNoteChildren(n, children);
-        for(Note* n:children) {
-            // TODO: reuse and delete - map<Thing*,Node*>
-            k = new KnowledgeGraphNode{KnowledgeGraphNodeType::NOTE, n->getName(), notesColor};
-            k->setThing(n);
-            k->setCardinality(n->getOutline()->getDirectNoteChildrenCount(n));
-            subgraph.addChild(k);
-        }
-
-        const std::vector<const Tag*>* tags = n->getTags();
-        for(const Tag* t:*tags) {
-            // TODO: reuse and delete - map<Thing*,Node*>
-            k = new KnowledgeGraphNode{KnowledgeGraphNodeType::TAG, t->getName(), t->getColor().asLong()};
-            subgraph.addChild(k);
-        }
+        // parent O/N, child Ns, tags and links
+        getRelatedThings(mind->remind().getGraphIndex().getNode(centralNode->getNode()), subgraph);
 
         subgraph.addParent(notesNode);
 
@@ -273,34 +306,11 @@ void KnowledgeGraph::getRelatedNodes(KnowledgeGraphNode* centralNode, KnowledgeS
     } else if(centralNode->getType() == KnowledgeGraphNodeType::TAG) {
         subgraph.setCentralNode(centralNode);
 
-        vector<const Tag*> tags{};
-        tags.push_back(mind->getOntology().findOrCreateTag(centralNode->getName()));
-        // Os
-        vector<Outline*> outlines{};
-        mind->findOutlinesByTags(tags, outlines);
-        if(outlines.size()) {
-            KnowledgeGraphNode* k;
-            for(Outline* o:outlines) {
-                // TODO: reuse and delete - map<Thing*,Node*>
-                k = new KnowledgeGraphNode{KnowledgeGraphNodeType::OUTLINE, o->getName(), outlinesColor, static_cast<unsigned int>(o->getNotesCount())};
-                k->setThing(o);
-                subgraph.addChild(k);
-            }
-        }
-
-        // Ns
-        vector<Note*> notes{};
-        mind->findNotesByTags(tags, notes);
-        if(notes.size()) {
-            KnowledgeGraphNode* k;
-            for(Note* n:notes) {
-                // TODO: reuse and delete - map<Thing*,Node*>
-                k = new KnowledgeGraphNode{KnowledgeGraphNodeType::NOTE, n->getName(), notesColor};
-                k->setThing(n);
-                k->setCardinality(n->getOutline()->getDirectNoteChildrenCount(n));
-                subgraph.addChild(k);
-            }
-        }
+        const Tag* tag = centralNode->getThing()
+            ? static_cast<const Tag*>(centralNode->getThing())
+            : mind->getOntology().findOrCreateTag(centralNode->getName());
+        // tagged Os and Ns
+        getRelatedThings(mind->remind().getGraphIndex().getNode(tag), subgraph);
 
         subgraph.addParent(tagsNode);
 
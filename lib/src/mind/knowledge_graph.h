@@ -19,7 +19,12 @@
 #ifndef M8R_KNOWLEDGE_GRAPH_H
 #define M8R_KNOWLEDGE_GRAPH_H
 
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
 #include "mind.h"
+#include "knowledge_graph_index.h"
 #include "../model/tag.h"
 
 namespace m8r {
@@ -58,7 +63,9 @@ public:
         this->name = name;
         this->color = color;
         this->cardinality = cardinality;
+        this->thing = nullptr;
     }
+    void setName(const std::string& name) { this->name = name; }
     void setThing(Thing* thing) { this->thing = thing; }
     const std::string& getName() const { return name; }
     long getColor() const { return color; }
@@ -75,11 +82,16 @@ class KnowledgeSubGraph
     KnowledgeGraphNode* centralNode;
     std::vector<KnowledgeGraphNode*> parents;
     std::vector<KnowledgeGraphNode*> children;
-    // IMPROVE map<> all;
+    // nodes in 2+ hops from the central node and edges they were reached by
+    std::vector<KnowledgeGraphNode*> others;
+    std::vector<std::pair<KnowledgeGraphNode*,KnowledgeGraphNode*>> edges;
+    std::unordered_set<const KnowledgeGraphNode*> all;
 
     // ensure that knowledge graph size (number of nodes) is smaller than limit
     int maxSubgraphNodes;
     int count;
+    // neighbourhood of things (Os, Ns and tags) is expanded up to hops
+    unsigned maxHops;
 
 public:
     explicit KnowledgeSubGraph(KnowledgeGraphNode* centralNode, int limit=INT_MAX);
@@ -89,19 +101,43 @@ public:
     KnowledgeSubGraph &operator=(const KnowledgeSubGraph&&) = delete;
     ~KnowledgeSubGraph() {}
 
-    void setCentralNode(KnowledgeGraphNode* centralNode) { this->centralNode = centralNode; }
+    void setCentralNode(KnowledgeGraphNode* centralNode) {
+        this->centralNode = centralNode;
+        all.insert(centralNode);
+    }
     void setMaxNodes(int maxNodes) { this->maxSubgraphNodes = maxNodes; }
+    void setMaxHops(unsigned maxHops) { this->maxHops = maxHops; }
+    unsigned getMaxHops() const { return maxHops; }
+    /**
+     * @brief Number of nodes which can be still added.
+     */
+    size_t getCapacity() const { return count > 0 ? static_cast<size_t>(count) : 0; }
     KnowledgeGraphNode* getCentralNode() const { return centralNode; }
-    // IMPROVE bool contains(KnowledgeGraphNode node) { return false; }
-    void addParent(KnowledgeGraphNode* p) { if(count-- > 0) parents.push_back(p); }
-    void addChild(KnowledgeGraphNode* c) { if(count-- > 0) children.push_back(c); }
+    bool contains(const KnowledgeGraphNode* node) const { return all.count(node) > 0; }
+    void addParent(KnowledgeGraphNode* p) { if(count > 0 && all.insert(p).second) { count--; parents.push_back(p); } }
+    void addChild(KnowledgeGraphNode* c) { if(count > 0 && all.insert(c).second) { count--; children.push_back(c); } }
+    /**
+     * @brief Add node which is NOT adjacent to the central node w/ edge source > destination.
+     */
+    void addOther(KnowledgeGraphNode* o, KnowledgeGraphNode* source, KnowledgeGraphNode* destination) {
+        if(count > 0 && all.insert(o).second) {
+            count--;
+            others.push_back(o);
+            edges.push_back(std::make_pair(source, destination));
+        }
+    }
     std::vector<KnowledgeGraphNode*>& getParents() { return parents; }
     std::vector<KnowledgeGraphNode*>& getChildren() { return children; }
-    size_t size() { return 1 + parents.size() + children.size(); }
+    std::vector<KnowledgeGraphNode*>& getOthers() { return others; }
+    std::vector<std::pair<KnowledgeGraphNode*,KnowledgeGraphNode*>>& getEdges() { return edges; }
+    size_t size() { return 1 + parents.size() + children.size() + others.size(); }
     void clear() {
         centralNode = nullptr;
         parents.clear();
         children.clear();
+        others.clear();
+        edges.clear();
+        all.clear();
         count = maxSubgraphNodes-1;
     }
 };
@@ -121,6 +157,9 @@ class KnowledgeGraph
     long unsigned outlinesColor;
     long unsigned notesColor;
 
+    // O, N or tag > its node (nodes are reused as navigator keeps them)
+    std::unordered_map<const void*,KnowledgeGraphNode*> thingNodes;
+
 public:
     explicit KnowledgeGraph(
         Mind* mind,
@@ -137,7 +176,16 @@ public:
     KnowledgeGraphNode* getNode(KnowledgeGraphNodeType type);
     KnowledgeGraphNode* getNode(Outline* outline);
     KnowledgeGraphNode* getNode(Note* note);
+    KnowledgeGraphNode* getNode(const Tag* tag);
     void getRelatedNodes(KnowledgeGraphNode* centralNode, KnowledgeSubGraph& subgraph);
+
+private:
+    KnowledgeGraphNode* getNode(KnowledgeGraphIndex::NodeId node);
+    KnowledgeGraphNode* getThingNode(KnowledgeGraphNodeType type, const void* thing);
+    /**
+     * @brief Add (multi-hop) neighbourhood of O, N or tag from the graph index.
+     */
+    void getRelatedThings(KnowledgeGraphIndex::NodeId node, KnowledgeSubGraph& subgraph);
 };
 
 }
@@ -0,0 +1,354 @@
+/*
+ knowledge_graph_index.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "knowledge_graph_index.h"
+
+#include "../gear/file_utils.h"
+
+using namespace std;
+
+namespace m8r {
+
+constexpr KnowledgeGraphIndex::NodeId KnowledgeGraphIndex::NO_NODE;
+
+/**
+ * @brief Resolve (relative) link path to O key - . and .. are resolved lexically.
+ */
+static string linkPathToKey(const string& outlineKey, const string& path)
+{
+    if(path.empty()) {
+        return outlineKey;
+    }
+
+    string joined{};
+    if(path[0] == '/' || path[0] == FILE_PATH_SEPARATOR_CHAR || (path.size() > 1 && path[1] == ':')) {
+        joined = path;
+    } else {
+        string directory{}, file{};
+        pathToDirectoryAndFile(outlineKey, directory, file);
+        joined = directory + FILE_PATH_SEPARATOR + path;
+    }
+
+    vector<string> segments{};
+    size_t begin = 0;
+    for(size_t i=0; i<=joined.size(); i++) {
+        if(i == joined.size() || joined[i] == '/' || joined[i] == FILE_PATH_SEPARATOR_CHAR) {
+            string segment = joined.substr(begin, i-begin);
+            if(segment == "..") {
+                if(segments.size() > 1) {
+                    segments.pop_back();
+                }
+            } else if(segment != "." && (segment.size() || segments.empty())) {
+                // empty first segment stands for root
+                segments.push_back(segment);
+            }
+            begin = i+1;
+        }
+    }
+
+    string key{};
+    for(size_t i=0; i<segments.size(); i++) {
+        if(i) {
+            key += FILE_PATH_SEPARATOR;
+        }
+        key += segments[i];
+    }
+    return key;
+}
+
+KnowledgeGraphIndex::KnowledgeGraphIndex()
+    : nodes{},
+      freeIds{},
+      ids{},
+      tagReferences{},
+      contributions{},
+      outlineKeys{},
+      offsets{},
+      adjacents{},
+      adjacencyIndexed{false},
+      visits{},
+      visit{0}
+{
+}
+
+KnowledgeGraphIndex::~KnowledgeGraphIndex()
+{
+}
+
+void KnowledgeGraphIndex::clear()
+{
+    nodes.clear();
+    freeIds.clear();
+    ids.clear();
+    tagReferences.clear();
+    contributions.clear();
+    outlineKeys.clear();
+    offsets.clear();
+    adjacents.clear();
+    adjacencyIndexed = false;
+}
+
+KnowledgeGraphIndex::NodeId KnowledgeGraphIndex::addNode(NodeType type, const void* thing)
+{
+    NodeId id;
+    if(freeIds.size()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+        nodes[id] = Node{type, thing};
+    } else {
+        id = static_cast<NodeId>(nodes.size());
+        nodes.push_back(Node{type, thing});
+    }
+    ids[thing] = id;
+    return id;
+}
+
+void KnowledgeGraphIndex::removeNode(const void* thing)
+{
+    auto i = ids.find(thing);
+    if(i != ids.end()) {
+        nodes[i->second].thing = nullptr;
+        freeIds.push_back(i->second);
+        ids.erase(i);
+    }
+}
+
+void KnowledgeGraphIndex::addLinks(Contribution& contribution, NodeId from, const vector<Link*>& links)
+{
+    for(Link* l:links) {
+        const string& url = l->getUrl();
+        // only links to Os/Ns i.e. no URLs w/ scheme
+        if(url.empty() || url.find("://") != string::npos || url.find("mailto:") == 0) {
+            continue;
+        }
+        size_t hash = url.find('#');
+        contribution.links.push_back(PendingLink{
+            from,
+            linkPathToKey(contribution.key, url.substr(0, hash)),
+            hash == string::npos ? string{} : url.substr(hash+1)});
+    }
+}
+
+void KnowledgeGraphIndex::index(const Outline* outline)
+{
+    forget(outline);
+
+    Contribution& c = contributions[outline];
+    // IMPROVE make O key getter const
+    c.key = const_cast<Outline*>(outline)->getKey();
+    outlineKeys[c.key] = outline;
+
+    NodeId o = addNode(NodeType::OUTLINE, outline);
+    c.things.push_back(o);
+    addLinks(c, o, outline->getLinks());
+
+    for(const Note* n:outline->getNotes()) {
+        NodeId id = addNode(NodeType::NOTE, n);
+        c.things.push_back(id);
+        // emplace() keeps the first N w/ the name
+        c.anchors.emplace(n->getMangledName(), id);
+
+        // N's parent precedes N
+        Note* parent = outline->getNoteParent(n);
+        c.edges.push_back(Edge{parent ? ids[parent] : o, id, Relation::CHILD});
+
+        addLinks(c, id, n->getLinks());
+    }
+
+    // tags of O and Ns
+    for(size_t i=0; i<c.things.size(); i++) {
+        const vector<const Tag*>* tags = i ? outline->getNotes()[i-1]->getTags() : outline->getTags();
+        for(const Tag* t:*tags) {
+            if(!tagReferences[t]++) {
+                addNode(NodeType::TAG, t);
+            }
+            c.tags.push_back(t);
+            c.edges.push_back(Edge{c.things[i], ids[t], Relation::TAG});
+        }
+    }
+
+    adjacencyIndexed = false;
+}
+
+void KnowledgeGraphIndex::forget(const Outline* outline)
+{
+    auto entry = contributions.find(outline);
+    if(entry != contributions.end()) {
+        Contribution& c = entry->second;
+        for(NodeId id:c.things) {
+            removeNode(nodes[id].thing);
+        }
+        for(const Tag* t:c.tags) {
+            auto r = tagReferences.find(t);
+            if(!--r->second) {
+                removeNode(t);
+                tagReferences.erase(r);
+            }
+        }
+        auto k = outlineKeys.find(c.key);
+        if(k != outlineKeys.end() && k->second == outline) {
+            outlineKeys.erase(k);
+        }
+        contributions.erase(entry);
+
+        adjacencyIndexed = false;
+    }
+}
+
+void KnowledgeGraphIndex::indexAdjacency() const
+{
+    if(adjacencyIndexed) {
+        return;
+    }
+
+    // resolve links
+    vector<Edge> links{};
+    for(const auto& c:contributions) {
+        for(const PendingLink& l:c.second.links) {
+            auto target = outlineKeys.find(l.key);
+            if(target != outlineKeys.end()) {
+                const Contribution& t = contributions.find(target->second)->second;
+                NodeId to = t.things[0];
+                if(l.anchor.size()) {
+                    auto a = t.anchors.find(l.anchor);
+                    if(a != t.anchors.end()) {
+                        to = a->second;
+                    }
+                }
+                if(to != l.from) {
+                    links.push_back(Edge{l.from, to, Relation::LINK});
+                }
+            }
+        }
+    }
+
+    // count degrees
+    offsets.assign(nodes.size()+1, 0);
+    auto count = [this](const Edge& e) {
+        offsets[e.from+1]++;
+        offsets[e.to+1]++;
+    };
+    for(const auto& c:contributions) {
+        for(const Edge& e:c.second.edges) {
+            count(e);
+        }
+    }
+    for(const Edge& e:links) {
+        count(e);
+    }
+    for(size_t i=1; i<offsets.size(); i++) {
+        offsets[i] += offsets[i-1];
+    }
+
+    // fill adjacents of both edge nodes
+    adjacents.resize(offsets.back());
+    vector<uint32_t> cursors{offsets.begin(), offsets.end()-1};
+    auto fill = [this, &cursors](const Edge& e) {
+        Relation reverse
+            = e.relation==Relation::CHILD ? Relation::PARENT
+            : e.relation==Relation::TAG ? Relation::TAGGED
+            : Relation::BACKLINK;
+        adjacents[cursors[e.from]++] = Adjacent{e.to, e.relation};
+        adjacents[cursors[e.to]++] = Adjacent{e.from, reverse};
+    };
+    for(const auto& c:contributions) {
+        for(const Edge& e:c.second.edges) {
+            fill(e);
+        }
+    }
+    for(const Edge& e:links) {
+        fill(e);
+    }
+
+    adjacencyIndexed = true;
+}
+
+size_t KnowledgeGraphIndex::getEdgesCount() const
+{
+    indexAdjacency();
+    return adjacents.size()/2;
+}
+
+size_t KnowledgeGraphIndex::getDegree(NodeId node) const
+{
+    indexAdjacency();
+    return offsets[node+1] - offsets[node];
+}
+
+bool KnowledgeGraphIndex::isInScope(NodeId node, const MindScopeAspect& scope) const
+{
+    switch(nodes[node].type) {
+    case NodeType::OUTLINE:
+        return scope.isInScope(getOutline(node));
+    case NodeType::NOTE:
+        return scope.isInScope(getNote(node)) && scope.isInScope(getNote(node)->getOutline());
+    case NodeType::TAG:
+        return true;
+    }
+    return true;
+}
+
+void KnowledgeGraphIndex::expand(
+    NodeId node,
+    unsigned maxHops,
+    size_t maxNodes,
+    vector<Reached>& reached,
+    const MindScopeAspect* scope) const
+{
+    if(node >= nodes.size() || !nodes[node].thing) {
+        return;
+    }
+    indexAdjacency();
+    if(scope && !scope->isEnabled()) {
+        scope = nullptr;
+    }
+
+    // new visit instead of clearing visited flags
+    if(visits.size() < nodes.size() || !++visit) {
+        visits.assign(nodes.size(), 0);
+        visit = 1;
+    }
+    visits[node] = visit;
+
+    // reached vector is the BFS queue - it may contain Ns from previous calls
+    size_t begin = reached.size();
+    size_t limit = begin + maxNodes;
+    size_t head = begin;
+    NodeId from = node;
+    unsigned hops = 0;
+    while(hops < maxHops && reached.size() < limit) {
+        for(uint32_t a=offsets[from]; a<offsets[from+1] && reached.size() < limit; a++) {
+            const Adjacent& adjacent = adjacents[a];
+            if(visits[adjacent.node] != visit) {
+                visits[adjacent.node] = visit;
+                if(!scope || isInScope(adjacent.node, *scope)) {
+                    reached.push_back(Reached{adjacent.node, from, adjacent.relation, hops+1});
+                }
+            }
+        }
+
+        if(head == reached.size()) {
+            break;
+        }
+        from = reached[head].node;
+        hops = reached[head].hops;
+        head++;
+    }
+}
+
+} // m8r namespace
@@ -0,0 +1,218 @@
+/*
+ knowledge_graph_index.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_KNOWLEDGE_GRAPH_INDEX_H
+#define M8R_KNOWLEDGE_GRAPH_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../model/outline.h"
+#include "../model/note.h"
+#include "../model/tag.h"
+#include "aspect/mind_scope_aspect.h"
+
+namespace m8r {
+
+/**
+ * @brief Adjacency index of Os, Ns, tags and explicit links.
+ *
+ * Every O, N and (used) tag gets a node ID. Edges are contributed by Os:
+ * O/N > its direct child Ns, O/N > its tags and O/N > O/N it links to
+ * (link URL is a relative or absolute path of O file w/ optional #N).
+ * Every edge can be walked in both directions.
+ *
+ * Index is incremental - (re)indexing or forgetting an O replaces its
+ * contribution in O(O size) and recycles IDs of its Things; old Ns are NOT
+ * dereferenced. Adjacency is kept in CSR (compressed sparse row) arrays which
+ * are rebuilt lazily in O(V+E) on the first query after a change. Links are
+ * resolved on rebuild, therefore link target may be indexed after the source.
+ */
+class KnowledgeGraphIndex
+{
+public:
+    typedef uint32_t NodeId;
+    static constexpr NodeId NO_NODE = UINT32_MAX;
+
+    enum class NodeType : uint8_t {
+        OUTLINE,
+        NOTE,
+        TAG
+    };
+
+    /**
+     * @brief Relation of adjacent node to the node.
+     */
+    enum class Relation : uint8_t {
+        // O/N > direct child N
+        CHILD,
+        // N > parent O/N
+        PARENT,
+        // O/N > tag
+        TAG,
+        // tag > O/N
+        TAGGED,
+        // O/N > link target O/N
+        LINK,
+        // link target O/N > O/N
+        BACKLINK
+    };
+
+    struct Adjacent {
+        NodeId node;
+        Relation relation;
+    };
+
+    /**
+     * @brief Node reached by multi-hop expansion from the node it was reached from.
+     */
+    struct Reached {
+        NodeId node;
+        NodeId from;
+        Relation relation;
+        unsigned hops;
+    };
+
+private:
+    /**
+     * @brief Indexed node - thing==nullptr indicates recycled ID.
+     */
+    struct Node {
+        NodeType type;
+        const void* thing;
+    };
+
+    struct Edge {
+        NodeId from;
+        NodeId to;
+        Relation relation;
+    };
+
+    struct PendingLink {
+        NodeId from;
+        std::string key;
+        std::string anchor;
+    };
+
+    /**
+     * @brief Nodes and edges contributed by O.
+     */
+    struct Contribution {
+        std::string key;
+        // O's node is the first one
+        std::vector<NodeId> things;
+        std::vector<const Tag*> tags;
+        std::vector<Edge> edges;
+        std::vector<PendingLink> links;
+        // mangled N name > N
+        std::unordered_map<std::string,NodeId> anchors;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<NodeId> freeIds;
+    std::unordered_map<const void*,NodeId> ids;
+    std::unordered_map<const Tag*,unsigned> tagReferences;
+    std::unordered_map<const Outline*,Contribution> contributions;
+    std::unordered_map<std::string,const Outline*> outlineKeys;
+
+    // CSR: adjacents of node N are adjacents[offsets[N], offsets[N+1])
+    mutable std::vector<uint32_t> offsets;
+    mutable std::vector<Adjacent> adjacents;
+    mutable bool adjacencyIndexed;
+
+    // expansion: node is visited if visits[node]==visit
+    mutable std::vector<uint32_t> visits;
+    mutable uint32_t visit;
+
+public:
+    explicit KnowledgeGraphIndex();
+    KnowledgeGraphIndex(const KnowledgeGraphIndex&) = delete;
+    KnowledgeGraphIndex(const KnowledgeGraphIndex&&) = delete;
+    KnowledgeGraphIndex& operator=(const KnowledgeGraphIndex&) = delete;
+    KnowledgeGraphIndex& operator=(const KnowledgeGraphIndex&&) = delete;
+    ~KnowledgeGraphIndex();
+
+    void clear();
+
+    /**
+     * @brief Index O, its Ns, tags and links - O's previous contribution is replaced.
+     */
+    void index(const Outline* outline);
+
+    /**
+     * @brief Remove O, its Ns, tags and links from the index.
+     */
+    void forget(const Outline* outline);
+
+    NodeId getNode(const Outline* outline) const { return getNode(static_cast<const void*>(outline)); }
+    NodeId getNode(const Note* note) const { return getNode(static_cast<const void*>(note)); }
+    NodeId getNode(const Tag* tag) const { return getNode(static_cast<const void*>(tag)); }
+
+    NodeType getType(NodeId node) const { return nodes[node].type; }
+    Outline* getOutline(NodeId node) const {
+        return nodes[node].type==NodeType::OUTLINE ? static_cast<Outline*>(const_cast<void*>(nodes[node].thing)) : nullptr;
+    }
+    Note* getNote(NodeId node) const {
+        return nodes[node].type==NodeType::NOTE ? static_cast<Note*>(const_cast<void*>(nodes[node].thing)) : nullptr;
+    }
+    const Tag* getTag(NodeId node) const {
+        return nodes[node].type==NodeType::TAG ? static_cast<const Tag*>(nodes[node].thing) : nullptr;
+    }
+
+    size_t getNodesCount() const { return ids.size(); }
+    size_t getEdgesCount() const;
+    size_t getDegree(NodeId node) const;
+
+    template<typename F> void forEachAdjacent(NodeId node, F f) const {
+        indexAdjacency();
+        for(uint32_t a=offsets[node]; a<offsets[node+1]; a++) {
+            f(adjacents[a]);
+        }
+    }
+
+    /**
+     * @brief Breadth-first expansion of the node neighbourhood.
+     *
+     * Every node is reached once (by the shortest path), the node itself is
+     * not reported. Expansion stops after given hops or when maxNodes nodes
+     * are reached. Os and Ns out of scope (if given) are neither reported
+     * nor expanded.
+     */
+    void expand(
+        NodeId node,
+        unsigned maxHops,
+        size_t maxNodes,
+        std::vector<Reached>& reached,
+        const MindScopeAspect* scope=nullptr) const;
+
+private:
+    NodeId getNode(const void* thing) const {
+        auto i = ids.find(thing);
+        return i == ids.end() ? NO_NODE : i->second;
+    }
+    NodeId addNode(NodeType type, const void* thing);
+    void removeNode(const void* thing);
+    void addLinks(Contribution& contribution, NodeId from, const std::vector<Link*>& links);
+    bool isInScope(NodeId node, const MindScopeAspect& scope) const;
+    void indexAdjacency() const;
+};
+
+}
+#endif // M8R_KNOWLEDGE_GRAPH_INDEX_H
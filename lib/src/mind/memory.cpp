@@ -18,6 +18,13 @@
  */
 #include "memory.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <set>
+#include <thread>
+
 #include "../gear/string_utils.h"
 
 using namespace std;
@@ -36,10 +43,22 @@ Memory::Memory(
       persistence(new FilesystemPersistence{mdRepresentation, htmlRepresentation}),
       twikiRepresentation{mdRepresentation, persistence},
       csvRepresentation{},
-      limbo{}
+      limbo{},
+      ftsIndex{},
+      tagIndex{},
+      graphIndex{},
+      statistics{},
+      snapshot{},
+      statisticsJournal{},
+      changeListener{}
 {
     cache = true;
     mindScope = nullptr;
+    scheduler = nullptr;
+
+    // Os written by MindForger must not be relearned as changed outside of MindForger
+    persistence->setWriteListener(
+        [this](const string& path, const string& replacement) { repositoryWatcher.expect(path, replacement); });
 }
 
 vector<Stencil*>& Memory::getStencils(ResourceType type)
@@ -58,6 +77,27 @@ void Memory::learn()
 {
     aware = true;
 
+    // watch repository BEFORE it's indexed so that no change is missed
+    if(config.isRepositoryWatcher()
+         &&
+       config.getActiveRepository()->getMode() == Repository::RepositoryMode::REPOSITORY)
+    {
+        string memoryDirectory{config.getActiveRepository()->getDir()};
+        if(config.getActiveRepository()->getType() == Repository::RepositoryType::MINDFORGER) {
+            memoryDirectory += FILE_PATH_SEPARATOR;
+            memoryDirectory += DIRNAME_MEMORY;
+        }
+        repositoryWatcher.watch(memoryDirectory);
+    } else {
+        repositoryWatcher.unwatch();
+    }
+
+    // the same threads walk repository directories and parse Markdown files
+    unsigned threads = config.getLearnThreads()>0
+        ? static_cast<unsigned>(config.getLearnThreads())
+        : std::thread::hardware_concurrency();
+    repositoryIndexer.getDirectoryWalker().setThreads(threads);
+    repositoryIndexer.getDirectoryWalker().setIgnorePatterns(config.getIndexerIgnorePatterns());
     repositoryIndexer.index(config.getActiveRepository());
 
 #ifdef DO_MF_DEBUG
@@ -67,27 +107,55 @@ void Memory::learn()
 
     if(config.getActiveRepository()->getMode() == Repository::RepositoryMode::REPOSITORY) {
         MF_DEBUG(endl << "Markdown files:");
-        for(const string* markdownFile:repositoryIndexer.getMarkdownFiles()) {
-            Outline* outline = mdRepresentation.outline(File(*markdownFile));
-            MF_DEBUG(endl << "  '" << *markdownFile << "' format " << (outline->getFormat()==MarkdownDocument::Format::MINDFORGER?"MF":"MD"));
-
-            // fix O type according to repository type
-            switch(config.getActiveRepository()->getType()) {
-            case Repository::RepositoryType::MINDFORGER:
-                outline->setFormat(MarkdownDocument::Format::MINDFORGER);
-                break;
-            case Repository::RepositoryType::MARKDOWN:
-                outline->setFormat(MarkdownDocument::Format::MARKDOWN);
-                break;
+        const set<const string*> markdownFilesSet = repositoryIndexer.getMarkdownFiles();
+        vector<const string*> markdownFiles{markdownFilesSet.begin(), markdownFilesSet.end()};
+        // indexer's set is ordered by pointers > sort by path to learn Os deterministically
+        std::sort(
+            markdownFiles.begin(),
+            markdownFiles.end(),
+            [](const string* a, const string* b) { return *a < *b; });
+        if(config.isRepositorySnapshot()
+             &&
+           config.getActiveRepository()->getType() == Repository::RepositoryType::MINDFORGER
+             &&
+           !config.getActiveRepository()->isReadOnly())
+        {
+            snapshot.load(RepositorySnapshot::path(config.getCachePath(), config.getActiveRepository()->getDir()));
+        } else {
+            snapshot.clear();
+        }
+        if(threads > 1 && markdownFiles.size() > 1) {
+            learnOutlinesParallel(markdownFiles, threads);
+        } else {
+            for(const string* markdownFile:markdownFiles) {
+                MarkdownDocument md{markdownFile};
+                snapshot.from(md);
+                learnOutline(md);
             }
-
-            if(outline->isVirgin()) {
-                MF_DEBUG(endl << "    VIRGIN ~ most probably wrongly parsed > SKIPPING it");
-                delete outline;
-            } else {
-                outlines.push_back(outline);
-                outlinesMap.insert(map<string,Outline*>::value_type(outline->getKey(), outline));
+        }
+        if(snapshot.isLoaded()) {
+            MF_DEBUG(endl << "Repository snapshot: " << snapshot.getRestoredCount() << " restored, " << snapshot.getParsedCount() << " parsed");
+            snapshot.save();
+        }
+        // reads are journaled only if they are persisted
+        if(config.isStatisticsJournal()
+             &&
+           config.isSaveReadsMetadata()
+             &&
+           config.getActiveRepository()->getType() == Repository::RepositoryType::MINDFORGER
+             &&
+           !config.getActiveRepository()->isReadOnly())
+        {
+            string journalPath{config.getActiveRepository()->getDir()};
+            journalPath += FILE_PATH_SEPARATOR;
+            journalPath += FILENAME_STATISTICS_JOURNAL;
+            statisticsJournal.open(journalPath, config.getActiveRepository()->getDir());
+            statisticsJournal.replay(outlines);
+            if(statisticsJournal.isCompactionNeeded()) {
+                statisticsJournal.compact();
             }
+        } else {
+            statisticsJournal.close();
         }
 
 #ifdef MF_WIP
@@ -152,7 +220,8 @@ void Memory::learn()
                 delete outline;
             } else {
                 outlines.push_back(outline);
-                outlinesMap.insert(map<string,Outline*>::value_type(outline->getKey(), outline));
+                outlinesMap.emplace(outline->getKey(), outline);
+                reindex(outline);
             }
 
             MF_DEBUG(endl);
@@ -165,11 +234,141 @@ void Memory::learn()
 #endif
 }
 
+void Memory::learnOutline(MarkdownDocument& md)
+{
+    Outline* outline = mdRepresentation.outline(md);
+    MF_DEBUG(endl << "  '" << *md.getFilePath() << "' format " << (outline->getFormat()==MarkdownDocument::Format::MINDFORGER?"MF":"MD"));
+
+    // fix O type according to repository type
+    switch(config.getActiveRepository()->getType()) {
+    case Repository::RepositoryType::MINDFORGER:
+        outline->setFormat(MarkdownDocument::Format::MINDFORGER);
+        break;
+    case Repository::RepositoryType::MARKDOWN:
+        outline->setFormat(MarkdownDocument::Format::MARKDOWN);
+        break;
+    }
+
+    if(outline->isVirgin()) {
+        MF_DEBUG(endl << "    VIRGIN ~ most probably wrongly parsed > SKIPPING it");
+        delete outline;
+    } else {
+        outlines.push_back(outline);
+        outlinesMap.emplace(outline->getKey(), outline);
+        reindex(outline);
+    }
+}
+
+/*
+ * Markdown files are lexed and parsed by scheduler workers, while Outlines
+ * are created from ASTs (and tags/types are registered in the Ontology)
+ * by the calling thread strictly in the order of files. Therefore Outlines
+ * order, Outlines map and Ontology are identical to the sequential load.
+ * The calling thread parses the next file itself if no worker took it yet,
+ * so it never waits for a busy scheduler.
+ *
+ * Workers may run ahead of the calling thread by a bounded window of
+ * documents only to keep the number of ASTs held in memory low.
+ */
+void Memory::learnOutlinesParallel(const vector<const string*>& markdownFiles, unsigned threads)
+{
+    const size_t window = threads*LEARN_WINDOW_PER_THREAD;
+    vector<MarkdownDocument*> documents(markdownFiles.size(), nullptr);
+    vector<std::exception_ptr> errors(markdownFiles.size(), nullptr);
+    std::atomic<size_t> next{0};
+    size_t learned = 0;
+    std::mutex documentsMutex{};
+    std::condition_variable documentParsed{};
+    std::condition_variable documentLearned{};
+
+    auto parse = [&](size_t i) {
+        MarkdownDocument* md = new MarkdownDocument{markdownFiles[i]};
+        std::exception_ptr error{};
+        try {
+            snapshot.from(*md);
+        } catch(...) {
+            error = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock{documentsMutex};
+            documents[i] = md;
+            errors[i] = error;
+        }
+        documentParsed.notify_one();
+    };
+
+    auto worker = [&]() {
+        size_t i;
+        while((i = next++) < markdownFiles.size()) {
+            {
+                std::unique_lock<std::mutex> lock{documentsMutex};
+                documentLearned.wait(lock, [&]{ return i < learned+window; });
+            }
+            parse(i);
+        }
+    };
+
+    std::exception_ptr error{};
+    auto learnInOrder = [&]() {
+        for(size_t i=0; i<markdownFiles.size(); i++) {
+            size_t unclaimed = i;
+            if(next.compare_exchange_strong(unclaimed, i+1)) {
+                parse(i);
+            }
+
+            MarkdownDocument* md;
+            {
+                std::unique_lock<std::mutex> lock{documentsMutex};
+                documentParsed.wait(lock, [&]{ return documents[i] != nullptr; });
+                md = documents[i];
+                documents[i] = nullptr;
+                if(!error) {
+                    error = errors[i];
+                }
+            }
+            if(!error) {
+                try {
+                    learnOutline(*md);
+                } catch(...) {
+                    error = std::current_exception();
+                }
+            }
+            delete md;
+            {
+                std::lock_guard<std::mutex> lock{documentsMutex};
+                learned = i+1;
+            }
+            documentLearned.notify_all();
+        }
+    };
+
+    if(scheduler) {
+        scheduler->parallel(
+            static_cast<unsigned>(std::min<size_t>(threads, markdownFiles.size()))-1,
+            worker,
+            learnInOrder,
+            TaskScheduler::INTERACTIVE);
+    } else {
+        learnInOrder();
+    }
+
+    if(error) {
+        std::rethrow_exception(error);
+    }
+}
+
 void Memory::amnesia()
 {
     aware = false;
 
+    // journaled reads are folded to Markdown on shutdown
+    foldStatisticsJournal();
+    statisticsJournal.close();
+    // Os saved so far must be written before they are forgotten
+    flush();
+    repositoryWatcher.unwatch();
     repositoryIndexer.clear();
+    snapshot.clear();
 
     // IMPROVE reset ontology i.e. clear custom types & keep only default ontology
     // ontology.reset();
@@ -179,11 +378,18 @@ void Memory::amnesia()
     }
     outlines.clear();
     outlinesMap.clear();
+    ftsIndex.clear();
+    tagIndex.clear();
+    graphIndex.clear();
+    outlineNames.clear();
+    nameToOutlines.clear();
+    statistics.clear();
 
     for(Outline*& outline:limboOutlines) {
         delete outline;
     }
     limboOutlines.clear();
+    deleteReplacedOutlines();
 
     for(Stencil*& stencil:outlineStencils) {
         delete stencil;
@@ -236,6 +442,8 @@ void Memory::remember(const std::string& outlineKey)
         o->makeModified();
         o->checkAndFixProperties();
         persistence->save(o);
+        statisticsJournal.forget(o);
+        reindex(o);
     } else {
         throw MindForgerException{
             "Save: unable to find outline w/ given key (" + outlineKey + ") to save"
@@ -253,11 +461,13 @@ void Memory::remember(Outline* outline)
 
     outline->checkAndFixProperties();
     persistence->save(outline);
+    statisticsJournal.forget(outline);
 
     if(!getOutline(outline->getKey())) {
         outlines.push_back(outline);
-        outlinesMap.insert(map<string,Outline*>::value_type(outline->getKey(), outline));
+        outlinesMap.emplace(outline->getKey(), outline);
     }
+    reindex(outline);
 }
 
 void Memory::exportToHtml(Outline* outline, const string& fileName)
@@ -280,15 +490,114 @@ void Memory::exportToCsv(
     );
 }
 
-void Memory::forget(Outline* outline)
+void Memory::detach(Outline* outline)
 {
+    statisticsJournal.forget(outline);
     outlinesMap.erase(outline->getKey());
-    limboOutlines.push_back(outline);
+    unindex(outline);
     outlines.erase(std::remove(outlines.begin(), outlines.end(), outline), outlines.end());
 }
 
+void Memory::forget(Outline* outline)
+{
+    detach(outline);
+    limboOutlines.push_back(outline);
+}
+
+void Memory::read(Outline* outline)
+{
+    outline->makeRead();
+    // only remembered Os are journaled (forgotten ones are dropped from the journal)
+    if(getOutline(outline->getKey()) != outline) {
+        return;
+    }
+    statistics.read(outline);
+    statisticsJournal.read(outline);
+    if(statisticsJournal.isCompactionNeeded()) {
+        statisticsJournal.compact();
+    }
+}
+
+void Memory::read(Note* note)
+{
+    note->makeRead();
+    if(!note->getOutline() || getOutline(note->getOutline()->getKey()) != note->getOutline()) {
+        return;
+    }
+    statistics.read(note);
+    statisticsJournal.read(note);
+    if(statisticsJournal.isCompactionNeeded()) {
+        statisticsJournal.compact();
+    }
+}
+
+void Memory::foldStatisticsJournal()
+{
+    if(!statisticsJournal.isOpen() || !statisticsJournal.getJournaledOutlinesCount()) {
+        return;
+    }
+
+    for(Outline* o:statisticsJournal.getJournaledOutlines()) {
+        // O is saved as is - reads don't make it modified
+        persistence->save(o);
+    }
+    // journal can be truncated only once its Os are on disk
+    if(flush().empty()) {
+        statisticsJournal.truncate();
+    } else {
+        statisticsJournal.compact();
+    }
+}
+
+vector<string> Memory::takeUnwrittenOutlines()
+{
+    vector<string> unwritten = persistence->takeFailedWrites();
+    for(const string& key:unwritten) {
+        Outline* o = getOutline(key);
+        if(o) {
+            MF_DEBUG("Memory: O " << key << " was NOT written" << endl);
+            o->makeDirty();
+        }
+    }
+    return unwritten;
+}
+
+vector<string> Memory::flush()
+{
+    persistence->flush();
+    return takeUnwrittenOutlines();
+}
+
+Outline* Memory::relearn(const string& filePath)
+{
+    Outline* outline = getOutline(filePath);
+    if(outline) {
+        detach(outline);
+        replacedOutlines.push_back(outline);
+    }
+
+    if(!isFile(filePath.c_str()) || !File::fileHasMarkdownExtension(filePath)) {
+        return nullptr;
+    }
+
+    MarkdownDocument md{&filePath};
+    snapshot.from(md);
+    learnOutline(md);
+    return getOutline(filePath);
+}
+
+void Memory::deleteReplacedOutlines()
+{
+    for(Outline*& outline:replacedOutlines) {
+        delete outline;
+    }
+    replacedOutlines.clear();
+}
+
 Memory::~Memory()
 {
+    foldStatisticsJournal();
+    deleteReplacedOutlines();
     for(Outline*& outline:outlines) {
         delete outline;
     }
@@ -301,6 +610,7 @@ Memory::~Memory()
     for(Stencil*& stencil:noteStencils) {
         delete stencil;
     }
+    // pending writes are written before persistence is deleted
     delete persistence;
 }
 
@@ -311,22 +621,12 @@ unsigned Memory::getOutlinesCount() const
 
 unsigned Memory::getOutlineMarkdownsSize() const
 {
-    // IMPROVE introduce dirty flag (add/remove outline and recount only then)
-    unsigned int result{};
-    for(Outline* outline:outlines) {
-        result+=outline->getBytesize();
-    }
-    return result;
+    return statistics.getOutlineMarkdownsSize();
 }
 
 unsigned Memory::getNotesCount() const
 {
-    // IMPROVE PERFORMANCE cache this number & introduce dirty flag (add/remove outline and recount only then)
-    unsigned int result{};
-    for(Outline* outline:outlines) {
-        result+=outline->getNotes().size();
-    }
-    return result;
+    return statistics.getNotesCount();
 }
 
 const vector<Outline*>& Memory::getOutlines() const
@@ -344,9 +644,9 @@ string Memory::createLimboKey(const string* name)
     return persistence->createFileName(config.getLimboPath(), name, File::EXTENSION_MD_MD);
 }
 
-Outline* Memory::getOutline(const string& key)
+Outline* Memory::getOutline(const string& key) const
 {
-    map<string,Outline*>::const_iterator entry = outlinesMap.find(key);
+    auto entry = outlinesMap.find(key);
     if(entry == outlinesMap.end()) {
         return nullptr;
     } else {
@@ -354,6 +654,65 @@ Outline* Memory::getOutline(const string& key)
     }
 }
 
+void Memory::reindex(Outline* outline)
+{
+    if(changeListener) {
+        changeListener(outline->getKey());
+    }
+    ftsIndex.index(outline);
+    tagIndex.index(outline);
+    graphIndex.index(outline);
+    indexOutlineName(outline);
+    statistics.index(outline);
+}
+
+void Memory::unindex(Outline* outline)
+{
+    if(changeListener) {
+        changeListener(outline->getKey());
+    }
+    ftsIndex.forget(outline);
+    tagIndex.forget(outline);
+    graphIndex.forget(outline);
+    forgetOutlineName(outline);
+    statistics.forget(outline);
+}
+
+void Memory::indexOutlineName(Outline* outline)
+{
+    auto name = outlineNames.find(outline);
+    if(name != outlineNames.end()) {
+        if(name->second == outline->getName()) {
+            return;
+        }
+        forgetOutlineName(outline);
+    }
+    outlineNames[outline] = outline->getName();
+    nameToOutlines[outline->getName()].push_back(outline);
+}
+
+void Memory::forgetOutlineName(const Outline* outline)
+{
+    auto name = outlineNames.find(outline);
+    if(name != outlineNames.end()) {
+        auto named = nameToOutlines.find(name->second);
+        if(named != nameToOutlines.end()) {
+            vector<Outline*>& os = named->second;
+            os.erase(std::remove(os.begin(), os.end(), outline), os.end());
+            if(os.empty()) {
+                nameToOutlines.erase(named);
+            }
+        }
+        outlineNames.erase(name);
+    }
+}
+
+const vector<Outline*>* Memory::findOutlinesByName(const string& name) const
+{
+    auto named = nameToOutlines.find(name);
+    return named == nameToOutlines.end() ? nullptr : &named->second;
+}
+
 std::vector<Note*>& Memory::getAllNotes(vector<Note*>& notes, bool doSortByRead, bool addNoteForOutline) const
 {
     for(Outline* o:outlines) {
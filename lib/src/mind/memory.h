@@ -19,15 +19,19 @@
 #ifndef M8R_MEMORY_H_
 #define M8R_MEMORY_H_
 
+#include <functional>
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 #include "../debug.h"
 #include "../exceptions.h"
 #include "../gear/async_utils.h"
+#include "../gear/task_scheduler.h"
 #include "../mind/ontology/ontology.h"
 #include "../config/configuration.h"
 #include "../repository_indexer.h"
+#include "../repository_watcher.h"
 #include "../representations/markdown/markdown_document.h"
 #include "../representations/markdown/markdown_outline_representation.h"
 #include "../representations/html/html_outline_representation.h"
@@ -40,13 +44,25 @@
 #include "../model/resource_types.h"
 #include "../persistence/persistence.h"
 #include "../persistence/filesystem_persistence.h"
+#include "../persistence/repository_snapshot.h"
+#include "../persistence/statistics_journal.h"
 #include "aspect/mind_scope_aspect.h"
 #include "limbo.h"
+#include "fts_index.h"
+#include "tag_index.h"
+#include "knowledge_graph_index.h"
+#include "memory_statistics.h"
 
 namespace m8r {
 
 class Memory
 {
+public:
+    /**
+     * @brief How many Markdown documents may parallel learning workers parse ahead (per thread).
+     */
+    static constexpr unsigned LEARN_WINDOW_PER_THREAD = 8;
+
 private:
     /**
      * @brief Indicates whether Mind learned a repository.
@@ -63,6 +79,7 @@ private:
     bool cache;
 
     RepositoryIndexer repositoryIndexer;
+    RepositoryWatcher repositoryWatcher;
     Configuration& config;
     Ontology& ontology;
     MarkdownOutlineRepresentation& mdRepresentation;
@@ -70,7 +87,15 @@ private:
     TWikiOutlineRepresentation twikiRepresentation;
     CsvOutlineRepresentation csvRepresentation;
     MindScopeAspect* mindScope;
+    // workers which help to learn repository
+    TaskScheduler* scheduler;
     Limbo limbo;
+    FtsIndex ftsIndex;
+    TagIndex tagIndex;
+    KnowledgeGraphIndex graphIndex;
+    MemoryStatistics statistics;
+    RepositorySnapshot snapshot;
+    StatisticsJournal statisticsJournal;
 
     std::vector<Outline*> outlines;
     std::vector<Note*> notes;
@@ -78,9 +103,16 @@ private:
     std::vector<Stencil*> noteStencils;
 
     std::vector<Outline*> limboOutlines;
+    // Os replaced by relearn() which might be still referenced by views
+    std::vector<Outline*> replacedOutlines;
+
+    // notified w/ O key whenever O is (re)indexed or unindexed
+    std::function<void(const std::string&)> changeListener;
 
-    // IMPROVE unordered_map
-    std::map<std::string,Outline*> outlinesMap;
+    std::unordered_map<std::string,Outline*> outlinesMap;
+    // O name index - names are indexed when O is learned/remembered
+    std::unordered_map<const Outline*,std::string> outlineNames;
+    std::unordered_map<std::string,std::vector<Outline*>> nameToOutlines;
 
 public:
     explicit Memory(
@@ -98,12 +130,24 @@ public:
      * @brief Set time and/or tag Mind scope.
      */
     void setMindScope(MindScopeAspect* mindScopeAspect) { mindScope = mindScopeAspect; }
+    /**
+     * @brief Set scheduler whose workers parse Markdown files when repository is learned in parallel.
+     */
+    void setScheduler(TaskScheduler* scheduler) { this->scheduler = scheduler; }
+
+    /**
+     * @brief Set listener notified w/ O key when O is changed in memory - e.g. to evict caches.
+     */
+    void setChangeListener(std::function<void(const std::string&)> listener) { changeListener = listener; }
 
     /**
      * @brief Learn repository content.
      */
     void learn();
     bool isAware() { return aware; }
+    const RepositorySnapshot& getSnapshot() const { return snapshot; }
+    RepositoryWatcher& getRepositoryWatcher() { return repositoryWatcher; }
+    StatisticsJournal& getStatisticsJournal() { return statisticsJournal; }
 
     /**
      * @brief Forget everything.
@@ -167,6 +211,58 @@ public:
      */
     void forget(Outline* outline);
 
+    /**
+     * @brief (Re)index O in FTS, tag, graph, name and statistics indices.
+     *
+     * Must be called whenever O (or its Ns) is changed in memory - change
+     * listener is notified even if O's revision was not bumped.
+     */
+    void reindex(Outline* outline);
+    /**
+     * @brief Remove O from all Memory indices.
+     */
+    void unindex(Outline* outline);
+
+    /**
+     * @brief Make O read and journal its statistics.
+     */
+    void read(Outline* outline);
+    /**
+     * @brief Make N read and journal its statistics.
+     */
+    void read(Note* note);
+    /**
+     * @brief Save Os w/ journaled statistics and truncate the journal - call it on idle or shutdown.
+     */
+    void foldStatisticsJournal();
+
+    /**
+     * @brief Make Os whose files could not be written (behind) dirty again.
+     *
+     * @return Keys of Os which were not written since the last call.
+     */
+    std::vector<std::string> takeUnwrittenOutlines();
+    /**
+     * @brief Block until all Os saved so far are written.
+     *
+     * @return Keys of Os which were not written (they are dirty again).
+     */
+    std::vector<std::string> flush();
+
+    /**
+     * @brief (Re)learn O from file which was created, modified or removed outside of MindForger.
+     *
+     * Previous version of the O is removed from memory, but it's not deleted
+     * as it might be still referenced (views) - it's deleted by deleteReplacedOutlines().
+     *
+     * @return Learned O or nullptr if the file doesn't exist or it's not an O.
+     */
+    Outline* relearn(const std::string& filePath);
+    /**
+     * @brief Delete Os replaced by relearn() - they must not be referenced anymore.
+     */
+    void deleteReplacedOutlines();
+
     /**
      * @brief Get Ontology.
      * @return Ontology
@@ -205,7 +301,12 @@ public:
      * Get outline including AST - if Outline contains only name/description/metadata,
      * then AST is loaded and full outline returned.
      */
-    Outline* getOutline(const std::string &key);
+    Outline* getOutline(const std::string &key) const;
+
+    /**
+     * @brief Get Os w/ given name (as of their last learn/remember) or nullptr.
+     */
+    const std::vector<Outline*>* findOutlinesByName(const std::string& name) const;
 
     /**
      * @brief Get Ns of all outlines.
@@ -220,11 +321,32 @@ public:
      */
 
     RepositoryIndexer& getRepositoryIndexer() { return repositoryIndexer; }
+    // indices are updated by reindex()/unindex() only
+    const FtsIndex& getFtsIndex() const { return ftsIndex; }
+    const TagIndex& getTagIndex() const { return tagIndex; }
+    const KnowledgeGraphIndex& getGraphIndex() const { return graphIndex; }
+    const MemoryStatistics& getStatistics() const { return statistics; }
     Persistence& getPersistence() const { return *persistence; }
 
 private:
     const OutlineType* toOutlineType(const MarkdownAstSectionMetadata&);
 
+    /**
+     * @brief Create Outline from parsed Markdown document and learn it.
+     */
+    void learnOutline(MarkdownDocument& md);
+
+    /**
+     * @brief Remove O from Os, map, journal and indices (O is not deleted).
+     */
+    void detach(Outline* outline);
+    void indexOutlineName(Outline* outline);
+    void forgetOutlineName(const Outline* outline);
+    /**
+     * @brief Lex and parse Markdown files in parallel and learn them in given order.
+     */
+    void learnOutlinesParallel(const std::vector<const std::string*>& markdownFiles, unsigned threads);
+
 };
 
 } /* namespace */
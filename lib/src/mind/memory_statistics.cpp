@@ -0,0 +1,174 @@
+/*
+ memory_statistics.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "memory_statistics.h"
+
+#include "../gear/string_utils.h"
+
+using namespace std;
+
+namespace m8r {
+
+MemoryStatistics::MemoryStatistics()
+    : contributions{},
+      notesCount{0},
+      markdownsSize{0},
+      outlineReads{},
+      outlineWrites{},
+      noteReads{},
+      noteWrites{},
+      tagsCardinality{},
+      tagsRanking{}
+{
+}
+
+MemoryStatistics::~MemoryStatistics()
+{
+}
+
+void MemoryStatistics::clear()
+{
+    contributions.clear();
+    notesCount = 0;
+    markdownsSize = 0;
+    outlineReads.clear();
+    outlineWrites.clear();
+    noteReads.clear();
+    noteWrites.clear();
+    tagsCardinality.clear();
+    tagsRanking.clear();
+}
+
+void MemoryStatistics::addTag(const Tag* tag)
+{
+    u_int32_t& cardinality = tagsCardinality[tag];
+    // NONE tags are checked once per tag occurrence change, not on query
+    bool ranked = !stringistring(string("none"), tag->getName());
+    if(ranked && cardinality) {
+        tagsRanking.erase(make_pair(cardinality, tag));
+    }
+    cardinality++;
+    if(ranked) {
+        tagsRanking.insert(make_pair(cardinality, tag));
+    }
+}
+
+void MemoryStatistics::removeTag(const Tag* tag)
+{
+    auto c = tagsCardinality.find(tag);
+    if(c == tagsCardinality.end()) {
+        return;
+    }
+    bool ranked = !stringistring(string("none"), tag->getName());
+    if(ranked) {
+        tagsRanking.erase(make_pair(c->second, tag));
+    }
+    if(--c->second) {
+        if(ranked) {
+            tagsRanking.insert(make_pair(c->second, tag));
+        }
+    } else {
+        tagsCardinality.erase(c);
+    }
+}
+
+void MemoryStatistics::index(Outline* outline)
+{
+    if(!outline) {
+        return;
+    }
+
+    forget(outline);
+
+    Contribution& c = contributions[outline];
+    c.bytesize = outline->getBytesize();
+    c.reads = outline->getReads();
+    c.revision = outline->getRevision();
+    markdownsSize += c.bytesize;
+    outlineReads.insert(make_pair(c.reads, outline));
+    outlineWrites.insert(make_pair(c.revision, outline));
+    for(const Tag* t:*outline->getTags()) {
+        c.tags.push_back(t);
+        addTag(t);
+    }
+
+    c.notes.reserve(outline->getNotes().size());
+    c.noteOffsets.reserve(outline->getNotes().size());
+    for(Note* n:outline->getNotes()) {
+        c.noteOffsets[n] = c.notes.size();
+        c.notes.push_back(make_pair(n, make_pair(n->getReads(), n->getRevision())));
+        noteReads.insert(make_pair(n->getReads(), n));
+        noteWrites.insert(make_pair(n->getRevision(), n));
+        for(const Tag* t:*n->getTags()) {
+            c.tags.push_back(t);
+            addTag(t);
+        }
+    }
+    notesCount += c.notes.size();
+}
+
+void MemoryStatistics::forget(const Outline* outline)
+{
+    auto entry = contributions.find(outline);
+    if(entry != contributions.end()) {
+        Contribution& c = entry->second;
+        Outline* o = const_cast<Outline*>(outline);
+        markdownsSize -= c.bytesize;
+        outlineReads.erase(make_pair(c.reads, o));
+        outlineWrites.erase(make_pair(c.revision, o));
+        for(const auto& n:c.notes) {
+            noteReads.erase(make_pair(n.second.first, n.first));
+            noteWrites.erase(make_pair(n.second.second, n.first));
+        }
+        notesCount -= c.notes.size();
+        for(const Tag* t:c.tags) {
+            removeTag(t);
+        }
+        contributions.erase(entry);
+    }
+}
+
+void MemoryStatistics::read(Outline* outline)
+{
+    auto entry = contributions.find(outline);
+    if(entry != contributions.end() && entry->second.reads != outline->getReads()) {
+        Contribution& c = entry->second;
+        outlineReads.erase(make_pair(c.reads, outline));
+        c.reads = outline->getReads();
+        outlineReads.insert(make_pair(c.reads, outline));
+    }
+}
+
+void MemoryStatistics::read(Note* note)
+{
+    auto entry = contributions.find(note->getOutline());
+    if(entry != contributions.end()) {
+        Contribution& c = entry->second;
+        auto offset = c.noteOffsets.find(note);
+        if(offset != c.noteOffsets.end()) {
+            u_int32_t& reads = c.notes[offset->second].second.first;
+            if(reads != note->getReads()) {
+                noteReads.erase(make_pair(reads, note));
+                reads = note->getReads();
+                noteReads.insert(make_pair(reads, note));
+            }
+        }
+    }
+}
+
+} // m8r namespace
@@ -0,0 +1,133 @@
+/*
+ memory_statistics.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_MEMORY_STATISTICS_H
+#define M8R_MEMORY_STATISTICS_H
+
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../model/outline.h"
+#include "../model/note.h"
+#include "../model/tag.h"
+
+namespace m8r {
+
+/**
+ * @brief Incrementally maintained statistics of Memory.
+ *
+ * Counters (Os, Ns, Markdown bytes), the most read/written O and N trackers
+ * and tag histogram are updated whenever an O is (re)indexed or forgotten
+ * (reads of a single O/N are updated on its own when it is read),
+ * therefore every query is O(1). Values contributed by an O are kept by
+ * the statistics - old Ns are NOT dereferenced and it is safe to reindex O
+ * after its Ns were deleted.
+ *
+ * Tags whose name contains "none" are not tracked as the most used tag.
+ */
+class MemoryStatistics
+{
+    template<typename T> using Ranking = std::set<std::pair<u_int32_t,T*>>;
+
+    /**
+     * @brief Values O and its Ns contributed to statistics.
+     */
+    struct Contribution {
+        unsigned bytesize;
+        u_int32_t reads;
+        u_int32_t revision;
+        std::vector<std::pair<Note*,std::pair<u_int32_t,u_int32_t>>> notes;
+        // N > its offset in notes
+        std::unordered_map<const Note*,size_t> noteOffsets;
+        std::vector<const Tag*> tags;
+    };
+
+    std::unordered_map<const Outline*,Contribution> contributions;
+
+    unsigned notesCount;
+    unsigned markdownsSize;
+
+    Ranking<Outline> outlineReads;
+    Ranking<Outline> outlineWrites;
+    Ranking<Note> noteReads;
+    Ranking<Note> noteWrites;
+
+    std::unordered_map<const Tag*,u_int32_t> tagsCardinality;
+    Ranking<const Tag> tagsRanking;
+
+public:
+    explicit MemoryStatistics();
+    MemoryStatistics(const MemoryStatistics&) = delete;
+    MemoryStatistics(const MemoryStatistics&&) = delete;
+    MemoryStatistics& operator=(const MemoryStatistics&) = delete;
+    MemoryStatistics& operator=(const MemoryStatistics&&) = delete;
+    ~MemoryStatistics();
+
+    void clear();
+
+    /**
+     * @brief Count O and its Ns - O's contribution from previous indexation is removed.
+     */
+    void index(Outline* outline);
+
+    /**
+     * @brief Remove O and its Ns from statistics.
+     */
+    void forget(const Outline* outline);
+
+    /**
+     * @brief Update reads of O (which was already indexed) in O(log n).
+     */
+    void read(Outline* outline);
+    /**
+     * @brief Update reads of N (whose O was already indexed) in O(log n).
+     */
+    void read(Note* note);
+
+    unsigned getOutlinesCount() const { return static_cast<unsigned>(contributions.size()); }
+    unsigned getNotesCount() const { return notesCount; }
+    unsigned getOutlineMarkdownsSize() const { return markdownsSize; }
+
+    /*
+     * The top of rankings, nullptr if there is no Thing w/ non-zero value.
+     */
+
+    Outline* getMostReadOutline() const { return top(outlineReads); }
+    Outline* getMostWrittenOutline() const { return top(outlineWrites); }
+    Note* getMostReadNote() const { return top(noteReads); }
+    Note* getMostWrittenNote() const { return top(noteWrites); }
+    const Tag* getMostUsedTag() const { return top(tagsRanking); }
+
+    u_int32_t getTagCardinality(const Tag* tag) const {
+        auto c = tagsCardinality.find(tag);
+        return c == tagsCardinality.end() ? 0 : c->second;
+    }
+
+private:
+    template<typename T> static T* top(const Ranking<T>& ranking) {
+        return ranking.empty() || !ranking.rbegin()->first ? nullptr : ranking.rbegin()->second;
+    }
+
+    void addTag(const Tag* tag);
+    void removeTag(const Tag* tag);
+};
+
+}
+#endif // M8R_MEMORY_STATISTICS_H
@@ -49,7 +49,8 @@ Mind::Mind(Configuration &configuration)
       exclusiveMind{},
       timeScopeAspect{},
       tagsScopeAspect{ontology},
-      scopeAspect{timeScopeAspect, tagsScopeAspect}
+      scopeAspect{timeScopeAspect, tagsScopeAspect},
+      scheduler{}
 {
     ai = new Ai{memory, *this};
 
@@ -67,6 +68,10 @@ Mind::Mind(Configuration &configuration)
     timeScopeAspect.setTimeScope(config.getTimeScope());
     tagsScopeAspect.setTags(config.getTagsScope());
     memory.setMindScope(&scopeAspect);
+    memory.setScheduler(&scheduler);
+    // O's HTML is evicted whenever O is changed in memory regardless of who changed it
+    memory.setChangeListener(
+        [this](const string& outlineKey) { htmlRepresentation.getHtmlCache().forget(outlineKey); });
 
     stats = new MindStatistics();
     stats->mostReadOutline = nullptr;
@@ -78,6 +83,9 @@ Mind::Mind(Configuration &configuration)
 
 Mind::~Mind()
 {
+    // tasks reference AI > cancel and finish them first
+    scheduler.shutdown();
+
     delete ai;
     if(wingman) delete wingman;
     delete knowledgeGraph;
@@ -109,6 +117,7 @@ bool Mind::learn()
         memory.learn();
 #ifdef MF_MD_2_HTML_CMARK
         autolinking->reindex();
+        htmlRepresentation.setAutolinkingGeneration(autolinking->getGeneration());
 #endif
         MF_DEBUG("Mind LEARNED " << memory.getOutlinesCount() << " Os" << endl);
         return true;
@@ -265,8 +274,10 @@ bool Mind::mindAmnesia()
 
         // forget EVERYTHING
         memory.amnesia();
+        htmlRepresentation.getHtmlCache().clear();
 #ifdef MF_MD_2_HTML_CMARK
         autolinking->clear();
+        htmlRepresentation.setAutolinkingGeneration(autolinking->getGeneration());
 #endif
         MF_DEBUG("Mind WITH amnesia" << endl);
         return true;
@@ -280,10 +291,11 @@ bool Mind::mindAmnesia()
  * Autolinking
  */
 
-void Mind::autolinkUpdate(const std::string& oldName, const std::string& newName) const
+void Mind::autolinkUpdate(const std::string& oldName, const std::string& newName)
 {
 #ifdef MF_MD_2_HTML_CMARK
     autolinking->update(oldName, newName);
+    htmlRepresentation.setAutolinkingGeneration(autolinking->getGeneration());
 #endif
 }
 
@@ -296,6 +308,20 @@ bool Mind::autolinkFindLongestPrefixWord(std::string& s, std::string& r) const
 #endif
 }
 
+void Mind::autolinkFindWholeWords(
+        const std::string& s,
+        const std::string& delimiters,
+        std::vector<AhoCorasick::Match>& matches) const
+{
+#ifdef MF_MD_2_HTML_CMARK
+    autolinking->findWholeWords(s, delimiters, matches);
+#else
+    UNUSED_ARG(s);
+    UNUSED_ARG(delimiters);
+    UNUSED_ARG(matches);
+#endif
+}
+
 /*
  * Remembering
  */
@@ -304,12 +330,16 @@ bool Mind::autolinkFindLongestPrefixWord(std::string& s, std::string& r) const
 void Mind::remember(const std::string& outlineKey)
 {
     memory.remember(outlineKey);
+    if(config.getMindState()==Configuration::MindState::THINKING) {
+        ai->remember(memory.getOutline(outlineKey));
+    }
 
     // TODO onRemembering()
 
 #ifdef MF_MD_2_HTML_CMARK
     if(config.isAutolinking()) {
         autolinking->reindex();
+        htmlRepresentation.setAutolinkingGeneration(autolinking->getGeneration());
     }
 #endif
 }
@@ -317,10 +347,14 @@ void Mind::remember(const std::string& outlineKey)
 void Mind::remember(Outline* outline)
 {
     memory.remember(outline);
+    if(config.getMindState()==Configuration::MindState::THINKING) {
+        ai->remember(outline);
+    }
 
 #ifdef MF_MD_2_HTML_CMARK
     if(config.isAutolinking()) {
         autolinking->reindex();
+        htmlRepresentation.setAutolinkingGeneration(autolinking->getGeneration());
     }
 #endif
 }
@@ -328,16 +362,117 @@ void Mind::remember(Outline* outline)
 void Mind::forget(Outline* outline)
 {
     memory.forget(outline);
+    if(config.getMindState()==Configuration::MindState::THINKING) {
+        ai->forget(outline);
+    }
 
     // TODO onRemembering()
 
 #ifdef MF_MD_2_HTML_CMARK
     if(config.isAutolinking()) {
         autolinking->reindex();
+        htmlRepresentation.setAutolinkingGeneration(autolinking->getGeneration());
+    }
+#endif
+}
+
+
+unsigned Mind::learnRepositoryChanges(RepositoryChanges& changes)
+{
+    changes.rescan = false;
+    changes.outlineKeys.clear();
+
+    if(config.getMindState()==Configuration::MindState::DREAMING || activeProcesses) {
+        // changes are kept by the watcher until Mind can learn them
+        return 0;
+    }
+
+    lock_guard<mutex> criticalSection{exclusiveMind};
+
+    // Os replaced by the previous call are not referenced by the caller anymore
+    memory.deleteReplacedOutlines();
+
+    vector<RepositoryWatcher::Change> watched{};
+    if(!memory.getRepositoryWatcher().poll(watched)) {
+        return 0;
+    }
+
+    if(watched[0].type == RepositoryWatcher::ChangeType::RESCAN) {
+        MF_DEBUG("Watcher: events were lost > repository must be relearned" << endl);
+        changes.rescan = true;
+        return 0;
     }
+
+    RepositoryIndexer& indexer = memory.getRepositoryIndexer();
+    vector<string> removedMarkdowns{};
+    for(const RepositoryWatcher::Change& change:watched) {
+        switch(change.type) {
+        case RepositoryWatcher::ChangeType::UPDATED:
+            if(indexer.addFile(change.path) && relearnChangedOutline(change.path)) {
+                changes.outlineKeys.push_back(change.path);
+            }
+            break;
+        case RepositoryWatcher::ChangeType::REMOVED:
+            indexer.removeFile(change.path);
+            if(relearnChangedOutline(change.path)) {
+                changes.outlineKeys.push_back(change.path);
+            }
+            break;
+        case RepositoryWatcher::ChangeType::DIRECTORY_REMOVED: {
+            removedMarkdowns.clear();
+            indexer.removeDirectory(change.path, removedMarkdowns);
+            // Os created by MindForger might not be indexed > lookup Os by path
+            string prefix{change.path};
+            prefix += FILE_PATH_SEPARATOR;
+            vector<string> keys{};
+            for(Outline* o:memory.getOutlines()) {
+                if(stringStartsWith(o->getKey(), prefix)) {
+                    keys.push_back(o->getKey());
+                }
+            }
+            for(const string& key:keys) {
+                if(relearnChangedOutline(key)) {
+                    changes.outlineKeys.push_back(key);
+                }
+            }
+            break;
+        }
+        case RepositoryWatcher::ChangeType::RESCAN:
+            break;
+        }
+    }
+
+    unsigned count = static_cast<unsigned>(changes.outlineKeys.size());
+    if(count) {
+        onRemembering();
+#ifdef MF_MD_2_HTML_CMARK
+        if(config.isAutolinking()) {
+            autolinking->reindex();
+            htmlRepresentation.setAutolinkingGeneration(autolinking->getGeneration());
+        }
 #endif
+    }
+
+    MF_DEBUG("Watcher: " << count << " Os learned/forgotten" << endl);
+    return count;
 }
 
+bool Mind::relearnChangedOutline(const string& path)
+{
+    Outline* oldOutline = memory.getOutline(path);
+    // old O is kept by memory until the next learning of changes > it's still valid for AI to forget it
+    Outline* outline = memory.relearn(path);
+    if(config.getMindState()==Configuration::MindState::THINKING) {
+        if(oldOutline) {
+            ai->forget(oldOutline);
+        }
+        if(outline) {
+            ai->remember(outline);
+        }
+    }
+
+    return oldOutline || outline;
+}
 
 const vector<Note*>& Mind::getMemoryDwell(int pageSize) const
 {
@@ -383,29 +518,37 @@ void Mind::findNoteFts(
         vector<Note*>* result,
         const string& pattern,
         const FtsSearch searchMode,
-        Outline* outline)
+        Outline* outline,
+        const unordered_set<const Note*>* candidates)
 {
+    // FTS index candidates (if any) - nullptr stands for O's name and description
+    bool doO = candidates==nullptr || candidates->count(nullptr);
+
     // IMPROVE make this faster - do NOT convert to lower case, but compare it in that method > will do less
     // IMPROVE avoid duplicate code - introduce an pre-processing iface (lower/nop) and used one code
     if(searchMode == FtsSearch::IGNORE_CASE) {
         string s{};
-        stringToLower(outline->getName(), s);
-        if(s.find(pattern)!=string::npos) {
-            result->push_back(outline->getOutlineDescriptorAsNote());
-        } else {
-            for(string* d:outline->getDescription()) {
-                if(d) {
-                    s.clear();
-                    stringToLower(*d, s);
-                    if(s.find(pattern)!=string::npos) {
-                        result->push_back(outline->getOutlineDescriptorAsNote());
-                        break;
+        if(doO) {
+            stringToLower(outline->getName(), s);
+            if(s.find(pattern)!=string::npos) {
+                result->push_back(outline->getOutlineDescriptorAsNote());
+            } else {
+                for(string* d:outline->getDescription()) {
+                    if(d) {
+                        s.clear();
+                        stringToLower(*d, s);
+                        if(s.find(pattern)!=string::npos) {
+                            result->push_back(outline->getOutlineDescriptorAsNote());
+                            break;
+                        }
                     }
                 }
             }
         }
         for(Note* note:outline->getNotes()) {
-            if(scopeAspect.isOutOfScope(note)) {
+            if(scopeAspect.isOutOfScope(note)
+               || (candidates && !candidates->count(note)))
+            {
                 continue;
             }
             s.clear();
@@ -426,19 +569,23 @@ void Mind::findNoteFts(
             }
         }
     } else if (searchMode == FtsSearch::EXACT) {
-        if(outline->getName().find(pattern)!=string::npos) {
-            result->push_back(outline->getOutlineDescriptorAsNote());
-        } else {
-            for(string* d:outline->getDescription()) {
-                if(d && d->find(pattern)!=string::npos) {
-                    result->push_back(outline->getOutlineDescriptorAsNote());
-                    // avoid multiple matches in the result
-                    break;
+        if(doO) {
+            if(outline->getName().find(pattern)!=string::npos) {
+                result->push_back(outline->getOutlineDescriptorAsNote());
+            } else {
+                for(string* d:outline->getDescription()) {
+                    if(d && d->find(pattern)!=string::npos) {
+                        result->push_back(outline->getOutlineDescriptorAsNote());
+                        // avoid multiple matches in the result
+                        break;
+                    }
                 }
             }
         }
         for(Note* note:outline->getNotes()) {
-            if(scopeAspect.isOutOfScope(note)) {
+            if(scopeAspect.isOutOfScope(note)
+               || (candidates && !candidates->count(note)))
+            {
                 continue;
             }
             if(note->getName().find(pattern)!=string::npos) {
@@ -456,22 +603,26 @@ void Mind::findNoteFts(
     } else if (searchMode == FtsSearch::REGEXP) {
         std::smatch matchedString;
         std::regex regex{pattern};
-        if(std::regex_search(outline->getName(), matchedString, regex)) {
-            result->push_back(outline->getOutlineDescriptorAsNote());
-        } else {
-            for(string* d:outline->getDescription()) {
-                if(d && std::regex_search(*d, matchedString, regex)) {
-                    result->push_back(outline->getOutlineDescriptorAsNote());
-                    // avoid multiple matches in the result
-                    break;
+        if(doO) {
+            if(std::regex_search(outline->getName(), matchedString, regex)) {
+                result->push_back(outline->getOutlineDescriptorAsNote());
+            } else {
+                for(string* d:outline->getDescription()) {
+                    if(d && std::regex_search(*d, matchedString, regex)) {
+                        result->push_back(outline->getOutlineDescriptorAsNote());
+                        // avoid multiple matches in the result
+                        break;
+                    }
                 }
             }
         }
         for(Note* note:outline->getNotes()) {
-            if(scopeAspect.isOutOfScope(note)) {
+            if(scopeAspect.isOutOfScope(note)
+               || (candidates && !candidates->count(note)))
+            {
                 continue;
             }
-            if(std::regex_search(outline->getName(), matchedString, regex)) {
+            if(std::regex_search(note->getName(), matchedString, regex)) {
                 result->push_back(note);
             } else {
                 for(string* d:note->getDescription()) {
@@ -505,12 +656,33 @@ vector<Note*>* Mind::findNoteFts(const string& pattern, FtsSearch searchMode, Ou
     if(outlineScope) {
         findNoteFts(result, r, searchMode, outlineScope);
     } else {
-        const vector<m8r::Outline*> outlines = memory.getOutlines();
+        // FTS index is a prefilter - it narrows Os/Ns to be matched
+        vector<string> literals{};
+        FtsIndex::Candidates candidates{};
+        bool indexed;
+        if(searchMode == FtsSearch::REGEXP) {
+            // report invalid regexp even if there are no candidates
+            std::regex{pattern};
+            indexed = FtsIndex::regexLiterals(r, literals)
+                && memory.getFtsIndex().findCandidates(literals, candidates);
+        } else {
+            literals.push_back(r);
+            indexed = memory.getFtsIndex().findCandidates(literals, candidates);
+        }
+
+        const vector<m8r::Outline*>& outlines = memory.getOutlines();
         for(Outline* outline:outlines) {
             if(scopeAspect.isOutOfScope(outline)) {
                 continue;
             }
-            findNoteFts(result, r, searchMode, outline);
+            if(indexed) {
+                auto c = candidates.find(outline);
+                if(c != candidates.end()) {
+                    findNoteFts(result, r, searchMode, outline, &c->second);
+                }
+            } else {
+                findNoteFts(result, r, searchMode, outline);
+            }
         }
     }
     return result;
@@ -548,24 +720,38 @@ vector<Note*>* Mind::getRefereeNotes(const Note& note, const Outline& outline) c
 
 void Mind::findNotesByTags(const vector<const Tag*>& tags, vector<Note*>& result) const
 {
-    vector<Note*> allNotes{};
-    memory.getAllNotes(allNotes);
-    for(Note* n:allNotes) {
-        const vector<const Tag*>* thingTags = n->getTags();
-        bool hasAllTags=true;
-        for(size_t i=0; i<tags.size(); i++) {
-            if(std::find(
-                        thingTags->begin(),
-                        thingTags->end(),
-                        tags.at(i)) == thingTags->end())
-            {
-                hasAllTags=false;
-                break;
-            }
-        }
-        if(hasAllTags) {
-            result.push_back(n);
-        }
+    const TagIndex& tagIndex = memory.getTagIndex();
+    TagIndex::Bitset things{};
+    tagIndex.findAll(tags, things);
+    things &= tagIndex.getNotes();
+    // N is in scope regardless of its O (like in Memory::getAllNotes())
+    tagIndex.filterScope(scopeAspect, things, false);
+    if(things.empty()) {
+        return;
+    }
+
+    // ids are recycled > Ns are returned in O/N order
+    unordered_map<const Outline*,size_t> outlineOffsets{};
+    const vector<Outline*>& outlines = memory.getOutlines();
+    for(size_t i=0; i<outlines.size(); i++) {
+        outlineOffsets[outlines[i]] = i;
+    }
+    vector<pair<pair<size_t,int>,Note*>> found{};
+    found.reserve(things.size());
+    things.forEach([&](uint32_t id) {
+        Note* n = tagIndex.getNote(id);
+        found.push_back(make_pair(
+            make_pair(outlineOffsets[n->getOutline()], n->getOutline()->getNoteOffset(n)),
+            n));
+    });
+    std::sort(
+        found.begin(),
+        found.end(),
+        [](const pair<pair<size_t,int>,Note*>& a, const pair<pair<size_t,int>,Note*>& b) { return a.first < b.first; });
+
+    result.reserve(result.size()+found.size());
+    for(const auto& f:found) {
+        result.push_back(f.second);
     }
 }
 
@@ -706,22 +892,27 @@ vector<Note*>* Mind::getNotesOfType(const NoteType& type, const Outline& outline
 
 void Mind::findOutlinesByTags(const std::vector<const Tag*>& tags, std::vector<Outline*>& result) const
 {
-    for(Outline* o:memory.getOutlines()) {
-        bool allMatched = true;
-        for(size_t i=0; i<tags.size(); i++) {
-            if(std::find(
-                        o->getTags()->begin(),
-                        o->getTags()->end(),
-                        tags.at(i)) == o->getTags()->end())
-            {
-                allMatched = false;
-                break;
-            }
-        }
-        if(allMatched) {
-            result.push_back(o);
-        }
+    const TagIndex& tagIndex = memory.getTagIndex();
+    TagIndex::Bitset things{};
+    tagIndex.findAll(tags, things);
+    // Os are NOT filtered by scope (like w/o the index)
+    things &= tagIndex.getOutlines();
+    if(things.empty()) {
+        return;
     }
+
+    // ids are recycled > Os are returned in Memory order
+    unordered_map<const Outline*,size_t> outlineOffsets{};
+    const vector<Outline*>& outlines = memory.getOutlines();
+    for(size_t i=0; i<outlines.size(); i++) {
+        outlineOffsets[outlines[i]] = i;
+    }
+    size_t first = result.size();
+    things.forEach([&](uint32_t id) { result.push_back(tagIndex.getOutline(id)); });
+    std::sort(
+        result.begin()+first,
+        result.end(),
+        [&outlineOffsets](Outline* a, Outline* b) { return outlineOffsets[a] < outlineOffsets[b]; });
 }
 
 vector<Tag*>* Mind::getOutlinesTags() const
@@ -738,46 +929,16 @@ void Mind::getTagsCardinality(map<const Tag*,int>& tagsCardinality)
 {
     if(ontology.getTags().size()) {
         for(const Tag* t:ontology.getTags().values()) {
-            // IMPROVE make NONE exclusion faster (checks in three loops below)
-            if(!stringistring(string("none"), t->getName())) {
-                tagsCardinality[t] = 0;
-            }
+            tagsCardinality[t] = 0;
         }
-        const vector<Outline*>& outlines = memory.getOutlines();
-        bool doO, doN;
-        for(Outline* o:outlines) {
-            doO = false;
-            if(scopeAspect.isEnabled()) {
-                if(scopeAspect.isInScope(o)) {
-                    doO = true;
-                }
+        // cardinalities are maintained by the index (evaluated only if scope is set)
+        memory.getTagIndex().getCardinalities(tagsCardinality, &scopeAspect);
+        // NONE tags are excluded once per tag (not once per Thing)
+        for(auto t=tagsCardinality.begin(); t!=tagsCardinality.end(); ) {
+            if(stringistring(string("none"), t->first->getName())) {
+                t = tagsCardinality.erase(t);
             } else {
-                doO = true;
-            }
-            if(doO) {
-                for(const Tag* ot:*o->getTags()) {
-                    if(!stringistring(string("none"), ot->getName())) {
-                        tagsCardinality[ot] = tagsCardinality[ot]+1;
-                    }
-                }
-
-                doN = false;
-                for(Note* n:o->getNotes()) {
-                    if(scopeAspect.isEnabled()) {
-                        if(scopeAspect.isInScope(n)) {
-                            doN = true;
-                        }
-                    } else {
-                        doN = true;
-                    }
-                    if(doN) {
-                        for(const Tag* nt:*n->getTags()) {
-                            if(!stringistring(string("none"), nt->getName())) {
-                                tagsCardinality[nt] = tagsCardinality[nt]+1;
-                            }
-                        }
-                    }
-                }
+                ++t;
             }
         }
     } else {
@@ -965,6 +1126,8 @@ bool Mind::outlineForget(string outlineKey)
         forget(o);
         auto k = memory.createLimboKey(&o->getName());
         o->setKey(k);
+        // O file must be written before it's moved
+        memory.flush();
         moveFile(outlineKey, k);
         return true;
     }
@@ -1000,7 +1163,9 @@ Outline* Mind::outlinesMapNew(string outlineKey)
         memory.getOntology().getDefaultOutlineType()};
 
     for(Outline* o:getOutlines()) {
-        Note* n = o->getOutlineDescriptorAsNote();
+        // clone O's descriptor as map owns (and deletes) its Ns
+        Note* n = new Note(*o->getOutlineDescriptorAsNote());
+        n->clearLinks();
         newOutlinesMap->addNote(n);
 
         n->addLink(
@@ -1034,11 +1199,12 @@ void Mind::outlinesMapSynchronize(Outline* outlinesMap)
     //   - remove from map: map O NOT in runtime O
     //   - add at the top of map: runtime Os NOT in mapOs
     MF_DEBUG("Map O links validity check:");
-    vector<string> mapOsKeys{};
+    unordered_set<string> mapOsKeys{};
+    mapOsKeys.reserve(outlinesMap->getNotesCount());
     for(Note* n:outlinesMap->getNotes()) {
         Link* oLink = n->getLinkByName(LINK_NAME_OUTLINE_KEY);
         if(oLink) {
-            string oKey{oLink->getUrl()};
+            const string& oKey = oLink->getUrl();
             Outline* o = findOutlineByKey(oKey);
             if(o) {
                 // valid O in MF & map
@@ -1054,7 +1220,7 @@ void Mind::outlinesMapSynchronize(Outline* outlinesMap)
                 n->setModifiedPretty();
                 n->setRead(o->getRead());
                 n->setReadPretty();
-                mapOsKeys.push_back(oKey);
+                mapOsKeys.insert(oKey);
             } else {
                 MF_DEBUG("  INVALID (no O for link): " << n->getName() << endl);
                 osToRemove.push_back(n);
@@ -1067,54 +1233,50 @@ void Mind::outlinesMapSynchronize(Outline* outlinesMap)
     MF_DEBUG("DONE O links validity check" << endl);
 
     if(osToRemove.size()) {
-        MF_DEBUG("Removing Ns with INVALID O key:" << endl);
-        for(auto oToRemove:osToRemove) {
-            MF_DEBUG("  " << oToRemove->getName() << endl);
-            delete oToRemove;
-            outlinesMap->removeNote(oToRemove);
-        }
-        osToRemove.clear();
+        MF_DEBUG("Removing " << osToRemove.size() << " Ns with INVALID O key" << endl);
+        outlinesMap->forgetNotes(osToRemove);
     }
 
     // find mind keys which are NOT in map > prepend them to map
-    vector<Outline*> osToAdd{};
-    MF_DEBUG("Finding mind keys to be ADDED to map:" << endl);
-    for(auto mindO: getOutlines()) {
-        if(find(mapOsKeys.begin(), mapOsKeys.end(), mindO->getKey()) == mapOsKeys.end()) {
-            MF_DEBUG("  " << mindO->getKey() << endl);
+    vector<Note*> mapNotes{};
+    MF_DEBUG("ADDING mind keys to map:" << endl);
+    for(auto o: getOutlines()) {
+        if(!mapOsKeys.count(o->getKey())) {
+            MF_DEBUG("  " << o->getKey() << endl);
 
             // TODO skip keys w/ "," ~ https://github.com/dvorka/mindforger/issues/1518 workaround
             // TODO remove this code once #1518 is fixed
-            if(find(mindO->getKey().begin(), mindO->getKey().end(), ',') == mindO->getKey().end()) {
-                osToAdd.push_back(mindO);
-            } else {
+            if(find(o->getKey().begin(), o->getKey().end(), ',') != o->getKey().end()) {
                 MF_DEBUG("    SKIPPING key w/ ','" << endl);
                 continue;
             }
 
-        }
-    }
-    MF_DEBUG("ADDING mind keys to map:" << endl);
-    for(auto o:osToAdd) {
-        MF_DEBUG("  " << o->getKey() << endl);
-        // clone O's descriptor to get N which might be deleted later
-        Note* n = new Note(*o->getOutlineDescriptorAsNote());
+            // clone O's descriptor to get N which might be deleted later
+            Note* n = new Note(*o->getOutlineDescriptorAsNote());
+            n->setOutline(outlinesMap);
 
-        n->clearLinks();
-        n->addLink(
-            new Link{
-                LINK_NAME_OUTLINE_KEY,
-                o->getKey()
-            }
-        );
-        n->addLink(
-            new Link{
-                LINK_NAME_OUTLINE_PATH,
-                Mind::outlineMapKey2Relative(o->getKey())
-            }
-        );
+            n->clearLinks();
+            n->addLink(
+                new Link{
+                    LINK_NAME_OUTLINE_KEY,
+                    o->getKey()
+                }
+            );
+            n->addLink(
+                new Link{
+                    LINK_NAME_OUTLINE_PATH,
+                    Mind::outlineMapKey2Relative(o->getKey())
+                }
+            );
 
-        outlinesMap->addNote(n , 0);
+            mapNotes.push_back(n);
+        }
+    }
+    if(mapNotes.size()) {
+        // Ns are prepended one by one i.e. the last added N is the first one in map
+        std::reverse(mapNotes.begin(), mapNotes.end());
+        mapNotes.insert(mapNotes.end(), outlinesMap->getNotes().begin(), outlinesMap->getNotes().end());
+        outlinesMap->setNotes(mapNotes);
     }
 }
 
@@ -1165,13 +1327,8 @@ Outline* Mind::outlinesMapLearn(string outlineKey)
     }
 
     if(osToRemove.size()) {
-        MF_DEBUG("Removing Ns with MISSING relative O key:" << endl);
-        for(auto oToRemove:osToRemove) {
-            MF_DEBUG("  " << oToRemove->getName() << endl);
-            delete oToRemove;
-            outlinesMap->removeNote(oToRemove);
-        }
-        osToRemove.clear();
+        MF_DEBUG("Removing " << osToRemove.size() << " Ns with MISSING relative O key" << endl);
+        outlinesMap->forgetNotes(osToRemove);
     }
 
     // synchronize map's Os with mind's Os
@@ -1250,6 +1407,8 @@ Note* Mind::noteNew(
         n->setModifiedPretty();
 
         o->addNote(n, NO_PARENT==offset?0:offset);
+        // N is counted/tagged before O is remembered
+        memory.reindex(o);
         return n;
     } else {
         throw MindForgerException("Outline for given key not found!");
@@ -1260,7 +1419,9 @@ Note* Mind::noteClone(const string& outlineKey, const Note* newNote, const bool
 {
     Outline* o = memory.getOutline(outlineKey);
     if(o) {
-        return o->cloneNote(newNote, deep);
+        Note* n = o->cloneNote(newNote, deep);
+        memory.reindex(o);
+        return n;
     } else {
         throw MindForgerException("Outline for given key not found!");
     }
@@ -1301,6 +1462,11 @@ Outline* Mind::noteForget(Note* note)
         deleteWatermark++;
 
         note->getOutline()->forgetNote(note);
+        // N and its children are deleted > drop them from Memory indices and AI
+        memory.reindex(o);
+        if(config.getMindState()==Configuration::MindState::THINKING) {
+            ai->remember(o);
+        }
         return o;
     } else {
         throw MindForgerException("Unable find Outline from which should be the Note deleted!");
@@ -1353,6 +1519,7 @@ void Mind::noteOnRename(const std::string& oldName, const std::string& newName)
 {
 #ifdef MF_MD_2_HTML_CMARK
     autolinking->update(oldName, newName);
+    htmlRepresentation.setAutolinkingGeneration(autolinking->getGeneration());
 #endif
 }
 
@@ -1363,7 +1530,22 @@ void Mind::onRemembering()
 
 MindStatistics* Mind::getStatistics()
 {
-    // IMPROVE cache it until memory is dirty
+    if(!scopeAspect.isEnabled()) {
+        // statistics are maintained by memory
+        const MemoryStatistics& memoryStatistics = memory.getStatistics();
+        stats->mostReadOutline = memoryStatistics.getMostReadOutline();
+        stats->mostWrittenOutline = memoryStatistics.getMostWrittenOutline();
+        stats->mostReadNote = memoryStatistics.getMostReadNote();
+        stats->mostWrittenNote = memoryStatistics.getMostWrittenNote();
+        stats->mostUsedTag = memoryStatistics.getMostUsedTag();
+        return stats;
+    }
+
+    // IMPROVE maintain scoped statistics
+    stats->mostReadOutline = nullptr;
+    stats->mostWrittenOutline = nullptr;
+    stats->mostReadNote = nullptr;
+    stats->mostWrittenNote = nullptr;
     const vector<Outline*>&os = memory.getOutlines();
     if(os.size()) {
         u_int32_t maxReads=0;
@@ -1425,14 +1607,11 @@ MindStatistics* Mind::getStatistics()
 unique_ptr<vector<Outline*>> Mind::findOutlineByNameFts(const string& pattern) const
 {
     // IMPROVE implement regexp and other search options by reusing HSTR code
-    // IMPROVE PERF this method is extremely inefficient > use cached map (stack member) evicted on memory modification
     unique_ptr<vector<Outline*>> result{new vector<Outline*>()};
     if(pattern.size()) {
-        vector<Outline*> outlines = memory.getOutlines();
-        for(Outline* outline:outlines) {
-            if(!pattern.compare(outline->getName())) {
-                result->push_back(outline);
-            }
+        const vector<Outline*>* outlines = memory.findOutlinesByName(pattern);
+        if(outlines) {
+            result->assign(outlines->begin(), outlines->end());
         }
     }
     return result;
@@ -1441,12 +1620,7 @@ unique_ptr<vector<Outline*>> Mind::findOutlineByNameFts(const string& pattern) c
 Outline* Mind::findOutlineByKey(const string& key) const
 {
     if(key.size()) {
-        vector<Outline*> outlines = memory.getOutlines();
-        for(Outline* outline:outlines) {
-            if(key.compare(outline->getKey()) == 0) {
-                return outline;
-            }
-        }
+        return memory.getOutline(key);
     }
 
     return nullptr;
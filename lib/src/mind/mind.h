@@ -23,6 +23,7 @@
 #include <memory>
 #include <mutex>
 #include <regex>
+#include <unordered_set>
 #include <vector>
 
 #include "memory.h"
@@ -34,6 +35,8 @@
 #include "associated_notes.h"
 #include "ontology/thing_class_rel_triple.h"
 #include "aspect/mind_scope_aspect.h"
+#include "../gear/aho_corasick.h"
+#include "../gear/task_scheduler.h"
 #include "../config/configuration.h"
 #include "../representations/representation_interceptor.h"
 #include "../representations/markdown/markdown_configuration_representation.h"
@@ -258,6 +261,11 @@ private:
      */
     MindScopeAspect scopeAspect;
 
+    /**
+     * @brief Scheduler of background Mind tasks (AI dreaming, leaderboards, ...).
+     */
+    TaskScheduler scheduler;
+
 public:
     explicit Mind(Configuration &config);
     Mind() = delete;
@@ -326,8 +334,12 @@ public:
      * Autolinking
      */
 
-    void autolinkUpdate(const std::string& oldName, const std::string& newName) const;
+    void autolinkUpdate(const std::string& oldName, const std::string& newName);
     bool autolinkFindLongestPrefixWord(std::string& s, std::string& r) const;
+    void autolinkFindWholeWords(
+            const std::string& s,
+            const std::string& delimiters,
+            std::vector<AhoCorasick::Match>& matches) const;
 
     /*
      * Knowledge graph
@@ -361,6 +373,35 @@ public:
      */
     void forget(Outline* outline);
 
+    /**
+     * @brief Os changed outside of MindForger which were learned by Mind.
+     */
+    struct RepositoryChanges {
+        // watcher lost events - caller must learn() the whole repository
+        bool rescan;
+        // keys of (re)learned and forgotten Os
+        std::vector<std::string> outlineKeys;
+
+        RepositoryChanges() : rescan{false}, outlineKeys{} {}
+    };
+
+    /**
+     * @brief Learn Os changed outside of MindForger (git pull, sync, other editors).
+     *
+     * Changes reported by repository watcher are translated to (re)learning
+     * and forgetting of particular Os. Method is expected to be called
+     * periodically:
+     *
+     * - Previous versions of (re)learned/forgotten Os are deleted on the
+     *   next call, therefore caller must stop referencing them (e.g. views
+     *   must be refreshed w/ Os of changed keys) before the next call.
+     * - Repository is NOT relearned by the method if the watcher lost events
+     *   as it deletes all Os - caller must learn() it and refresh views.
+     *
+     * @return Number of (re)learned and forgotten Os.
+     */
+    unsigned learnRepositoryChanges(RepositoryChanges& changes);
+
     /**
      * @brief Get ontology.
      */
@@ -408,6 +449,8 @@ public:
     // composite mind scope aspect
     MindScopeAspect& getScopeAspect() { return scopeAspect; }
 
+    TaskScheduler& getScheduler() { return scheduler; }
+
     /*
      * (CROSS) REFERENCES - explicit associations created by the user.
      */
@@ -729,11 +772,17 @@ private:
      */
     void onRemembering();
 
+    /**
+     * @brief Relearn O from file changed outside of MindForger (or forget it if it was removed or it's not an O anymore).
+     */
+    bool relearnChangedOutline(const std::string& path);
+
     void findNoteFts(
             std::vector<Note*>* result,
             const std::string& pattern,
             const FtsSearch searchMode,
-            Outline* outline);
+            Outline* outline,
+            const std::unordered_set<const Note*>* candidates=nullptr);
 };
 
 } /* namespace */
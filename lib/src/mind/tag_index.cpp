@@ -0,0 +1,325 @@
+/*
+ tag_index.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "tag_index.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace m8r {
+
+/*
+ * Bitset
+ */
+
+vector<TagIndex::Bitset::Word>::iterator TagIndex::Bitset::find(uint32_t index)
+{
+    return std::lower_bound(
+        words.begin(),
+        words.end(),
+        index,
+        [](const Word& w, uint32_t i) { return w.index < i; });
+}
+
+vector<TagIndex::Bitset::Word>::const_iterator TagIndex::Bitset::find(uint32_t index) const
+{
+    return std::lower_bound(
+        words.begin(),
+        words.end(),
+        index,
+        [](const Word& w, uint32_t i) { return w.index < i; });
+}
+
+void TagIndex::Bitset::set(uint32_t id)
+{
+    uint32_t index = id/64;
+    uint64_t bit = static_cast<uint64_t>(1) << (id%64);
+    // IDs are mostly growing > append is the common case
+    if(words.empty() || words.back().index < index) {
+        words.push_back(Word{index, bit});
+        count++;
+        return;
+    }
+    auto w = find(index);
+    if(w != words.end() && w->index == index) {
+        if(!(w->bits & bit)) {
+            w->bits |= bit;
+            count++;
+        }
+    } else {
+        words.insert(w, Word{index, bit});
+        count++;
+    }
+}
+
+void TagIndex::Bitset::reset(uint32_t id)
+{
+    uint32_t index = id/64;
+    uint64_t bit = static_cast<uint64_t>(1) << (id%64);
+    auto w = find(index);
+    if(w != words.end() && w->index == index && (w->bits & bit)) {
+        w->bits &= ~bit;
+        count--;
+        if(!w->bits) {
+            words.erase(w);
+        }
+    }
+}
+
+bool TagIndex::Bitset::test(uint32_t id) const
+{
+    uint32_t index = id/64;
+    auto w = find(index);
+    return w != words.end() && w->index == index && (w->bits & (static_cast<uint64_t>(1) << (id%64)));
+}
+
+TagIndex::Bitset& TagIndex::Bitset::operator&=(const Bitset& other)
+{
+    size_t r=0;
+    count = 0;
+    auto o = other.words.begin();
+    for(size_t i=0; i<words.size() && o!=other.words.end(); ) {
+        if(words[i].index < o->index) {
+            i++;
+        } else if(o->index < words[i].index) {
+            o++;
+        } else {
+            uint64_t bits = words[i].bits & o->bits;
+            if(bits) {
+                words[r++] = Word{words[i].index, bits};
+                count += std::bitset<64>(bits).count();
+            }
+            i++;
+            o++;
+        }
+    }
+    words.resize(r);
+    return *this;
+}
+
+TagIndex::Bitset& TagIndex::Bitset::operator|=(const Bitset& other)
+{
+    if(other.words.empty()) {
+        return *this;
+    }
+
+    vector<Word> merged{};
+    merged.reserve(words.size()+other.words.size());
+    count = 0;
+    auto w = words.begin();
+    auto o = other.words.begin();
+    while(w!=words.end() || o!=other.words.end()) {
+        if(o==other.words.end() || (w!=words.end() && w->index < o->index)) {
+            merged.push_back(*w++);
+        } else if(w==words.end() || o->index < w->index) {
+            merged.push_back(*o++);
+        } else {
+            merged.push_back(Word{w->index, w->bits | o->bits});
+            w++;
+            o++;
+        }
+        count += std::bitset<64>(merged.back().bits).count();
+    }
+    words.swap(merged);
+    return *this;
+}
+
+/*
+ * Index
+ */
+
+TagIndex::TagIndex()
+    : things{},
+      freeIds{},
+      outlineThings{},
+      postings{},
+      outlines{},
+      notes{}
+{
+}
+
+TagIndex::~TagIndex()
+{
+}
+
+void TagIndex::clear()
+{
+    things.clear();
+    freeIds.clear();
+    outlineThings.clear();
+    postings.clear();
+    outlines.clear();
+    notes.clear();
+}
+
+void TagIndex::addThing(const Outline* outline, const Note* note, const vector<const Tag*>* tags)
+{
+    uint32_t id;
+    if(freeIds.size()) {
+        // recycled IDs keep bitsets dense
+        id = freeIds.back();
+        freeIds.pop_back();
+    } else {
+        id = static_cast<uint32_t>(things.size());
+        things.push_back(Thing{});
+    }
+
+    Thing& thing = things[id];
+    thing.outline = outline;
+    thing.note = note;
+    if(tags) {
+        thing.tags = *tags;
+    } else {
+        thing.tags.clear();
+    }
+
+    outlineThings[outline].push_back(id);
+    (note ? notes : outlines).set(id);
+    for(const Tag* t:thing.tags) {
+        postings[t].set(id);
+    }
+}
+
+void TagIndex::index(const Outline* outline)
+{
+    if(!outline) {
+        return;
+    }
+
+    forget(outline);
+
+    addThing(outline, nullptr, outline->getTags());
+    for(Note* n:outline->getNotes()) {
+        addThing(outline, n, n->getTags());
+    }
+}
+
+void TagIndex::forget(const Outline* outline)
+{
+    auto entry = outlineThings.find(outline);
+    if(entry != outlineThings.end()) {
+        // descending IDs are recycled first, therefore reindexed O gets its IDs back
+        for(auto id=entry->second.rbegin(); id!=entry->second.rend(); ++id) {
+            Thing& thing = things[*id];
+            for(const Tag* t:thing.tags) {
+                auto posting = postings.find(t);
+                if(posting != postings.end()) {
+                    posting->second.reset(*id);
+                    if(posting->second.empty()) {
+                        postings.erase(posting);
+                    }
+                }
+            }
+            (thing.note ? notes : outlines).reset(*id);
+            thing.outline = nullptr;
+            thing.note = nullptr;
+            thing.tags.clear();
+            freeIds.push_back(*id);
+        }
+        outlineThings.erase(entry);
+    }
+}
+
+void TagIndex::findAll(const vector<const Tag*>& tags, Bitset& result) const
+{
+    result.clear();
+    if(tags.empty()) {
+        result |= outlines;
+        result |= notes;
+        return;
+    }
+
+    vector<const Bitset*> tagPostings{};
+    for(const Tag* t:tags) {
+        auto posting = postings.find(t);
+        if(posting == postings.end()) {
+            return;
+        }
+        tagPostings.push_back(&posting->second);
+    }
+    // the smallest posting first to keep intermediate results small
+    std::sort(
+        tagPostings.begin(),
+        tagPostings.end(),
+        [](const Bitset* a, const Bitset* b) { return a->size() < b->size(); });
+    result |= *tagPostings[0];
+    for(size_t i=1; i<tagPostings.size() && !result.empty(); i++) {
+        result &= *tagPostings[i];
+    }
+}
+
+void TagIndex::findAny(const vector<const Tag*>& tags, Bitset& result) const
+{
+    result.clear();
+    for(const Tag* t:tags) {
+        auto posting = postings.find(t);
+        if(posting != postings.end()) {
+            result |= posting->second;
+        }
+    }
+}
+
+void TagIndex::filterScope(const MindScopeAspect& scope, Bitset& result, bool outlineScope) const
+{
+    if(!scope.isEnabled()) {
+        return;
+    }
+
+    Bitset inScope{};
+    result.forEach([&](uint32_t id) {
+        const Thing& thing = things[id];
+        if(thing.note
+             ? (scope.isInScope(thing.note) && (!outlineScope || scope.isInScope(thing.outline)))
+             : scope.isInScope(thing.outline))
+        {
+            inScope.set(id);
+        }
+    });
+    result = std::move(inScope);
+}
+
+size_t TagIndex::getCardinality(const Tag* tag) const
+{
+    auto posting = postings.find(tag);
+    return posting == postings.end() ? 0 : posting->second.size();
+}
+
+void TagIndex::getCardinalities(map<const Tag*,int>& cardinalities, const MindScopeAspect* scope) const
+{
+    if(scope && scope->isEnabled()) {
+        // scope is evaluated once per Thing, not once per posting
+        Bitset inScope{};
+        inScope |= outlines;
+        inScope |= notes;
+        filterScope(*scope, inScope);
+        Bitset posting{};
+        for(const auto& p:postings) {
+            posting.clear();
+            posting |= p.second;
+            posting &= inScope;
+            cardinalities[p.first] = static_cast<int>(posting.size());
+        }
+    } else {
+        for(const auto& p:postings) {
+            cardinalities[p.first] = static_cast<int>(p.second.size());
+        }
+    }
+}
+
+} // m8r namespace
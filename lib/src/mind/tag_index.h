@@ -0,0 +1,171 @@
+/*
+ tag_index.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_TAG_INDEX_H
+#define M8R_TAG_INDEX_H
+
+#include <bitset>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "../model/outline.h"
+#include "../model/note.h"
+#include "../model/tag.h"
+#include "aspect/mind_scope_aspect.h"
+
+namespace m8r {
+
+/**
+ * @brief Tag inverted index.
+ *
+ * Every Thing (O or N) gets a dense ID and every tag a posting of IDs
+ * of Things tagged by it. Postings are compressed bitsets, therefore
+ * AND/OR tag queries are bitset intersections/unions and tag cardinality
+ * is a lookup.
+ *
+ * Index is incremental - (re)indexing or forgetting an O removes its
+ * Things from postings and recycles their IDs. Tags of indexed Things
+ * are kept by the index, so old Ns are NOT dereferenced and it is safe
+ * to reindex O after its Ns were deleted.
+ */
+class TagIndex
+{
+public:
+    /**
+     * @brief Compressed bitset - only non-zero 64b words are stored.
+     */
+    class Bitset
+    {
+        struct Word {
+            uint32_t index;
+            uint64_t bits;
+        };
+
+        // sorted by index
+        std::vector<Word> words;
+        size_t count;
+
+    public:
+        explicit Bitset() : words{}, count{0} {}
+
+        void set(uint32_t id);
+        void reset(uint32_t id);
+        bool test(uint32_t id) const;
+        void clear() { words.clear(); count = 0; }
+
+        /**
+         * @brief Number of set bits.
+         */
+        size_t size() const { return count; }
+        bool empty() const { return !count; }
+
+        Bitset& operator&=(const Bitset& other);
+        Bitset& operator|=(const Bitset& other);
+
+        template<typename F> void forEach(F f) const {
+            for(const Word& w:words) {
+                uint64_t bits = w.bits;
+                while(bits) {
+                    uint64_t lowest = bits & (~bits+1);
+                    f(w.index*64 + static_cast<uint32_t>(std::bitset<64>(lowest-1).count()));
+                    bits ^= lowest;
+                }
+            }
+        }
+
+    private:
+        std::vector<Word>::iterator find(uint32_t index);
+        std::vector<Word>::const_iterator find(uint32_t index) const;
+    };
+
+private:
+    /**
+     * @brief Indexed Thing - outline==nullptr indicates recycled ID.
+     */
+    struct Thing {
+        const Outline* outline;
+        const Note* note;
+        std::vector<const Tag*> tags;
+    };
+
+    std::vector<Thing> things;
+    std::vector<uint32_t> freeIds;
+    std::unordered_map<const Outline*,std::vector<uint32_t>> outlineThings;
+    std::unordered_map<const Tag*,Bitset> postings;
+    Bitset outlines;
+    Bitset notes;
+
+public:
+    explicit TagIndex();
+    TagIndex(const TagIndex&) = delete;
+    TagIndex(const TagIndex&&) = delete;
+    TagIndex& operator=(const TagIndex&) = delete;
+    TagIndex& operator=(const TagIndex&&) = delete;
+    ~TagIndex();
+
+    void clear();
+
+    /**
+     * @brief Index O and its Ns - O's Things from previous indexation are removed.
+     */
+    void index(const Outline* outline);
+
+    /**
+     * @brief Remove O and its Ns from the index.
+     */
+    void forget(const Outline* outline);
+
+    /**
+     * @brief Find Things tagged by ALL given tags (all Things if no tag is given).
+     */
+    void findAll(const std::vector<const Tag*>& tags, Bitset& result) const;
+    /**
+     * @brief Find Things tagged by ANY of given tags.
+     */
+    void findAny(const std::vector<const Tag*>& tags, Bitset& result) const;
+
+    /**
+     * @brief Keep Things in scope - N is in scope if N (and its O if outlineScope) is in scope.
+     */
+    void filterScope(const MindScopeAspect& scope, Bitset& result, bool outlineScope=true) const;
+
+    const Bitset& getOutlines() const { return outlines; }
+    const Bitset& getNotes() const { return notes; }
+    Outline* getOutline(uint32_t id) const { return const_cast<Outline*>(things[id].outline); }
+    Note* getNote(uint32_t id) const { return const_cast<Note*>(things[id].note); }
+
+    /**
+     * @brief Get the number of Things tagged by the tag.
+     */
+    size_t getCardinality(const Tag* tag) const;
+    /**
+     * @brief Get cardinality of every used tag (only Things in scope are counted if scope is given).
+     */
+    void getCardinalities(std::map<const Tag*,int>& cardinalities, const MindScopeAspect* scope=nullptr) const;
+
+    size_t getThingsCount() const { return outlines.size() + notes.size(); }
+    size_t getTagsCount() const { return postings.size(); }
+
+private:
+    void addThing(const Outline* outline, const Note* note, const std::vector<const Tag*>* tags);
+};
+
+}
+#endif // M8R_TAG_INDEX_H
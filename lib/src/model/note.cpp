@@ -86,6 +86,14 @@ Note::~Note()
     }
 }
 
+void Note::setName(const string& name)
+{
+    ThingInTime::setName(name);
+    if(outline) {
+        outline->invalidateNoteNames();
+    }
+}
+
 string Note::getMangledName() const
 {
     string result = name;
@@ -132,6 +140,9 @@ u_int16_t Note::getDepth() const
 void Note::setDepth(u_int16_t depth)
 {
     this->depth = depth;
+    if(outline) {
+        outline->invalidateNoteStructure();
+    }
 }
 
 void Note::makeModified()
@@ -157,12 +168,15 @@ void Note::setModified(time_t modified)
 
 const string& Note::getModifiedPretty() const
 {
+    if(modifiedPretty.empty()) {
+        modifiedPretty = datetimeToPrettyHtml(modified);
+    }
     return modifiedPretty;
 }
 
 void Note::setModifiedPretty()
 {
-    this->modifiedPretty = datetimeToPrettyHtml(modified);
+    this->modifiedPretty.clear();
 }
 
 void Note::setModifiedPretty(const string& modifiedPretty)
@@ -172,12 +186,15 @@ void Note::setModifiedPretty(const string& modifiedPretty)
 
 const string& Note::getReadPretty() const
 {
+    if(readPretty.empty()) {
+        readPretty = datetimeToPrettyHtml(read);
+    }
     return readPretty;
 }
 
 void Note::setReadPretty()
 {
-    this->readPretty = datetimeToPrettyHtml(read);
+    this->readPretty.clear();
 }
 
 void Note::setReadPretty(const string& readPretty)
@@ -476,11 +493,17 @@ Link* Note::getLinkByName(const string& name) const
 void Note::demote()
 {
     depth++;
+    if(outline) {
+        outline->invalidateNoteStructure();
+    }
 }
 
 void Note::promote()
 {
     if(depth) depth--;
+    if(outline) {
+        outline->invalidateNoteStructure();
+    }
 }
 
 void Note::makeDirty()
@@ -72,9 +72,10 @@ private:
     const NoteType* type;
     std::vector<std::string*> description;
 
-    std::string modifiedPretty;
+    // pretty HTML timestamps are calculated lazily when needed (empty ~ not calculated)
+    mutable std::string modifiedPretty;
     u_int32_t revision;
-    std::string readPretty;
+    mutable std::string readPretty;
     u_int32_t reads;
 
     u_int8_t progress;
@@ -100,6 +101,10 @@ public:
     void checkAndFixProperties();
 
     virtual std::string& getKey() override;
+    /**
+     * @brief Set name and invalidate N name indices of the O.
+     */
+    virtual void setName(const std::string& name) override;
 
     /**
      * @brief Return GitHub compatible mangled name to ensure compatiblity between GitHub and MindForger # links.
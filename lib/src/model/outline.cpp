@@ -18,6 +18,8 @@
  */
 #include "outline.h"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace m8r {
@@ -77,6 +79,11 @@ Outline::Outline(const OutlineType* type)
       progress{},
       notes{},
       outlineDescriptorAsNote{new Note(&NOTE_4_OUTLINE_TYPE, this)},
+      noteNames{},
+      noteMangledNames{},
+      noteNamesIndexed{false},
+      noteStructure{},
+      noteStructureIndexed{false},
       bytesize{},
       dirty{false},
       readOnly{false},
@@ -135,6 +142,11 @@ Outline::Outline(const Outline& o)
       progress{},
       notes{},
       outlineDescriptorAsNote{},
+      noteNames{},
+      noteMangledNames{},
+      noteNamesIndexed{false},
+      noteStructure{},
+      noteStructureIndexed{false},
       bytesize{},
       dirty{},
       readOnly{},
@@ -302,7 +314,7 @@ void Outline::notifyChange(Note* note)
     revision++;
 
     note->setModified(modified);
-    note->setModifiedPretty(datetimeToPrettyHtml(modified));
+    note->setModifiedPretty();
     note->incRevision();
 }
 
@@ -365,12 +377,15 @@ void Outline::makeModified()
 
 const string& Outline::getModifiedPretty() const
 {
+    if(modifiedPretty.empty()) {
+        modifiedPretty = datetimeToPrettyHtml(modified);
+    }
     return modifiedPretty;
 }
 
 void Outline::setModifiedPretty()
 {
-    this->modifiedPretty = datetimeToPrettyHtml(modified);
+    this->modifiedPretty.clear();
 }
 
 void Outline::setModifiedPretty(const string& modifiedPretty)
@@ -391,11 +406,15 @@ size_t Outline::getNotesCount() const
 void Outline::setNotes(const vector<Note*>& notes)
 {
     this->notes = notes;
+    invalidateNoteNames();
+    invalidateNoteStructure();
 }
 
 void Outline::sortNotesByRead()
 {
     Outline::sortByRead(this->notes);
+    invalidateNoteNames();
+    invalidateNoteStructure();
 }
 
 int8_t Outline::getProgress() const
@@ -526,8 +545,7 @@ Note* Outline::cloneNote(const Note* clonedNote, const bool deep)
                 for(Note* n:children) {
                     newNote = new Note(*n);
                     resetClonedNote(newNote);
-                    newNote->setOutline(this);
-                    notes.push_back(newNote);
+                    addNote(newNote);
                 }
             }
         }
@@ -545,18 +563,27 @@ Note* Outline::cloneNote(const Note* clonedNote, const bool deep)
 
 void Outline::addNote(Note* note)
 {
+    invalidateNoteNames();
     note->setOutline(this);
     notes.push_back(note);
+    if(noteStructureIndexed) {
+        indexInsertedNote(notes.size()-1);
+    }
 }
 
 void Outline::addNote(Note* note, int offset)
 {
+    invalidateNoteNames();
     note->setOutline(this);
     if(static_cast<unsigned int>(offset) > notes.size()-1) {
+        offset = notes.size();
         notes.push_back(note);
     } else {
         notes.insert(notes.begin()+offset, note);
     }
+    if(noteStructureIndexed) {
+        indexInsertedNote(offset);
+    }
 }
 
 void Outline::addNotes(std::vector<Note*>& notesToAdd, int offset)
@@ -569,8 +596,28 @@ void Outline::addNotes(std::vector<Note*>& notesToAdd, int offset)
     }
 }
 
+void Outline::indexNoteNames() const
+{
+    if(!noteNamesIndexed) {
+        noteNames.clear();
+        noteMangledNames.clear();
+        for(Note* n:notes) {
+            // emplace() keeps the first N w/ the name
+            noteNames.emplace(n->getName(), n);
+            noteMangledNames.emplace(n->getMangledName(), n);
+        }
+        noteNamesIndexed = true;
+    }
+}
+
 Note* Outline::getNoteByName(const std::string& noteName) const
 {
+    indexNoteNames();
+    auto n = noteNames.find(noteName);
+    if(n != noteNames.end()) {
+        return n->second;
+    }
+
     for(Note* n:notes) {
         if(n->getName().find(noteName) != string::npos) {
             return n;
@@ -581,62 +628,242 @@ Note* Outline::getNoteByName(const std::string& noteName) const
 
 Note* Outline::getNoteByMangledName(const std::string& mangledName) const
 {
-    for(Note* n:notes) {
-        if(!n->getMangledName().compare(mangledName)) {
-            return n;
+    indexNoteNames();
+    auto n = noteMangledNames.find(mangledName);
+    return n == noteMangledNames.end() ? nullptr : n->second;
+}
+
+void Outline::indexNoteStructure() const
+{
+    if(!noteStructureIndexed) {
+        noteStructure.clear();
+        noteStructure.reserve(notes.size());
+
+        // ancestors of the current N w/ their last child so far
+        vector<pair<Note*,Note*>> ancestors{};
+        Note* lastTopLevel{nullptr};
+        for(size_t i=0; i<notes.size(); i++) {
+            Note* n = notes[i];
+            while(!ancestors.empty() && ancestors.back().first->getDepth() >= n->getDepth()) {
+                NoteStructure& a = noteStructure[ancestors.back().first];
+                a.descendants = static_cast<unsigned>(i - a.offset - 1);
+                ancestors.pop_back();
+            }
+
+            Note* parent = ancestors.empty() ? nullptr : ancestors.back().first;
+            Note*& previous = ancestors.empty() ? lastTopLevel : ancestors.back().second;
+            if(previous) {
+                noteStructure[previous].next = n;
+            }
+            noteStructure[n] = NoteStructure{static_cast<int>(i), 0, parent, previous, nullptr};
+            previous = n;
+
+            ancestors.push_back(make_pair(n, nullptr));
+        }
+        for(auto& a:ancestors) {
+            NoteStructure& s = noteStructure[a.first];
+            s.descendants = static_cast<unsigned>(notes.size() - s.offset - 1);
         }
+
+        noteStructureIndexed = true;
     }
-    return nullptr;
 }
 
-int Outline::getNoteOffset(const Note* note) const
+const Outline::NoteStructure* Outline::getNoteStructure(const Note* note) const
 {
-    if(!notes.empty()) {
-        if(notes.size()==1) {
-            return 0;
-        } else {
-            // IMPROVE this is SLOW O(n) - consider keeping order of N within it as a field
-            auto it = std::find(notes.begin(), notes.end(), note);
-            if(it != notes.end()) {
-                return std::distance(notes.begin(), it);
-            }
+    indexNoteStructure();
+    auto s = noteStructure.find(note);
+    return s == noteStructure.end() ? nullptr : &s->second;
+}
+
+void Outline::indexInsertedNote(size_t offset)
+{
+    Note* note = notes[offset];
+    for(size_t i=offset+1; i<notes.size(); i++) {
+        noteStructure[notes[i]].offset = static_cast<int>(i);
+    }
+
+    // Ns above N w/o lower depth end their subtrees above N > they lose children below N
+    Note* parent = offset ? notes[offset-1] : nullptr;
+    Note* previous{nullptr};
+    while(parent && parent->getDepth() >= note->getDepth()) {
+        NoteStructure& p = noteStructure[parent];
+        p.descendants = static_cast<unsigned>(offset - p.offset - 1);
+        if(previous) {
+            noteStructure[previous].next = nullptr;
+        }
+        previous = parent;
+        parent = p.parent;
+    }
+    for(Note* a=parent; a; a=noteStructure[a].parent) {
+        noteStructure[a].descendants++;
+    }
+
+    // Ns below N w/ greater depth become N's descendants
+    NoteStructure s{static_cast<int>(offset), 0, parent, previous, nullptr};
+    Note* child{nullptr};
+    size_t i = offset+1;
+    while(i<notes.size() && notes[i]->getDepth() > note->getDepth()) {
+        NoteStructure& c = noteStructure[notes[i]];
+        c.parent = note;
+        c.previous = child;
+        if(child) {
+            noteStructure[child].next = notes[i];
         }
+        child = notes[i];
+        i += c.descendants+1;
+    }
+    if(child) {
+        noteStructure[child].next = nullptr;
+    }
+    s.descendants = static_cast<unsigned>(i - offset - 1);
+
+    if(previous) {
+        noteStructure[previous].next = note;
+    }
+    if(i<notes.size() && noteStructure[notes[i]].parent == parent) {
+        s.next = notes[i];
+        noteStructure[notes[i]].previous = note;
     }
-    return -1;
+    noteStructure[note] = s;
 }
 
-void Outline::getDirectNoteChildren(vector<Note*>& directChildren)
+void Outline::unindexNoteSubtree(size_t offset)
 {
-    if(notes.size()) {
-        // child depth is initialized to a big nuber
-        //  +
-        // any non-monotonous non-growing depth is detected as direct child
-        u_int16_t minDepth = static_cast<u_int16_t>(1 << 15);
-        for(Note* n:notes) {
-            if(minDepth >= n->getDepth()) {
-                directChildren.push_back(n);
-                minDepth = n->getDepth();
-            }
+    // offsets of Ns below the subtree are NOT updated
+    NoteStructure s = noteStructure[notes[offset]];
+    if(s.previous) {
+        noteStructure[s.previous].next = s.next;
+    }
+    if(s.next) {
+        noteStructure[s.next].previous = s.previous;
+    }
+    for(Note* a=s.parent; a; a=noteStructure[a].parent) {
+        noteStructure[a].descendants -= s.descendants+1;
+    }
+    for(size_t i=offset; i<=offset+s.descendants; i++) {
+        noteStructure.erase(notes[i]);
+    }
+}
+
+void Outline::indexPromotedNote(Note* note)
+{
+    NoteStructure& s = noteStructure[note];
+
+    // last direct child of N
+    Note* child = s.descendants ? notes[s.offset+s.descendants] : nullptr;
+    while(child && noteStructure[child].parent != note) {
+        child = noteStructure[child].parent;
+    }
+
+    // siblings below N w/ the original depth of N become N's children
+    Note* sibling = s.next;
+    while(sibling && sibling->getDepth() > note->getDepth()) {
+        NoteStructure& c = noteStructure[sibling];
+        c.parent = note;
+        c.previous = child;
+        if(child) {
+            noteStructure[child].next = sibling;
+        }
+        s.descendants += c.descendants+1;
+        child = sibling;
+        sibling = c.next;
+    }
+    if(child) {
+        noteStructure[child].next = nullptr;
+    }
+    if(sibling) {
+        noteStructure[sibling].previous = note;
+    }
+    s.next = sibling;
+
+    // parent w/o lower depth > N becomes parent's next sibling (w/ all its siblings below as children)
+    if(s.parent && s.parent->getDepth() >= note->getDepth()) {
+        Note* parent = s.parent;
+        NoteStructure& p = noteStructure[parent];
+        if(s.previous) {
+            noteStructure[s.previous].next = nullptr;
+        }
+        p.descendants = static_cast<unsigned>(s.offset - p.offset - 1);
+        if(p.next) {
+            noteStructure[p.next].previous = note;
         }
+        s.parent = p.parent;
+        s.previous = parent;
+        s.next = p.next;
+        p.next = note;
     }
+
+    noteStructureIndexed = true;
+}
+
+void Outline::indexDemotedNote(Note* note)
+{
+    NoteStructure& s = noteStructure[note];
+
+    // previous sibling w/ the original depth of N becomes N's parent
+    if(s.previous && s.previous->getDepth() < note->getDepth()) {
+        Note* parent = s.previous;
+        NoteStructure& p = noteStructure[parent];
+
+        // N is appended to parent's children
+        Note* child = p.descendants ? notes[s.offset-1] : nullptr;
+        while(child && noteStructure[child].parent != parent) {
+            child = noteStructure[child].parent;
+        }
+        if(child) {
+            noteStructure[child].next = note;
+        }
+        if(s.next) {
+            noteStructure[s.next].previous = parent;
+        }
+        p.next = s.next;
+        p.descendants += s.descendants+1;
+        s.parent = parent;
+        s.previous = child;
+        s.next = nullptr;
+    }
+
+    noteStructureIndexed = true;
+}
+
+int Outline::getNoteOffset(const Note* note) const
+{
+    const NoteStructure* s = getNoteStructure(note);
+    return s ? s->offset : NO_OFFSET;
+}
+
+Note* Outline::getNoteParent(const Note* note) const
+{
+    const NoteStructure* s = getNoteStructure(note);
+    return s ? s->parent : nullptr;
+}
+
+void Outline::getDirectNoteChildren(vector<Note*>& directChildren)
+{
+    // top level Ns are delimited by their subtrees
+    for(size_t i=0; i<notes.size(); i+=getNoteStructure(notes[i])->descendants+1) {
+        directChildren.push_back(notes[i]);
+    }
+}
+
+size_t Outline::getDirectNoteChildrenCount()
+{
+    size_t count = 0;
+    for(size_t i=0; i<notes.size(); i+=getNoteStructure(notes[i])->descendants+1) {
+        count++;
+    }
+    return count;
 }
 
 void Outline::getDirectNoteChildren(const Note* note, std::vector<Note*>& directChildren)
 {
     if(note) {
-        if(notes.size()) {
-            vector<Note*> allNoteChildren{};
-            getAllNoteChildren(note, &allNoteChildren);
-
-            // child depth is initialized to a big nuber
-            //  +
-            // any non-monotonous non-growing depth is detected as direct child
-            u_int16_t minDepth = static_cast<u_int16_t>(1 << 15);
-            for(Note* n:allNoteChildren) {
-                if(minDepth >= n->getDepth()) {
-                    directChildren.push_back(n);
-                    minDepth = n->getDepth();
-                }
+        const NoteStructure* s = getNoteStructure(note);
+        if(s) {
+            size_t end = s->offset + s->descendants + 1;
+            for(size_t i=s->offset+1; i<end; i+=getNoteStructure(notes[i])->descendants+1) {
+                directChildren.push_back(notes[i]);
             }
         }
     } else {
@@ -644,45 +871,42 @@ void Outline::getDirectNoteChildren(const Note* note, std::vector<Note*>& direct
     }
 }
 
-// IMPROVE: if gap between Ns level is >1, this method doesn't work (user has freedom to make arbitrary depth)
+size_t Outline::getDirectNoteChildrenCount(const Note* note)
+{
+    if(note) {
+        size_t count = 0;
+        const NoteStructure* s = getNoteStructure(note);
+        if(s) {
+            size_t end = s->offset + s->descendants + 1;
+            for(size_t i=s->offset+1; i<end; i+=getNoteStructure(notes[i])->descendants+1) {
+                count++;
+            }
+        }
+        return count;
+    } else {
+        return getDirectNoteChildrenCount();
+    }
+}
+
 void Outline::getAllNoteChildren(const Note* note, vector<Note*>* children, Outline::Patch* patch)
 {
     if(note) {
-        if(note == notes[notes.size()-1]) {
+        const NoteStructure* s = getNoteStructure(note);
+        if(s) {
+            if(children) {
+                children->insert(
+                    children->end(),
+                    notes.begin()+s->offset+1,
+                    notes.begin()+s->offset+1+s->descendants);
+            }
             if(patch) {
-                patch->start=notes.size()-1;
-                patch->count=0;
+                patch->start=s->offset;
+                patch->count=s->descendants;
             }
-            return;
         } else {
-            // IMPROVE this is SLOW o(n) - consider keeping order of N within it as a field
-            auto offset = std::find(notes.begin(), notes.end(), note);
-            if(offset != notes.end()) {
-                auto index = std::distance(notes.begin(), offset);
-                for(size_t i=index+1; i<notes.size(); i++) {
-                    if(notes[i]->getDepth() > note->getDepth()) {
-                        if(children) {
-                            children->push_back(notes[i]);
-                        }
-                    } else {
-                        if(patch) {
-                            patch->start=index;
-                            patch->count=i-index;
-                        }
-                        return;
-                    }
-                }
-                if(patch) {
-                    patch->start=index;
-                    patch->count=notes.size()-1-index;
-                }
-                return;
-            } else {
-                // note not in vector
-                if(patch) {
-                    patch->start=patch->count=0;
-                }
-                return;
+            // note not in vector
+            if(patch) {
+                patch->start=patch->count=0;
             }
         }
     }
@@ -690,19 +914,11 @@ void Outline::getAllNoteChildren(const Note* note, vector<Note*>* children, Outl
 
 void Outline::getNotePathToRoot(const size_t offset, std::vector<int>& parents)
 {
-    if(offset && offset<notes.size()) {
-        int parentDepth = notes[offset]->getDepth()-1;
-        if(parentDepth >= 0) {
-            for(size_t i=offset; i!=0; i--) {
-                if(notes[i]->getDepth() == parentDepth) {
-                    parents.push_back(i);
-                    if(!parentDepth) {
-                        return;
-                    } else {
-                        parentDepth--;
-                    }
-                }
-            }
+    if(offset<notes.size()) {
+        const NoteStructure* s = getNoteStructure(notes[offset]);
+        while(s && s->parent) {
+            s = getNoteStructure(s->parent);
+            parents.push_back(s->offset);
         }
     }
 }
@@ -710,88 +926,117 @@ void Outline::getNotePathToRoot(const size_t offset, std::vector<int>& parents)
 void Outline::removeNote(Note* note, bool deallocate)
 {
     if(note && notes.size()) {
-        auto d = note->getDepth();
-        for(size_t i=0; i<notes.size(); i++) {
-            if(notes[i] == note) {
-                auto begin = i++;
-                while(i<notes.size() && notes[i]->getDepth()>d) {
-                    if(deallocate) {
-                        delete notes[i];
-                    }
-                    i++;
+        const NoteStructure* s = getNoteStructure(note);
+        if(s) {
+            size_t offset = s->offset;
+            auto begin = notes.begin()+offset;
+            auto end = begin+s->descendants+1;
+            unindexNoteSubtree(offset);
+            if(deallocate) {
+                for(auto n=begin+1; n!=end; ++n) {
+                    delete *n;
                 }
-                // because erase deletes [begin,end)
-                notes.erase(notes.begin()+begin, notes.begin()+i);
-
-                if(deallocate) {
-                    delete note;
-                }
-
-                return;
+                delete note;
+            }
+            // because erase deletes [begin,end)
+            notes.erase(begin, end);
+            for(size_t i=offset; i<notes.size(); i++) {
+                noteStructure[notes[i]].offset = static_cast<int>(i);
             }
         }
-
-        // IMPROVE this iterates ALL Ns, but I know that I need to delete just 1st one
-        notes.erase(std::remove(notes.begin(), notes.end(), note), notes.end());
     }
+    invalidateNoteNames();
 }
 
-int Outline::getOffsetOfAboveNoteSibling(Note* note, int& offset)
+void Outline::forgetNotes(const vector<Note*>& ns)
 {
-    offset = getNoteOffset(note);
-    if(offset != Outline::NO_OFFSET) {
-        if(offset) {
-            for(int o=offset-1; o>=0; o--) {
-                if(notes[o]->getDepth() == note->getDepth()) {
-                    if(offset == o) {
-                        return NO_SIBLING;
-                    } else {
-                        return o;
-                    }
-                }
-                if(notes[o]->getDepth() < note->getDepth()) {
-                    return NO_SIBLING;
+    if(ns.size() && notes.size()) {
+        unordered_set<const Note*> forgotten{ns.begin(), ns.end()};
+        vector<Note*> remembered{};
+        remembered.reserve(notes.size());
+        for(size_t i=0; i<notes.size(); ) {
+            if(forgotten.count(notes[i])) {
+                size_t end = i + getNoteStructure(notes[i])->descendants + 1;
+                unindexNoteSubtree(i);
+                for(; i<end; i++) {
+                    delete notes[i];
                 }
+            } else {
+                noteStructure[notes[i]].offset = static_cast<int>(remembered.size());
+                remembered.push_back(notes[i++]);
             }
         }
+        notes.swap(remembered);
+    }
+    invalidateNoteNames();
+}
+
+int Outline::getOffsetOfAboveNoteSibling(Note* note, int& offset)
+{
+    const NoteStructure* s = getNoteStructure(note);
+    offset = s ? s->offset : NO_OFFSET;
+    if(s && s->previous && s->previous->getDepth() == note->getDepth()) {
+        return getNoteStructure(s->previous)->offset;
     }
     return NO_SIBLING;
 }
 
 int Outline::getOffsetOfBelowNoteSibling(Note* note, int& offset)
 {
-    offset = getNoteOffset(note);
-    if(offset != Outline::NO_OFFSET) {
-        if(static_cast<unsigned int>(offset) < notes.size()-1) {
-            for(unsigned int o=offset+1; o<notes.size(); o++) {
-                if(notes[o]->getDepth() == note->getDepth()) {
-                    if(static_cast<unsigned int>(offset) == o) {
-                        return NO_SIBLING;
-                    } else {
-                        return o;
-                    }
-                }
-                if(notes[o]->getDepth() < note->getDepth()) {
-                    return NO_SIBLING;
-                }
-            }
-        }
+    const NoteStructure* s = getNoteStructure(note);
+    offset = s ? s->offset : NO_OFFSET;
+    if(s && s->next && s->next->getDepth() == note->getDepth()) {
+        return getNoteStructure(s->next)->offset;
     }
     return NO_SIBLING;
 }
 
+void Outline::moveNoteSiblingsAbove(Note* first, Note* last, Note* above, Note* aboveLast)
+{
+    NoteStructure& f = noteStructure[first];
+    NoteStructure& l = noteStructure[last];
+    NoteStructure& a = noteStructure[above];
+    NoteStructure& al = noteStructure[aboveLast];
+
+    // [above, first) and [first, end of last's subtree) are swapped
+    size_t begin = a.offset;
+    size_t end = l.offset + l.descendants + 1;
+    std::rotate(notes.begin()+begin, notes.begin()+f.offset, notes.begin()+end);
+    for(size_t i=begin; i<end; i++) {
+        noteStructure[notes[i]].offset = static_cast<int>(i);
+    }
+
+    Note* previous = a.previous;
+    Note* next = l.next;
+    if(previous) {
+        noteStructure[previous].next = first;
+    }
+    f.previous = previous;
+    l.next = above;
+    a.previous = last;
+    al.next = next;
+    if(next) {
+        noteStructure[next].previous = aboveLast;
+    }
+}
+
 void Outline::promoteNote(Note* note, Outline::Patch* patch)
 {
     if(note) {
         if(note->getDepth()) {
             vector<Note*> children{};
             getAllNoteChildren(note, &children, patch);
+            bool indexed = getNoteStructure(note) != nullptr;
             note->promote();
             note->makeModified();
             for(Note* n:children) {
                 n->promote();
                 // IMPROVE consider whether children should be marked as modified or no n->makeModified();
             }
+            // depth changes invalidated the index > update it in place instead
+            if(indexed) {
+                indexPromotedNote(note);
+            }
             makeModified();
             if(patch) {
                 patch->diff = Outline::Patch::Diff::CHANGE;
@@ -810,12 +1055,17 @@ void Outline::demoteNote(Note* note, Outline::Patch* patch)
         if(note->getDepth() < MAX_NOTE_DEPTH) {
             vector<Note*> children{};
             getAllNoteChildren(note, &children, patch);
+            bool indexed = getNoteStructure(note) != nullptr;
             note->demote();
             note->makeModified();
             for(Note* n:children) {
                 n->demote();
                 // IMPROVE consider whether children should be marked as modified or no n->makeModified();
             }
+            // depth changes invalidated the index > update it in place instead
+            if(indexed) {
+                indexDemotedNote(note);
+            }
             makeModified();
             if(patch) {
                 patch->diff = Outline::Patch::Diff::CHANGE;
@@ -828,41 +1078,29 @@ void Outline::demoteNote(Note* note, Outline::Patch* patch)
     }
 }
 
-// IMPROVE move to up and first are almost the same - introduce method that has sibling offset as parameter
 void Outline::moveNoteToFirst(Note* note, Outline::Patch* patch)
 {
+    invalidateNoteNames();
     if(note) {
-        int no, noteOffset = NO_OFFSET;
+        int noteOffset = NO_OFFSET;
 
         // loop to find the first sibling
         int so, siblingOffset = NO_OFFSET;
         Note* n = note;
-        while((so = getOffsetOfAboveNoteSibling(n, no)) != NO_SIBLING) {
-            if(noteOffset == NO_OFFSET) noteOffset = no;
+        while((so = getOffsetOfAboveNoteSibling(n, noteOffset)) != NO_SIBLING) {
             siblingOffset = so;
-            n = note->getOutline()->getNotes()[siblingOffset];
+            n = notes[siblingOffset];
         }
 
         if(siblingOffset != NO_SIBLING) {
-            vector<Note*> children{};
-            getAllNoteChildren(note, &children);
+            noteOffset = getNoteOffset(note);
             if(patch) {
                 // upper tier to patch [sibling's offset, note's last child]
                 patch->diff = Outline::Patch::Diff::MOVE;
                 patch->start = siblingOffset;
-                patch->count = noteOffset+children.size() - siblingOffset;
-            }
-            // modify outline: cut & insert
-            if(children.size()) {
-                notes.erase(notes.begin()+noteOffset, notes.begin()+noteOffset+children.size()+1);
-                for(int c=children.size()-1; c>=0; c--) {
-                    // bottom up insert
-                    notes.insert(notes.begin()+siblingOffset, children[c]);
-                }
-            } else {
-                notes.erase(notes.begin()+noteOffset);
+                patch->count = noteOffset+getNoteStructure(note)->descendants - siblingOffset;
             }
-            notes.insert(notes.begin()+siblingOffset, note);
+            moveNoteSiblingsAbove(note, note, n, getNoteStructure(note)->previous);
             note->makeModified();
             return;
         } else {
@@ -880,29 +1118,19 @@ void Outline::moveNoteToFirst(Note* note, Outline::Patch* patch)
 
 void Outline::moveNoteUp(Note* note, Outline::Patch* patch)
 {
+    invalidateNoteNames();
     if(note) {
         int noteOffset;
         int siblingOffset = getOffsetOfAboveNoteSibling(note, noteOffset);
         if(siblingOffset != NO_SIBLING) {
-            vector<Note*> children{};
-            getAllNoteChildren(note, &children);
+            Note* sibling = notes[siblingOffset];
             if(patch) {
                 // upper tier to patch [sibling's offset, note's last child]
                 patch->diff = Outline::Patch::Diff::MOVE;
                 patch->start = siblingOffset;
-                patch->count = noteOffset+children.size() - siblingOffset;
-            }
-            // modify outline: cut & insert
-            if(children.size()) {
-                notes.erase(notes.begin()+noteOffset, notes.begin()+noteOffset+children.size()+1);
-                for(int c=children.size()-1; c>=0; c--) {
-                    // bottom up insert
-                    notes.insert(notes.begin()+siblingOffset, children[c]);
-                }
-            } else {
-                notes.erase(notes.begin()+noteOffset);
+                patch->count = noteOffset+getNoteStructure(note)->descendants - siblingOffset;
             }
-            notes.insert(notes.begin()+siblingOffset, note);
+            moveNoteSiblingsAbove(note, note, sibling, sibling);
             makeModified();
             return;
         } else {
@@ -920,31 +1148,19 @@ void Outline::moveNoteUp(Note* note, Outline::Patch* patch)
 
 void Outline::moveNoteDown(Note* note, Outline::Patch* patch)
 {
+    invalidateNoteNames();
     if(note) {
         int noteOffset;
         int siblingOffset = getOffsetOfBelowNoteSibling(note, noteOffset);
         if(siblingOffset != NO_SIBLING) {
             Note* sibling = notes[siblingOffset];
-            vector<Note*> siblingChildren{};
-            getAllNoteChildren(sibling, &siblingChildren);
             if(patch) {
                 // upper tier to patch [note's original offset,sibling's last child]
                 patch->diff = Outline::Patch::Diff::MOVE;
                 patch->start = noteOffset;
-                patch->count = siblingOffset+siblingChildren.size() - noteOffset;
-            }
-            // modify outline: cut & insert (COPY moved Note below sibling, DELETE original Note)
-            vector<Note*> children{};
-            getAllNoteChildren(note, &children);
-            int belowSiblingIndex = siblingOffset+siblingChildren.size()+1;
-            notes.insert(notes.begin()+belowSiblingIndex, note);
-            if(children.size()) {
-                for(int c=children.size()-1; c>=0; c--) {
-                    // bottom up insert
-                    notes.insert(notes.begin()+belowSiblingIndex+1, children[c]);
-                }
+                patch->count = siblingOffset+getNoteStructure(sibling)->descendants - noteOffset;
             }
-            notes.erase(notes.begin()+noteOffset, notes.begin()+noteOffset+children.size()+1);
+            moveNoteSiblingsAbove(sibling, sibling, note, note);
             makeModified();
             return;
         } else {
@@ -962,40 +1178,27 @@ void Outline::moveNoteDown(Note* note, Outline::Patch* patch)
 
 void Outline::moveNoteToLast(Note* note, Outline::Patch* patch)
 {
+    invalidateNoteNames();
     if(note) {
-        int no, noteOffset = NO_OFFSET;
+        int noteOffset = NO_OFFSET;
 
-        // loop to find the first sibling
+        // loop to find the last sibling
         int so, siblingOffset = NO_OFFSET;
         Note* n = note;
-        while((so = getOffsetOfBelowNoteSibling(n, no)) != NO_SIBLING) {
-            if(noteOffset == NO_OFFSET) noteOffset = no;
+        while((so = getOffsetOfBelowNoteSibling(n, noteOffset)) != NO_SIBLING) {
             siblingOffset = so;
-            n = note->getOutline()->getNotes()[siblingOffset];
+            n = notes[siblingOffset];
         }
 
         if(siblingOffset != NO_SIBLING) {
-            Note* sibling = notes[siblingOffset];
-            vector<Note*> siblingChildren{};
-            getAllNoteChildren(sibling, &siblingChildren);
+            noteOffset = getNoteOffset(note);
             if(patch) {
                 // upper tier to patch [note's original offset,sibling's last child]
                 patch->diff = Outline::Patch::Diff::MOVE;
                 patch->start = noteOffset;
-                patch->count = siblingOffset+siblingChildren.size() - noteOffset;
-            }
-            // modify outline: cut & insert (COPY moved Note below sibling, DELETE original Note)
-            vector<Note*> children{};
-            getAllNoteChildren(note, &children);
-            int belowSiblingIndex = siblingOffset+siblingChildren.size()+1;
-            notes.insert(notes.begin()+belowSiblingIndex, note);
-            if(children.size()) {
-                for(int c=children.size()-1; c>=0; c--) {
-                    // bottom up insert
-                    notes.insert(notes.begin()+belowSiblingIndex+1, children[c]);
-                }
+                patch->count = siblingOffset+getNoteStructure(n)->descendants - noteOffset;
             }
-            notes.erase(notes.begin()+noteOffset, notes.begin()+noteOffset+children.size()+1);
+            moveNoteSiblingsAbove(getNoteStructure(note)->next, n, note, note);
             makeModified();
             return;
         } else {
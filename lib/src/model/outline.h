@@ -20,6 +20,8 @@
 #define M8R_OUTLINE_H_
 
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "../mind/ontology/thing_class_rel_triple.h"
@@ -127,7 +129,8 @@ private:
     const OutlineType* type;
     std::vector<std::string*> description;
 
-    std::string modifiedPretty;
+    // pretty HTML timestamp is calculated lazily when needed (empty ~ not calculated)
+    mutable std::string modifiedPretty;
     u_int32_t revision;
     u_int32_t reads;
 
@@ -135,11 +138,46 @@ private:
     int8_t urgency;
     int8_t progress;
 
-    // IMPROVE introduce own data structure: tree of ordered notes w/ offset i.e. heap
+    // Ns in document order - hierarchy is given by N depths
     std::vector<Note*> notes;
 
     Note* outlineDescriptorAsNote;
 
+    /**
+     * @brief N name and mangled name indices (the first N in order wins).
+     *
+     * Indices are built on lookup and invalidated by any change of Ns
+     * or their names.
+     */
+    mutable std::unordered_map<std::string,Note*> noteNames;
+    mutable std::unordered_map<std::string,Note*> noteMangledNames;
+    mutable bool noteNamesIndexed;
+
+    /**
+     * @brief N hierarchy record.
+     *
+     * Parent is the closest N above w/ lower depth (nullptr for O), previous/next
+     * are adjacent Ns w/ the same parent (regardless their depth).
+     */
+    struct NoteStructure {
+        int offset;
+        unsigned descendants;
+        Note* parent;
+        Note* previous;
+        Note* next;
+    };
+
+    /**
+     * @brief N hierarchy index.
+     *
+     * Index is built on lookup by a single pass over Ns. Once built, it is updated
+     * in place when Ns are added, removed, moved among siblings, promoted or demoted,
+     * any other change of Ns or their depths invalidates it. Hierarchy queries
+     * therefore don't scan all Ns.
+     */
+    mutable std::unordered_map<const Note*,NoteStructure> noteStructure;
+    mutable bool noteStructureIndexed;
+
     /**
      * @brief Markdown file size.
      */
@@ -165,6 +203,15 @@ private:
      */
     TimeScope timeScope;
 
+private:
+    void indexNoteNames() const;
+    void indexNoteStructure() const;
+    const NoteStructure* getNoteStructure(const Note* note) const;
+    void indexInsertedNote(size_t offset);
+    void unindexNoteSubtree(size_t offset);
+    void indexPromotedNote(Note* note);
+    void indexDemotedNote(Note* note);
+
 public:
     Outline() = delete;
     explicit Outline(const OutlineType* type);
@@ -269,9 +316,24 @@ public:
     Note* cloneNote(const Note* clonedNote, const bool deep=true);
     void addNote(Note*, int offset);
     void addNotes(std::vector<Note*>&, int offset);
+    /**
+     * @brief Get N w/ given name, or the first N whose name contains it.
+     */
     Note* getNoteByName(const std::string& noteName) const;
     Note* getNoteByMangledName(const std::string& mangledName) const;
+    /**
+     * @brief Ns or their names were changed - N name indices must be rebuilt.
+     */
+    void invalidateNoteNames() { noteNamesIndexed = false; }
+    /**
+     * @brief Ns order or depths were changed - N hierarchy index must be rebuilt.
+     */
+    void invalidateNoteStructure() { noteStructureIndexed = false; }
     int getNoteOffset(const Note* note) const;
+    /**
+     * @brief Get parent N (nullptr if O is the parent or N is not in O).
+     */
+    Note* getNoteParent(const Note* note) const;
 
     /**
      * @brief Get direct Os children.
@@ -295,8 +357,7 @@ public:
      * are returned regardless how big depth GAP is between O and N.
      */
     void getDirectNoteChildren(std::vector<Note*>& children);
-    // IMPROVE cache w/ dirty flag
-    size_t getDirectNoteChildrenCount() { std::vector<Note*> c{}; getDirectNoteChildren(c); return c.size(); }
+    size_t getDirectNoteChildrenCount();
     /**
      * @brief Get direct Ns children.
      *
@@ -304,17 +365,21 @@ public:
      * the gap in depth is.
      */
     void getDirectNoteChildren(const Note* note, std::vector<Note*>& children);
-    size_t getDirectNoteChildrenCount(const Note* note) { std::vector<Note*> c{}; getDirectNoteChildren(note, c); return c.size(); }
+    size_t getDirectNoteChildrenCount(const Note* note);
 
     void getAllNoteChildren(const Note* note, std::vector<Note*>* children=nullptr, Outline::Patch* patch=nullptr);
     /**
-     * @brief Get skeleton-style (Note per level) path to root.
+     * @brief Get skeleton-style (Note per level) path to root i.e. offsets of N's ancestors.
      */
     void getNotePathToRoot(const size_t offset, std::vector<int>& parents);
     /**
      * @brief Forget Note including its children.
      */
     void forgetNote(Note* n) { removeNote(n, true); }
+    /**
+     * @brief Forget Notes including their children in a single pass.
+     */
+    void forgetNotes(const std::vector<Note*>& ns);
     /**
      * @brief Remove Note including its children from Outline, but do NOT dealocate them.
      */
@@ -376,6 +441,13 @@ private:
     int getOffsetOfAboveNoteSibling(Note* note, int& offset);
     int getOffsetOfBelowNoteSibling(Note* note, int& offset);
 
+    /**
+     * @brief Move sibling subtrees first..last above sibling subtrees above..aboveLast.
+     *
+     * Only offsets of moved Ns and links of siblings at the boundaries are updated.
+     */
+    void moveNoteSiblingsAbove(Note* first, Note* last, Note* above, Note* aboveLast);
+
     void resetClonedNote(Note* n);
     void resetClonedOutline(Outline* o);
 };
@@ -19,11 +19,144 @@
 #include "filesystem_persistence.h"
 
 #include <sys/stat.h>
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <cerrno>
+#endif
+
+#include <set>
+#include <vector>
 
 using namespace std;
 
 namespace m8r {
 
+constexpr int FilesystemPersistence::WRITE_BEHIND_DELAY_MILLIS;
+
+#ifndef _WIN32
+namespace {
+
+struct TemporaryFile {
+    std::string path;
+    std::string temporaryPath;
+    int fd;
+};
+
+/**
+ * @brief Get path of the file to be replaced - symbolic links are preserved.
+ */
+string getReplacedFilePath(const string& path)
+{
+    struct stat fileStat;
+    if(!lstat(path.c_str(), &fileStat) && S_ISLNK(fileStat.st_mode)) {
+        char* resolved = realpath(path.c_str(), nullptr);
+        if(resolved) {
+            string resolvedPath{resolved};
+            free(resolved);
+            return resolvedPath;
+        }
+    }
+    return path;
+}
+
+/**
+ * @brief Write content to temporary file w/ the mode of the replaced file.
+ *
+ * @return descriptor of the written file (NOT synced) or -1 on error.
+ */
+int writeTemporaryFile(const string& path, const string& temporaryPath, const string& content)
+{
+    int fd = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if(fd < 0) {
+        return -1;
+    }
+    struct stat fileStat;
+    if(!stat(path.c_str(), &fileStat)) {
+        fchmod(fd, fileStat.st_mode & 07777);
+    }
+
+    const char* data = content.data();
+    size_t remaining = content.size();
+    while(remaining) {
+        ssize_t written = write(fd, data, remaining);
+        if(written < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            close(fd);
+            unlink(temporaryPath.c_str());
+            return -1;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    return fd;
+}
+
+void syncDirectory(const string& directory)
+{
+    int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if(fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+/**
+ * @brief Sync and rename temporary files - syncs are batched (all files are
+ * written before the first sync blocks), parent directories are synced once.
+ * Listener (if any) is called before each rename, paths of the replaced files
+ * are added to replaced and paths of the files which were not replaced to failed.
+ */
+void replaceFiles(
+        vector<TemporaryFile>& files,
+        vector<string>& replaced,
+        vector<string>& failed,
+        const std::function<void(const string&,const string&)>& listener)
+{
+    for(TemporaryFile& f:files) {
+        if(fsync(f.fd)) {
+            MF_DEBUG("Persistence: unable to sync " << f.temporaryPath << ": " << strerror(errno) << endl);
+            close(f.fd);
+            unlink(f.temporaryPath.c_str());
+            f.fd = -1;
+            failed.push_back(f.path);
+        } else {
+            close(f.fd);
+        }
+    }
+
+    set<string> directories{};
+    string directory{}, file{};
+    for(TemporaryFile& f:files) {
+        if(f.fd < 0) {
+            continue;
+        }
+        string target = getReplacedFilePath(f.path);
+        // file must be expected before it's replaced, otherwise the change could be noticed first
+        if(listener) {
+            listener(f.path, f.temporaryPath);
+        }
+        if(rename(f.temporaryPath.c_str(), target.c_str())) {
+            MF_DEBUG("Persistence: unable to replace " << target << ": " << strerror(errno) << endl);
+            unlink(f.temporaryPath.c_str());
+            failed.push_back(f.path);
+        } else {
+            pathToDirectoryAndFile(target, directory, file);
+            directories.insert(directory.size() ? directory : ".");
+            replaced.push_back(f.path);
+        }
+    }
+    // rename is durable once directory is synced
+    for(const string& d:directories) {
+        syncDirectory(d);
+    }
+}
+
+} // anonymous namespace
+#endif
+
 string FilesystemPersistence::getUniqueDirOrFileName(
     const string& directory,
     const string* text,
@@ -46,12 +179,33 @@ string FilesystemPersistence::getUniqueDirOrFileName(
 }
 
 FilesystemPersistence::FilesystemPersistence(MarkdownOutlineRepresentation& mdRepresentation, HtmlOutlineRepresentation& htmlRepresentation)
-    : mdRepresentation(mdRepresentation), htmlRepresentation(htmlRepresentation)
+    : mdRepresentation(mdRepresentation),
+      htmlRepresentation(htmlRepresentation),
+      pendingWrites{},
+      writing{false},
+      flushRequests{},
+      stopWriter{false},
+      writer{nullptr},
+      failedWrites{},
+      writeListener{}
 {
 }
 
 FilesystemPersistence::~FilesystemPersistence()
 {
+    {
+        lock_guard<mutex> lock{writesMutex};
+        stopWriter = true;
+    }
+    writesAvailable.notify_all();
+    if(writer) {
+        // writer writes pending Outlines before it finishes
+        writer->join();
+        delete writer;
+    }
+    for(auto& w:pendingWrites) {
+        delete w.second;
+    }
 }
 
 void FilesystemPersistence::load(Stencil* stencil)
@@ -73,6 +227,9 @@ string FilesystemPersistence::createFileName(
     const string* text,
     const string& extension
 ) {
+    // files of Outlines waiting to be written don't exist yet
+    flush();
+
     return FilesystemPersistence::getUniqueDirOrFileName(
         directory, text, extension
     );
@@ -98,21 +255,157 @@ bool FilesystemPersistence::isWriteable(const string& outlineKey)
 
 void FilesystemPersistence::save(Outline* outline)
 {
+    // model is NOT thread safe > serialize it here, write it in writer thread
     string* text = mdRepresentation.to(outline);
     if(text!=nullptr) {
         MF_DEBUG("Saving O: " << outline->getKey() << endl);
-        ofstream out(outline->getKey());
-        MF_DEBUG("  O opened: " << boolalpha << out.is_open() << endl);
-        out << *text;
-        MF_DEBUG("  O written: " << &out << endl);
-        out.close();
-        MF_DEBUG("O saved: " << &out << endl);
-        delete text;
+        {
+            lock_guard<mutex> lock{writesMutex};
+            auto w = pendingWrites.find(outline->getKey());
+            if(w != pendingWrites.end()) {
+                // coalesce w/ the save which was not written yet
+                delete w->second;
+                w->second = text;
+            } else {
+                pendingWrites[outline->getKey()] = text;
+            }
+            if(!writer) {
+                writer = new thread{&FilesystemPersistence::writeBehind, this};
+            }
+        }
+        writesAvailable.notify_one();
 
         outline->clearDirty();
     }
 }
 
+void FilesystemPersistence::flush()
+{
+    unique_lock<mutex> lock{writesMutex};
+    if(!writer) {
+        return;
+    }
+    flushRequests++;
+    writesAvailable.notify_all();
+    writesDone.wait(lock, [this]{ return pendingWrites.empty() && !writing; });
+    flushRequests--;
+}
+
+vector<string> FilesystemPersistence::takeFailedWrites()
+{
+    lock_guard<mutex> lock{writesMutex};
+    vector<string> failed{failedWrites.begin(), failedWrites.end()};
+    failedWrites.clear();
+    return failed;
+}
+
+void FilesystemPersistence::setWriteListener(std::function<void(const std::string&,const std::string&)> listener)
+{
+    lock_guard<mutex> lock{writesMutex};
+    writeListener = listener;
+}
+
+void FilesystemPersistence::writeBehind()
+{
+    unique_lock<mutex> lock{writesMutex};
+    while(true) {
+        writesAvailable.wait(lock, [this]{ return stopWriter || !pendingWrites.empty(); });
+        if(pendingWrites.empty()) {
+            // stopped and everything written
+            return;
+        }
+        // bursts of saves (refactorings, imports, ...) are written in one batch
+        writesAvailable.wait_for(
+            lock,
+            chrono::milliseconds(WRITE_BEHIND_DELAY_MILLIS),
+            [this]{ return stopWriter || flushRequests; });
+
+        map<string,string*> batch{};
+        batch.swap(pendingWrites);
+        writing = true;
+        lock.unlock();
+
+        writeBatch(batch);
+
+        lock.lock();
+        writing = false;
+        writesDone.notify_all();
+    }
+}
+
+void FilesystemPersistence::writeBatch(map<string,string*>& batch)
+{
+    MF_DEBUG("Persistence: writing " << batch.size() << " Os" << endl);
+    std::function<void(const std::string&,const std::string&)> listener{};
+    {
+        lock_guard<mutex> lock{writesMutex};
+        listener = writeListener;
+    }
+
+    vector<string> written{};
+    vector<string> failed{};
+#ifdef _WIN32
+    for(auto& w:batch) {
+        if(writeFileAtomically(w.first, *w.second)) {
+            written.push_back(w.first);
+            if(listener) {
+                listener(w.first, w.first);
+            }
+        } else {
+            failed.push_back(w.first);
+        }
+    }
+#else
+    vector<TemporaryFile> files{};
+    for(auto& w:batch) {
+        string temporaryPath{getReplacedFilePath(w.first)};
+        temporaryPath += FILE_EXTENSION_TEMPORARY;
+        int fd = writeTemporaryFile(w.first, temporaryPath, *w.second);
+        if(fd >= 0) {
+            files.push_back(TemporaryFile{w.first, temporaryPath, fd});
+        } else {
+            MF_DEBUG("Persistence: unable to write " << temporaryPath << ": " << strerror(errno) << endl);
+            failed.push_back(w.first);
+        }
+    }
+    replaceFiles(files, written, failed, listener);
+#endif
+    for(auto& w:batch) {
+        delete w.second;
+    }
+
+    // failures are reported to the owner of the model which makes the Os dirty again
+    lock_guard<mutex> lock{writesMutex};
+    for(const string& path:written) {
+        failedWrites.erase(path);
+    }
+    for(const string& path:failed) {
+        failedWrites.insert(path);
+    }
+}
+
+bool FilesystemPersistence::writeFileAtomically(const string& path, const string& content)
+{
+#ifdef _WIN32
+    // IMPROVE use ReplaceFile() to replace file atomically
+    ofstream out(path);
+    out << content;
+    out.close();
+    return !out.fail();
+#else
+    string temporaryPath{getReplacedFilePath(path)};
+    temporaryPath += FILE_EXTENSION_TEMPORARY;
+    int fd = writeTemporaryFile(path, temporaryPath, content);
+    if(fd < 0) {
+        return false;
+    }
+    vector<TemporaryFile> files{TemporaryFile{path, temporaryPath, fd}};
+    vector<string> replaced{}, failed{};
+    replaceFiles(files, replaced, failed, nullptr);
+    return !replaced.empty();
+#endif
+}
+
 void FilesystemPersistence::saveAsHtml(Outline* outline, const string& fileName)
 {
     string* text = new string{};
@@ -124,9 +417,7 @@ void FilesystemPersistence::saveAsHtml(Outline* outline, const string& fileName)
         true,
         false
     );
-    ofstream out(fileName);
-    out << *text;
-    out.close();
+    writeFileAtomically(fileName, *text);
     delete text;
 }
 
@@ -19,7 +19,12 @@
 #ifndef M8R_FILESYSTEM_PERSISTENCE_H
 #define M8R_FILESYSTEM_PERSISTENCE_H
 
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
 
 #include "persistence.h"
 #include "../config/configuration.h"
@@ -29,12 +34,50 @@
 
 namespace m8r {
 
+/**
+ * @brief Filesystem persistence w/ write-behind.
+ *
+ * Outlines are serialized on save (by the thread which owns the model), but
+ * written to files by a background writer thread so that slow disks don't
+ * block the UI. Repeated saves of the same Outline waiting to be written are
+ * coalesced (the last one wins).
+ *
+ * File is written to a temporary file which is renamed to the Outline file
+ * once it's synced - a crash in the middle of a write never truncates a
+ * notebook. Temporary files of a batch are synced together before they are
+ * renamed.
+ *
+ * Use flush() as a barrier whenever Outline files must be on disk e.g.
+ * before they are moved or read, before amnesia and on exit. Paths of
+ * Outline files which could not be written are kept until they are taken
+ * by the owner of the model (which makes the Outlines dirty again).
+ */
 class FilesystemPersistence : public Persistence
 {
+public:
+    // saves arriving within this period are written in one batch
+    static constexpr int WRITE_BEHIND_DELAY_MILLIS = 20;
+
 private:
     MarkdownOutlineRepresentation& mdRepresentation;
     HtmlOutlineRepresentation& htmlRepresentation;
 
+    // Outline file path > serialized Outline waiting to be written
+    std::map<std::string,std::string*> pendingWrites;
+    // batch taken by the writer is being written
+    bool writing;
+    // flush() requests waiting for the writer
+    unsigned flushRequests;
+    bool stopWriter;
+    std::mutex writesMutex;
+    std::condition_variable writesAvailable;
+    std::condition_variable writesDone;
+    std::thread* writer;
+    // Outline files whose last write failed
+    std::set<std::string> failedWrites;
+
+    std::function<void(const std::string&,const std::string&)> writeListener;
+
 public:
 
     static std::string getUniqueDirOrFileName(
@@ -70,8 +113,23 @@ public:
      * @return `false` if read-only, else `true`.
      */
     bool isWriteable(const std::string& outlineKey);
+    /**
+     * @brief Serialize Outline and queue it for write.
+     */
     virtual void save(Outline* outline);
     virtual void saveAsHtml(Outline* o, const std::string& fileName);
+    virtual void flush();
+    virtual std::vector<std::string> takeFailedWrites();
+    virtual void setWriteListener(std::function<void(const std::string&,const std::string&)> listener);
+
+    /**
+     * @brief Atomically replace file content: write temporary file, sync it and rename it.
+     */
+    static bool writeFileAtomically(const std::string& path, const std::string& content);
+
+private:
+    void writeBehind();
+    void writeBatch(std::map<std::string,std::string*>& batch);
 };
 
 }
@@ -19,6 +19,10 @@
 #ifndef M8R_PERSISTENCE_H_
 #define M8R_PERSISTENCE_H_
 
+#include <functional>
+#include <string>
+#include <vector>
+
 #include "../model/stencil.h"
 #include "../model/outline.h"
 
@@ -39,6 +43,19 @@ public:
     virtual bool isWriteable(const std::string& outlineKey) = 0;
     virtual void save(Outline* outline) = 0;
     virtual void saveAsHtml(Outline* outline, const std::string& fileName) = 0;
+    /**
+     * @brief Block until all Outlines saved so far are written.
+     */
+    virtual void flush() = 0;
+    /**
+     * @brief Get (and forget) paths of Outline files which could not be written since the last call.
+     */
+    virtual std::vector<std::string> takeFailedWrites() = 0;
+    /**
+     * @brief Set function called (from any thread) with the path of each Outline file
+     * and the path of its written replacement just before the file is replaced.
+     */
+    virtual void setWriteListener(std::function<void(const std::string&,const std::string&)> listener) = 0;
 };
 
 }
@@ -0,0 +1,503 @@
+/*
+ repository_snapshot.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "repository_snapshot.h"
+
+#include <cstdio>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace m8r {
+
+constexpr uint32_t RepositorySnapshot::MAGIC;
+constexpr uint32_t RepositorySnapshot::VERSION;
+
+/*
+ * Binary snapshot writer and bounds checking reader.
+ */
+
+class SnapshotWriter
+{
+private:
+    string& out;
+
+public:
+    explicit SnapshotWriter(string& out) : out(out) {}
+
+    template<typename T> void number(T n) {
+        out.append(reinterpret_cast<const char*>(&n), sizeof(T));
+    }
+    void text(const string& s) {
+        number<uint32_t>(s.size());
+        out.append(s);
+    }
+};
+
+class SnapshotReader
+{
+private:
+    const char* p;
+    const char* end;
+    bool ok;
+
+public:
+    explicit SnapshotReader(const char* data, size_t size) : p(data), end(data+size), ok(true) {}
+
+    bool isOk() const { return ok; }
+    bool isEnd() const { return p==end; }
+
+    template<typename T> T number() {
+        T n{};
+        if(ok && static_cast<size_t>(end-p) >= sizeof(T)) {
+            memcpy(&n, p, sizeof(T));
+            p += sizeof(T);
+        } else {
+            ok = false;
+        }
+        return n;
+    }
+    bool text(string& s) {
+        uint32_t length = number<uint32_t>();
+        if(ok && static_cast<size_t>(end-p) >= length) {
+            s.assign(p, length);
+            p += length;
+        } else {
+            ok = false;
+        }
+        return ok;
+    }
+    string* text() {
+        string* s = new string{};
+        if(!text(*s)) {
+            delete s;
+            return nullptr;
+        }
+        return s;
+    }
+};
+
+/*
+ * RepositorySnapshot
+ */
+
+RepositorySnapshot::RepositorySnapshot()
+    : snapshotPath{},
+      written{0},
+      records{},
+      dirty{false},
+      restored{0},
+      parsed{0}
+{
+}
+
+RepositorySnapshot::~RepositorySnapshot()
+{
+}
+
+int64_t RepositorySnapshot::modificationTime(const struct stat& fileStat)
+{
+#ifdef __APPLE__
+    return fileStat.st_mtimespec.tv_sec*1000000000LL + fileStat.st_mtimespec.tv_nsec;
+#elif _WIN32
+    return fileStat.st_mtime*1000000000LL;
+#else
+    return fileStat.st_mtim.tv_sec*1000000000LL + fileStat.st_mtim.tv_nsec;
+#endif
+}
+
+uint64_t RepositorySnapshot::hash(const char* data, size_t size)
+{
+    // FNV-1a
+    uint64_t h = 14695981039346656037ULL;
+    for(size_t i=0; i<size; i++) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+string RepositorySnapshot::path(const string& cacheDirectory, const string& repositoryDirectory)
+{
+    char suffix[17];
+    snprintf(
+        suffix,
+        sizeof(suffix),
+        "%016llx",
+        static_cast<unsigned long long>(hash(repositoryDirectory.data(), repositoryDirectory.size())));
+
+    string snapshotPath{cacheDirectory};
+    snapshotPath += FILE_PATH_SEPARATOR;
+    snapshotPath += FILENAME_REPOSITORY_SNAPSHOT;
+    snapshotPath += suffix;
+    return snapshotPath;
+}
+
+void RepositorySnapshot::clear()
+{
+    lock_guard<mutex> criticalSection{recordsMutex};
+    snapshotPath.clear();
+    written = 0;
+    records.clear();
+    dirty = false;
+    restored = parsed = 0;
+}
+
+void RepositorySnapshot::load(const string& snapshotPath)
+{
+    clear();
+    this->snapshotPath = snapshotPath;
+
+    MappedFile file{};
+    // snapshot is replaced atomically (renamed) > it can be mapped
+    if(!file.open(snapshotPath, true)) {
+        MF_DEBUG(endl << "Repository snapshot: none found in " << snapshotPath);
+        return;
+    }
+    struct stat fileStat;
+    if(stat(snapshotPath.c_str(), &fileStat)) {
+        return;
+    }
+    written = modificationTime(fileStat);
+    SnapshotReader in{file.data(), file.size()};
+    if(in.number<uint32_t>()!=MAGIC || in.number<uint32_t>()!=VERSION) {
+        MF_DEBUG(endl << "Repository snapshot: foreign or old version snapshot " << snapshotPath << " ignored");
+        return;
+    }
+    uint64_t count = in.number<uint64_t>();
+    string path{};
+    for(uint64_t i=0; i<count && in.isOk(); i++) {
+        Record record{};
+        in.text(path);
+        record.modified = in.number<int64_t>();
+        record.size = in.number<uint64_t>();
+        record.hash = in.number<uint64_t>();
+        in.text(record.document);
+        record.used = false;
+        if(in.isOk()) {
+            records[path] = std::move(record);
+        }
+    }
+    if(!in.isOk() || !in.isEnd()) {
+        MF_DEBUG(endl << "Repository snapshot: broken snapshot " << snapshotPath << " ignored");
+        records.clear();
+    }
+    MF_DEBUG(endl << "Repository snapshot: " << records.size() << " records loaded from " << snapshotPath);
+}
+
+bool RepositorySnapshot::save()
+{
+    lock_guard<mutex> criticalSection{recordsMutex};
+    if(snapshotPath.empty()) {
+        return false;
+    }
+
+    // drop records of files which are no longer in the repository
+    for(auto it=records.begin(); it!=records.end();) {
+        if(!it->second.used) {
+            it = records.erase(it);
+            dirty = true;
+        } else {
+            ++it;
+        }
+    }
+    if(!dirty) {
+        return true;
+    }
+
+    string out{};
+    SnapshotWriter writer{out};
+    writer.number<uint32_t>(MAGIC);
+    writer.number<uint32_t>(VERSION);
+    writer.number<uint64_t>(records.size());
+    for(const auto& r:records) {
+        writer.text(r.first);
+        writer.number<int64_t>(r.second.modified);
+        writer.number<uint64_t>(r.second.size);
+        writer.number<uint64_t>(r.second.hash);
+        writer.text(r.second.document);
+    }
+
+    // cache directory is created on the first save
+    string directory{snapshotPath.substr(0, snapshotPath.find_last_of(FILE_PATH_SEPARATOR_CHAR))};
+    if(!isDirectory(directory.c_str()) && !createDirectories(directory)) {
+        return false;
+    }
+
+    // write, sync & rename so that a crash never leaves a truncated snapshot
+    string tmpPath{snapshotPath};
+    tmpPath += ".tmp";
+    {
+        ofstream file(tmpPath, ios::binary|ios::trunc);
+        file.write(out.data(), out.size());
+        if(!file.good()) {
+            remove(tmpPath.c_str());
+            return false;
+        }
+    }
+#ifndef _WIN32
+    // rename may be persisted before data > renamed file would be empty after crash
+    int fd = open(tmpPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0 || fsync(fd)) {
+        if(fd >= 0) {
+            close(fd);
+        }
+        remove(tmpPath.c_str());
+        return false;
+    }
+    close(fd);
+#endif
+    if(rename(tmpPath.c_str(), snapshotPath.c_str())) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+    dirty = false;
+    MF_DEBUG(endl << "Repository snapshot: " << records.size() << " records saved to " << snapshotPath);
+    return true;
+}
+
+void RepositorySnapshot::from(MarkdownDocument& md)
+{
+    const string& path = *md.getFilePath();
+
+    struct stat fileStat;
+    if(snapshotPath.empty() || stat(path.c_str(), &fileStat)) {
+        md.from();
+        return;
+    }
+    const int64_t modified = modificationTime(fileStat);
+    const uint64_t size = fileStat.st_size;
+
+    Record* record = nullptr;
+    {
+        lock_guard<mutex> criticalSection{recordsMutex};
+        auto it = records.find(path);
+        if(it!=records.end()) {
+            record = &it->second;
+            record->used = true;
+        }
+    }
+
+    uint64_t contentHash = 0;
+    bool hashed = false;
+    if(record && record->size==size) {
+        // racy record: file modified in the same timestamp granule as the snapshot
+        // was written might have been changed after it was hashed > hash it again
+        const bool racy = record->modified >= written;
+        if(record->modified==modified && !racy) {
+            if(restore(md, *record, fileStat.st_mtime)) {
+                return;
+            }
+        } else {
+            // touched file might have the same content
+            MappedFile file{};
+            if(file.open(path)) {
+                contentHash = hash(file.data(), file.size());
+                hashed = true;
+                if(contentHash==record->hash && restore(md, *record, fileStat.st_mtime)) {
+                    lock_guard<mutex> criticalSection{recordsMutex};
+                    // rewrite snapshot also for racy records so that they are no longer racy
+                    record->modified = modified;
+                    dirty = true;
+                    return;
+                }
+            }
+        }
+    }
+
+    // hash before parsing: if file changes meanwhile, then the record gets invalid
+    if(!hashed) {
+        MappedFile file{};
+        if(file.open(path)) {
+            contentHash = hash(file.data(), file.size());
+        }
+    }
+    md.from();
+
+    Record fresh{};
+    fresh.modified = modified;
+    fresh.size = size;
+    fresh.hash = contentHash;
+    fresh.used = true;
+    serialize(md, fresh.document);
+
+    lock_guard<mutex> criticalSection{recordsMutex};
+    records[path] = std::move(fresh);
+    dirty = true;
+    parsed++;
+}
+
+bool RepositorySnapshot::restore(MarkdownDocument& md, Record& record, time_t modified)
+{
+    if(deserialize(record.document, md, modified)) {
+        lock_guard<mutex> criticalSection{recordsMutex};
+        restored++;
+        return true;
+    }
+    return false;
+}
+
+void RepositorySnapshot::serialize(const MarkdownDocument& md, string& document)
+{
+    SnapshotWriter out{document};
+    out.number<uint8_t>(md.getFormat());
+    out.number<uint32_t>(md.getFileSize());
+
+    vector<MarkdownAstNodeSection*>* ast = md.getAst();
+    out.number<uint32_t>(ast?ast->size():0);
+    if(ast) {
+        for(MarkdownAstNodeSection* section:*ast) {
+            uint8_t flags =
+                (section->getText()?1:0)
+                | (section->getBody()?1<<1:0)
+                | (section->isPostDeclaredSection()?1<<2:0)
+                | (section->isTrailingHashesSection()?1<<3:0);
+            out.number<uint8_t>(flags);
+            out.number<uint16_t>(section->getDepth());
+            if(section->getText()) {
+                out.text(*section->getText());
+            }
+            if(section->getBody()) {
+                out.number<uint32_t>(section->getBody()->size());
+                for(const string* line:*section->getBody()) {
+                    out.text(*line);
+                }
+            }
+
+            MarkdownAstSectionMetadata& meta = section->getMetadata();
+            out.number<uint8_t>(meta.getType()?1:0);
+            if(meta.getType()) {
+                out.text(*meta.getType());
+            }
+            out.number<int64_t>(meta.getCreated());
+            out.number<int64_t>(meta.getModified());
+            out.number<uint32_t>(meta.getRevision());
+            out.number<int64_t>(meta.getRead());
+            out.number<uint32_t>(meta.getReads());
+            out.number<int8_t>(meta.getImportance());
+            out.number<int8_t>(meta.getUrgency());
+            out.number<int8_t>(meta.getProgress());
+            out.number<int64_t>(meta.getDeadline());
+            const TimeScope& scope = meta.getTimeScope();
+            out.number<uint8_t>(scope.years);
+            out.number<uint8_t>(scope.months);
+            out.number<uint8_t>(scope.days);
+            out.number<uint8_t>(scope.hours);
+            out.number<uint8_t>(scope.minutes);
+            out.number<uint32_t>(meta.getTags().size());
+            for(const string* tag:meta.getTags()) {
+                out.text(*tag);
+            }
+            out.number<uint32_t>(meta.getLinks().size());
+            for(Link* link:meta.getLinks()) {
+                out.text(link->getName());
+                out.text(link->getUrl());
+            }
+        }
+    }
+}
+
+bool RepositorySnapshot::deserialize(const string& document, MarkdownDocument& md, time_t modified)
+{
+    SnapshotReader in{document.data(), document.size()};
+    MarkdownDocument::Format format = static_cast<MarkdownDocument::Format>(in.number<uint8_t>());
+    uint32_t fileSize = in.number<uint32_t>();
+
+    vector<MarkdownAstNodeSection*>* ast = new vector<MarkdownAstNodeSection*>{};
+    uint32_t count = in.number<uint32_t>();
+    for(uint32_t i=0; i<count && in.isOk(); i++) {
+        uint8_t flags = in.number<uint8_t>();
+        uint16_t depth = in.number<uint16_t>();
+        MarkdownAstNodeSection* section = (flags&1)
+            ? new MarkdownAstNodeSection(in.text())
+            : new MarkdownAstNodeSection();
+        ast->push_back(section);
+        section->setDepth(depth);
+        if(flags&(1<<2)) section->setPostDeclaredSection();
+        if(flags&(1<<3)) section->setTrailingHashesSection();
+        if(flags&(1<<1)) {
+            vector<string*>* body = new vector<string*>{};
+            uint32_t lines = in.number<uint32_t>();
+            body->reserve(lines<0xFFFF?lines:0xFFFF);
+            for(uint32_t l=0; l<lines && in.isOk(); l++) {
+                string* line = in.text();
+                if(line) {
+                    body->push_back(line);
+                }
+            }
+            section->setBody(body);
+        } else {
+            section->setBody(nullptr);
+        }
+
+        MarkdownAstSectionMetadata& meta = section->getMetadata();
+        if(in.number<uint8_t>()) {
+            meta.setType(in.text());
+        }
+        meta.setCreated(in.number<int64_t>());
+        meta.setModified(in.number<int64_t>());
+        meta.setRevision(in.number<uint32_t>());
+        meta.setRead(in.number<int64_t>());
+        meta.setReads(in.number<uint32_t>());
+        meta.setImportance(in.number<int8_t>());
+        meta.setUrgency(in.number<int8_t>());
+        meta.setProgress(in.number<int8_t>());
+        meta.setDeadline(in.number<int64_t>());
+        uint8_t years = in.number<uint8_t>();
+        uint8_t months = in.number<uint8_t>();
+        uint8_t days = in.number<uint8_t>();
+        uint8_t hours = in.number<uint8_t>();
+        uint8_t minutes = in.number<uint8_t>();
+        meta.setTimeScope(TimeScope{years, months, days, hours, minutes});
+        vector<string*> tags{};
+        uint32_t tagsCount = in.number<uint32_t>();
+        for(uint32_t t=0; t<tagsCount && in.isOk(); t++) {
+            string* tag = in.text();
+            if(tag) {
+                tags.push_back(tag);
+            }
+        }
+        meta.setTags(&tags);
+        vector<Link*> links{};
+        uint32_t linksCount = in.number<uint32_t>();
+        string name{}, url{};
+        for(uint32_t l=0; l<linksCount && in.isOk(); l++) {
+            if(in.text(name) && in.text(url)) {
+                links.push_back(new Link{name, url});
+            }
+        }
+        meta.setLinks(&links);
+    }
+
+    if(!in.isOk() || !in.isEnd()) {
+        for(MarkdownAstNodeSection* section:*ast) {
+            delete section;
+        }
+        delete ast;
+        return false;
+    }
+
+    md.from(ast, format, fileSize, modified);
+    return true;
+}
+
+} // m8r namespace
@@ -0,0 +1,128 @@
+/*
+ repository_snapshot.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_REPOSITORY_SNAPSHOT_H
+#define M8R_REPOSITORY_SNAPSHOT_H
+
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../debug.h"
+#include "../config/configuration.h"
+#include "../gear/file_utils.h"
+#include "../representations/markdown/markdown_document.h"
+
+namespace m8r {
+
+/**
+ * @brief Persistent binary snapshot of parsed repository Markdown files.
+ *
+ * Lexing and parsing of all repository Markdown files on every start is expensive,
+ * while most of the files typically didn't change since the last start. Snapshot
+ * keeps ASTs of parsed Markdown documents in a compact binary file stored in the
+ * user cache directory (not in repository, which might be versioned or synchronized). Snapshot record of a file is valid if file's modification
+ * time (nanoseconds) and size are the same or, if just the modification time changed,
+ * if file content hash is the same. Content of a racy record - file modified not
+ * earlier than the snapshot was written, i.e. possibly changed within the timestamp
+ * granularity after it was hashed - is always hashed. Valid records are restored
+ * instead of parsing.
+ *
+ * Snapshot keeps MarkdownDocument ASTs (not Outlines) so that Outlines, tags and
+ * types are always created by the Markdown representation and ontology exactly
+ * like when Markdown files are parsed.
+ *
+ * Binary format (native byte order, version mismatch invalidates snapshot):
+ *
+ *   MAGIC VERSION count (path mtime size hash length DOCUMENT)*
+ *
+ * Methods used by learning workers are thread safe.
+ */
+class RepositorySnapshot
+{
+public:
+    static constexpr uint32_t MAGIC = 0x5338524d; // M8RS
+    static constexpr uint32_t VERSION = 2;
+
+private:
+    struct Record {
+        // nanoseconds
+        int64_t modified;
+        uint64_t size;
+        uint64_t hash;
+        std::string document;
+        bool used;
+    };
+
+    std::string snapshotPath;
+    // snapshot file modification time (nanoseconds)
+    int64_t written;
+    std::unordered_map<std::string,Record> records;
+    bool dirty;
+
+    unsigned restored;
+    unsigned parsed;
+
+    std::mutex recordsMutex;
+
+public:
+    explicit RepositorySnapshot();
+    RepositorySnapshot(const RepositorySnapshot&) = delete;
+    RepositorySnapshot(const RepositorySnapshot&&) = delete;
+    RepositorySnapshot& operator=(const RepositorySnapshot&) = delete;
+    RepositorySnapshot& operator=(const RepositorySnapshot&&) = delete;
+    ~RepositorySnapshot();
+
+    /**
+     * @brief Load snapshot from file - missing, foreign or broken snapshot is ignored.
+     */
+    void load(const std::string& snapshotPath);
+    /**
+     * @brief Save snapshot (if changed) - records of files which were not used are dropped.
+     */
+    bool save();
+    void clear();
+
+    /**
+     * @brief Restore document from valid snapshot record or parse it and record it.
+     */
+    void from(MarkdownDocument& md);
+
+    bool isLoaded() const { return !snapshotPath.empty(); }
+    size_t size() const { return records.size(); }
+    unsigned getRestoredCount() const { return restored; }
+    unsigned getParsedCount() const { return parsed; }
+
+    static uint64_t hash(const char* data, size_t size);
+    /**
+     * @brief Get path of snapshot of given repository directory in cache directory.
+     */
+    static std::string path(const std::string& cacheDirectory, const std::string& repositoryDirectory);
+    static int64_t modificationTime(const struct stat& fileStat);
+
+private:
+    bool restore(MarkdownDocument& md, Record& record, time_t modified);
+    static void serialize(const MarkdownDocument& md, std::string& document);
+    static bool deserialize(const std::string& document, MarkdownDocument& md, time_t modified);
+};
+
+}
+#endif // M8R_REPOSITORY_SNAPSHOT_H
@@ -0,0 +1,330 @@
+/*
+ statistics_journal.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "statistics_journal.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <unordered_map>
+
+#include "../gear/file_utils.h"
+#include "../gear/string_utils.h"
+#include "filesystem_persistence.h"
+
+using namespace std;
+
+namespace m8r {
+
+constexpr const char* StatisticsJournal::MAGIC;
+constexpr int StatisticsJournal::VERSION;
+constexpr unsigned StatisticsJournal::DEFAULT_MAX_RECORDS;
+
+StatisticsJournal::StatisticsJournal(unsigned maxRecords)
+    : journalPath{},
+      repositoryPath{},
+      out{},
+      records{},
+      maxRecords{maxRecords},
+      compactAt{maxRecords},
+      journaled{}
+{
+}
+
+StatisticsJournal::~StatisticsJournal()
+{
+    close();
+}
+
+void StatisticsJournal::open(const string& journalPath, const string& repositoryPath)
+{
+    close();
+
+    this->journalPath = journalPath;
+    this->repositoryPath = repositoryPath;
+}
+
+void StatisticsJournal::close()
+{
+    if(out.is_open()) {
+        out.close();
+    }
+    journalPath.clear();
+    repositoryPath.clear();
+    records = 0;
+    compactAt = maxRecords;
+    journaled.clear();
+}
+
+string StatisticsJournal::toRelativePath(const string& path) const
+{
+    if(repositoryPath.size()
+         && path.size() > repositoryPath.size()
+         && stringStartsWith(path, repositoryPath)
+         && path[repositoryPath.size()] == FILE_PATH_SEPARATOR_CHAR)
+    {
+        return path.substr(repositoryPath.size()+1);
+    }
+    return path;
+}
+
+unsigned StatisticsJournal::replay(const vector<Outline*>& outlines)
+{
+    if(!isOpen()) {
+        return 0;
+    }
+
+    ifstream in{journalPath};
+    if(!in.is_open()) {
+        return 0;
+    }
+
+    string line{};
+    stringstream header{};
+    header << MAGIC << " " << VERSION;
+    if(!getline(in, line) || line != header.str()) {
+        MF_DEBUG("Journal: foreign or broken journal " << journalPath << " ignored" << endl);
+        in.close();
+        remove(journalPath.c_str());
+        return 0;
+    }
+
+    unordered_map<string,Outline*> keyToOutline{};
+    for(Outline* o:outlines) {
+        keyToOutline[toRelativePath(o->getKey())] = o;
+    }
+
+    unsigned applied{};
+    string kind{}, reads{}, read{}, path{}, offset{}, name{};
+    while(getline(in, line)) {
+        records++;
+
+        stringstream s{line};
+        if(!getline(s, kind, '\t') || kind != "R"
+             || !getline(s, reads, '\t')
+             || !getline(s, read, '\t')
+             || !getline(s, path, '\t')
+             || !getline(s, offset, '\t'))
+        {
+            // record truncated by a crash
+            continue;
+        }
+        if(!getline(s, name)) {
+            name.clear();
+        }
+
+        auto o = keyToOutline.find(path);
+        if(o == keyToOutline.end()) {
+            continue;
+        }
+
+        u_int32_t r;
+        time_t t;
+        int n;
+        try {
+            r = static_cast<u_int32_t>(stoul(reads));
+            t = static_cast<time_t>(stoll(read));
+            n = stoi(offset);
+        } catch(...) {
+            continue;
+        }
+
+        bool changed{false};
+        if(n < 0) {
+            if(r > o->second->getReads()) {
+                o->second->setReads(r);
+                changed = true;
+            }
+            if(t > o->second->getRead()) {
+                o->second->setRead(t);
+                changed = true;
+            }
+            if(changed) {
+                journal(o->second, nullptr, Record{-1, string{}, o->second->getReads(), o->second->getRead()});
+            }
+        } else {
+            const vector<Note*>& notes = o->second->getNotes();
+            // N is identified by offset, name check drops records of moved Ns
+            if(static_cast<size_t>(n) < notes.size() && notes[n]->getName() == name) {
+                Note* note = notes[n];
+                if(r > note->getReads()) {
+                    note->setReads(r);
+                    changed = true;
+                }
+                if(t > note->getRead()) {
+                    note->setRead(t);
+                    changed = true;
+                }
+                if(changed) {
+                    journal(o->second, note, Record{n, name, note->getReads(), note->getRead()});
+                }
+            }
+        }
+        if(changed) {
+            applied++;
+        }
+    }
+
+    MF_DEBUG("Journal: " << applied << " of " << records << " records applied to " << journaled.size() << " Os" << endl);
+    return applied;
+}
+
+void StatisticsJournal::journal(const Outline* outline, const Note* note, const Record& record)
+{
+    Journaled& j = journaled[outline];
+    if(j.path.empty()) {
+        j.path = toRelativePath(const_cast<Outline*>(outline)->getKey());
+        j.outline = false;
+    }
+    if(record.offset < 0) {
+        j.outline = true;
+        j.outlineRecord = record;
+    } else {
+        j.notes[note] = record;
+    }
+}
+
+void StatisticsJournal::write(ostream& o, const string& path, const Record& record) const
+{
+    string sanitizedName{record.name};
+    for(char& c:sanitizedName) {
+        if(c == '\t' || c == '\n' || c == '\r') {
+            c = ' ';
+        }
+    }
+
+    o << "R\t" << record.reads << "\t" << static_cast<long long>(record.read)
+      << "\t" << path
+      << "\t" << record.offset
+      << "\t" << sanitizedName << "\n";
+}
+
+void StatisticsJournal::append(const Outline* outline, const Note* note, const Record& record)
+{
+    if(!isOpen()) {
+        return;
+    }
+
+    if(!out.is_open()) {
+        bool exists = isFile(journalPath.c_str());
+        out.open(journalPath, ofstream::out | ofstream::app);
+        if(!out.is_open()) {
+            MF_DEBUG("Journal: unable to open " << journalPath << endl);
+            return;
+        }
+        if(!exists) {
+            out << MAGIC << " " << VERSION << "\n";
+        }
+    }
+
+    journal(outline, note, record);
+    write(out, journaled[outline].path, record);
+    // record is not synced - losing the last reads on a crash is fine
+    out.flush();
+
+    records++;
+}
+
+void StatisticsJournal::read(Outline* outline)
+{
+    if(outline) {
+        append(outline, nullptr, Record{-1, string{}, outline->getReads(), outline->getRead()});
+    }
+}
+
+void StatisticsJournal::read(Note* note)
+{
+    if(note && note->getOutline()) {
+        append(
+            note->getOutline(),
+            note,
+            Record{
+                note->getOutline()->getNoteOffset(note),
+                note->getName(),
+                note->getReads(),
+                note->getRead()});
+    }
+}
+
+vector<Outline*> StatisticsJournal::getJournaledOutlines() const
+{
+    vector<Outline*> outlines{};
+    for(const auto& j:journaled) {
+        outlines.push_back(const_cast<Outline*>(j.first));
+    }
+    return outlines;
+}
+
+void StatisticsJournal::truncate()
+{
+    if(!isOpen()) {
+        return;
+    }
+
+    if(out.is_open()) {
+        out.close();
+    }
+    remove(journalPath.c_str());
+    MF_DEBUG("Journal: " << records << " records of " << journaled.size() << " Os folded to Markdown" << endl);
+    records = 0;
+    compactAt = maxRecords;
+    journaled.clear();
+}
+
+void StatisticsJournal::forget(const Outline* outline)
+{
+    journaled.erase(outline);
+}
+
+void StatisticsJournal::compact()
+{
+    if(!isOpen()) {
+        return;
+    }
+
+    stringstream compacted{};
+    compacted << MAGIC << " " << VERSION << "\n";
+    unsigned compactedRecords{};
+    for(const auto& j:journaled) {
+        if(j.second.outline) {
+            write(compacted, j.second.path, j.second.outlineRecord);
+            compactedRecords++;
+        }
+        for(const auto& n:j.second.notes) {
+            // N might be moved since the read > write its current offset
+            Record record{n.second};
+            record.offset = j.first->getNoteOffset(n.first);
+            if(record.offset >= 0) {
+                write(compacted, j.second.path, record);
+                compactedRecords++;
+            }
+        }
+    }
+
+    if(out.is_open()) {
+        out.close();
+    }
+    if(FilesystemPersistence::writeFileAtomically(journalPath, compacted.str())) {
+        MF_DEBUG("Journal: compacted " << records << " records to " << compactedRecords << endl);
+        records = compactedRecords;
+    }
+    // don't compact on every read if most of the records are alive
+    compactAt = std::max(maxRecords, 2*records);
+}
+
+} // m8r namespace
@@ -0,0 +1,166 @@
+/*
+ statistics_journal.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_STATISTICS_JOURNAL_H
+#define M8R_STATISTICS_JOURNAL_H
+
+#include <fstream>
+#include <string>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include "../debug.h"
+#include "../model/outline.h"
+#include "../model/note.h"
+
+namespace m8r {
+
+/**
+ * @brief Optional append-only journal of volatile O/N statistics (reads, read timestamp).
+ *
+ * Reading an O or N changes just a counter in its metadata, but persisting
+ * it would mean rewriting the whole Markdown file. Instead, the journal
+ * file in repository directory gets one short line per read. Journal is
+ * replayed when the repository is learned (crash recovery) and it is folded
+ * back into Markdown metadata of the journaled Os on idle or shutdown - Os
+ * are saved once and the journal is truncated. When it grows too big
+ * in the meantime, it is compacted to the latest record of every journaled
+ * thing.
+ *
+ * Records keep absolute values (not increments) and replay keeps the
+ * maximum of the journaled and learned value - records made obsolete by a
+ * save of the O, or records of changed/removed Os, do no harm.
+ *
+ * Format (one record per line, tab separated, O path relative to repository):
+ *
+ *   M8RJ VERSION
+ *   R reads read O-path N-offset N-name
+ *
+ * N offset is -1 for O. N is identified by O path and N offset, N name just
+ * verifies that the offset still points to the same N - record of N which
+ * was moved in the meantime is dropped.
+ */
+class StatisticsJournal
+{
+public:
+    static constexpr const char* MAGIC = "M8RJ";
+    static constexpr int VERSION = 1;
+    // journal is compacted once it has this many records
+    static constexpr unsigned DEFAULT_MAX_RECORDS = 10000;
+
+private:
+    struct Record {
+        int offset;
+        std::string name;
+        u_int32_t reads;
+        time_t read;
+    };
+
+    /**
+     * @brief The latest records of O and its Ns newer than O's Markdown file.
+     */
+    struct Journaled {
+        std::string path;
+        bool outline;
+        Record outlineRecord;
+        std::unordered_map<const Note*,Record> notes;
+    };
+
+    std::string journalPath;
+    std::string repositoryPath;
+    std::ofstream out;
+
+    unsigned records;
+    unsigned maxRecords;
+    // compaction threshold - raised if compacted journal is still big
+    unsigned compactAt;
+
+    std::unordered_map<const Outline*,Journaled> journaled;
+
+public:
+    explicit StatisticsJournal(unsigned maxRecords=DEFAULT_MAX_RECORDS);
+    StatisticsJournal(const StatisticsJournal&) = delete;
+    StatisticsJournal(const StatisticsJournal&&) = delete;
+    StatisticsJournal& operator=(const StatisticsJournal&) = delete;
+    StatisticsJournal& operator=(const StatisticsJournal&&) = delete;
+    ~StatisticsJournal();
+
+    /**
+     * @brief Open journal file of given repository (it's created on the first record).
+     */
+    void open(const std::string& journalPath, const std::string& repositoryPath);
+    /**
+     * @brief Close journal - records are kept in the file.
+     */
+    void close();
+    bool isOpen() const { return !journalPath.empty(); }
+
+    /**
+     * @brief Apply journal records to learned Os.
+     *
+     * @return Number of applied records.
+     */
+    unsigned replay(const std::vector<Outline*>& outlines);
+
+    /**
+     * @brief Journal statistics of the read O.
+     */
+    void read(Outline* outline);
+    /**
+     * @brief Journal statistics of the read N.
+     */
+    void read(Note* note);
+
+    /**
+     * @brief Get Os w/ journaled statistics which are not in their Markdown files yet.
+     */
+    std::vector<Outline*> getJournaledOutlines() const;
+    /**
+     * @brief Journaled Os were saved - drop all records and remove the journal file.
+     */
+    void truncate();
+
+    /**
+     * @brief O was saved or forgotten - its records don't have to be kept on compaction.
+     */
+    void forget(const Outline* outline);
+
+    /**
+     * @brief Does the journal have too many records?
+     */
+    bool isCompactionNeeded() const { return records >= compactAt; }
+    /**
+     * @brief Atomically rewrite journal w/ the latest record of every journaled thing.
+     *
+     * Cost is proportional to the number of journaled things, no Markdown file is written.
+     */
+    void compact();
+
+    unsigned getRecordsCount() const { return records; }
+    size_t getJournaledOutlinesCount() const { return journaled.size(); }
+
+private:
+    void journal(const Outline* outline, const Note* note, const Record& record);
+    void write(std::ostream& o, const std::string& path, const Record& record) const;
+    void append(const Outline* outline, const Note* note, const Record& record);
+    std::string toRelativePath(const std::string& path) const;
+};
+
+}
+#endif // M8R_STATISTICS_JOURNAL_H
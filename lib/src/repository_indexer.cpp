@@ -24,7 +24,8 @@ using namespace m8r::filesystem;
 namespace m8r {
 
 RepositoryIndexer::RepositoryIndexer()
-    : repository(nullptr)
+    : repository(nullptr),
+      directoryWalker{}
 {}
 
 RepositoryIndexer::~RepositoryIndexer() {
@@ -123,42 +124,11 @@ void RepositoryIndexer::updateIndex() {
 void RepositoryIndexer::updateIndexMemory(const string& directory)
 {
     if(repository->getMode() == Repository::RepositoryMode::REPOSITORY) {
-        MF_DEBUG(endl << "INDEXING memory DIR: " << directory);
-        DIR* dir;
-        if((dir = opendir(directory.c_str()))) {
-            const struct dirent *entry;
-            if((entry = readdir(dir))) {
-                string path;
-                string* ppath;
-                do {
-                    if(entry->d_type == DT_DIR) {
-                        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-                            continue;
-                        }
-                        //MF_DEBUG(endl << "DIVE> " << directory.c_str() << "//" << entry->d_name);
-                        path.assign(directory);
-                        path += FILE_PATH_SEPARATOR;
-                        path += entry->d_name;
-
-                        updateIndexMemory(path);
-                    } else {
-                        MF_DEBUG(endl << "  FILE: " << directory.c_str() << "//" << entry->d_name);
-                        ppath = new string{directory};
-                        ppath->append(FILE_PATH_SEPARATOR);
-                        ppath->append(entry->d_name);
-
-                        allFiles.insert(ppath);
-                        if(File::fileHasMarkdownExtension(*ppath)) {
-                            markdowns.insert(ppath);
-                        } else if(File::fileHasPdfExtension(*ppath)) {
-                            pdfs.insert(ppath);
-                        } else if(File::fileHasTextExtension(*ppath)) {
-                            texts.insert(ppath);
-                        }
-                    }
-                } while ((entry = readdir(dir)) != 0);
-                closedir(dir);
-            }
+        MF_DEBUG(endl << "INDEXING memory DIR: " << directory << " w/ " << directoryWalker.getThreads() << " threads");
+        vector<string> files{};
+        directoryWalker.walk(directory, files);
+        for(string& file:files) {
+            indexFile(new string{std::move(file)});
         }
     } else {
         MF_DEBUG(endl << "INDEXING memory single FILE: " << repository->getFile() << " in " << repository->getDir());
@@ -174,6 +144,104 @@ void RepositoryIndexer::updateIndexMemory(const string& directory)
     }
 }
 
+void RepositoryIndexer::indexFile(const string* path)
+{
+    allFiles.insert(path);
+    if(File::fileHasMarkdownExtension(*path)) {
+        markdowns.insert(path);
+    } else if(File::fileHasPdfExtension(*path)) {
+        pdfs.insert(path);
+    } else if(File::fileHasTextExtension(*path)) {
+        texts.insert(path);
+    }
+}
+
+const string* RepositoryIndexer::findFile(const string& path) const
+{
+    // IMPROVE sets are ordered by pointers > lookup by path is linear (it is rare)
+    for(const string* f:allFiles) {
+        if(*f == path) {
+            return f;
+        }
+    }
+    return nullptr;
+}
+
+bool RepositoryIndexer::isIgnored(const string& path) const
+{
+    if(directoryWalker.getIgnorePatterns().empty()) {
+        return false;
+    }
+
+    // check names of the path components below memory directory
+    size_t begin = stringStartsWith(path, memoryDirectory) ? memoryDirectory.size() : 0;
+    string name{};
+    while(begin < path.size()) {
+        while(begin < path.size() && path[begin] == FILE_PATH_SEPARATOR_CHAR) {
+            begin++;
+        }
+        size_t end = path.find(FILE_PATH_SEPARATOR_CHAR, begin);
+        if(end == string::npos) {
+            end = path.size();
+        }
+        if(end > begin) {
+            name.assign(path, begin, end-begin);
+            if(directoryWalker.isIgnored(name.c_str())) {
+                return true;
+            }
+        }
+        begin = end;
+    }
+    return false;
+}
+
+bool RepositoryIndexer::addFile(const string& path)
+{
+    if(isIgnored(path)) {
+        return false;
+    }
+    if(!findFile(path)) {
+        MF_DEBUG("Indexer: adding file " << path << endl);
+        indexFile(new string{path});
+    }
+    return File::fileHasMarkdownExtension(path);
+}
+
+void RepositoryIndexer::removeFile(const string& path)
+{
+    const string* f = findFile(path);
+    if(f) {
+        MF_DEBUG("Indexer: removing file " << path << endl);
+        markdowns.erase(f);
+        pdfs.erase(f);
+        texts.erase(f);
+        allFiles.erase(f);
+        delete f;
+    }
+}
+
+void RepositoryIndexer::removeDirectory(const string& directory, vector<string>& removedMarkdowns)
+{
+    string prefix{directory};
+    prefix += FILE_PATH_SEPARATOR;
+
+    vector<const string*> removed{};
+    for(const string* f:allFiles) {
+        if(stringStartsWith(*f, prefix)) {
+            removed.push_back(f);
+        }
+    }
+    for(const string* f:removed) {
+        if(markdowns.erase(f)) {
+            removedMarkdowns.push_back(*f);
+        }
+        pdfs.erase(f);
+        texts.erase(f);
+        allFiles.erase(f);
+        delete f;
+    }
+}
+
 void RepositoryIndexer::updateIndexStencils(const string& directory, set<const std::string*>& stencils)
 {
     MF_DEBUG(endl << "INDEXING stencils DIR: " << directory);
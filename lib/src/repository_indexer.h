@@ -34,6 +34,7 @@
 #include <vector>
 
 #include "debug.h"
+#include "gear/directory_walker.h"
 #include "gear/file_utils.h"
 #include "gear/string_utils.h"
 #include "config/configuration.h"
@@ -77,6 +78,9 @@ private:
     std::string outlineStencilsDirectory;
     std::string noteStencilsDirectory;
 
+    // memory directory is walked in parallel
+    DirectoryWalker directoryWalker;
+
     std::set<const std::string*> allFiles;
     std::set<const std::string*> markdowns;
     std::set<const std::string*> outlineStencils;
@@ -100,6 +104,8 @@ public:
     virtual ~RepositoryIndexer();
 
     Repository* getRepository() const { return repository; }
+    const std::string& getMemoryDirectory() const { return memoryDirectory; }
+    DirectoryWalker& getDirectoryWalker() { return directoryWalker; }
 
     const std::set<const std::string*> getMarkdownFiles() const;
     const std::set<const std::string*> getPdfFiles() const;
@@ -119,6 +125,22 @@ public:
      */
     void updateIndex();
 
+    /**
+     * @brief Add file created outside of MindForger to the index w/o rescan.
+     * @return true if file is a Markdown file which is not ignored.
+     */
+    bool addFile(const std::string& path);
+
+    /**
+     * @brief Remove deleted file from the index.
+     */
+    void removeFile(const std::string& path);
+
+    /**
+     * @brief Remove all files from deleted directory (and its subdirectories) from the index.
+     */
+    void removeDirectory(const std::string& directory, std::vector<std::string>& removedMarkdowns);
+
     /**
      * @brief Clear all fields.
      */
@@ -126,6 +148,9 @@ public:
 
 private:
     void updateIndexMemory(const std::string& directory);
+    void indexFile(const std::string* path);
+    const std::string* findFile(const std::string& path) const;
+    bool isIgnored(const std::string& path) const;
     void updateIndexStencils(const std::string& directory, std::set<const std::string*>& stencils);
 };
 
@@ -0,0 +1,345 @@
+/*
+ repository_watcher.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "repository_watcher.h"
+
+#ifdef __linux__
+  #include <dirent.h>
+  #include <sys/inotify.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+  #include <cerrno>
+  #include <cstring>
+#endif
+
+#include "definitions.h"
+#include "config/configuration.h"
+#include "gear/file_utils.h"
+#include "gear/lang_utils.h"
+#include "gear/string_utils.h"
+
+using namespace std;
+
+namespace m8r {
+
+#ifdef __linux__
+static constexpr uint32_t WATCH_MASK
+    = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+    | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+constexpr int RepositoryWatcher::DEFAULT_DEBOUNCE_MILLIS;
+constexpr int RepositoryWatcher::DEFAULT_MAX_DEBOUNCE_MILLIS;
+
+RepositoryWatcher::RepositoryWatcher(int debounceMillis, int maxDebounceMillis)
+    : fd{-1},
+      root{},
+      watches{},
+      pending{},
+      overflow{false},
+      expected{},
+      debounce{debounceMillis},
+      maxDebounce{maxDebounceMillis},
+      firstEvent{},
+      lastEvent{}
+{
+}
+
+RepositoryWatcher::~RepositoryWatcher()
+{
+    unwatch();
+}
+
+bool RepositoryWatcher::isSupported()
+{
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool RepositoryWatcher::watch(const string& directory)
+{
+    unwatch();
+
+#ifdef __linux__
+    int descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(descriptor < 0) {
+        MF_DEBUG("Watcher: unable to initialize inotify: " << strerror(errno) << endl);
+        return false;
+    }
+    {
+        lock_guard<mutex> criticalSection{expectedMutex};
+        fd = descriptor;
+    }
+
+    root = directory;
+    watchDirectory(root, false);
+    if(watches.empty()) {
+        unwatch();
+        return false;
+    }
+
+    MF_DEBUG("Watcher: watching " << watches.size() << " directories in " << root << endl);
+    return true;
+#else
+    UNUSED_ARG(directory);
+    return false;
+#endif
+}
+
+void RepositoryWatcher::unwatch()
+{
+    lock_guard<mutex> criticalSection{expectedMutex};
+#ifdef __linux__
+    if(fd >= 0) {
+        // closing the descriptor removes all watches
+        close(fd);
+    }
+#endif
+    fd = -1;
+    root.clear();
+    watches.clear();
+    pending.clear();
+    expected.clear();
+    overflow = false;
+}
+
+void RepositoryWatcher::watchDirectory(const string& directory, bool reportFiles)
+{
+#ifdef __linux__
+    int wd = inotify_add_watch(fd, directory.c_str(), WATCH_MASK);
+    if(wd < 0) {
+        MF_DEBUG("Watcher: unable to watch " << directory << ": " << strerror(errno) << endl);
+        return;
+    }
+    watches[wd] = directory;
+
+    // directory is watched BEFORE it's listed > no file is missed
+    DIR* dir;
+    if((dir = opendir(directory.c_str()))) {
+        const struct dirent* entry;
+        string path{};
+        while((entry = readdir(dir)) != nullptr) {
+            if(strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+                continue;
+            }
+            path.assign(directory);
+            path += FILE_PATH_SEPARATOR;
+            path += entry->d_name;
+            if(entry->d_type == DT_DIR) {
+                watchDirectory(path, reportFiles);
+            } else if(reportFiles && entry->d_type == DT_REG) {
+                change(path, ChangeType::UPDATED);
+            }
+        }
+        closedir(dir);
+    }
+#else
+    UNUSED_ARG(directory);
+    UNUSED_ARG(reportFiles);
+#endif
+}
+
+void RepositoryWatcher::unwatchDirectory(const string& directory)
+{
+#ifdef __linux__
+    string prefix{directory};
+    prefix += FILE_PATH_SEPARATOR;
+    for(auto w=watches.begin(); w!=watches.end(); ) {
+        if(w->second == directory || stringStartsWith(w->second, prefix)) {
+            // watch of deleted directory is already removed by kernel
+            inotify_rm_watch(fd, w->first);
+            w = watches.erase(w);
+        } else {
+            ++w;
+        }
+    }
+#else
+    UNUSED_ARG(directory);
+#endif
+}
+
+void RepositoryWatcher::change(const string& path, ChangeType type)
+{
+    if(type == ChangeType::DIRECTORY_REMOVED) {
+        // changes of the directory files are superseded
+        string prefix{path};
+        prefix += FILE_PATH_SEPARATOR;
+        for(auto p=pending.lower_bound(prefix); p!=pending.end() && stringStartsWith(p->first, prefix); ) {
+            p = pending.erase(p);
+        }
+    }
+
+    auto now = chrono::steady_clock::now();
+    if(pending.empty() && !overflow) {
+        firstEvent = now;
+    }
+    lastEvent = now;
+
+    // coalesce: the last change wins
+    pending[path] = type;
+}
+
+void RepositoryWatcher::rescan()
+{
+    auto now = chrono::steady_clock::now();
+    if(pending.empty() && !overflow) {
+        firstEvent = now;
+    }
+    lastEvent = now;
+    overflow = true;
+}
+
+void RepositoryWatcher::readEvents()
+{
+#ifdef __linux__
+    alignas(struct inotify_event) char buffer[64*1024];
+    ssize_t length;
+    while((length = read(fd, buffer, sizeof(buffer))) > 0) {
+        for(char* p = buffer; p < buffer+length; ) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + event->len;
+
+            if(event->mask & IN_Q_OVERFLOW) {
+                MF_DEBUG("Watcher: events queue OVERFLOW" << endl);
+                rescan();
+                continue;
+            }
+
+            auto w = watches.find(event->wd);
+            if(w == watches.end()) {
+                continue;
+            }
+            if(event->mask & IN_IGNORED) {
+                watches.erase(w);
+                continue;
+            }
+            if(event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                if(w->second == root) {
+                    MF_DEBUG("Watcher: repository directory is GONE" << endl);
+                    rescan();
+                }
+                continue;
+            }
+            if(!event->len) {
+                continue;
+            }
+
+            string path{w->second};
+            path += FILE_PATH_SEPARATOR;
+            path += event->name;
+            if(stringEndsWith(path, FILE_EXTENSION_TEMPORARY)) {
+                continue;
+            }
+
+            if(event->mask & IN_ISDIR) {
+                if(event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    MF_DEBUG("Watcher: directory added " << path << endl);
+                    watchDirectory(path, true);
+                } else if(event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    MF_DEBUG("Watcher: directory removed " << path << endl);
+                    unwatchDirectory(path);
+                    change(path, ChangeType::DIRECTORY_REMOVED);
+                }
+            } else {
+                // IN_CREATE is followed by IN_CLOSE_WRITE (file is complete then)
+                if(event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                    change(path, ChangeType::UPDATED);
+                } else if(event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    change(path, ChangeType::REMOVED);
+                }
+            }
+        }
+    }
+#endif
+}
+
+bool RepositoryWatcher::stamp(const string& path, FileStamp& fileStamp)
+{
+#ifdef __linux__
+    struct stat fileStat;
+    if(stat(path.c_str(), &fileStat)) {
+        return false;
+    }
+    fileStamp.mtimeNanos
+        = static_cast<long long>(fileStat.st_mtim.tv_sec)*1000000000LL + fileStat.st_mtim.tv_nsec;
+    fileStamp.size = static_cast<long long>(fileStat.st_size);
+    return true;
+#else
+    UNUSED_ARG(path);
+    UNUSED_ARG(fileStamp);
+    return false;
+#endif
+}
+
+void RepositoryWatcher::expect(const string& path, const string& replacement)
+{
+    // rename keeps mtime and size of the replacement
+    FileStamp fileStamp;
+    lock_guard<mutex> criticalSection{expectedMutex};
+    if(isWatching() && stamp(replacement, fileStamp)) {
+        expected[path] = fileStamp;
+    }
+}
+
+bool RepositoryWatcher::poll(vector<Change>& changes)
+{
+    if(!isWatching()) {
+        return false;
+    }
+
+    readEvents();
+    if(pending.empty() && !overflow) {
+        return false;
+    }
+
+    auto now = chrono::steady_clock::now();
+    if(now - lastEvent < debounce && now - firstEvent < maxDebounce) {
+        return false;
+    }
+
+    if(overflow) {
+        changes.push_back(Change{root, ChangeType::RESCAN});
+    } else {
+        lock_guard<mutex> criticalSection{expectedMutex};
+        for(const auto& p:pending) {
+            auto e = expected.find(p.first);
+            if(e != expected.end()) {
+                FileStamp fileStamp;
+                if(p.second == ChangeType::UPDATED
+                     && stamp(p.first, fileStamp)
+                     && fileStamp == e->second)
+                {
+                    MF_DEBUG("Watcher: skipping file written by MindForger " << p.first << endl);
+                    continue;
+                }
+                expected.erase(e);
+            }
+            changes.push_back(Change{p.first, p.second});
+        }
+    }
+    pending.clear();
+    overflow = false;
+
+    MF_DEBUG("Watcher: " << changes.size() << " changes" << endl);
+    return !changes.empty();
+}
+
+} // m8r namespace
@@ -0,0 +1,157 @@
+/*
+ repository_watcher.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef M8R_REPOSITORY_WATCHER_H_
+#define M8R_REPOSITORY_WATCHER_H_
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "debug.h"
+
+namespace m8r {
+
+/**
+ * @brief Repository watcher reports files changed outside of MindForger.
+ *
+ * Watcher uses Linux inotify to watch memory directory and its subdirectories
+ * (new subdirectories are watched as they appear). Events are coalesced per
+ * path (e.g. create + write + write is a single UPDATED change) and debounced:
+ * changes are reported once there was no event for the debounce period (bursts
+ * like git pull or sync are reported as a single batch), but at latest after
+ * the max debounce period.
+ *
+ * Watcher does NOT have a thread - it's polled w/o blocking by the thread
+ * which owns Mind (e.g. by UI timer) as Memory must be modified by that thread.
+ *
+ * Files written by MindForger itself must be announced using expect() to avoid
+ * re-learning of just saved Os. Temporary files of atomic writes are ignored.
+ *
+ * Watcher is a no-op on platforms w/o inotify.
+ */
+class RepositoryWatcher
+{
+public:
+    static constexpr int DEFAULT_DEBOUNCE_MILLIS = 300;
+    static constexpr int DEFAULT_MAX_DEBOUNCE_MILLIS = 3000;
+
+    enum class ChangeType {
+        // file created, modified or moved to watched directory
+        UPDATED,
+        // file deleted or moved away from watched directory
+        REMOVED,
+        // directory deleted or moved away (its files are NOT reported)
+        DIRECTORY_REMOVED,
+        // events were lost (kernel queue overflow) - rescan is needed
+        RESCAN
+    };
+
+    struct Change {
+        std::string path;
+        ChangeType type;
+    };
+
+private:
+    struct FileStamp {
+        long long mtimeNanos;
+        long long size;
+
+        bool operator==(const FileStamp& o) const {
+            return mtimeNanos==o.mtimeNanos && size==o.size;
+        }
+    };
+
+    int fd;
+    std::string root;
+
+    // watch descriptor > directory
+    std::map<int,std::string> watches;
+    // coalesced changes which wait for debounce period
+    std::map<std::string,ChangeType> pending;
+    bool overflow;
+    // files written by MindForger
+    std::map<std::string,FileStamp> expected;
+    // guards expected and fd as files are expected by persistence writer thread
+    std::mutex expectedMutex;
+
+    std::chrono::milliseconds debounce;
+    std::chrono::milliseconds maxDebounce;
+    std::chrono::steady_clock::time_point firstEvent;
+    std::chrono::steady_clock::time_point lastEvent;
+
+public:
+    explicit RepositoryWatcher(
+        int debounceMillis=DEFAULT_DEBOUNCE_MILLIS,
+        int maxDebounceMillis=DEFAULT_MAX_DEBOUNCE_MILLIS);
+    RepositoryWatcher(const RepositoryWatcher&) = delete;
+    RepositoryWatcher(const RepositoryWatcher&&) = delete;
+    RepositoryWatcher& operator=(const RepositoryWatcher&) = delete;
+    RepositoryWatcher& operator=(const RepositoryWatcher&&) = delete;
+    ~RepositoryWatcher();
+
+    /**
+     * @brief Is watching supported on this platform?
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Start watching directory and its subdirectories (previous watch is stopped).
+     */
+    bool watch(const std::string& directory);
+
+    /**
+     * @brief Stop watching and drop pending changes.
+     */
+    void unwatch();
+
+    bool isWatching() const { return fd >= 0; }
+    const std::string& getRoot() const { return root; }
+    size_t getWatchedDirectoriesCount() const { return watches.size(); }
+
+    /**
+     * @brief File is written by MindForger - don't report it unless it's modified again.
+     *
+     * Call it once the replacement (written file or temporary file which is
+     * about to be renamed to path) is complete, but BEFORE it's renamed - it
+     * can be called from any thread.
+     */
+    void expect(const std::string& path, const std::string& replacement);
+
+    /**
+     * @brief Read pending events w/o blocking and get debounced changes.
+     *
+     * @return true if there are changes.
+     */
+    bool poll(std::vector<Change>& changes);
+
+private:
+    void readEvents();
+    void watchDirectory(const std::string& directory, bool reportFiles);
+    void unwatchDirectory(const std::string& directory);
+    void change(const std::string& path, ChangeType type);
+    void rescan();
+
+    static bool stamp(const std::string& path, FileStamp& fileStamp);
+};
+
+} // m8r namespace
+
+#endif /* M8R_REPOSITORY_WATCHER_H_ */
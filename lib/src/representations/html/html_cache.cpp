@@ -0,0 +1,139 @@
+/*
+ html_cache.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "html_cache.h"
+
+using namespace std;
+
+namespace m8r {
+
+constexpr size_t HtmlCache::DEFAULT_MAX_ENTRIES;
+constexpr size_t HtmlCache::DEFAULT_MAX_BYTES;
+
+HtmlCache::HtmlCache(size_t maxEntries, size_t maxBytes)
+    : maxEntries{maxEntries},
+      maxBytes{maxBytes},
+      bytes{},
+      entries{},
+      index{},
+      hits{},
+      misses{}
+{
+}
+
+HtmlCache::~HtmlCache()
+{
+}
+
+bool HtmlCache::get(const string& key, string& html)
+{
+    lock_guard<mutex> criticalSection{entriesMutex};
+
+    auto i = index.find(key);
+    if(i == index.end()) {
+        misses++;
+        return false;
+    }
+
+    // move to front as the most recently used
+    entries.splice(entries.begin(), entries, i->second);
+    html += i->second->html;
+    hits++;
+    return true;
+}
+
+void HtmlCache::put(const string& key, const string& outlineKey, const string& html)
+{
+    if(!maxEntries || html.size() > maxBytes) {
+        return;
+    }
+
+    lock_guard<mutex> criticalSection{entriesMutex};
+
+    auto i = index.find(key);
+    if(i != index.end()) {
+        bytes -= i->second->html.size();
+        entries.erase(i->second);
+        index.erase(i);
+    }
+
+    entries.push_front(Entry{key, outlineKey, html});
+    index[key] = entries.begin();
+    bytes += html.size();
+
+    evict();
+}
+
+void HtmlCache::evict()
+{
+    while(entries.size() > maxEntries || bytes > maxBytes) {
+        bytes -= entries.back().html.size();
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
+
+void HtmlCache::forget(const string& outlineKey)
+{
+    lock_guard<mutex> criticalSection{entriesMutex};
+
+    for(auto i=entries.begin(); i!=entries.end(); ) {
+        if(i->outlineKey == outlineKey) {
+            bytes -= i->html.size();
+            index.erase(i->key);
+            i = entries.erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void HtmlCache::clear()
+{
+    lock_guard<mutex> criticalSection{entriesMutex};
+
+    entries.clear();
+    index.clear();
+    bytes = 0;
+}
+
+size_t HtmlCache::size() const
+{
+    lock_guard<mutex> criticalSection{entriesMutex};
+    return entries.size();
+}
+
+size_t HtmlCache::getBytes() const
+{
+    lock_guard<mutex> criticalSection{entriesMutex};
+    return bytes;
+}
+
+unsigned long HtmlCache::getHits() const
+{
+    lock_guard<mutex> criticalSection{entriesMutex};
+    return hits;
+}
+
+unsigned long HtmlCache::getMisses() const
+{
+    lock_guard<mutex> criticalSection{entriesMutex};
+    return misses;
+}
+
+} // m8r namespace
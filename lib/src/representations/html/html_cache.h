@@ -0,0 +1,103 @@
+/*
+ html_cache.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_HTML_CACHE_H
+#define M8R_HTML_CACHE_H
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace m8r {
+
+/**
+ * @brief Bounded LRU cache of rendered HTML.
+ *
+ * Entry is identified by a key which must capture everything the HTML depends
+ * on (thing key, revision, modified timestamp, rendering options, ...) - stale
+ * entries are never served as a changed thing has a different key. Entries
+ * are also bound to the key of their O so that they can be evicted when the O
+ * is remembered or forgotten.
+ *
+ * Cache is bounded by both the number of entries and the bytes of HTML,
+ * least recently used entries are evicted first.
+ */
+class HtmlCache
+{
+public:
+    // whole O HTML is cached as per N fragments > large Os need many entries
+    static constexpr size_t DEFAULT_MAX_ENTRIES = 16*1024;
+    static constexpr size_t DEFAULT_MAX_BYTES = 32*1024*1024;
+
+private:
+    struct Entry {
+        std::string key;
+        std::string outlineKey;
+        std::string html;
+    };
+
+    size_t maxEntries;
+    size_t maxBytes;
+    size_t bytes;
+
+    // most recently used entry first
+    std::list<Entry> entries;
+    std::unordered_map<std::string,std::list<Entry>::iterator> index;
+
+    unsigned long hits;
+    unsigned long misses;
+
+    mutable std::mutex entriesMutex;
+
+public:
+    explicit HtmlCache(size_t maxEntries=DEFAULT_MAX_ENTRIES, size_t maxBytes=DEFAULT_MAX_BYTES);
+    HtmlCache(const HtmlCache&) = delete;
+    HtmlCache(const HtmlCache&&) = delete;
+    HtmlCache &operator=(const HtmlCache&) = delete;
+    HtmlCache &operator=(const HtmlCache&&) = delete;
+    ~HtmlCache();
+
+    /**
+     * @brief Append cached HTML to html and return true on hit.
+     */
+    bool get(const std::string& key, std::string& html);
+
+    /**
+     * @brief Cache HTML - HTML bigger than the whole cache is not cached.
+     */
+    void put(const std::string& key, const std::string& outlineKey, const std::string& html);
+
+    /**
+     * @brief Evict all entries of given O.
+     */
+    void forget(const std::string& outlineKey);
+
+    void clear();
+
+    size_t size() const;
+    size_t getBytes() const;
+    unsigned long getHits() const;
+    unsigned long getMisses() const;
+
+private:
+    void evict();
+};
+
+}
+#endif // M8R_HTML_CACHE_H
@@ -18,6 +18,9 @@
  */
 #include "html_outline_representation.h"
 
+#include <algorithm>
+#include <cstdio>
+
 namespace m8r {
 
 using namespace std;
@@ -28,7 +31,9 @@ HtmlOutlineRepresentation::HtmlOutlineRepresentation(
     : config(Configuration::getInstance()),
       exportColors{},
       lf{exportColors},
-      markdownRepresentation(ontology, descriptionInterceptor)
+      markdownRepresentation(ontology, descriptionInterceptor),
+      htmlCache{},
+      autolinkingGeneration{}
 {
 #if defined MF_MD_2_HTML_CMARK
     markdownTranscoder = new CmarkGfmMarkdownTranscoder{};
@@ -283,17 +288,7 @@ string* HtmlOutlineRepresentation::to(const string* markdown, string* html, stri
     } else {
         html->clear();
         header(*html, basePath, standalone, yScrollTo);
-
-        if(markdown->size() > 0) {
-#ifdef MF_NO_MD_2_HTML
-            html->append("<pre>");
-            html->append(*markdown);
-            html->append("</pre>");
-#else
-            markdownTranscoder->to(RepresentationType::HTML, markdown, html);
-#endif
-        }
-
+        body(markdown, *html);
         footer(*html);
     }
 
@@ -304,6 +299,56 @@ string* HtmlOutlineRepresentation::to(const string* markdown, string* html, stri
     return html;
 }
 
+void HtmlOutlineRepresentation::body(const string* markdown, string& html)
+{
+    if(markdown->size() > 0) {
+#ifdef MF_NO_MD_2_HTML
+        html.append("<pre>");
+        transcode(markdown, html);
+        html.append("</pre>");
+#else
+        transcode(markdown, html);
+#endif
+    }
+}
+
+void HtmlOutlineRepresentation::transcode(const string* markdown, string& html)
+{
+#ifdef MF_NO_MD_2_HTML
+    html.append(*markdown);
+#else
+    markdownTranscoder->to(RepresentationType::HTML, markdown, &html);
+#endif
+}
+
+void HtmlOutlineRepresentation::htmlCacheKey(
+        const void* thing,
+        const string& outlineKey,
+        const string& name,
+        time_t modified,
+        u_int32_t revision,
+        unsigned int flags,
+        string& key) const
+{
+    // thing address distinguishes Ns w/ the same name in an O
+    char buffer[100];
+    snprintf(
+        buffer,
+        sizeof(buffer),
+        "%p %lld %u %x %x %lu ",
+        thing,
+        static_cast<long long>(modified),
+        revision,
+        flags,
+        config.getMd2HtmlOptions(),
+        flags&HTML_CACHE_AUTOLINKING?autolinkingGeneration:0);
+    key.reserve(outlineKey.size()+name.size()+sizeof(buffer)+1);
+    key.assign(buffer);
+    key += outlineKey;
+    key += "#";
+    key += name;
+}
+
 string* HtmlOutlineRepresentation::toNoMeta(Outline* outline, string* html, bool standalone, int yScrollTo)
 {
     // IMPROVE markdown can be processed by Mind to be enriched with various links and relationships
@@ -320,7 +365,8 @@ string* HtmlOutlineRepresentation::to(
         bool autolinking,
         bool whole,
         bool metadata,
-        int yScrollTo)
+        int yScrollTo,
+        bool cache)
 {
     if(!metadata) {
         return toNoMeta(outline, html, standalone, yScrollTo);
@@ -422,44 +468,44 @@ string* HtmlOutlineRepresentation::to(
         htmlHeader += "<br/>";
 
         // HTML completion
-        string outlineMd{};
         string path, file;
         pathToDirectoryAndFile(outline->getKey(), path, file);
 
-        // O header
-        if(autolinking) {
-            markdownRepresentation.toDescription(
-                outline->getOutlineDescriptorAsNote(),
-                &outlineMd,
-                autolinking
-            );
-        } else {
-            outlineMd.append(
-                outline->getOutlineDescriptorAsNote()->getDescriptionAsString()
-            );
-        }
-        // Ns
-        if(whole) {
-            const vector<Note*>& notes=outline->getNotes();
-            if(notes.size()) {
-                string noteMd{};
-                for(Note* note:notes) {
-                    outlineMd.append("\n");
-                    // TODO MD representation to render also tags as HTML injected code (under section)
-                    markdownRepresentation.to(
-                        note,
-                        &noteMd,
-                        outline->getFormat()==MarkdownDocument::Format::MINDFORGER,
-                        autolinking
-                    );
-                    outlineMd.append(noteMd);
-                    noteMd.clear();
-                }
+        if(cache) {
+            string cacheKey{};
+            unsigned int flags = HTML_CACHE_OUTLINE;
+            if(autolinking) flags |= HTML_CACHE_AUTOLINKING;
+            if(autolinking && config.isAutolinkingCaseInsensitive()) flags |= HTML_CACHE_CASE_INSENSITIVE;
+            if(whole) flags |= HTML_CACHE_WHOLE;
+            htmlCacheKey(
+                outline,
+                outline->getKey(),
+                outline->getName(),
+                outline->getModified(),
+                outline->getRevision(),
+                flags,
+                cacheKey);
+
+            html->clear();
+            header(*html, &path, false, yScrollTo);
+            // whole O HTML is cached only if it's not assembled from fragments
+            if(!htmlCache.get(cacheKey, *html)
+               && !(whole && config.isUiHtmlFragments() && toFragments(outline, flags, autolinking, *html)))
+            {
+                size_t bodyOffset = html->size();
+                string outlineMd{};
+                toMarkdown(outline, outlineMd, autolinking, whole);
+                body(&outlineMd, *html);
+                htmlCache.put(cacheKey, outline->getKey(), html->substr(bodyOffset));
             }
+            footer(*html);
+        } else {
+            string outlineMd{};
+            toMarkdown(outline, outlineMd, autolinking, whole);
+            // MD 2 HTML
+            to(&outlineMd, html, &path, false, yScrollTo);
         }
 
-        // MD 2 HTML
-        to(&outlineMd, html, &path, false, yScrollTo);
         // inject custom HTML header
         html->replace(
                     html->find("<body>"), // <body> element index
@@ -477,19 +523,257 @@ string* HtmlOutlineRepresentation::to(
     return html;
 }
 
+void HtmlOutlineRepresentation::toDescriptionMarkdown(Outline* outline, string& md, bool autolinking)
+{
+    if(autolinking) {
+        markdownRepresentation.toDescription(
+            outline->getOutlineDescriptorAsNote(),
+            &md,
+            autolinking
+        );
+    } else {
+        md.append(
+            outline->getOutlineDescriptorAsNote()->getDescriptionAsString()
+        );
+    }
+}
+
+void HtmlOutlineRepresentation::toMarkdown(Outline* outline, string& outlineMd, bool autolinking, bool whole)
+{
+    // O header
+    toDescriptionMarkdown(outline, outlineMd, autolinking);
+    // Ns
+    if(whole) {
+        const vector<Note*>& notes=outline->getNotes();
+        if(notes.size()) {
+            string noteMd{};
+            for(Note* note:notes) {
+                outlineMd.append("\n");
+                // TODO MD representation to render also tags as HTML injected code (under section)
+                markdownRepresentation.to(
+                    note,
+                    &noteMd,
+                    outline->getFormat()==MarkdownDocument::Format::MINDFORGER,
+                    autolinking
+                );
+                outlineMd.append(noteMd);
+                noteMd.clear();
+            }
+        }
+    }
+}
+
+bool HtmlOutlineRepresentation::toFragments(Outline* outline, unsigned int flags, bool autolinking, string& html)
+{
+    const bool metadata = outline->getFormat()==MarkdownDocument::Format::MINDFORGER;
+    flags |= HTML_CACHE_FRAGMENT;
+    if(metadata) flags |= HTML_CACHE_METADATA;
+
+    string fragments{};
+    string key{};
+    string md{};
+
+    // O header
+    htmlCacheKey(
+        outline,
+        outline->getKey(),
+        outline->getName(),
+        outline->getModified(),
+        outline->getRevision(),
+        flags,
+        key);
+    if(!htmlCache.get(key, fragments)) {
+        toDescriptionMarkdown(outline, md, autolinking);
+        if(!toFragment(md, key, outline->getKey(), fragments)) {
+            return false;
+        }
+    }
+
+    // Ns - fragment MD is exactly the N's substring of the whole O MD
+    string noteMd{};
+    for(Note* note:outline->getNotes()) {
+        htmlCacheKey(
+            note,
+            outline->getKey(),
+            note->getName(),
+            note->getModified(),
+            note->getRevision(),
+            flags | (static_cast<unsigned int>(note->getDepth()) & HTML_CACHE_DEPTH_MASK),
+            key);
+        if(!htmlCache.get(key, fragments)) {
+            markdownRepresentation.to(note, &noteMd, metadata, autolinking);
+            md.assign("\n");
+            md.append(noteMd);
+            if(!toFragment(md, key, outline->getKey(), fragments)) {
+                return false;
+            }
+        }
+    }
+
+#ifdef MF_NO_MD_2_HTML
+    // fragments are MD > wrap them as body() does
+    if(fragments.size()) {
+        html.append("<pre>");
+        html.append(fragments);
+        html.append("</pre>");
+    }
+#else
+    html.append(fragments);
+#endif
+    return true;
+}
+
+bool HtmlOutlineRepresentation::toFragment(
+        const string& markdown,
+        const string& key,
+        const string& outlineKey,
+        string& html)
+{
+    if(!isSelfContainedFragment(markdown)) {
+        return false;
+    }
+
+    size_t offset = html.size();
+    transcode(&markdown, html);
+    htmlCache.put(key, outlineKey, html.substr(offset));
+    return true;
+}
+
+static size_t countOccurrences(const string& s, const string& what)
+{
+    size_t count{};
+    for(size_t i=s.find(what); i!=string::npos; i=s.find(what, i+what.size())) {
+        count++;
+    }
+    return count;
+}
+
+bool HtmlOutlineRepresentation::isSelfContainedFragment(const string& markdown)
+{
+    // fenced code blocks
+    char fenceChar{};
+    size_t fenceSize{};
+    size_t b=0;
+    while(b < markdown.size()) {
+        size_t e = markdown.find('\n', b);
+        if(e == string::npos) {
+            e = markdown.size();
+        }
+
+        size_t indent{};
+        size_t i=b;
+        while(i<e && (markdown[i]==' ' || markdown[i]=='\t')) {
+            indent += markdown[i]=='\t'?4:1;
+            i++;
+        }
+        if(i<e && (markdown[i]=='`' || markdown[i]=='~')) {
+            char c = markdown[i];
+            size_t run = i;
+            while(run<e && markdown[run]==c) {
+                run++;
+            }
+            run -= i;
+            if(run >= 3) {
+                if(fenceChar) {
+                    if(c == fenceChar && run >= fenceSize) {
+                        size_t t = i+run;
+                        while(t<e && (markdown[t]==' ' || markdown[t]=='\t' || markdown[t]=='\r')) {
+                            t++;
+                        }
+                        if(t == e) {
+                            fenceChar = 0;
+                        }
+                    }
+                } else {
+                    if(indent >= 4) {
+                        // indented code or list item content - not worth exact parsing
+                        return false;
+                    }
+                    fenceChar = c;
+                    fenceSize = run;
+                }
+            }
+        } else if(!fenceChar && indent<4 && i<e && markdown[i]=='[') {
+            // (reference) link or footnote definition is document global
+            size_t d = markdown.find("]:", i);
+            if(d != string::npos && d < e) {
+                return false;
+            }
+        }
+
+        b = e+1;
+    }
+    if(fenceChar) {
+        return false;
+    }
+
+    // HTML blocks which span blank lines until closed
+    if(markdown.find('<') != string::npos) {
+        string lower{markdown};
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        static const vector<pair<string,string>> htmlBlocks{
+            {"<!--", "-->"},
+            {"<pre", "</pre>"},
+            {"<script", "</script>"},
+            {"<style", "</style>"},
+            {"<textarea", "</textarea>"},
+            {"<?", "?>"},
+            {"<![cdata[", "]]>"}
+        };
+        for(const pair<string,string>& block:htmlBlocks) {
+            if(countOccurrences(lower, block.first) != countOccurrences(lower, block.second)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 string* HtmlOutlineRepresentation::to(
     const Note* note,
     string* html,
     bool autolinking,
-    int yScrollTo)
+    int yScrollTo,
+    bool cache)
 {
+    string path, file;
+    pathToDirectoryAndFile(note->getOutlineKey(), path, file);
+
+    string cacheKey{};
+    if(cache && config.isUiHtmlTheme()) {
+        unsigned int flags = static_cast<unsigned int>(note->getDepth()) & HTML_CACHE_DEPTH_MASK;
+        if(autolinking) flags |= HTML_CACHE_AUTOLINKING;
+        if(autolinking && config.isAutolinkingCaseInsensitive()) flags |= HTML_CACHE_CASE_INSENSITIVE;
+        htmlCacheKey(
+            note,
+            note->getOutlineKey(),
+            note->getName(),
+            note->getModified(),
+            note->getRevision(),
+            flags,
+            cacheKey);
+
+        html->clear();
+        header(*html, &path, false, yScrollTo);
+        if(htmlCache.get(cacheKey, *html)) {
+            footer(*html);
+            return html;
+        }
+    }
+
     string* markdown = new string{};
     markdown->reserve(MarkdownOutlineRepresentation::AVG_NOTE_SIZE);
     markdownRepresentation.to(note, markdown, true, autolinking);
 
-    string path, file;
-    pathToDirectoryAndFile(note->getOutlineKey(), path, file);
-    to(markdown, html, &path, false, yScrollTo);
+    if(cacheKey.size()) {
+        size_t bodyOffset = html->size();
+        body(markdown, *html);
+        htmlCache.put(cacheKey, note->getOutlineKey(), html->substr(bodyOffset));
+        footer(*html);
+    } else {
+        to(markdown, html, &path, false, yScrollTo);
+    }
     delete markdown;
     return html;
 }
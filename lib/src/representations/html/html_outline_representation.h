@@ -25,6 +25,7 @@
 #include "../../config/configuration.h"
 #include "../../model/note.h"
 #include "../unicode.h"
+#include "html_cache.h"
 #include "../markdown/markdown_outline_representation.h"
 #include "../markdown/markdown_transcoder.h"
 #if defined  MF_MD_2_HTML_CMARK
@@ -72,10 +73,20 @@ public:
 class HtmlOutlineRepresentation
 {
 private:
+    // HTML cache key flags (N depth is stored in the lowest byte)
+    static constexpr unsigned int HTML_CACHE_DEPTH_MASK = 0xFF;
+    static constexpr unsigned int HTML_CACHE_OUTLINE = 1<<8;
+    static constexpr unsigned int HTML_CACHE_AUTOLINKING = 1<<9;
+    static constexpr unsigned int HTML_CACHE_CASE_INSENSITIVE = 1<<10;
+    static constexpr unsigned int HTML_CACHE_WHOLE = 1<<11;
+    static constexpr unsigned int HTML_CACHE_FRAGMENT = 1<<12;
+    static constexpr unsigned int HTML_CACHE_METADATA = 1<<13;
+
     // Performance hints:
     //  - += is ~2x faster than append() (depends on cpp lib implementation)
     //  - pre-allocation of the string using reserver() is critical to avoid slow re-allocations
-    //  - IMPROVE consider caching of re-used HTML snippets
+    //  - HTML of Os/Ns shown in views is cached (header/footer are always rendered)
+    //  - whole O HTML can be assembled from per N fragments cached independently (configuration)
 
     Configuration& config;
     HtmlExportColorsRepresentation exportColors;
@@ -83,6 +94,11 @@ private:
     MarkdownOutlineRepresentation markdownRepresentation;
     MarkdownTranscoder* markdownTranscoder;
 
+    // rendered (MD 2 HTML transcoded) O/N HTML body
+    HtmlCache htmlCache;
+    // autolinking index generation - autolinked HTML must be re-rendered on its change
+    unsigned long autolinkingGeneration;
+
 public:
     /**
      * @brief Html O representation.
@@ -123,6 +139,9 @@ public:
      * @param metadata Render (tags, timestamps, reads/writes) metadata.
      *        No metadata (fast) rendering is used by live preview.
      * @param yScrollTo Inject JavaScript which scrolls HTML to given % on page load.
+     * @param cache Use HTML cache - O must be the remembered one (not an aux O
+     *        used by live preview) as O key, modified and revision identify HTML.
+     *        Cache is used only by metadata rendering.
      * @return Pointer to O HTML representation.
      */
     std::string* to(
@@ -132,13 +151,22 @@ public:
         bool autolinking=false,
         bool whole=false,
         bool metadata=false,
-        int yScrollTo=0
+        int yScrollTo=0,
+        bool cache=false
     );
+    /**
+     * @brief Export Note to HTML.
+     *
+     * @param cache Use HTML cache - N must be the remembered one (not an aux N
+     *        used by live preview). Metadata like reads in the (invisible) HTML
+     *        comment of cached HTML might be outdated.
+     */
     std::string* to(
         const Note* note,
         std::string* html,
         bool autolinking=false,
-        int yScrollTo=0
+        int yScrollTo=0,
+        bool cache=false
     );
 
     /**
@@ -153,11 +181,62 @@ public:
 
     MarkdownOutlineRepresentation& getMarkdownRepresentation() { return markdownRepresentation; }
 
+    HtmlCache& getHtmlCache() { return htmlCache; }
+    void setAutolinkingGeneration(unsigned long generation) { autolinkingGeneration = generation; }
+
 private:
     void header(std::string& html, std::string* basePath, bool standalone, int yScrollTo);
     void footer(std::string& html);
+    /**
+     * @brief Append MD transcoded to HTML (w/o header and footer).
+     */
+    void body(const std::string* markdown, std::string& html);
+    /**
+     * @brief Append MD transcoded to HTML (w/o header, footer and MD 2 HTML fallback wrapper).
+     */
+    void transcode(const std::string* markdown, std::string& html);
+
+    /**
+     * @brief Build HTML cache key from everything the cached HTML depends on.
+     */
+    void htmlCacheKey(
+        const void* thing,
+        const std::string& outlineKey,
+        const std::string& name,
+        time_t modified,
+        u_int32_t revision,
+        unsigned int flags,
+        std::string& key) const;
 
     std::string* toNoMeta(Outline* outline, std::string* html, bool standalone, int yScrollTo);
+    /**
+     * @brief O header description (and Ns if whole) MD for metadata HTML rendering.
+     */
+    void toMarkdown(Outline* outline, std::string& outlineMd, bool autolinking, bool whole);
+    void toDescriptionMarkdown(Outline* outline, std::string& md, bool autolinking);
+
+    /**
+     * @brief Append whole O body assembled from O description and Ns HTML fragments.
+     *
+     * Fragments are transcoded and cached independently, therefore only fragments
+     * of modified Ns are transcoded again. HTML is byte-identical to single pass
+     * transcoding of whole O MD. If a fragment is not self-contained,
+     * then false is returned and HTML is left intact.
+     */
+    bool toFragments(Outline* outline, unsigned int flags, bool autolinking, std::string& html);
+    bool toFragment(
+        const std::string& markdown,
+        const std::string& key,
+        const std::string& outlineKey,
+        std::string& html);
+    /**
+     * @brief Can be MD fragment transcoded independently of other fragments?
+     *
+     * Conservative check: MD w/ (reference) link definitions, which are
+     * document global, or w/ unclosed fenced code and HTML blocks, which
+     * continue in the next fragment, is not self-contained.
+     */
+    static bool isSelfContainedFragment(const std::string& markdown);
 };
 
 } // m8r namespace
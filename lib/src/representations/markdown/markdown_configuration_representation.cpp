@@ -33,6 +33,11 @@ constexpr const auto CONFIG_SETTING_MIND_STATE = "* Mind state: ";
 constexpr const auto CONFIG_SETTING_MIND_TIME_SCOPE_LABEL = "* Time scope: ";
 constexpr const auto CONFIG_SETTING_MIND_TAGS_SCOPE_LABEL = "* Tags scope: ";
 constexpr const auto CONFIG_SETTING_MIND_DISTRIBUTOR_INTERVAL = "* Async refresh interval (ms): ";
+constexpr const auto CONFIG_SETTING_MIND_LEARN_THREADS = "* Learning threads: ";
+constexpr const auto CONFIG_SETTING_MIND_REPOSITORY_SNAPSHOT = "* Repository snapshot: ";
+constexpr const auto CONFIG_SETTING_MIND_REPOSITORY_WATCHER = "* Repository watcher: ";
+constexpr const auto CONFIG_SETTING_MIND_INDEXER_IGNORE = "* Ignored files: ";
+constexpr const auto CONFIG_SETTING_MIND_STATISTICS_JOURNAL = "* Statistics journal: ";
 constexpr const auto CONFIG_SETTING_MIND_AUTOLINKING = "* Autolinking: ";
 constexpr const auto CONFIG_SETTING_MIND_WINGMAN_PROVIDER = "* Wingman LLM provider: ";
 constexpr const auto CONFIG_SETTING_MIND_OPENAI_KEY = "* Wingman's OpenAI API key: ";
@@ -63,6 +68,7 @@ constexpr const auto CONFIG_SETTING_UI_EDITOR_TABS_AS_SPACES_LABEL =  "* Editor
 constexpr const auto CONFIG_SETTING_UI_EDITOR_AUTOSAVE_LABEL =  "* Editor autosave on close: ";
 constexpr const auto CONFIG_SETTING_EXTERNAL_EDITOR_CMD_LABEL =  "* External editor command: ";
 constexpr const auto CONFIG_SETTING_UI_FULL_O_PREVIEW_LABEL =  "* Full Outline preview: ";
+constexpr const auto CONFIG_SETTING_UI_HTML_FRAGMENTS_LABEL =  "* Outline HTML from Note fragments: ";
 constexpr const auto CONFIG_SETTING_NAVIGATOR_MAX_GRAPH_NODES_LABEL = "* Navigator max knowledge graph nodes: ";
 constexpr const auto CONFIG_SETTING_MD_HIGHLIGHT_LABEL = "* Enable source code syntax highlighting support in Markdown: ";
 constexpr const auto CONFIG_SETTING_MD_MATH_LABEL = "* Enable math support in Markdown: ";
@@ -264,6 +270,12 @@ void MarkdownConfigurationRepresentation::configurationSection(
                         } else {
                             c.setUiFullOPreview(false);
                         }
+                    } else if(line->find(CONFIG_SETTING_UI_HTML_FRAGMENTS_LABEL) != std::string::npos) {
+                        if(line->find("yes") != std::string::npos) {
+                            c.setUiHtmlFragments(true);
+                        } else {
+                            c.setUiHtmlFragments(false);
+                        }
                     } else if(line->find(CONFIG_SETTING_UI_EDITOR_KEY_BINDING_LABEL) != std::string::npos) {
                         if(line->find(UI_EDITOR_KEY_BINDING_EMACS) != std::string::npos) {
                             c.setEditorKeyBinding(Configuration::EditorKeyBindingMode::EMACS);
@@ -396,6 +408,50 @@ void MarkdownConfigurationRepresentation::configurationSection(
                         }
                         i %= 10000;
                         c.setDistributorSleepInterval(i);
+                    } else if(line->find(CONFIG_SETTING_MIND_LEARN_THREADS) != std::string::npos) {
+                        string t = line->substr(strlen(CONFIG_SETTING_MIND_LEARN_THREADS));
+                        std::string::size_type st;
+                        int i;
+                        try {
+                          i = std::stoi (t,&st);
+                        }
+                        catch(...) {
+                          i = Configuration::DEFAULT_LEARN_THREADS;
+                        }
+                        if(i<0 || i>Configuration::MAX_LEARN_THREADS) {
+                            i=Configuration::DEFAULT_LEARN_THREADS;
+                        }
+                        c.setLearnThreads(i);
+                    } else if(line->find(CONFIG_SETTING_MIND_REPOSITORY_SNAPSHOT) != std::string::npos) {
+                        if(line->find("yes") != std::string::npos) {
+                            c.setRepositorySnapshot(true);
+                        } else {
+                            c.setRepositorySnapshot(false);
+                        }
+                    } else if(line->find(CONFIG_SETTING_MIND_REPOSITORY_WATCHER) != std::string::npos) {
+                        if(line->find("yes") != std::string::npos) {
+                            c.setRepositoryWatcher(true);
+                        } else {
+                            c.setRepositoryWatcher(false);
+                        }
+                    } else if(line->find(CONFIG_SETTING_MIND_INDEXER_IGNORE) != std::string::npos) {
+                        std::vector<std::string> patterns{};
+                        std::stringstream s{line->substr(
+                            line->find(CONFIG_SETTING_MIND_INDEXER_IGNORE)+strlen(CONFIG_SETTING_MIND_INDEXER_IGNORE))};
+                        std::string pattern{};
+                        while(std::getline(s, pattern, ',')) {
+                            stringTrim(pattern);
+                            if(pattern.size()) {
+                                patterns.push_back(pattern);
+                            }
+                        }
+                        c.setIndexerIgnorePatterns(patterns);
+                    } else if(line->find(CONFIG_SETTING_MIND_STATISTICS_JOURNAL) != std::string::npos) {
+                        if(line->find("yes") != std::string::npos) {
+                            c.setStatisticsJournal(true);
+                        } else {
+                            c.setStatisticsJournal(false);
+                        }
                     } else if(line->find(CONFIG_SETTING_MIND_AUTOLINKING) != std::string::npos) {
                         if(line->find("yes") != std::string::npos) {
                             c.setAutolinking(true);
@@ -465,7 +521,7 @@ string* MarkdownConfigurationRepresentation::to(Configuration& c)
 string& MarkdownConfigurationRepresentation::to(Configuration* c, string& md)
 {
     stringstream s{};
-    string timeScopeAsString{}, tagsScopeAsString{}, mindStateAsString{"sleep"};
+    string timeScopeAsString{}, tagsScopeAsString{}, mindStateAsString{"sleep"}, ignorePatternsAsString{};
     if(c) {
         // time
         c->getTimeScope().toString(timeScopeAsString);
@@ -477,6 +533,13 @@ string& MarkdownConfigurationRepresentation::to(Configuration* c, string& md)
             }
             tagsScopeAsString.resize(tagsScopeAsString.size()-1);
         }
+        // indexer
+        for(const string& p:c->getIndexerIgnorePatterns()) {
+            if(ignorePatternsAsString.size()) {
+                ignorePatternsAsString += ", ";
+            }
+            ignorePatternsAsString += p;
+        }
         // mind state
         if(c->getDesiredMindState()==Configuration::MindState::THINKING) mindStateAsString= "think";
     } else {
@@ -503,6 +566,21 @@ string& MarkdownConfigurationRepresentation::to(Configuration* c, string& md)
          CONFIG_SETTING_MIND_DISTRIBUTOR_INTERVAL << (c?c->getDistributorSleepInterval():Configuration::DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL+1) << endl <<
          "    * Sleep interval (miliseconds) between asynchronous mind-related evaluations (associations, ...)" << endl <<
          "    * Examples: 500, 1000, 3000, 5000" << endl <<
+         CONFIG_SETTING_MIND_LEARN_THREADS << (c?c->getLearnThreads():Configuration::DEFAULT_LEARN_THREADS) << endl <<
+         "    * Number of threads used to load (lex and parse) repository Markdown files" << endl <<
+         "    * Examples: 0 (detect number of CPUs), 1 (sequential), 4" << endl <<
+         CONFIG_SETTING_MIND_REPOSITORY_SNAPSHOT << (c?(c->isRepositorySnapshot()?"yes":"no"):(Configuration::DEFAULT_REPOSITORY_SNAPSHOT?"yes":"no")) << endl <<
+         "    * Keep parsed Markdown files in a snapshot file in user cache directory to start faster" << endl <<
+         "    * Examples: yes, no" << endl <<
+         CONFIG_SETTING_MIND_REPOSITORY_WATCHER << (c?(c->isRepositoryWatcher()?"yes":"no"):(Configuration::DEFAULT_REPOSITORY_WATCHER?"yes":"no")) << endl <<
+         "    * Learn notebooks changed outside of MindForger (git pull, sync tools, other editors) - Linux only" << endl <<
+         "    * Examples: yes, no" << endl <<
+         CONFIG_SETTING_MIND_INDEXER_IGNORE << ignorePatternsAsString << endl <<
+         "    * Comma separated names of files and directories which are not indexed (* and ? wildcards)" << endl <<
+         "    * Examples: .git, node_modules, *.tmp" << endl <<
+         CONFIG_SETTING_MIND_STATISTICS_JOURNAL << (c?(c->isStatisticsJournal()?"yes":"no"):(Configuration::DEFAULT_STATISTICS_JOURNAL?"yes":"no")) << endl <<
+         "    * Append notebook and note reads to " << FILENAME_STATISTICS_JOURNAL << " file and write them to Markdown files on exit" << endl <<
+         "    * Examples: yes, no" << endl <<
          CONFIG_SETTING_MIND_AUTOLINKING << (c?(c->isAutolinking()?"yes":"no"):(Configuration::DEFAULT_AUTOLINKING?"yes":"no")) << endl <<
          "    * Examples: yes, no" << endl <<
          CONFIG_SETTING_MIND_WINGMAN_PROVIDER << Configuration::getWingmanLlmProviderAsString(c?c->getWingmanLlmProvider():Configuration::DEFAULT_WINGMAN_LLM_PROVIDER) << endl <<
@@ -590,6 +668,9 @@ string& MarkdownConfigurationRepresentation::to(Configuration* c, string& md)
          CONFIG_SETTING_MD_DIAGRAM_LABEL << (c?c->getJsLibSupportAsString(c->getUiEnableDiagramsInMd()):UI_JS_LIB_NO) << endl <<
          "    * Enable online Mermaid JavaScript library to show diagrams in HTML generated from Markdown." << endl <<
          "    * Examples: online, no" << endl <<
+         CONFIG_SETTING_UI_HTML_FRAGMENTS_LABEL << (c?(c->isUiHtmlFragments()?"yes":"no"):(Configuration::DEFAULT_UI_HTML_FRAGMENTS?"yes":"no")) << endl <<
+         "    * Render Outline HTML from cached HTML of its Notes - only changed Notes are rendered again (experimental)." << endl <<
+         "    * Examples: yes, no" << endl <<
          CONFIG_SETTING_NAVIGATOR_MAX_GRAPH_NODES_LABEL << (c?c->getNavigatorMaxNodes():Configuration::DEFAULT_NAVIGATOR_MAX_GRAPH_NODES) << endl <<
          "    * Maximum number of knowledge graph navigator nodes (performance vs. readability trade-off)." << endl <<
          "    * Examples: 150" << endl <<
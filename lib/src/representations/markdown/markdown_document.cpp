@@ -80,6 +80,16 @@ void MarkdownDocument::from(const std::string* text)
     } // else: empty file/no lexems
 }
 
+void MarkdownDocument::from(vector<MarkdownAstNodeSection*>* ast, Format format, unsigned fileSize, time_t modified)
+{
+    clear();
+    this->modified = modified;
+    this->fileSize = fileSize;
+    this->format = format;
+    this->ast = ast;
+    from(ast);
+}
+
 void MarkdownDocument::from(const std::vector<MarkdownAstNodeSection*>* ast)
 {
     if(ast!=nullptr && ast->size()) {
@@ -79,6 +79,10 @@ public:
 
     void from();
     void from(const std::string* text);
+    /**
+     * @brief Set already parsed AST (e.g. restored from repository snapshot) - AST is owned by document.
+     */
+    void from(std::vector<MarkdownAstNodeSection*>* ast, Format format, unsigned fileSize, time_t modified);
     bool isParsed() const { return ast==nullptr; }
     void clear();
 
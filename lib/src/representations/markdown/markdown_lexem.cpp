@@ -51,10 +51,6 @@ MarkdownLexem::MarkdownLexem(MarkdownLexemType type, unsigned short int depth)
     idx = lng = 0;
 }
 
-MarkdownLexem::~MarkdownLexem()
-{
-}
-
 MarkdownLexemType MarkdownLexem::getType() const
 {
     return type;
@@ -71,6 +71,9 @@ enum class MarkdownLexemType
 
 /**
  * @brief Token created by a Markdown lexical analyzer (tokenizer).
+ *
+ * Lexem is a small value type (16B) - lexer stores lexems by value
+ * in a contiguous array which is reused across files.
  */
 class MarkdownLexem
 {
@@ -107,11 +110,11 @@ public:
             unsigned short int index,
             unsigned short int lenght);
     MarkdownLexem(MarkdownLexemType type, unsigned short int depth);
-    MarkdownLexem(const MarkdownLexem&) = delete;
-    MarkdownLexem(const MarkdownLexem&&) = delete;
-    MarkdownLexem& operator=(const MarkdownLexem&) = delete;
-    MarkdownLexem& operator=(const MarkdownLexem&&) = delete;
-    virtual ~MarkdownLexem();
+    MarkdownLexem(const MarkdownLexem&) = default;
+    MarkdownLexem(MarkdownLexem&&) = default;
+    MarkdownLexem& operator=(const MarkdownLexem&) = default;
+    MarkdownLexem& operator=(MarkdownLexem&&) = default;
+    ~MarkdownLexem() = default;
 
     MarkdownLexemType getType() const;
     void setType(MarkdownLexemType type);
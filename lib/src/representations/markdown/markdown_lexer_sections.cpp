@@ -63,74 +63,70 @@ FileLineProvider::~FileLineProvider()
  */
 
 MarkdownLexemTable::MarkdownLexemTable()
+    : BEGIN_DOC{MarkdownLexemType::BEGIN_DOC},
+      META_BEGIN{MarkdownLexemType::META_BEGIN},
+      META_PROPERTY_DELIMITER{MarkdownLexemType::META_PROPERTY_DELIMITER},
+      META_PROPERTY_type{MarkdownLexemType::META_PROPERTY_type},
+      META_PROPERTY_created{MarkdownLexemType::META_PROPERTY_created},
+      META_PROPERTY_reads{MarkdownLexemType::META_PROPERTY_reads},
+      META_PROPERTY_read{MarkdownLexemType::META_PROPERTY_read},
+      META_PROPERTY_revision{MarkdownLexemType::META_PROPERTY_revision},
+      META_PROPERTY_modified{MarkdownLexemType::META_PROPERTY_modified},
+      META_PROPERTY_importance{MarkdownLexemType::META_PROPERTY_importance},
+      META_PROPERTY_urgency{MarkdownLexemType::META_PROPERTY_urgency},
+      META_PROPERTY_progress{MarkdownLexemType::META_PROPERTY_progress},
+      META_PROPERTY_tags{MarkdownLexemType::META_PROPERTY_tags},
+      META_PROPERTY_links{MarkdownLexemType::META_PROPERTY_links},
+      META_PROPERTY_deadline{MarkdownLexemType::META_PROPERTY_deadline},
+      META_PROPERTY_scope{MarkdownLexemType::META_PROPERTY_scope},
+      META_NAMEVALUE_DELIMITER{MarkdownLexemType::META_NAMEVALUE_DELIMITER},
+      HTML_COMMENT_BEGIN{MarkdownLexemType::HTML_COMMENT_BEGIN},
+      HTML_COMMENT_END{MarkdownLexemType::HTML_COMMENT_END},
+      BR{MarkdownLexemType::BR},
+      END_DOC{MarkdownLexemType::END_DOC}
 {
-    BEGIN_DOC = new MarkdownLexem { MarkdownLexemType::BEGIN_DOC };
-    lexems.insert(BEGIN_DOC);
-    META_BEGIN = new MarkdownLexem { MarkdownLexemType::META_BEGIN };
-    lexems.insert(META_BEGIN);
-    META_PROPERTY_DELIMITER = new MarkdownLexem{MarkdownLexemType::META_PROPERTY_DELIMITER};
-    lexems.insert(META_PROPERTY_DELIMITER);
-    META_PROPERTY_type = new MarkdownLexem{MarkdownLexemType::META_PROPERTY_type};
-    lexems.insert(META_PROPERTY_type);
-    META_PROPERTY_created = new MarkdownLexem{MarkdownLexemType::META_PROPERTY_created};
-    lexems.insert(META_PROPERTY_created);
-    META_PROPERTY_reads = new MarkdownLexem{MarkdownLexemType::META_PROPERTY_reads};
-    lexems.insert(META_PROPERTY_reads);
-    META_PROPERTY_read = new MarkdownLexem{MarkdownLexemType::META_PROPERTY_read};
-    lexems.insert(META_PROPERTY_read);
-    META_PROPERTY_revision = new MarkdownLexem{MarkdownLexemType::META_PROPERTY_revision};
-    lexems.insert(META_PROPERTY_revision);
-    META_PROPERTY_modified = new MarkdownLexem{MarkdownLexemType::META_PROPERTY_modified};
-    lexems.insert(META_PROPERTY_modified);
-    META_PROPERTY_importance = new MarkdownLexem{MarkdownLexemType::META_PROPERTY_importance};
-    lexems.insert(META_PROPERTY_importance);
-    META_PROPERTY_urgency = new MarkdownLexem{MarkdownLexemType::META_PROPERTY_urgency};
-    lexems.insert(META_PROPERTY_urgency);
-    META_PROPERTY_progress = new MarkdownLexem{MarkdownLexemType::META_PROPERTY_progress};
-    lexems.insert(META_PROPERTY_progress);
-    META_PROPERTY_tags = new MarkdownLexem{MarkdownLexemType::META_PROPERTY_tags};
-    lexems.insert(META_PROPERTY_tags);
-    META_PROPERTY_links= new MarkdownLexem{MarkdownLexemType::META_PROPERTY_links};
-    lexems.insert(META_PROPERTY_links);
-    META_PROPERTY_deadline = new MarkdownLexem{MarkdownLexemType::META_PROPERTY_deadline};
-    lexems.insert(META_PROPERTY_deadline);
-    META_PROPERTY_scope = new MarkdownLexem{MarkdownLexemType::META_PROPERTY_scope};
-    lexems.insert(META_PROPERTY_scope);
-    META_NAMEVALUE_DELIMITER = new MarkdownLexem{MarkdownLexemType::META_NAMEVALUE_DELIMITER};
-    lexems.insert(META_NAMEVALUE_DELIMITER);
-    HTML_COMMENT_BEGIN = new MarkdownLexem{MarkdownLexemType::HTML_COMMENT_BEGIN};
-    lexems.insert(HTML_COMMENT_BEGIN);
-    HTML_COMMENT_END = new MarkdownLexem{MarkdownLexemType::HTML_COMMENT_END};
-    lexems.insert(HTML_COMMENT_END);
-    BR = new MarkdownLexem{MarkdownLexemType::BR};
-    lexems.insert(BR);
-    END_DOC = new MarkdownLexem{MarkdownLexemType::END_DOC};
-    lexems.insert(END_DOC);
 }
 
 MarkdownLexemTable::~MarkdownLexemTable()
 {
-    delete BEGIN_DOC;
-    delete META_BEGIN;
-    delete META_PROPERTY_DELIMITER;
-    delete META_PROPERTY_type;
-    delete META_PROPERTY_created;
-    delete META_PROPERTY_reads;
-    delete META_PROPERTY_read;
-    delete META_PROPERTY_revision;
-    delete META_PROPERTY_modified;
-    delete META_PROPERTY_importance;
-    delete META_PROPERTY_urgency;
-    delete META_PROPERTY_progress;
-    delete META_PROPERTY_tags;
-    delete META_PROPERTY_links;
-    delete META_PROPERTY_deadline;
-    delete META_PROPERTY_scope;
-    delete META_NAMEVALUE_DELIMITER;
-    delete HTML_COMMENT_BEGIN;
-    delete HTML_COMMENT_END;
-    delete BR;
-    delete END_DOC;
+}
+
+/*
+ * MarkdownLexemArena
+ */
+
+constexpr size_t MarkdownLexemArena::MAX_RETAINED_LEXEMS;
+
+MarkdownLexemArena::MarkdownLexemArena()
+    : lexems{},
+      leased{false}
+{
+}
+
+MarkdownLexemArena::~MarkdownLexemArena()
+{
+}
+
+MarkdownLexemArena* MarkdownLexemArena::lease()
+{
+    static thread_local MarkdownLexemArena threadArena{};
+
+    if(threadArena.leased) {
+        return nullptr;
+    }
+    threadArena.leased = true;
+    return &threadArena;
+}
+
+void MarkdownLexemArena::release()
+{
+    if(lexems.capacity() > MAX_RETAINED_LEXEMS) {
+        // giant file must not keep its lexems memory for the rest of the thread's life
+        vector<MarkdownLexem>{}.swap(lexems);
+    } else {
+        lexems.clear();
+    }
+    leased = false;
 }
 
 /*
@@ -168,9 +164,13 @@ MarkdownSymbolTable::~MarkdownSymbolTable()
  * MarkdownLexerSections
  */
 
-MarkdownLexerSections::MarkdownLexerSections(const string* filePath)
+MarkdownLexerSections::MarkdownLexerSections(const string* filePath, MarkdownLexerInputMode inputMode)
+    : arena{MarkdownLexemArena::lease()},
+      ownLexems{},
+      lexems(arena?arena->getLexems():ownLexems)
 {
     this->filePath = filePath;
+    this->inputMode = inputMode;
     this->fileSize = 0;
     this->inCodeBlock = false;
     this->lastBrTokensOffset = 0;
@@ -178,84 +178,85 @@ MarkdownLexerSections::MarkdownLexerSections(const string* filePath)
 
 MarkdownLexerSections::~MarkdownLexerSections()
 {
-    // lines
-    for(string*& line:lines) {
-        if(line!=nullptr) {
-            delete line;
-        }
+    // line copies (lines themselves are spans)
+    for(string*& line:lineCopies) {
+        delete line;
     }
 
-    // lexems
-    for(MarkdownLexem*& lexem:lexems) {
-        if(lexem!=nullptr) {
-            if(!MarkdownSymbolTable::LEXEM.contains(lexem)) {
-                delete lexem;
-                lexem=nullptr;
-            }
-        }
+    if(arena) {
+        arena->release();
     }
 }
 
-void MarkdownLexerSections::tokenize()
+bool MarkdownLexerSections::loadLines()
 {
     fileSize = 0;
-    if(fileToLines(filePath, lines, fileSize)) {
-        // IMPROVE body of this function can be shared by file & text
-        lexems.push_back(MarkdownSymbolTable::LEXEM.BEGIN_DOC);
-
-        unsigned offset = 0;
-        while(nextToken(offset)) {
-            offset++;
+    if(inputMode==MarkdownLexerInputMode::SINGLE_BUFFER && mappedFile.open(*filePath)) {
+        if(bufferToLineSpans(mappedFile.data(), mappedFile.size(), lines)) {
+            // keep getline() semantics: every line is counted w/ its EOL
+            fileSize = mappedFile.size();
+            if(mappedFile.data()[fileSize-1]!='\n') {
+                fileSize++;
+            }
         }
-
-        if(lexems.size()==1) {
-            lexems.clear();
-        } else {
-            lexems.push_back(MarkdownSymbolTable::LEXEM.END_DOC);
+    } else if(fileToLines(filePath, lineCopies, fileSize)) {
+        lines.reserve(lineCopies.size());
+        for(string* line:lineCopies) {
+            lines.push_back(LineSpan{line->data(), line->size()});
         }
     }
+    return fileSize>0;
+}
+
+void MarkdownLexerSections::tokenize()
+{
+    if(loadLines()) {
+        tokenizeLines();
+    }
 }
 
 void MarkdownLexerSections::tokenize(const string* text)
 {
-    if(stringToLines(text, lines)) {
-        // IMPROVE body of this function can be shared by file & text
-        lexems.push_back(MarkdownSymbolTable::LEXEM.BEGIN_DOC);
+    if(text && bufferToLineSpans(text->data(), text->size(), lines)) {
+        tokenizeLines();
+    }
+}
+
+void MarkdownLexerSections::tokenizeLines()
+{
+    lexems.push_back(MarkdownSymbolTable::LEXEM.BEGIN_DOC);
 
-        unsigned offset = 0;
-        while(nextToken(offset)) {
-            offset++;
-        }
+    unsigned offset = 0;
+    while(nextToken(offset)) {
+        offset++;
+    }
 
-        if(lexems.size()==1) {
-            lexems.clear();
-        } else {
-            lexems.push_back(MarkdownSymbolTable::LEXEM.END_DOC);
-        }
+    if(lexems.size()==1) {
+        lexems.clear();
+    } else {
+        lexems.push_back(MarkdownSymbolTable::LEXEM.END_DOC);
     }
 }
 
 bool MarkdownLexerSections::lexWhitespaces(const unsigned offset, unsigned short int& idx)
 {
     unsigned short int i = idx+1;
-    if(lines[offset]!=nullptr) {
-        while(lines[offset]->size()>i && isspace(lines[offset]->at(i))) {
-            i++;
-        }
-        if(i != idx+1) {
-            lexems.push_back(new MarkdownLexem(MarkdownLexemType::WHITESPACES,offset,idx+1,i-1-idx));
-            idx = i-1;
-            return true;
-        }
+    while(lines[offset].size()>i && isspace(lines[offset].at(i))) {
+        i++;
+    }
+    if(i != idx+1) {
+        lexems.emplace_back(MarkdownLexemType::WHITESPACES,offset,idx+1,i-1-idx);
+        idx = i-1;
+        return true;
     }
     return false;
 }
 
 bool MarkdownLexerSections::startsWithCodeBlockSymbol(const unsigned offset) const
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>=3
+    if(lines[offset].size()>=3
          &&
-       lines[offset]->at(0)=='`' && lines[offset]->at(1)=='`' && lines[offset]->at(2)=='`'
+       lines[offset].at(0)=='`' && lines[offset].at(1)=='`' && lines[offset].at(2)=='`'
     ){
         return true;
     } else {
@@ -265,9 +266,9 @@ bool MarkdownLexerSections::startsWithCodeBlockSymbol(const unsigned offset) con
 
 bool MarkdownLexerSections::startsWithHtmlCommentEndSymbol(const unsigned offset, const unsigned short idx) const
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>=(size_t)(idx+3)
+    if(lines[offset].size()>=(size_t)(idx+3)
          &&
-       lines[offset]->at(idx)=='-' && lines[offset]->at(idx+1)=='-' && lines[offset]->at(idx+2)=='>'
+       lines[offset].at(idx)=='-' && lines[offset].at(idx+1)=='-' && lines[offset].at(idx+2)=='>'
     ){
         return true;
     } else {
@@ -278,27 +279,25 @@ bool MarkdownLexerSections::startsWithHtmlCommentEndSymbol(const unsigned offset
 bool MarkdownLexerSections::lexSectionSymbol(const unsigned offset, unsigned short int& idx)
 {
     unsigned depth = 0; // depth = [0,n)
-    if(lines[offset]!=nullptr) {
-        while(lines[offset]->size()>depth && lines[offset]->at(depth)=='#') {
-            ++depth;
-        }
-        if(depth
-             &&
-           (lines[offset]->size()>=depth || isspace(lines[offset]->at(depth))))
-        {
-            idx = depth-1;
-            lexems.push_back(new MarkdownLexem(MarkdownLexemType::SECTION,depth-1));
-            return true;
-        }
+    while(lines[offset].size()>depth && lines[offset].at(depth)=='#') {
+        ++depth;
+    }
+    if(depth
+         &&
+       (lines[offset].size()>=depth || isspace(lines[offset].at(depth))))
+    {
+        idx = depth-1;
+        lexems.emplace_back(MarkdownLexemType::SECTION,depth-1);
+        return true;
     }
     return false;
 }
 
 bool MarkdownLexerSections::lexHtmlCommentBeginSymbol(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>=(size_t)(idx+4)
+    if(lines[offset].size()>=(size_t)(idx+4)
          &&
-       lines[offset]->at(idx)=='<' && lines[offset]->at(idx+1)=='!' && lines[offset]->at(idx+2)=='-' && lines[offset]->at(idx+3)=='-'
+       lines[offset].at(idx)=='<' && lines[offset].at(idx+1)=='!' && lines[offset].at(idx+2)=='-' && lines[offset].at(idx+3)=='-'
     ){
         idx+=4;
         lexems.push_back(symbolTable.LEXEM.HTML_COMMENT_BEGIN);
@@ -310,9 +309,9 @@ bool MarkdownLexerSections::lexHtmlCommentBeginSymbol(const unsigned offset, uns
 
 bool MarkdownLexerSections::lexHtmlCommentEndSymbol(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>=(size_t)(idx+3)
+    if(lines[offset].size()>=(size_t)(idx+3)
          &&
-       lines[offset]->at(idx)=='-' && lines[offset]->at(idx+1)=='-' && lines[offset]->at(idx+2)=='>'
+       lines[offset].at(idx)=='-' && lines[offset].at(idx+1)=='-' && lines[offset].at(idx+2)=='>'
     ){
         idx+=3;
         lexems.push_back(symbolTable.LEXEM.HTML_COMMENT_END);
@@ -325,17 +324,17 @@ bool MarkdownLexerSections::lexHtmlCommentEndSymbol(const unsigned offset, unsig
 bool MarkdownLexerSections::lexMetadataSymbol(const unsigned offset, unsigned short int& idx)
 {
     // case insensitive 'metadata'
-    if(lines[offset]!=nullptr && lines[offset]->size()>=(size_t)(idx+9)
+    if(lines[offset].size()>=(size_t)(idx+9)
          &&
-       (lines[offset]->at(idx+1)=='M' || lines[offset]->at(idx+1)=='m') &&
-       (lines[offset]->at(idx+2)=='e' || lines[offset]->at(idx+2)=='E') &&
-       (lines[offset]->at(idx+3)=='t' || lines[offset]->at(idx+3)=='T') &&
-       (lines[offset]->at(idx+4)=='a' || lines[offset]->at(idx+4)=='A') &&
-       (lines[offset]->at(idx+5)=='d' || lines[offset]->at(idx+5)=='D') &&
-       (lines[offset]->at(idx+6)=='a' || lines[offset]->at(idx+6)=='A') &&
-       (lines[offset]->at(idx+7)=='t' || lines[offset]->at(idx+7)=='T') &&
-       (lines[offset]->at(idx+8)=='a' || lines[offset]->at(idx+8)=='A') &&
-       lines[offset]->at(idx+9)==':'
+       (lines[offset].at(idx+1)=='M' || lines[offset].at(idx+1)=='m') &&
+       (lines[offset].at(idx+2)=='e' || lines[offset].at(idx+2)=='E') &&
+       (lines[offset].at(idx+3)=='t' || lines[offset].at(idx+3)=='T') &&
+       (lines[offset].at(idx+4)=='a' || lines[offset].at(idx+4)=='A') &&
+       (lines[offset].at(idx+5)=='d' || lines[offset].at(idx+5)=='D') &&
+       (lines[offset].at(idx+6)=='a' || lines[offset].at(idx+6)=='A') &&
+       (lines[offset].at(idx+7)=='t' || lines[offset].at(idx+7)=='T') &&
+       (lines[offset].at(idx+8)=='a' || lines[offset].at(idx+8)=='A') &&
+       lines[offset].at(idx+9)==':'
     ){
         idx+=9;
         lexems.push_back(symbolTable.LEXEM.META_BEGIN);
@@ -347,21 +346,21 @@ bool MarkdownLexerSections::lexMetadataSymbol(const unsigned offset, unsigned sh
 
 bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]->size() > (size_t)(idx+1)) {
-        switch(lines[offset]->at(idx+1)) {
+    if(lines[offset].size() > (size_t)(idx+1)) {
+        switch(lines[offset].at(idx+1)) {
         case 't':
-            if(lines[offset]->at(idx+2)=='y' &&
-               lines[offset]->at(idx+3)=='p' &&
-               lines[offset]->at(idx+4)=='e' &&
-               (lines[offset]->at(idx+5)==':' || !isspace(idx+5))) {
+            if(lines[offset].at(idx+2)=='y' &&
+               lines[offset].at(idx+3)=='p' &&
+               lines[offset].at(idx+4)=='e' &&
+               (lines[offset].at(idx+5)==':' || !isspace(idx+5))) {
                 idx+=4;
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_type);
                 return true;
             } else {
-                if(lines[offset]->at(idx+2)=='a' &&
-                   lines[offset]->at(idx+3)=='g' &&
-                   lines[offset]->at(idx+4)=='s' &&
-                   (lines[offset]->at(idx+5)==':' || !isspace(idx+5))) {
+                if(lines[offset].at(idx+2)=='a' &&
+                   lines[offset].at(idx+3)=='g' &&
+                   lines[offset].at(idx+4)=='s' &&
+                   (lines[offset].at(idx+5)==':' || !isspace(idx+5))) {
                     idx+=4;
                     lexems.push_back(symbolTable.LEXEM.META_PROPERTY_tags);
                     return true;
@@ -370,13 +369,13 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 }
             }
         case 'c':
-            if(lines[offset]->at(idx+2)=='r' &&
-               lines[offset]->at(idx+3)=='e' &&
-               lines[offset]->at(idx+4)=='a' &&
-               lines[offset]->at(idx+5)=='t' &&
-               lines[offset]->at(idx+6)=='e' &&
-               lines[offset]->at(idx+7)=='d' &&
-               (lines[offset]->at(idx+8)==':' || !isspace(idx+8))) {
+            if(lines[offset].at(idx+2)=='r' &&
+               lines[offset].at(idx+3)=='e' &&
+               lines[offset].at(idx+4)=='a' &&
+               lines[offset].at(idx+5)=='t' &&
+               lines[offset].at(idx+6)=='e' &&
+               lines[offset].at(idx+7)=='d' &&
+               (lines[offset].at(idx+8)==':' || !isspace(idx+8))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_created);
                 idx+=7;
                 return true;
@@ -384,30 +383,30 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'r':
-            if(lines[offset]->at(idx+2)=='e') {
-                if(lines[offset]->at(idx+3)=='a' &&
-                   lines[offset]->at(idx+4)=='d')
+            if(lines[offset].at(idx+2)=='e') {
+                if(lines[offset].at(idx+3)=='a' &&
+                   lines[offset].at(idx+4)=='d')
                 {
-                    if(lines[offset]->at(idx+5)=='s' &&
-                       (lines[offset]->at(idx+6)==':' || !isspace(idx+6))) {
+                    if(lines[offset].at(idx+5)=='s' &&
+                       (lines[offset].at(idx+6)==':' || !isspace(idx+6))) {
                         idx+=5;
                         lexems.push_back(symbolTable.LEXEM.META_PROPERTY_reads);
                         return true;
                     } else {
-                        if((lines[offset]->at(idx+5)==':' || !isspace(idx+5))) {
+                        if((lines[offset].at(idx+5)==':' || !isspace(idx+5))) {
                             idx+=4;
                             lexems.push_back(symbolTable.LEXEM.META_PROPERTY_read);
                             return true;
                         }
                     }
                 } else {
-                    if(lines[offset]->at(idx+3)=='v' &&
-                       lines[offset]->at(idx+4)=='i' &&
-                       lines[offset]->at(idx+5)=='s' &&
-                       lines[offset]->at(idx+6)=='i' &&
-                       lines[offset]->at(idx+7)=='o' &&
-                       lines[offset]->at(idx+8)=='n' &&
-                       (lines[offset]->at(idx+9)==':' || !isspace(idx+9)))
+                    if(lines[offset].at(idx+3)=='v' &&
+                       lines[offset].at(idx+4)=='i' &&
+                       lines[offset].at(idx+5)=='s' &&
+                       lines[offset].at(idx+6)=='i' &&
+                       lines[offset].at(idx+7)=='o' &&
+                       lines[offset].at(idx+8)=='n' &&
+                       (lines[offset].at(idx+9)==':' || !isspace(idx+9)))
                     {
                         idx+=8;
                         lexems.push_back(symbolTable.LEXEM.META_PROPERTY_revision);
@@ -417,16 +416,16 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
             }
             return false;
         case 'i':
-            if(lines[offset]->at(idx+2)=='m' &&
-               lines[offset]->at(idx+3)=='p' &&
-               lines[offset]->at(idx+4)=='o' &&
-               lines[offset]->at(idx+5)=='r' &&
-               lines[offset]->at(idx+6)=='t' &&
-               lines[offset]->at(idx+7)=='a' &&
-               lines[offset]->at(idx+8)=='n' &&
-               lines[offset]->at(idx+9)=='c' &&
-               lines[offset]->at(idx+10)=='e' &&
-               (lines[offset]->at(idx+11)==':' || !isspace(idx+11))) {
+            if(lines[offset].at(idx+2)=='m' &&
+               lines[offset].at(idx+3)=='p' &&
+               lines[offset].at(idx+4)=='o' &&
+               lines[offset].at(idx+5)=='r' &&
+               lines[offset].at(idx+6)=='t' &&
+               lines[offset].at(idx+7)=='a' &&
+               lines[offset].at(idx+8)=='n' &&
+               lines[offset].at(idx+9)=='c' &&
+               lines[offset].at(idx+10)=='e' &&
+               (lines[offset].at(idx+11)==':' || !isspace(idx+11))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_importance);
                 idx+=10;
                 return true;
@@ -434,13 +433,13 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'u':
-            if(lines[offset]->at(idx+2)=='r' &&
-               lines[offset]->at(idx+3)=='g' &&
-               lines[offset]->at(idx+4)=='e' &&
-               lines[offset]->at(idx+5)=='n' &&
-               lines[offset]->at(idx+6)=='c' &&
-               lines[offset]->at(idx+7)=='y' &&
-               (lines[offset]->at(idx+8)==':' || !isspace(idx+8))) {
+            if(lines[offset].at(idx+2)=='r' &&
+               lines[offset].at(idx+3)=='g' &&
+               lines[offset].at(idx+4)=='e' &&
+               lines[offset].at(idx+5)=='n' &&
+               lines[offset].at(idx+6)=='c' &&
+               lines[offset].at(idx+7)=='y' &&
+               (lines[offset].at(idx+8)==':' || !isspace(idx+8))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_urgency);
                 idx+=7;
                 return true;
@@ -448,14 +447,14 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'p':
-            if(lines[offset]->at(idx+2)=='r' &&
-               lines[offset]->at(idx+3)=='o' &&
-               lines[offset]->at(idx+4)=='g' &&
-               lines[offset]->at(idx+5)=='r' &&
-               lines[offset]->at(idx+6)=='e' &&
-               lines[offset]->at(idx+7)=='s' &&
-               lines[offset]->at(idx+8)=='s' &&
-               (lines[offset]->at(idx+9)==':' || !isspace(idx+9))) {
+            if(lines[offset].at(idx+2)=='r' &&
+               lines[offset].at(idx+3)=='o' &&
+               lines[offset].at(idx+4)=='g' &&
+               lines[offset].at(idx+5)=='r' &&
+               lines[offset].at(idx+6)=='e' &&
+               lines[offset].at(idx+7)=='s' &&
+               lines[offset].at(idx+8)=='s' &&
+               (lines[offset].at(idx+9)==':' || !isspace(idx+9))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_progress);
                 idx+=8;
                 return true;
@@ -463,14 +462,14 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'm':
-            if(lines[offset]->at(idx+2)=='o' &&
-               lines[offset]->at(idx+3)=='d' &&
-               lines[offset]->at(idx+4)=='i' &&
-               lines[offset]->at(idx+5)=='f' &&
-               lines[offset]->at(idx+6)=='i' &&
-               lines[offset]->at(idx+7)=='e' &&
-               lines[offset]->at(idx+8)=='d' &&
-               (lines[offset]->at(idx+9)==':' || !isspace(idx+9))) {
+            if(lines[offset].at(idx+2)=='o' &&
+               lines[offset].at(idx+3)=='d' &&
+               lines[offset].at(idx+4)=='i' &&
+               lines[offset].at(idx+5)=='f' &&
+               lines[offset].at(idx+6)=='i' &&
+               lines[offset].at(idx+7)=='e' &&
+               lines[offset].at(idx+8)=='d' &&
+               (lines[offset].at(idx+9)==':' || !isspace(idx+9))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_modified);
                 idx+=8;
                 return true;
@@ -479,11 +478,11 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
             }
         case 'l':
             // key for relationships is 'links' because a) there are clashes for 'r' b) links is shorter than relationships
-            if(lines[offset]->at(idx+2)=='i' &&
-               lines[offset]->at(idx+3)=='n' &&
-               lines[offset]->at(idx+4)=='k' &&
-               lines[offset]->at(idx+5)=='s' &&
-               (lines[offset]->at(idx+6)==':' || !isspace(idx+6))) {
+            if(lines[offset].at(idx+2)=='i' &&
+               lines[offset].at(idx+3)=='n' &&
+               lines[offset].at(idx+4)=='k' &&
+               lines[offset].at(idx+5)=='s' &&
+               (lines[offset].at(idx+6)==':' || !isspace(idx+6))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_links);
                 idx+=5;
                 return true;
@@ -491,11 +490,11 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 's':
-            if(lines[offset]->at(idx+2)=='c' &&
-               lines[offset]->at(idx+3)=='o' &&
-               lines[offset]->at(idx+4)=='p' &&
-               lines[offset]->at(idx+5)=='e' &&
-               (lines[offset]->at(idx+6)==':' || !isspace(idx+6))) {
+            if(lines[offset].at(idx+2)=='c' &&
+               lines[offset].at(idx+3)=='o' &&
+               lines[offset].at(idx+4)=='p' &&
+               lines[offset].at(idx+5)=='e' &&
+               (lines[offset].at(idx+6)==':' || !isspace(idx+6))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_scope);
                 idx+=5;
                 return true;
@@ -503,14 +502,14 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
                 return false;
             }
         case 'd':
-            if(lines[offset]->at(idx+2)=='e' &&
-               lines[offset]->at(idx+3)=='a' &&
-               lines[offset]->at(idx+4)=='d' &&
-               lines[offset]->at(idx+5)=='l' &&
-               lines[offset]->at(idx+6)=='i' &&
-               lines[offset]->at(idx+7)=='n' &&
-               lines[offset]->at(idx+8)=='e' &&
-               (lines[offset]->at(idx+9)==':' || !isspace(idx+9))) {
+            if(lines[offset].at(idx+2)=='e' &&
+               lines[offset].at(idx+3)=='a' &&
+               lines[offset].at(idx+4)=='d' &&
+               lines[offset].at(idx+5)=='l' &&
+               lines[offset].at(idx+6)=='i' &&
+               lines[offset].at(idx+7)=='n' &&
+               lines[offset].at(idx+8)=='e' &&
+               (lines[offset].at(idx+9)==':' || !isspace(idx+9))) {
                 lexems.push_back(symbolTable.LEXEM.META_PROPERTY_deadline);
                 idx+=8;
                 return true;
@@ -529,19 +528,19 @@ bool MarkdownLexerSections::lexMetaPropertyName(const unsigned offset, unsigned
  */
 bool MarkdownLexerSections::lexToEndOfHtmlComment(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>(size_t)(idx+1)) {
+    if(lines[offset].size()>(size_t)(idx+1)) {
         unsigned short int i;
         for(i=idx+1;
-            i<lines[offset]->size();
+            i<lines[offset].size();
             i++) {
-            if(lines[offset]->at(i)=='-') {
+            if(lines[offset].at(i)=='-') {
                 if(startsWithHtmlCommentEndSymbol(offset,i)) {
                     if(i > idx+1) {
-                        lexems.push_back(new MarkdownLexem(MarkdownLexemType::META_TEXT,offset,idx,i-idx)); // note: ushort-ushort narrowing ({} > ())
+                        lexems.emplace_back(MarkdownLexemType::META_TEXT,offset,idx,i-idx); // note: ushort-ushort narrowing ({} > ())
                         idx=i;
                     }
                     lexHtmlCommentEndSymbol(offset,i);
-                    if(lines[offset]->size()>=i) {
+                    if(lines[offset].size()>=i) {
                         lexems.push_back(symbolTable.LEXEM.BR);
                     }
                     return true;
@@ -549,7 +548,7 @@ bool MarkdownLexerSections::lexToEndOfHtmlComment(const unsigned offset, unsigne
             }
         }
         if(i > idx+1) {
-            lexems.push_back(new MarkdownLexem(MarkdownLexemType::META_TEXT,offset,idx,i-idx)); // note: ushort-ushort narrowing ({} > ())
+            lexems.emplace_back(MarkdownLexemType::META_TEXT,offset,idx,i-idx); // note: ushort-ushort narrowing ({} > ())
             lexems.push_back(symbolTable.LEXEM.BR);
             idx=i;
             return true;
@@ -567,7 +566,7 @@ bool MarkdownLexerSections::lexPostDeclaredSectionHeader(const unsigned int offs
         return false;
     } else {
         // previous line is valid section name && current line is header line for that name
-        if(lines[offset-1]!=nullptr && lines[offset-1]->size()>=2 && !isspace(lines[offset-1]->at(0))
+        if(lines[offset-1].size()>=2 && !isspace(lines[offset-1].at(0))
              &&
            isSameCharsLine(offset, delimiter))
         {
@@ -605,14 +604,14 @@ bool MarkdownLexerSections::lexPostDeclaredSectionHeader(const unsigned int offs
 
             if(lexems.size()>2 // BEGIN_DOC LINE BR
                  &&
-               lexems[lexems.size()-1]->getType()==MarkdownLexemType::BR
+               lexems[lexems.size()-1].getType()==MarkdownLexemType::BR
                  &&
-               lexems[lexems.size()-2]->getType()==MarkdownLexemType::LINE)
+               lexems[lexems.size()-2].getType()==MarkdownLexemType::LINE)
             {
                 if(delimiter=='=') {
-                    lexems.insert(lexems.begin()+lexems.size()-2, new MarkdownLexem(MarkdownLexemType::SECTION_equals,0));
+                    lexems.insert(lexems.begin()+lexems.size()-2, MarkdownLexem(MarkdownLexemType::SECTION_equals,0));
                 } else {
-                    lexems.insert(lexems.begin()+lexems.size()-2, new MarkdownLexem(MarkdownLexemType::SECTION_hyphens,1));
+                    lexems.insert(lexems.begin()+lexems.size()-2, MarkdownLexem(MarkdownLexemType::SECTION_hyphens,1));
                 }
             } else {
                 addLineToLexems(offset);
@@ -629,17 +628,17 @@ bool MarkdownLexerSections::lexPostDeclaredSectionHeader(const unsigned int offs
 
 void MarkdownLexerSections::addLineToLexems(const unsigned int offset)
 {
-    lexems.push_back(new MarkdownLexem{MarkdownLexemType::LINE, offset, 0, MarkdownLexem::WHOLE_LINE});
+    lexems.emplace_back(MarkdownLexemType::LINE, offset, 0, MarkdownLexem::WHOLE_LINE);
     lexems.push_back(symbolTable.LEXEM.BR);
 }
 
 bool MarkdownLexerSections::nextToken(const unsigned int offset) {
     if(offset<lines.size()) {
-        if(lines[offset]->size()==0) {
+        if(lines[offset].size()==0) {
             lexems.push_back(symbolTable.LEXEM.BR);
             return true;
         } else {
-            switch(lines[offset]->at(0)) {
+            switch(lines[offset].at(0)) {
             case '`':
                 if(startsWithCodeBlockSymbol(offset)) {
                     // sections lexer just needs to detect code block to avoid detection of false sections, but no need to tokenize it
@@ -659,11 +658,11 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                         char cc;
                         unsigned short int ws=0, text=0, x = idx+1;
                         while(lookahead(offset,idx)) {
-                            cc = lines[offset]->at(++idx);
+                            cc = lines[offset].at(++idx);
                             if(isspace(cc)) {
                                 // a) whitespaces
                                 if(ws==0 && text) {
-                                    lexems.push_back(new MarkdownLexem(MarkdownLexemType::TEXT,offset,x,idx-x)); // note: ushort-ushort narrowing ({} > ())
+                                    lexems.emplace_back(MarkdownLexemType::TEXT,offset,x,idx-x); // note: ushort-ushort narrowing ({} > ())
                                     text = 0;
                                     x = idx;
                                 }
@@ -700,11 +699,11 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                                         unsigned short int mess = 0;
                                         char ccc;
                                         while(lookahead(offset,idx)) {
-                                            ccc = lines[offset]->at(++idx);
+                                            ccc = lines[offset].at(++idx);
                                             if(ccc=='-' && lexHtmlCommentEndSymbol(offset,idx)) {
                                                 if(mess) {
                                                     // TODO BUG add text BEFORE last lexem
-                                                    lexems.push_back(new MarkdownLexem(MarkdownLexemType::TEXT,offset,idx-mess,mess)); // note: ushort-ushort narrowing ({} > ())
+                                                    lexems.emplace_back(MarkdownLexemType::TEXT,offset,idx-mess,mess); // note: ushort-ushort narrowing ({} > ())
                                                 }
                                                 // IMPROVE process the rest of line after --> (ignored for now)
 
@@ -718,7 +717,7 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                                             }
                                         }
                                         if(mess) {
-                                            lexems.push_back(new MarkdownLexem(MarkdownLexemType::TEXT,offset,idx-mess,mess)); // note: ushort-ushort narrowing ({} > ())
+                                            lexems.emplace_back(MarkdownLexemType::TEXT,offset,idx-mess,mess); // note: ushort-ushort narrowing ({} > ())
                                         }
 
                                         // TODO FIX
@@ -733,7 +732,7 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                                 } else {
                                     // b2) text
                                     if(text==0 && ws) {
-                                        lexems.push_back(new MarkdownLexem(MarkdownLexemType::WHITESPACES,offset,x,idx-x)); // note: ushort-ushort narrowing ({} > ())
+                                        lexems.emplace_back(MarkdownLexemType::WHITESPACES,offset,x,idx-x); // note: ushort-ushort narrowing ({} > ())
                                         ws = 0;
                                         x = idx;
                                     }
@@ -742,10 +741,10 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
                             }
                         } // while
                         if(ws) {
-                            lexems.push_back(new MarkdownLexem(MarkdownLexemType::WHITESPACES,offset,x,idx+1-x)); // note: ushort-ushort narrowing ({} > ())
+                            lexems.emplace_back(MarkdownLexemType::WHITESPACES,offset,x,idx+1-x); // note: ushort-ushort narrowing ({} > ())
                         }
                         if(text) {
-                            lexems.push_back(new MarkdownLexem(MarkdownLexemType::TEXT,offset,x,idx+1-x)); // note: ushort-ushort narrowing ({} > ())
+                            lexems.emplace_back(MarkdownLexemType::TEXT,offset,x,idx+1-x); // note: ushort-ushort narrowing ({} > ())
                         }
                         lexems.push_back(symbolTable.LEXEM.BR);
                         return true;
@@ -774,12 +773,12 @@ bool MarkdownLexerSections::nextToken(const unsigned int offset) {
 bool MarkdownLexerSections::isSameCharsLine(const unsigned offset, const char c) const
 {
     // fail fast
-    if(lines[offset]!=nullptr && lines[offset]->size()
+    if(lines[offset].size()
          &&
-       lines[offset]->at(0)==c && lines[offset]->at(lines[offset]->size()-1)==c)
+       lines[offset].at(0)==c && lines[offset].at(lines[offset].size()-1)==c)
     {
-        for(unsigned i=1; i<lines[offset]->size()-1; i++) {
-            if(lines[offset]->at(i)!=c) {
+        for(unsigned i=1; i<lines[offset].size()-1; i++) {
+            if(lines[offset].at(i)!=c) {
                 return false;
             }
         }
@@ -790,7 +789,7 @@ bool MarkdownLexerSections::isSameCharsLine(const unsigned offset, const char c)
 
 bool MarkdownLexerSections::lookahead(const unsigned offset, const unsigned short idx) const
 {
-    if(lines[offset]->size() > (size_t)(idx+1)) {
+    if(lines[offset].size() > (size_t)(idx+1)) {
         return true;
     } else {
         return false;
@@ -799,7 +798,7 @@ bool MarkdownLexerSections::lookahead(const unsigned offset, const unsigned shor
 
 bool MarkdownLexerSections::lexMetaPropertyNameValueDelimiter(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]->size()>(size_t)(idx+1) && lines[offset]->at(idx+1)==':') {
+    if(lines[offset].size()>(size_t)(idx+1) && lines[offset].at(idx+1)==':') {
         idx++;
         lexems.push_back(symbolTable.LEXEM.META_NAMEVALUE_DELIMITER);
         return true;
@@ -810,14 +809,14 @@ bool MarkdownLexerSections::lexMetaPropertyNameValueDelimiter(const unsigned off
 
 bool MarkdownLexerSections::lexMetaPropertyValue(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]!=nullptr && lines[offset]->size()>(size_t)(idx+1)) {
+    if(lines[offset].size()>(size_t)(idx+1)) {
         unsigned short int i;
         for(i=idx+1;
-            i<lines[offset]->size() && lines[offset]->at(i)!=';';
+            i<lines[offset].size() && lines[offset].at(i)!=';';
             i++)
         {}
         if(i>idx+1) {
-            lexems.push_back(new MarkdownLexem(MarkdownLexemType::META_PROPERTY_VALUE,offset,idx+1,i-idx-1));
+            lexems.emplace_back(MarkdownLexemType::META_PROPERTY_VALUE,offset,idx+1,i-idx-1);
             idx=i-1;
             return true;
         }
@@ -827,7 +826,7 @@ bool MarkdownLexerSections::lexMetaPropertyValue(const unsigned offset, unsigned
 
 bool MarkdownLexerSections::lexMetaPropertyDelimiter(const unsigned offset, unsigned short int& idx)
 {
-    if(lines[offset]->size()>(size_t)(idx+1) && lines[offset]->at(idx+1)==';') {
+    if(lines[offset].size()>(size_t)(idx+1) && lines[offset].at(idx+1)==';') {
         lexems.push_back(symbolTable.LEXEM.META_PROPERTY_DELIMITER);
         idx++;
         return true;
@@ -840,15 +839,14 @@ string* MarkdownLexerSections::getText(const MarkdownLexem* lexem)
 {
     if(lexem!=nullptr && lines.size()) {
         if(lexem->getOff()<lines.size()) {
+            // the only place where text of (mapped) lines is copied
             if(lexem->getLng()==MarkdownLexem::WHOLE_LINE) {
-                string *result = lines[lexem->getOff()];
-                lines[lexem->getOff()] = nullptr;
-                return result;
+                return new string{lines[lexem->getOff()].toString()};
             } else {
                 if(lexem->getLng()==0) {
                     return new string{};
                 } else {
-                    return new string{lines[lexem->getOff()]->substr(lexem->getIdx(),lexem->getLng())};
+                    return new string{lines[lexem->getOff()].substr(lexem->getIdx(),lexem->getLng())};
                 }
             }
         }
@@ -31,35 +31,31 @@
 namespace m8r {
 
 /**
- * @brief Managed table of reusable lexems.
+ * @brief Table of reusable lexems - lexems w/o text which are copied to lexer's lexems.
  */
 class MarkdownLexemTable {
-private:
-    // IMPROVE unordered set
-    std::set<MarkdownLexem*> lexems;
-
 public:
-    MarkdownLexem* BEGIN_DOC;
-    MarkdownLexem* META_BEGIN;
-    MarkdownLexem* META_PROPERTY_DELIMITER;
-    MarkdownLexem* META_PROPERTY_type;
-    MarkdownLexem* META_PROPERTY_created;
-    MarkdownLexem* META_PROPERTY_reads;
-    MarkdownLexem* META_PROPERTY_read;
-    MarkdownLexem* META_PROPERTY_revision;
-    MarkdownLexem* META_PROPERTY_modified;
-    MarkdownLexem* META_PROPERTY_importance;
-    MarkdownLexem* META_PROPERTY_urgency;
-    MarkdownLexem* META_PROPERTY_progress;
-    MarkdownLexem* META_PROPERTY_tags;
-    MarkdownLexem* META_PROPERTY_links;
-    MarkdownLexem* META_PROPERTY_deadline;
-    MarkdownLexem* META_PROPERTY_scope;
-    MarkdownLexem* META_NAMEVALUE_DELIMITER;
-    MarkdownLexem* HTML_COMMENT_BEGIN;
-    MarkdownLexem* HTML_COMMENT_END;
-    MarkdownLexem* BR;
-    MarkdownLexem* END_DOC;
+    const MarkdownLexem BEGIN_DOC;
+    const MarkdownLexem META_BEGIN;
+    const MarkdownLexem META_PROPERTY_DELIMITER;
+    const MarkdownLexem META_PROPERTY_type;
+    const MarkdownLexem META_PROPERTY_created;
+    const MarkdownLexem META_PROPERTY_reads;
+    const MarkdownLexem META_PROPERTY_read;
+    const MarkdownLexem META_PROPERTY_revision;
+    const MarkdownLexem META_PROPERTY_modified;
+    const MarkdownLexem META_PROPERTY_importance;
+    const MarkdownLexem META_PROPERTY_urgency;
+    const MarkdownLexem META_PROPERTY_progress;
+    const MarkdownLexem META_PROPERTY_tags;
+    const MarkdownLexem META_PROPERTY_links;
+    const MarkdownLexem META_PROPERTY_deadline;
+    const MarkdownLexem META_PROPERTY_scope;
+    const MarkdownLexem META_NAMEVALUE_DELIMITER;
+    const MarkdownLexem HTML_COMMENT_BEGIN;
+    const MarkdownLexem HTML_COMMENT_END;
+    const MarkdownLexem BR;
+    const MarkdownLexem END_DOC;
 
     MarkdownLexemTable();
     MarkdownLexemTable(const MarkdownLexemTable&) = delete;
@@ -67,8 +63,46 @@ public:
     MarkdownLexemTable& operator=(const MarkdownLexemTable&) = delete;
     MarkdownLexemTable& operator=(const MarkdownLexemTable&&) = delete;
     ~MarkdownLexemTable();
+};
+
+/**
+ * @brief Per-thread arena of lexems reused by lexers.
+ *
+ * Lexems are stored by value in a contiguous array whose capacity is kept
+ * when lexer is destroyed, therefore loading of a repository (thousands of
+ * files) doesn't allocate lexems one by one. Arena is leased to one lexer
+ * at a time - another lexer in the same thread uses its own array.
+ */
+class MarkdownLexemArena
+{
+public:
+    /**
+     * @brief Arena capacity above which memory is returned on release (16MB of lexems).
+     */
+    static constexpr size_t MAX_RETAINED_LEXEMS = 1<<20;
+
+private:
+    std::vector<MarkdownLexem> lexems;
+    bool leased;
+
+public:
+    explicit MarkdownLexemArena();
+    MarkdownLexemArena(const MarkdownLexemArena&) = delete;
+    MarkdownLexemArena(const MarkdownLexemArena&&) = delete;
+    MarkdownLexemArena& operator=(const MarkdownLexemArena&) = delete;
+    MarkdownLexemArena& operator=(const MarkdownLexemArena&&) = delete;
+    ~MarkdownLexemArena();
 
-    bool contains(MarkdownLexem *lexem) const { return lexems.find(lexem)!=lexems.end(); }
+    /**
+     * @brief Lease calling thread's arena - nullptr if it's already leased.
+     */
+    static MarkdownLexemArena* lease();
+
+    std::vector<MarkdownLexem>& getLexems() { return lexems; }
+    /**
+     * @brief Clear lexems (keeping capacity up to MAX_RETAINED_LEXEMS) and return arena.
+     */
+    void release();
 };
 
 class MarkdownSymbolTable
@@ -99,24 +133,49 @@ public:
     void clearSymbols() { symbols.clear(); }
 };
 
+/**
+ * @brief How lexer reads Markdown file lines.
+ */
+enum class MarkdownLexerInputMode {
+    /**
+     * @brief File is read to a single buffer and lines are spans to the buffer.
+     */
+    SINGLE_BUFFER,
+    /**
+     * @brief Every file line is read to its own heap allocated string.
+     */
+    LINE_COPIES
+};
+
 /**
  * @brief Markdown lexical analyzer for section-level granularity parser.
+ *
+ * Lines are spans which point either to single file buffer, line copies
+ * or text to tokenize (which therefore must outlive the lexer). Text is
+ * copied only when parser asks for it using getText().
  */
 class MarkdownLexerSections
 {
 private:
     const std::string* filePath;
+    MarkdownLexerInputMode inputMode;
     unsigned lastBrTokensOffset;
     bool inCodeBlock;
 
     size_t fileSize;
-    std::vector<std::string*> lines;
-    // IMPROVE prepare a LexemPool: vector + MarkdownLexem[1000] and allocate from there (performance)
-    std::vector<MarkdownLexem*> lexems;
+    MappedFile mappedFile;
+    std::vector<std::string*> lineCopies;
+    std::vector<LineSpan> lines;
+    // lexems are stored by value in thread's arena (or own array if arena is leased)
+    MarkdownLexemArena* arena;
+    std::vector<MarkdownLexem> ownLexems;
+    std::vector<MarkdownLexem>& lexems;
     MarkdownSymbolTable symbolTable;
 
 public:
-    explicit MarkdownLexerSections(const std::string* filePath=nullptr);
+    explicit MarkdownLexerSections(
+            const std::string* filePath=nullptr,
+            MarkdownLexerInputMode inputMode=MarkdownLexerInputMode::SINGLE_BUFFER);
     MarkdownLexerSections(const MarkdownLexerSections &) = delete;
     MarkdownLexerSections(const MarkdownLexerSections &&);
     MarkdownLexerSections &operator=(const MarkdownLexerSections &) = delete;
@@ -133,15 +192,17 @@ public:
 
     void setFilePath(const std::string*& filePath) { this->filePath = filePath; }
     size_t getFileSize() const { return fileSize; }
-    const std::vector<MarkdownLexem*>& getLexems() const { return lexems; }
-    const std::vector<std::string*>& getLines() const { return lines; }
+    const std::vector<MarkdownLexem>& getLexems() const { return lexems; }
+    MarkdownLexerInputMode getInputMode() const { return inputMode; }
+    const std::vector<LineSpan>& getLines() const { return lines; }
     const MarkdownSymbolTable& getSymbolTable() const { return symbolTable; }
-    MarkdownLexem* operator[](size_t i) { return lexems[i]; }
-    const MarkdownLexem* operator[](size_t i) const { return lexems[i]; }
+    const MarkdownLexem* operator[](size_t i) const { return &lexems[i]; }
     bool empty() const { return lexems.empty(); }
     size_t size() const { return lexems.size(); }
 
 private:
+    bool loadLines();
+    void tokenizeLines();
     bool nextToken(const unsigned int offset);
 
     inline bool lookahead(const unsigned offset, const unsigned short idx) const;
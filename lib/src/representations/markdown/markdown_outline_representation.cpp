@@ -105,6 +105,11 @@ Outline* MarkdownOutlineRepresentation::outline(const File& file)
 {
     MarkdownDocument md{&file.name};
     md.from();
+    return outline(md);
+}
+
+Outline* MarkdownOutlineRepresentation::outline(MarkdownDocument& md)
+{
     vector<MarkdownAstNodeSection*>* ast = md.moveAst();
 
     Outline* o = outline(ast);
@@ -113,7 +118,6 @@ Outline* MarkdownOutlineRepresentation::outline(const File& file)
         o->setKey(*md.getFilePath());
         o->setBytesize(md.getFileSize());
         o->completeProperties(md.getModified());
-        o->setModifiedPretty(datetimeToPrettyHtml(o->getModified()));
     }
     return o;
 }
@@ -79,6 +79,14 @@ public:
     virtual ~MarkdownOutlineRepresentation();
 
     virtual Outline* outline(const filesystem::File& file) override;
+    /**
+     * @brief Create Outline from lexed and parsed Markdown document.
+     *
+     * Markdown document can be lexed and parsed in any thread, however,
+     * this method must be called from a single thread as it registers
+     * tags and types in the (shared) Ontology.
+     */
+    virtual Outline* outline(MarkdownDocument& md);
     virtual Outline* header(const std::string* md);
     virtual Note* note(const filesystem::File& file);
     virtual Note* note(const std::string* md);
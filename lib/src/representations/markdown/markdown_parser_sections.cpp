@@ -36,6 +36,8 @@ MarkdownParserSections::MarkdownParserSections(MarkdownLexerSections& lexer)
     : lexer(lexer)
 {
     this->ast = nullptr;
+    this->lexems = nullptr;
+    this->lexemsCount = 0;
 }
 
 MarkdownParserSections::~MarkdownParserSections()
@@ -52,7 +54,9 @@ MarkdownParserSections::~MarkdownParserSections()
 void MarkdownParserSections::parse()
 {
     metadataExist = false;
-    if(lexer.size()) {
+    lexems = lexer.getLexems().data();
+    lexemsCount = lexer.size();
+    if(lexemsCount) {
         if(ast!=nullptr) {
             if(!ast->empty()) {
                 // TODO delete members
@@ -66,8 +70,8 @@ void MarkdownParserSections::parse()
 
 const MarkdownLexem* MarkdownParserSections::lookahead(size_t offset)
 {
-    if(offset<lexer.size()) {
-        return lexer[offset];
+    if(offset<lexemsCount) {
+        return &lexems[offset];
     } else {
         return nullptr;
     }
@@ -75,8 +79,8 @@ const MarkdownLexem* MarkdownParserSections::lookahead(size_t offset)
 
 const MarkdownLexem* MarkdownParserSections::lookahead(MarkdownLexemType lexemType, size_t offset)
 {
-    if(offset<lexer.size() && lexer[offset]->getType()==lexemType) {
-        return lexer[offset];
+    if(offset<lexemsCount && lexems[offset].getType()==lexemType) {
+        return &lexems[offset];
     } else {
         return nullptr;
     }
@@ -84,8 +88,8 @@ const MarkdownLexem* MarkdownParserSections::lookahead(MarkdownLexemType lexemTy
 
 const MarkdownLexem* MarkdownParserSections::lookaheadNot(MarkdownLexemType lexemType, size_t offset)
 {
-    if(offset<lexer.size() && lexer[offset]->getType()!=lexemType) {
-        return lexer[offset];
+    if(offset<lexemsCount && lexems[offset].getType()!=lexemType) {
+        return &lexems[offset];
     } else {
         return nullptr;
     }
@@ -93,15 +97,15 @@ const MarkdownLexem* MarkdownParserSections::lookaheadNot(MarkdownLexemType lexe
 
 const MarkdownLexem* MarkdownParserSections::lookaheadSection(size_t offset)
 {
-    if(offset<lexer.size()
+    if(offset<lexemsCount
          &&
-      (lexer[offset]->getType()==MarkdownLexemType::SECTION
+      (lexems[offset].getType()==MarkdownLexemType::SECTION
          ||
-       lexer[offset]->getType()==MarkdownLexemType::SECTION_equals
+       lexems[offset].getType()==MarkdownLexemType::SECTION_equals
          ||
-       lexer[offset]->getType()==MarkdownLexemType::SECTION_hyphens))
+       lexems[offset].getType()==MarkdownLexemType::SECTION_hyphens))
     {
-        return lexer[offset];
+        return &lexems[offset];
     } else {
         return nullptr;
     }
@@ -109,15 +113,15 @@ const MarkdownLexem* MarkdownParserSections::lookaheadSection(size_t offset)
 
 const MarkdownLexem* MarkdownParserSections::lookaheadNotSection(size_t offset)
 {
-    if(offset<lexer.size()
+    if(offset<lexemsCount
          &&
-      lexer[offset]->getType()!=MarkdownLexemType::SECTION
+      lexems[offset].getType()!=MarkdownLexemType::SECTION
          &&
-      lexer[offset]->getType()!=MarkdownLexemType::SECTION_equals
+      lexems[offset].getType()!=MarkdownLexemType::SECTION_equals
          &&
-      lexer[offset]->getType()!=MarkdownLexemType::SECTION_hyphens)
+      lexems[offset].getType()!=MarkdownLexemType::SECTION_hyphens)
     {
-        return lexer[offset];
+        return &lexems[offset];
     } else {
         return nullptr;
     }
@@ -147,12 +151,12 @@ void MarkdownParserSections::preambleRule(size_t& offset)
 
 MarkdownAstNodeSection* MarkdownParserSections::sectionRule(size_t& offset)
 {
-    if(offset+1<lexer.size()) {
+    if(offset+1<lexemsCount) {
         MarkdownAstNodeSection* result;
         unsigned depth;
-        switch(lexer[offset+1]->getType()) {
+        switch(lexems[offset+1].getType()) {
         case MarkdownLexemType::SECTION:
-            depth=lexer[offset+1]->getDepth();
+            depth=lexems[offset+1].getDepth();
             result=sectionHeaderRule(++offset);
             if(result!=nullptr) {
                 // detect trailing spaces (no metadata) like ### Section w/ depth 3 ###
@@ -182,9 +186,9 @@ MarkdownAstNodeSection* MarkdownParserSections::sectionRule(size_t& offset)
         case MarkdownLexemType::SECTION_equals:
         case MarkdownLexemType::SECTION_hyphens:
             // lexer ensures existence of LINE and BR right after SECTION_*
-            depth = lexer[offset+1]->getType()==MarkdownLexemType::SECTION_equals?0:1;
+            depth = lexems[offset+1].getType()==MarkdownLexemType::SECTION_equals?0:1;
             ++offset; // move to point to SECTION_*
-            result = new MarkdownAstNodeSection(lexer.getText(lexer[++offset])); // move to LINE
+            result = new MarkdownAstNodeSection(lexer.getText(&lexems[++offset])); // move to LINE
             result->setPostDeclaredSection();
             result->setDepth(depth);
             ++offset; // skip BR
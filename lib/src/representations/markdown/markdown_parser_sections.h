@@ -44,6 +44,9 @@ class MarkdownParserSections
 {
 private:
     MarkdownLexerSections& lexer;
+    // dense array of lexer's lexems
+    const MarkdownLexem* lexems;
+    size_t lexemsCount;
 
     std::vector<MarkdownAstNodeSection*>* ast;
 
@@ -0,0 +1,133 @@
+/*
+ aho_corasick_benchmark.cpp     MindForger markdown test
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "../../src/gear/trie.h"
+#include "../../src/gear/aho_corasick.h"
+#include "../../src/gear/file_utils.h"
+
+using namespace std;
+using namespace m8r;
+
+extern char* getMindforgerGitHomePath();
+
+static const string AUTOLINKING_TRAILING_CHARS{" \t,:;.!?<>{}&()-+/*\\_=%~#$^[]'\""};
+
+/*
+ * Autolinking of a text node as it was done by trie: longest prefix word is searched
+ * at every word offset and the text is chopped word by word.
+ */
+static size_t trieAutolinkMatches(const Trie& trie, const string& text)
+{
+    string txt{text}, pre{};
+    size_t matches{};
+    while(txt.size()) {
+        size_t preSize{};
+        while(preSize < txt.size() && AUTOLINKING_TRAILING_CHARS.find(txt.at(preSize)) != string::npos) {
+            preSize++;
+        }
+        txt = txt.substr(preSize);
+
+        pre.clear();
+        if(txt.size() && trie.findLongestPrefixWord(txt, pre)
+           && (txt.size() == pre.size() || AUTOLINKING_TRAILING_CHARS.find(txt.at(pre.size())) != string::npos))
+        {
+            matches++;
+            txt = txt.substr(pre.size());
+        } else {
+            size_t begin = txt.find_first_of(" \t");
+            if(begin != string::npos) {
+                txt = txt.substr(begin+1);
+            } else {
+                break;
+            }
+        }
+    }
+    return matches;
+}
+
+/*
+RESULT: Aho-Corasick is linear, trie per-word search w/ chopping is quadratic:
+
+2026/10/17 (1 CPU, -O1):
+Autolinking 64kB text w/ 3091 names
+  TRIE        ... 5633 matches in 15.951ms
+  AHO-CORASICK... 5913 matches in 3.159ms (automaton compiled in 1.645ms)
+Autolinking 512kB text w/ 3091 names
+  TRIE        ... 49428 matches in 1156.67ms
+  AHO-CORASICK... 50998 matches in 16.089ms (automaton compiled in 1.163ms)
+
+Aho-Corasick finds more matches as it finds the longest WHOLE word match (trie gives
+up once the longest prefix match is not a whole word).
+ */
+TEST(AhoCorasickBenchmark, DISABLED_AhoCorasickVsTrie)
+{
+    // 1.1M file
+    string fileName{"/lib/test/resources/benchmark-repository/memory/meta.md"};
+    fileName.insert(0, getMindforgerGitHomePath());
+    unique_ptr<string> s{m8r::fileToString(fileName)};
+
+    // large N description and O/N names (every 50th word)
+    string text = s->substr(0, 1<<19);
+    vector<string> names{};
+    size_t pos{}, end{}, i{};
+    while((end = s->find(' ', pos)) != string::npos) {
+        if(end > pos && (i++ % 50) == 0) {
+            names.push_back(s->substr(pos, end-pos));
+        }
+        pos = end + 1;
+    }
+    cout << "Autolinking " << text.size()/1024 << "kB text w/ " << names.size() << " names" << endl;
+
+    // TRIE
+    Trie trie{};
+    for(string& n:names) {
+        trie.addWord(n);
+    }
+    auto beginTrie = chrono::high_resolution_clock::now();
+    size_t trieMatches = trieAutolinkMatches(trie, text);
+    auto endTrie = chrono::high_resolution_clock::now();
+    cout << "  TRIE        ... " << trieMatches << " matches in "
+         << chrono::duration_cast<chrono::microseconds>(endTrie-beginTrie).count()/1000.0 << "ms" << endl;
+
+    // AHO-CORASICK
+    AhoCorasick automaton{};
+    for(string& n:names) {
+        automaton.addWord(n);
+    }
+    auto beginCompile = chrono::high_resolution_clock::now();
+    automaton.compile();
+    auto endCompile = chrono::high_resolution_clock::now();
+    vector<AhoCorasick::Match> matches{};
+    auto beginAho = chrono::high_resolution_clock::now();
+    automaton.findWholeWords(text, AUTOLINKING_TRAILING_CHARS, matches);
+    auto endAho = chrono::high_resolution_clock::now();
+    cout << "  AHO-CORASICK... " << matches.size() << " matches in "
+         << chrono::duration_cast<chrono::microseconds>(endAho-beginAho).count()/1000.0 << "ms"
+         << " (automaton compiled in "
+         << chrono::duration_cast<chrono::microseconds>(endCompile-beginCompile).count()/1000.0 << "ms)" << endl;
+
+    ASSERT_LE(trieMatches, matches.size());
+}
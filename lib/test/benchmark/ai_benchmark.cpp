@@ -23,6 +23,9 @@
 #include <gtest/gtest.h>
 
 #include "../../src/mind/mind.h"
+#include "../../src/mind/ai/ai.h"
+#include "../../src/mind/ai/nlp/markdown_tokenizer.h"
+#include "../../src/mind/ai/nlp/note_char_provider.h"
 
 using namespace std;
 using namespace m8r;
@@ -45,6 +48,9 @@ extern char* getMindforgerGitHomePath();
 /*
  * Measurements
  *
+ * 2026/10/17 ...   6s (<1') , 5.012 Ns, 12.557.566 rankings, 50.120 cells in top-K aaMatrix ... interned word IDs, CSR BoW vectors, merge of sorted word ID arrays, 1 CPU, -O1
+ * 2026/10/17 ...  46s (<1') , 5.012 Ns, 12.557.566 rankings, 50.120 cells in top-K aaMatrix ... titles as sorted word ID arrays (titles similarity 5.7s > 0.9s), 1 CPU, -O1
+ * 2026/10/17 ...  48s (<1') , 5.012 Ns, 12.557.566 rankings, 50.120 cells in top-K aaMatrix ... sparse top-K, 1/2 of matrix in parallel, 1 CPU, -O1
  * 2018/03/31 ...  46s (<1') , 5.000 Ns, 12.560.072 rankings in aaMatrix (5k^2 / 2) ... added stemmer (less words), only 10 relevant words compared
  * 2018/03/31 ... 129s (2')  , 5.000 Ns, 12.560.072 rankings in aaMatrix (5k^2 / 2) ... 1/2 of matrix, simplified vectors weight computation
  * 2018/03/31 ... 338s (5'30), 5.000 Ns, 12.560.072 rankings in aaMatrix (5k^2 / 2)
@@ -59,9 +65,10 @@ TEST(AiBenchmark, DISABLED_AaMatrix)
     config.setConfigFilePath("/tmp/cfg-aib-am.md");
     config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)), repositoryConfigRepresentation);
     m8r::Mind mind(config);
-    mind.think();
+    mind.learn();
     cout << "Statistics:" << endl
     << "  Outlines: " << mind.remind().getOutlinesCount() << endl
+    << "  Notes   : " << mind.remind().getNotesCount() << endl
     << "  Bytes   : " << mind.remind().getOutlineMarkdownsSize() << endl;
 
     ASSERT_LE(1, mind.remind().getOutlinesCount());
@@ -70,17 +77,73 @@ TEST(AiBenchmark, DISABLED_AaMatrix)
      * Tokenize repository > make AI to think > find the most similar Notes pair
      */
 
-    auto beginDream = chrono::high_resolution_clock::now();
-
-    // TODO to be rewritten mind.dream();
+    m8r::AiAaBoW aa{mind.remind(), mind};
 
+    auto beginDream = chrono::high_resolution_clock::now();
+    aa.dream().get();
     auto endDream = chrono::high_resolution_clock::now();
-    MF_DEBUG(endl << "Dream DONE in " << chrono::duration_cast<chrono::microseconds>(endDream-beginDream).count()/1000.0 << "ms" << endl);
+    cout << endl << "Dream DONE in " << chrono::duration_cast<chrono::microseconds>(endDream-beginDream).count()/1000.0 << "ms"
+         << " (" << aa.getAaCellsCount() << " AA cells)" << endl;
 
     // get the best associations of N
     m8r::Note* n=mind.remind().getOutlines()[0]->getNotes()[0];
-    UNUSED_ARG(n);
     std::vector<std::pair<m8r::Note*,float>> lb{};
-    // TODO to be rewritten mind.getAssociationsLeaderboard(n, lb);
-    // TODO to be rewritten m8r::Ai::print(n,lb);
+    aa.getAssociatedNotes(n, lb).get();
+    aa.getAssociatedNotes(n, lb).get();
+    m8r::Ai::print(n,lb);
+}
+
+/*
+ * Lexicon build (tokenization + stemming of all Ns) w/o and w/ stems cache.
+ *
+ * Measurements
+ *
+ * 2026/10/17 ... uncached 3.8s, cached 2.8s, 48MB (25x 5.012 Ns), 4.539 words lexicon, 6.500 cached stems, 1 CPU, -O1
+ */
+TEST(AiBenchmark, DISABLED_StemmerCache)
+{
+    string repositoryPath{"/lib/test/resources/benchmark-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-aib-sc.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)), repositoryConfigRepresentation);
+    m8r::Mind mind(config);
+    mind.learn();
+    cout << "Statistics:" << endl
+    << "  Outlines: " << mind.remind().getOutlinesCount() << endl
+    << "  Notes   : " << mind.remind().getNotesCount() << endl
+    << "  Bytes   : " << mind.remind().getOutlineMarkdownsSize() << endl;
+
+    ASSERT_LE(1, mind.remind().getOutlinesCount());
+
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+
+    // repository is tokenized several times to get ~50MB of Markdown
+    const int ROUNDS = 25;
+    m8r::CommonWordsBlacklist blacklist{};
+    size_t lexiconSizes[2];
+    for(int cached=0; cached<2; cached++) {
+        m8r::Stemmer::clearCache();
+        m8r::Lexicon lexicon{};
+        m8r::MarkdownTokenizer tokenizer{lexicon, blacklist};
+        tokenizer.getStemmer().setCached(cached);
+
+        auto begin = chrono::high_resolution_clock::now();
+        for(int r=0; r<ROUNDS; r++) {
+            for(m8r::Note* n:notes) {
+                m8r::NoteCharProvider chars{n};
+                m8r::WordFrequencyList wfl{&lexicon};
+                tokenizer.tokenize(chars, wfl);
+            }
+        }
+        auto end = chrono::high_resolution_clock::now();
+        lexiconSizes[cached] = lexicon.size();
+        cout << (cached?"Cached  ":"Uncached") << " lexicon of " << lexicon.size() << " words built in "
+             << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms"
+             << " (" << m8r::Stemmer::getCacheSize() << " cached stems)" << endl;
+    }
+    ASSERT_EQ(lexiconSizes[0], lexiconSizes[1]);
 }
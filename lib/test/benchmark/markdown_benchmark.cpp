@@ -42,11 +42,9 @@ using namespace m8r;
 
 extern char* getMindforgerGitHomePath();
 
-// 2018/03/02 100x = 2.460ms (120MiB)
-TEST(MarkdownParserBenchmark, DISABLED_ParserMeta)
+void benchmarkParser(const char* relativePath, MarkdownLexerInputMode inputMode, bool metadata, float mib)
 {
-    unique_ptr<string> fileName
-            = unique_ptr<string>(new string{"/lib/test/resources/benchmark-repository/memory/meta.md"});
+    unique_ptr<string> fileName = unique_ptr<string>(new string{relativePath});
     fileName.get()->insert(0, getMindforgerGitHomePath());
 
     // do >1 iterations
@@ -54,38 +52,56 @@ TEST(MarkdownParserBenchmark, DISABLED_ParserMeta)
     auto begin = chrono::high_resolution_clock::now();
     for(int i=0; i<ITERATIONS; i++) {
         cout << "." << flush;
-        MarkdownLexerSections lexer(fileName.get());
+        MarkdownLexerSections lexer(fileName.get(), inputMode);
         lexer.tokenize();
         MarkdownParserSections parser(lexer);
         parser.parse();
 
-        EXPECT_TRUE(parser.hasMetadata());
+        EXPECT_EQ(metadata, parser.hasMetadata());
     }
     auto end = chrono::high_resolution_clock::now();
-    MF_DEBUG(endl << (ITERATIONS*1.2) << "MiB (" << ITERATIONS << "x1.1MiB) MDs parsed in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms");
+    MF_DEBUG(endl << (ITERATIONS*mib) << "MiB (" << ITERATIONS << "x" << mib << "MiB) MDs parsed in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms");
     MF_DEBUG(" ~ AVG: " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000000.0 << "ms" << endl);
 }
 
+// 2018/03/02 100x = 2.460ms (120MiB)
+// 2026/10/17 100x = 2.416ms mmap vs. 2.971ms line copies
+// 2026/10/17 100x = 1.530ms mmap vs. 1.750ms line copies (lexem arena)
+TEST(MarkdownParserBenchmark, DISABLED_ParserMeta)
+{
+    benchmarkParser(
+        "/lib/test/resources/benchmark-repository/memory/meta.md",
+        MarkdownLexerInputMode::SINGLE_BUFFER,
+        true,
+        1.2);
+}
+
+TEST(MarkdownParserBenchmark, DISABLED_ParserMetaLineCopies)
+{
+    benchmarkParser(
+        "/lib/test/resources/benchmark-repository/memory/meta.md",
+        MarkdownLexerInputMode::LINE_COPIES,
+        true,
+        1.2);
+}
+
 // 2018/03/02 100x = 1.000ms (770MiB)
+// 2026/10/17 100x = 781ms mmap vs. 1.068ms line copies
+// 2026/10/17 100x = 412ms mmap vs. 612ms line copies (lexem arena)
 TEST(MarkdownParserBenchmark, DISABLED_ParserNoMeta)
 {
-    unique_ptr<string> fileName
-            = unique_ptr<string>(new string{"/lib/test/resources/benchmark-repository/memory/nometa.md"});
-    fileName.get()->insert(0, getMindforgerGitHomePath());
-
-    // do >1 iterations
-    const int ITERATIONS = 100;
-    auto begin = chrono::high_resolution_clock::now();
-    for(int i=0; i<ITERATIONS; i++) {
-        cout << "." << flush;
-        MarkdownLexerSections lexer(fileName.get());
-        lexer.tokenize();
-        MarkdownParserSections parser(lexer);
-        parser.parse();
+    benchmarkParser(
+        "/lib/test/resources/benchmark-repository/memory/nometa.md",
+        MarkdownLexerInputMode::SINGLE_BUFFER,
+        false,
+        0.77);
+}
 
-        EXPECT_FALSE(parser.hasMetadata());
-    }
-    auto end = chrono::high_resolution_clock::now();
-    MF_DEBUG(endl << (ITERATIONS*0.77) << "MiB (" << ITERATIONS << "x0.77MiB) MDs parsed in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms");
-    MF_DEBUG(" ~ AVG: " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000000.0 << "ms" << endl);
+TEST(MarkdownParserBenchmark, DISABLED_ParserNoMetaLineCopies)
+{
+    benchmarkParser(
+        "/lib/test/resources/benchmark-repository/memory/nometa.md",
+        MarkdownLexerInputMode::LINE_COPIES,
+        false,
+        0.77);
 }
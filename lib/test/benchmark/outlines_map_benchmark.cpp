@@ -0,0 +1,85 @@
+/*
+ outlines_map_benchmark.cpp           MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "../../src/mind/mind.h"
+#include "../../src/gear/file_utils.h"
+#include "../src/test_utils.h"
+
+using namespace std;
+using namespace m8r;
+
+// 2026/10/17 20k Os: in sync 1211ms > 265ms, 10k stale Ns 25696ms > 402ms (quadratic find/removeNote() > hashed keys & batch forget)
+TEST(OutlinesMapBenchmark, DISABLED_Synchronize20k)
+{
+    const int OUTLINES = 20000;
+    string repositoryPath{platformSpecificPath("/tmp/mf-benchmark-outlines-map")};
+    string memoryPath{repositoryPath + FILE_PATH_SEPARATOR + DIRNAME_MEMORY + FILE_PATH_SEPARATOR};
+    map<string,string> pathToContent{};
+    for(int o=0; o<OUTLINES; o++) {
+        pathToContent[memoryPath + "outline-" + std::to_string(o) + ".md"]
+            = "# Outline " + std::to_string(o) + "\nOutline description.\n";
+    }
+    createEmptyRepository(repositoryPath, pathToContent);
+
+    MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    Configuration& config = Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-omb-s20k.md");
+    config.setActiveRepository(
+        config.addRepository(RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+    Mind mind(config);
+    mind.learn();
+    ASSERT_EQ(OUTLINES, mind.remind().getOutlinesCount());
+    Outline* outlinesMap = mind.outlinesMapGet();
+    ASSERT_EQ(OUTLINES, outlinesMap->getNotesCount());
+
+    // steady state: map is in sync w/ mind
+    auto begin = chrono::high_resolution_clock::now();
+    mind.outlinesMapGet();
+    auto end = chrono::high_resolution_clock::now();
+    cout << endl << "Synchronized " << OUTLINES << " Os map in sync in "
+         << chrono::duration_cast<chrono::milliseconds>(end-begin).count() << "ms" << endl;
+
+    // half of map's Ns are stale and half of Os is missing in the map
+    vector<Note*> ns{outlinesMap->getNotes().begin(), outlinesMap->getNotes().begin()+OUTLINES/2};
+    for(int i=OUTLINES/2; i<OUTLINES; i++) {
+        delete outlinesMap->getNotes()[i];
+        Note* n = new Note(outlinesMap->getNotes()[0]->getType(), outlinesMap);
+        n->setName("Stale " + std::to_string(i));
+        n->addLink(new Link{LINK_NAME_OUTLINE_KEY, memoryPath + "stale-" + std::to_string(i) + ".md"});
+        ns.push_back(n);
+    }
+    outlinesMap->setNotes(ns);
+
+    begin = chrono::high_resolution_clock::now();
+    mind.outlinesMapGet();
+    end = chrono::high_resolution_clock::now();
+    EXPECT_EQ(OUTLINES, outlinesMap->getNotesCount());
+    cout << "Synchronized " << OUTLINES << " Os map w/ " << OUTLINES/2 << " stale Ns in "
+         << chrono::duration_cast<chrono::milliseconds>(end-begin).count() << "ms" << endl;
+}
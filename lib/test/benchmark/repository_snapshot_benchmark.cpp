@@ -0,0 +1,83 @@
+/*
+ repository_snapshot_benchmark.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <map>
+#include <string>
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "../../src/mind/mind.h"
+#include "../../src/gear/file_utils.h"
+#include "../src/test_utils.h"
+
+using namespace std;
+using namespace m8r;
+
+// 2026/10/17 10k Os (50k Ns): cold 3.0s, warm 2.0s - parsing 0.9s > snapshot 0.1s, the rest is O model & FTS
+// 2026/10/17 10k Os (50k Ns): cold 1.6s, warm 0.7s - reentrant localtime, lazy pretty timestamps, FTS w/o sort & per char facet lookup
+TEST(RepositorySnapshotBenchmark, DISABLED_WarmStart10k)
+{
+    const int OUTLINES = 10000;
+    string repositoryPath{platformSpecificPath("/tmp/mf-benchmark-repository-snapshot")};
+    string memoryPath{repositoryPath + FILE_PATH_SEPARATOR + DIRNAME_MEMORY + FILE_PATH_SEPARATOR};
+    map<string,string> pathToContent{};
+    for(int o=0; o<OUTLINES; o++) {
+        string md{"# Outline "};
+        md += std::to_string(o);
+        md += " <!-- Metadata: type: Grow; tags: benchmark, o" + std::to_string(o%100) + "; created: 2015-05-30 21:30:28; reads: 5; read: 2016-10-15 13:54:45; revision: 3; modified: 2016-03-31 13:54:45; importance: 4/5; urgency: 2/5; progress: 20%; -->\n";
+        md += "Outline description with a few words to be parsed.\n";
+        for(int n=0; n<5; n++) {
+            md += "\n## Note " + std::to_string(n) + " <!-- Metadata: type: Idea; tags: n" + std::to_string(n) + "; created: 2016-03-31 13:54:45; reads: 7; read: 2016-03-31 13:54:45; revision: 3; modified: 2016-03-31 13:54:45; -->\n";
+            for(int l=0; l<8; l++) {
+                md += "Note description line which is long enough to resemble a real note paragraph.\n";
+            }
+        }
+        pathToContent[memoryPath + "outline-" + std::to_string(o) + ".md"] = md;
+    }
+    createEmptyRepository(repositoryPath, pathToContent);
+
+    MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    Configuration& config = Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-rsb-ws10k.md");
+    config.setActiveRepository(
+        config.addRepository(RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+    config.setLearnThreads(1);
+    // snapshot in cache outlives repository > cold start
+    remove(RepositorySnapshot::path(config.getCachePath(), config.getActiveRepository()->getDir()).c_str());
+    Mind mind(config);
+
+    for(const char* start:{"cold", "warm"}) {
+        auto begin = chrono::high_resolution_clock::now();
+        mind.learn();
+        auto end = chrono::high_resolution_clock::now();
+
+        EXPECT_EQ(OUTLINES, mind.remind().getOutlinesCount());
+        cout << endl << start << " start: " << OUTLINES << " Os learned in "
+             << chrono::duration_cast<chrono::milliseconds>(end-begin).count() << "ms ("
+             << mind.remind().getSnapshot().getRestoredCount() << " restored, "
+             << mind.remind().getSnapshot().getParsedCount() << " parsed)" << endl;
+        mind.amnesia();
+    }
+
+    config.setLearnThreads(Configuration::DEFAULT_LEARN_THREADS);
+}
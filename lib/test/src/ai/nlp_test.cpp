@@ -64,6 +64,45 @@ TEST(AiNlpTestCase, DISABLED_Stemmer)
     }
 }
 
+TEST(AiNlpTestCase, StemmerCache)
+{
+    m8r::Stemmer::clearCache();
+    m8r::Stemmer stemmer{};
+    m8r::Stemmer uncached{};
+    uncached.setCached(false);
+    ASSERT_TRUE(stemmer.isCached());
+
+    // ASCII fast path
+    EXPECT_EQ("run", uncached.stem("running"));
+    EXPECT_EQ("inform", uncached.stem("informational"));
+    EXPECT_EQ("poni", uncached.stem("ponies"));
+    EXPECT_EQ(0, m8r::Stemmer::getCacheSize());
+
+    // cache miss, then hit
+    string w{"generalizations"};
+    stemmer.stemInPlace(w);
+    EXPECT_EQ("general", w);
+    EXPECT_EQ(1, m8r::Stemmer::getCacheSize());
+    w = "generalizations";
+    stemmer.stemInPlace(w);
+    EXPECT_EQ("general", w);
+    EXPECT_EQ(1, m8r::Stemmer::getCacheSize());
+
+    // cache is shared by stemmers
+    m8r::Stemmer another{};
+    EXPECT_EQ("general", another.stem("generalizations"));
+    EXPECT_EQ(1, m8r::Stemmer::getCacheSize());
+
+    // non-ASCII words go through UTF-8 conversion
+    EXPECT_EQ("naïv", stemmer.stem("naïvely"));
+    EXPECT_EQ(uncached.stem("naïvely"), stemmer.stem("naïvely"));
+    // invalid UTF-8 is kept as is
+    EXPECT_EQ("ab\xFF" "c", stemmer.stem("ab\xFF" "c"));
+
+    m8r::Stemmer::clearCache();
+    EXPECT_EQ(0, m8r::Stemmer::getCacheSize());
+}
+
 TEST(AiNlpTestCase, Lexicon)
 {
     m8r::Lexicon lexicon{};
@@ -142,14 +181,15 @@ TEST(AiNlpTestCase, DISABLED_BowOutline)
     wordBlaclist.addWord("text");
     m8r::MarkdownTokenizer tokenizer{lexicon, wordBlaclist};
     m8r::StringCharProvider chars{markdown};
-    m8r::WordFrequencyList* wfl = new m8r::WordFrequencyList{&lexicon};
+    m8r::WordFrequencyList wfl{&lexicon};
     cout << "Tokenizing MD string to word frequency list..." << endl;
-    tokenizer.tokenize(chars, *wfl);
-    wfl->sort();
+    tokenizer.tokenize(chars, wfl);
+    lexicon.recalculateWeights();
+    wfl.sort();
 
     // assert wfl
-    wfl->print();
-    ASSERT_EQ(19, wfl->size());
+    wfl.print();
+    ASSERT_EQ(19, wfl.size());
     // assert lexicon
     lexicon.print();
     ASSERT_EQ(19, lexicon.size());
@@ -160,9 +200,11 @@ TEST(AiNlpTestCase, DISABLED_BowOutline)
 
     m8r::BagOfWords bow{};
     bow.add(&o, wfl);
+    bow.reweight(lexicon);
 
-    bow.print();
+    bow.print(lexicon);
     ASSERT_EQ(1, bow.size());
+    ASSERT_EQ(19+10, bow.getWordsCount());
 }
 
 /*
@@ -297,6 +339,215 @@ TEST(AiNlpTestCase, DISABLED_AaUniverseBow)
     ASSERT_EQ("Alternative Universe", (*leaderboard)[1].first->getOutline()->getName());
 }
 
+TEST(AiNlpTestCase, AaTopKMatrix)
+{
+    typedef m8r::AssociationAssessmentTopKMatrix::Cell Cell;
+
+    m8r::AssociationAssessmentTopKMatrix aa{3};
+    aa.resize(2);
+    ASSERT_FALSE(aa.isCalculated(0));
+
+    // K best cells are kept, best first
+    vector<Cell> candidates{{1,.1f},{2,.5f},{3,.3f},{4,.9f},{5,.2f}};
+    aa.setRow(0, candidates);
+    vector<Cell> row{};
+    ASSERT_TRUE(aa.getRow(0, row));
+    ASSERT_EQ(3, row.size());
+    EXPECT_EQ(4, row[0].first);
+    EXPECT_EQ(2, row[1].first);
+    EXPECT_EQ(3, row[2].first);
+    EXPECT_EQ(3, aa.getCellsCount());
+
+    // new column enters top K
+    aa.update(0, 6, .4f);
+    row.clear();
+    aa.getRow(0, row);
+    EXPECT_EQ(6, row[2].first);
+    // column improves within top K
+    aa.update(0, 6, .95f);
+    row.clear();
+    aa.getRow(0, row);
+    EXPECT_EQ(6, row[0].first);
+    // column sinks below K-th > K-th best is unknown > invalidated
+    aa.update(0, 6, .0f);
+    EXPECT_FALSE(aa.isCalculated(0));
+
+    // row w/ less than K cells has all columns
+    candidates = {{0,.5f},{2,.7f}};
+    aa.setRow(1, candidates);
+    aa.forget(2);
+    row.clear();
+    ASSERT_TRUE(aa.getRow(1, row));
+    ASSERT_EQ(1, row.size());
+    EXPECT_EQ(0, row[0].first);
+
+    // full row which had forgotten column is invalidated
+    candidates = {{1,.1f},{2,.5f},{3,.3f},{4,.9f}};
+    aa.setRow(0, candidates);
+    aa.forget(3);
+    EXPECT_FALSE(aa.isCalculated(0));
+    aa.setRow(0, candidates);
+    aa.forget(1);
+    EXPECT_TRUE(aa.isCalculated(0));
+}
+
+TEST(AiNlpTestCase, BagOfWordsVectors)
+{
+    m8r::Lexicon lexicon{};
+    m8r::Outline o1{nullptr}, o2{nullptr};
+    m8r::BagOfWords bow{2};
+
+    // words w/ higher frequency have lower weight
+    m8r::WordFrequencyList wfl1{&lexicon};
+    for(const char* w:{"common", "common", "common", "rare", "unique"}) {
+        ++wfl1[lexicon.add(w)];
+    }
+    m8r::WordFrequencyList wfl2{&lexicon};
+    for(const char* w:{"common", "rare", "other"}) {
+        ++wfl2[lexicon.add(w)];
+    }
+    lexicon.recalculateWeights();
+    bow.add(&o1, wfl1);
+    bow.add(&o2, wfl2);
+    bow.reweight(lexicon);
+    ASSERT_EQ(2, bow.size());
+    ASSERT_EQ(3+2+3+2, bow.getWordsCount());
+
+    // all words sorted by ID, relevant words sorted by ID
+    m8r::BagOfWords::Vector v1;
+    ASSERT_TRUE(bow.get(&o1, v1));
+    ASSERT_EQ(3, v1.size);
+    EXPECT_EQ(lexicon.getId("common"), v1.ids[0]);
+    EXPECT_EQ(3, v1.frequencies[0]);
+    ASSERT_EQ(2, v1.relevantSize);
+    EXPECT_EQ(lexicon.getId("rare"), v1.relevantIds[0]);
+    EXPECT_EQ(lexicon.getId("unique"), v1.relevantIds[1]);
+    EXPECT_FLOAT_EQ(lexicon.getWeight(v1.relevantIds[0])+lexicon.getWeight(v1.relevantIds[1]), v1.relevantWeight);
+
+    // vectors can be replaced and removed
+    ASSERT_FALSE(bow.get(nullptr, v1));
+    bow.add(&o1, wfl2);
+    ASSERT_EQ(2, bow.size());
+    ASSERT_EQ(3+2+3+2, bow.getWordsCount());
+    bow.remove(&o1);
+    ASSERT_EQ(1, bow.size());
+    ASSERT_FALSE(bow.get(&o1, v1));
+    m8r::BagOfWords::Vector v2;
+    ASSERT_TRUE(bow.get(&o2, v2));
+    ASSERT_EQ(3, v2.size);
+
+    // intersection of sorted word ID arrays
+    uint32_t ids1[] = {1, 3, 5, 7};
+    float weights1[] = {.1f, .3f, .5f, .7f};
+    uint32_t ids2[] = {0, 3, 4, 7, 9};
+    EXPECT_FLOAT_EQ(1.f, m8r::BagOfWords::weightOfIntersection(ids1, weights1, 4, ids2, 5));
+    EXPECT_FLOAT_EQ(0.f, m8r::BagOfWords::weightOfIntersection(ids1, weights1, 4, ids2, 0));
+}
+
+TEST(AiNlpTestCase, AaBowIncremental)
+{
+    string repositoryPath{"/lib/test/resources/aa-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-abi.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)), repositoryConfigRepresentation);
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    m8r::Outline* u = mind.remind().getOutlines()[0]->getName()=="Universe"
+        ? mind.remind().getOutlines()[0]
+        : mind.remind().getOutlines()[1];
+    ASSERT_EQ("Universe", u->getName());
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+
+    // AI is not called through Mind to avoid Os to be written to repository
+    m8r::AiAaBoW aa{mind.remind(), mind};
+    ASSERT_TRUE(aa.dream().get());
+    EXPECT_GE(notes.size()*10, aa.getAaCellsCount());
+
+    auto leaderboard = [](m8r::AiAaBoW& a, const m8r::Note* n, vector<pair<m8r::Note*,float>>& lb) {
+        lb.clear();
+        a.getAssociatedNotes(n, lb).get(); // calculated and cached
+        lb.clear();
+        a.getAssociatedNotes(n, lb).get(); // copied from cache
+    };
+
+    m8r::Note* n = u->getNoteByName("Albert Einstein");
+    ASSERT_NE(nullptr, n);
+    vector<pair<m8r::Note*,float>> lb{};
+    leaderboard(aa, n, lb);
+    m8r::Ai::print(n, lb);
+    ASSERT_EQ(std::min<size_t>(10, notes.size()-1), lb.size());
+    for(size_t i=1; i<lb.size(); i++) {
+        EXPECT_GE(lb[i-1].second, lb[i].second);
+    }
+
+    // incrementally updated leaderboard must be the same as the one from full rebuild
+    auto expectSameAsRebuild = [&](const vector<pair<m8r::Note*,float>>& incremental) {
+        m8r::AiAaBoW fresh{mind.remind(), mind};
+        ASSERT_TRUE(fresh.dream().get());
+        vector<pair<m8r::Note*,float>> freshLb{};
+        leaderboard(fresh, n, freshLb);
+        ASSERT_EQ(freshLb.size(), incremental.size());
+        for(size_t i=0; i<freshLb.size(); i++) {
+            EXPECT_EQ(freshLb[i].first, incremental[i].first);
+            // rows of other Ns are not recalculated when word weights change
+            EXPECT_NEAR(freshLb[i].second, incremental[i].second, 0.001);
+        }
+    };
+
+    // rename N > its ranking must be updated w/o learning memory again
+    m8r::Note* m = u->getNoteByName("Stars");
+    ASSERT_NE(nullptr, m);
+    float before = -1;
+    for(auto& a:lb) {
+        if(a.first == m) before = a.second;
+    }
+    m->setName(n->getName());
+    m->setModified(m->getModified()+1);
+    ASSERT_TRUE(aa.remember(u));
+    leaderboard(aa, n, lb);
+    m8r::Ai::print(n, lb);
+    float after = -1;
+    for(auto& a:lb) {
+        if(a.first == m) after = a.second;
+    }
+    EXPECT_LT(before, after);
+    expectSameAsRebuild(lb);
+
+    // forget N (and its child) > it must disappear from leaderboards
+    u->forgetNote(m);
+    ASSERT_TRUE(aa.remember(u));
+    notes.clear();
+    mind.remind().getAllNotes(notes);
+    leaderboard(aa, n, lb);
+    m8r::Ai::print(n, lb);
+    ASSERT_EQ(std::min<size_t>(10, notes.size()-1), lb.size());
+    for(auto& a:lb) {
+        EXPECT_NE(m, a.first);
+    }
+    expectSameAsRebuild(lb);
+
+    // remember O while memory is learned asynchronously > O is remembered once memory is learned
+    unsigned int asyncMindThreshold = config.getAsyncMindThreshold();
+    config.setAsyncMindThreshold(0);
+    m = u->getNotes()[0] == n ? u->getNotes()[1] : u->getNotes()[0];
+    m->setName(n->getName());
+    m->setModified(m->getModified()+1);
+    shared_future<bool> dreaming = aa.dream();
+    ASSERT_TRUE(aa.remember(u));
+    ASSERT_TRUE(dreaming.get());
+    leaderboard(aa, n, lb);
+    m8r::Ai::print(n, lb);
+    ASSERT_FALSE(lb.empty());
+    expectSameAsRebuild(lb);
+    config.setAsyncMindThreshold(asyncMindThreshold);
+}
+
 /*
  * AA: FTS
  */
@@ -0,0 +1,106 @@
+/*
+ aho_corasick_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "gear/aho_corasick.h"
+
+using namespace std;
+
+static const string DELIMITERS{" \t,:;.!?<>{}&()-+/*\\_=%~#$^[]'\""};
+
+static vector<string> findWholeWords(const m8r::AhoCorasick& automaton, const string& text)
+{
+    vector<m8r::AhoCorasick::Match> matches{};
+    automaton.findWholeWords(text, DELIMITERS, matches);
+    vector<string> words{};
+    for(auto& m:matches) {
+        words.push_back(text.substr(m.begin, m.length));
+    }
+    return words;
+}
+
+TEST(AhoCorasickTestCase, FindWholeWords)
+{
+    // GIVEN
+    m8r::AhoCorasick automaton{};
+    for(const char* w:{"he", "she", "his", "hers", "Machine Learning", "Machine", "Learning", "ML", "a"}) {
+        automaton.addWord(w);
+    }
+    ASSERT_TRUE(automaton.isDirty());
+    automaton.compile();
+    ASSERT_FALSE(automaton.isDirty());
+    ASSERT_EQ(9, automaton.size());
+
+    // THEN whole words only (suffixes found via failure links)
+    EXPECT_EQ(vector<string>({"she", "he", "hers"}), findWholeWords(automaton, "she ushers he, (hers)"));
+    EXPECT_EQ(vector<string>{}, findWholeWords(automaton, "shell ushers sherlock"));
+    // longest match wins and matches don't overlap
+    EXPECT_EQ(
+        vector<string>({"Machine Learning", "ML", "a", "Machine", "Learning"}),
+        findWholeWords(automaton, "Machine Learning (ML) is a Machine... Learning!"));
+    EXPECT_EQ(vector<string>({"a"}), findWholeWords(automaton, "is a"));
+    EXPECT_EQ(vector<string>({"a"}), findWholeWords(automaton, "a"));
+    EXPECT_EQ(vector<string>{}, findWholeWords(automaton, ""));
+
+    // match offsets
+    vector<m8r::AhoCorasick::Match> matches{};
+    automaton.findWholeWords("  his.", DELIMITERS, matches);
+    ASSERT_EQ(1, matches.size());
+    EXPECT_EQ(2, matches[0].begin);
+    EXPECT_EQ(3, matches[0].length);
+}
+
+TEST(AhoCorasickTestCase, AddAndRemove)
+{
+    m8r::AhoCorasick automaton{};
+    automaton.addWord("twice");
+    automaton.addWord("twice");
+    automaton.addWord("once");
+    automaton.addWord("");
+    automaton.compile();
+    ASSERT_EQ(2, automaton.size());
+    ASSERT_EQ(1+5+4, automaton.getNodesCount());
+    EXPECT_EQ(vector<string>({"once", "twice"}), findWholeWords(automaton, "once twice"));
+
+    // remove word w/ refcount 1
+    ASSERT_TRUE(automaton.removeWord("once"));
+    ASSERT_FALSE(automaton.removeWord("once"));
+    automaton.compile();
+    EXPECT_EQ(vector<string>({"twice"}), findWholeWords(automaton, "once twice"));
+
+    // remove word w/ refcount 2
+    ASSERT_TRUE(automaton.removeWord("twice", true));
+    ASSERT_FALSE(automaton.isDirty());
+    EXPECT_EQ(vector<string>({"twice"}), findWholeWords(automaton, "once twice"));
+    ASSERT_TRUE(automaton.removeWord("twice", true));
+    ASSERT_TRUE(automaton.isDirty());
+    automaton.compile();
+    ASSERT_TRUE(automaton.empty());
+    EXPECT_EQ(vector<string>{}, findWholeWords(automaton, "once twice"));
+
+    automaton.addWord("again");
+    automaton.clear();
+    ASSERT_TRUE(automaton.empty());
+    ASSERT_FALSE(automaton.isDirty());
+}
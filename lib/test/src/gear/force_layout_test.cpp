@@ -0,0 +1,102 @@
+/*
+ force_layout_test.cpp     MindForger force-directed layout test
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gear/force_layout.h"
+
+using namespace std;
+
+TEST(ForceLayoutTestCase, BarnesHutApproximatesExactForces)
+{
+    // GIVEN layouts w/ the same random bodies and edges
+    m8r::ForceDirectedLayout barnesHut{};
+    m8r::ForceDirectedLayout exact{0};
+    mt19937 random{2018};
+    uniform_real_distribution<double> position{-500.0, 500.0};
+    const size_t BODIES = 1000;
+    for(size_t b=0; b<BODIES; b++) {
+        double x = position(random), y = position(random);
+        barnesHut.addBody(x, y);
+        exact.addBody(x, y);
+        if(b) {
+            size_t other = random() % b;
+            barnesHut.addEdge(b, other);
+            exact.addEdge(b, other);
+        }
+    }
+    // coincident bodies
+    barnesHut.addBody(0, 0);
+    barnesHut.addBody(0, 0);
+    exact.addBody(0, 0);
+    exact.addBody(0, 0);
+
+    vector<double> x{}, y{};
+    for(size_t b=0; b<exact.getBodiesCount(); b++) {
+        x.push_back(exact.getX(b));
+        y.push_back(exact.getY(b));
+    }
+
+    // WHEN
+    EXPECT_TRUE(barnesHut.step());
+    EXPECT_TRUE(exact.step());
+
+    // THEN bodies are moved by (almost) the same vectors
+    size_t imprecise = 0;
+    for(size_t b=0; b<exact.getBodiesCount(); b++) {
+        double error = hypot(barnesHut.getX(b) - exact.getX(b), barnesHut.getY(b) - exact.getY(b));
+        double move = hypot(exact.getX(b) - x[b], exact.getY(b) - y[b]);
+        if(error > 0.05*move) {
+            imprecise++;
+        }
+    }
+    EXPECT_LT(imprecise, exact.getBodiesCount()/100);
+}
+
+TEST(ForceLayoutTestCase, ConvergenceBoundsAndPinning)
+{
+    // GIVEN star w/ pinned center
+    m8r::ForceDirectedLayout layout{};
+    layout.setBounds(-200, -200, 200, 200);
+    size_t center = layout.addBody(0, 0);
+    layout.setPinned(center, true);
+    for(int b=0; b<20; b++) {
+        layout.addEdge(center, layout.addBody(b*3.0-30.0, b%5-2.0));
+    }
+
+    // WHEN layout is stepped until nothing moves
+    int steps = 0;
+    while(layout.step() && steps < 10000) {
+        steps++;
+    }
+
+    // THEN layout converged, center is pinned and bodies are in bounds
+    EXPECT_LT(steps, 10000);
+    EXPECT_EQ(0, layout.getX(center));
+    EXPECT_EQ(0, layout.getY(center));
+    for(size_t b=1; b<layout.getBodiesCount(); b++) {
+        EXPECT_LE(fabs(layout.getX(b)), 200.0);
+        EXPECT_LE(fabs(layout.getY(b)), 200.0);
+        EXPECT_GT(hypot(layout.getX(b), layout.getY(b)), 10.0);
+    }
+}
@@ -0,0 +1,172 @@
+/*
+ task_scheduler_test.cpp     MindForger task scheduler test
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gear/task_scheduler.h"
+
+using namespace std;
+
+TEST(TaskSchedulerTestCase, BoundedThreadsAndResults)
+{
+    // GIVEN
+    m8r::TaskScheduler scheduler{2};
+    atomic<int> sum{0};
+
+    // WHEN
+    vector<shared_future<int>> futures{};
+    for(int i=1; i<=100; i++) {
+        futures.push_back(scheduler.submit<int>([i, &sum](const m8r::TaskScheduler::Token&) {
+            sum += i;
+            return i*i;
+        }));
+    }
+
+    // THEN
+    int squares = 0;
+    for(shared_future<int>& f:futures) {
+        squares += f.get();
+    }
+    EXPECT_EQ(5050, sum.load());
+    EXPECT_EQ(338350, squares);
+    EXPECT_GE(2u, scheduler.getThreadsCount());
+    EXPECT_LE(1u, scheduler.getThreadsCount());
+}
+
+TEST(TaskSchedulerTestCase, PrioritiesAndSupersede)
+{
+    // GIVEN scheduler w/ a single worker blocked by a task
+    m8r::TaskScheduler scheduler{1};
+    promise<void> gate{};
+    shared_future<void> opened = gate.get_future().share();
+    shared_future<bool> blocker = scheduler.submit<bool>([opened](const m8r::TaskScheduler::Token&) {
+        opened.wait();
+        return true;
+    });
+
+    mutex orderMutex{};
+    vector<string> order{};
+    auto task = [&](const string& name) {
+        return [&, name](const m8r::TaskScheduler::Token& token) {
+            lock_guard<mutex> criticalSection{orderMutex};
+            order.push_back(token.isCancelled() ? name+"-cancelled" : name);
+            return !token.isCancelled();
+        };
+    };
+    int leaderboard{};
+
+    // WHEN tasks are queued w/ different priorities and leaderboard requests supersede each other
+    shared_future<bool> prefetch = scheduler.submit<bool>(task("prefetch"), m8r::TaskScheduler::PREFETCH);
+    shared_future<bool> dream = scheduler.submit<bool>(task("dream"), m8r::TaskScheduler::BACKGROUND);
+    shared_future<bool> first = scheduler.submit<bool>(task("first"), m8r::TaskScheduler::INTERACTIVE, &leaderboard);
+    shared_future<bool> second = scheduler.submit<bool>(task("second"), m8r::TaskScheduler::INTERACTIVE, &leaderboard);
+    gate.set_value();
+
+    // THEN
+    EXPECT_TRUE(blocker.get());
+    EXPECT_FALSE(first.get());
+    EXPECT_TRUE(second.get());
+    EXPECT_TRUE(dream.get());
+    EXPECT_TRUE(prefetch.get());
+    EXPECT_EQ((vector<string>{"first-cancelled", "second", "dream", "prefetch"}), order);
+}
+
+TEST(TaskSchedulerTestCase, NestedTasksAndShutdown)
+{
+    // GIVEN
+    m8r::TaskScheduler scheduler{2};
+
+    // WHEN task submits subtasks to its own worker and waits for them (other worker steals them)
+    shared_future<int> parent = scheduler.submit<int>([&scheduler](const m8r::TaskScheduler::Token&) {
+        vector<shared_future<int>> children{};
+        for(int i=0; i<10; i++) {
+            children.push_back(scheduler.submit<int>([i](const m8r::TaskScheduler::Token&) { return i; }));
+        }
+        int sum = 0;
+        for(shared_future<int>& c:children) {
+            sum += c.get();
+        }
+        return sum;
+    });
+
+    // THEN
+    EXPECT_EQ(45, parent.get());
+
+    // WHEN scheduler is shut down
+    scheduler.shutdown();
+    shared_future<bool> late = scheduler.submit<bool>([](const m8r::TaskScheduler::Token& token) {
+        return token.isCancelled();
+    });
+
+    // THEN task is run synchronously as cancelled
+    ASSERT_EQ(future_status::ready, late.wait_for(chrono::seconds(0)));
+    EXPECT_TRUE(late.get());
+    EXPECT_EQ(0u, scheduler.getPendingCount());
+}
+
+TEST(TaskSchedulerTestCase, ParallelLoopHelpedByWorkers)
+{
+    // GIVEN
+    m8r::TaskScheduler scheduler{2};
+    atomic<int> next{0};
+    atomic<int> sum{0};
+    auto loop = [&]() {
+        int i;
+        while((i = next++) < 1000) {
+            sum += i;
+        }
+    };
+
+    // WHEN loop is run by the calling thread w/ the help of workers
+    scheduler.parallel(2, loop, loop);
+
+    // THEN
+    EXPECT_EQ(499500, sum.load());
+
+    // GIVEN the other worker is blocked
+    promise<void> gate{};
+    shared_future<void> opened = gate.get_future().share();
+    shared_future<bool> blocker = scheduler.submit<bool>([opened](const m8r::TaskScheduler::Token&) {
+        opened.wait();
+        return true;
+    });
+
+    // WHEN loop is run from a task
+    next = 0;
+    sum = 0;
+    shared_future<int> parent = scheduler.submit<int>([&](const m8r::TaskScheduler::Token&) {
+        scheduler.parallel(2, loop, loop);
+        return sum.load();
+    });
+
+    // THEN it's finished by the task's worker w/o waiting for the blocked worker
+    ASSERT_EQ(future_status::ready, parent.wait_for(chrono::seconds(10)));
+    EXPECT_EQ(499500, parent.get());
+    gate.set_value();
+    EXPECT_TRUE(blocker.get());
+    scheduler.shutdown();
+    EXPECT_EQ(0u, scheduler.getPendingCount());
+}
@@ -102,3 +102,47 @@ TEST(TrieTestCase, AddAndRemove)
     ASSERT_FALSE(trie.findWord(word));
     ASSERT_EQ(13, count);
 }
+
+TEST(TrieTestCase, Freeze)
+{
+    m8r::Trie trie{};
+    for(const char* w:{"you", "yours", "young", "he", "zebra", "Zulu"}) {
+        trie.addWord(w);
+    }
+    trie.removeWord("zebra");
+    ASSERT_EQ(1+3+2+2+2+5+4, trie.getNodesCount());
+
+    // nodes of removed words are dropped
+    trie.freeze();
+    ASSERT_TRUE(trie.isFrozen());
+    ASSERT_EQ(1+3+2+2+2+4, trie.getNodesCount());
+    ASSERT_EQ(14, trie.print());
+
+    EXPECT_TRUE(trie.findWord("yours"));
+    EXPECT_TRUE(trie.findWord("Zulu"));
+    EXPECT_FALSE(trie.findWord("zebra"));
+    EXPECT_FALSE(trie.findWord("your"));
+    string r{};
+    EXPECT_TRUE(trie.findLongestPrefixWord("youth", r));
+    EXPECT_EQ("you", r);
+    r.clear();
+    EXPECT_TRUE(trie.findLongestPrefixWord("yours truly", r));
+    EXPECT_EQ("yours", r);
+    r.clear();
+    EXPECT_FALSE(trie.findLongestPrefixWord("hi", r));
+
+    // refcounts are kept
+    trie.addWord("he");
+    ASSERT_TRUE(trie.isFrozen());
+    trie.removeWord("he", true);
+    EXPECT_TRUE(trie.findWord("he"));
+
+    // new nodes thaw the trie
+    trie.addWord("hello");
+    ASSERT_FALSE(trie.isFrozen());
+    EXPECT_TRUE(trie.findWord("hello"));
+    EXPECT_TRUE(trie.findWord("young"));
+    trie.freeze();
+    EXPECT_TRUE(trie.findWord("hello"));
+    EXPECT_TRUE(trie.findWord("he"));
+}
@@ -161,3 +161,268 @@ TEST(HtmlTestCase, TaskList)
     cout << "= BEGIN N HTML =" << endl << html << endl << "= END N HTML =" << endl;
     EXPECT_NE(std::string::npos, html.find("input"));
 }
+
+TEST(HtmlTestCase, HtmlCache)
+{
+    // LRU: entries and bytes limits
+    m8r::HtmlCache cache{2, 10};
+    string html{};
+    cache.put("a", "o1", "AAA");
+    cache.put("b", "o1", "BBB");
+    EXPECT_TRUE(cache.get("a", html));
+    EXPECT_EQ("AAA", html);
+    // b is the least recently used
+    cache.put("c", "o2", "CCC");
+    EXPECT_EQ(2, cache.size());
+    EXPECT_FALSE(cache.get("b", html));
+    EXPECT_TRUE(cache.get("c", html));
+    EXPECT_EQ("AAACCC", html);
+    // bytes limit evicts both a and c
+    cache.put("d", "o2", "DDDDDDDD");
+    EXPECT_EQ(1, cache.size());
+    EXPECT_EQ(8, cache.getBytes());
+    // HTML bigger than cache is not cached
+    cache.put("e", "o2", "EEEEEEEEEEE");
+    EXPECT_FALSE(cache.get("e", html));
+    EXPECT_EQ(1, cache.size());
+    // eviction of O entries
+    cache.forget("o2");
+    EXPECT_EQ(0, cache.size());
+    EXPECT_EQ(0, cache.getBytes());
+
+    // Ns HTML
+    string fileName{"/lib/test/resources/basic-repository/memory/outline.md"};
+    fileName.insert(0, getMindforgerGitHomePath());
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-htc-hc.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(fileName)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind(config);
+    m8r::HtmlColorsMock dummyColors{};
+    m8r::HtmlOutlineRepresentation htmlRepresentation{mind.remind().getOntology(),dummyColors,nullptr};
+    mind.learn();
+    mind.think().get();
+
+    ASSERT_GE(mind.remind().getOutlinesCount(), 1);
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+    ASSERT_GE(o->getNotesCount(), 2);
+    m8r::Note* n = o->getNotes()[0];
+    m8r::HtmlCache& htmlCache = htmlRepresentation.getHtmlCache();
+
+    string uncached{};
+    htmlRepresentation.to(n, &uncached);
+    EXPECT_EQ(0, htmlCache.size());
+
+    // miss and hit render the same HTML as uncached rendering
+    string cached{};
+    htmlRepresentation.to(n, &cached, false, 0, true);
+    EXPECT_EQ(1, htmlCache.size());
+    EXPECT_EQ(0, htmlCache.getHits());
+    EXPECT_EQ(uncached, cached);
+    htmlRepresentation.to(n, &cached, false, 0, true);
+    EXPECT_EQ(1, htmlCache.getHits());
+    EXPECT_EQ(uncached, cached);
+    // scroll is injected to the header > body is still cached
+    htmlRepresentation.to(n, &cached, false, 50, true);
+    EXPECT_EQ(2, htmlCache.getHits());
+    EXPECT_NE(uncached, cached);
+
+    // another N
+    htmlRepresentation.to(o->getNotes()[1], &cached, false, 0, true);
+    EXPECT_EQ(2, htmlCache.size());
+    EXPECT_EQ(2, htmlCache.getHits());
+
+    // modified N has different key > it is re-rendered
+    vector<string*> description{};
+    description.push_back(new string{"Cache MUST NOT serve this."});
+    n->setDescription(description);
+    n->makeModified();
+    htmlRepresentation.to(n, &cached, false, 0, true);
+    EXPECT_EQ(2, htmlCache.getHits());
+    EXPECT_NE(std::string::npos, cached.find("Cache MUST NOT serve this."));
+
+    // O header
+    htmlRepresentation.to(o, &uncached, false, false, false, true);
+    htmlRepresentation.to(o, &cached, false, false, false, true, 0, true);
+    EXPECT_EQ(uncached, cached);
+    htmlRepresentation.to(o, &cached, false, false, false, true, 0, true);
+    EXPECT_EQ(3, htmlCache.getHits());
+    EXPECT_EQ(uncached, cached);
+
+    // O eviction
+    htmlCache.forget(o->getKey());
+    EXPECT_EQ(0, htmlCache.size());
+
+    // structural change w/o revision bump (N refactoring) is not served from cache once
+    // Memory reindexes O (test resources must not be written by remember())
+    m8r::HtmlOutlineRepresentation* mindHtmlRepresentation = mind.getHtmlRepresentation();
+    // link definition is document global > whole O is rendered (and cached) in a single pass
+    description.clear();
+    description.push_back(new string{"See [MindForger][mf]."});
+    description.push_back(new string{""});
+    description.push_back(new string{"[mf]: https://www.mindforger.com"});
+    n->setDescription(description);
+    mindHtmlRepresentation->to(o, &cached, false, false, true, true, 0, true);
+    EXPECT_LT(0, mindHtmlRepresentation->getHtmlCache().size());
+    const string removedName{o->getNotes()[1]->getName()};
+    EXPECT_NE(std::string::npos, cached.find(removedName));
+    u_int32_t revision = o->getRevision();
+    o->removeNote(o->getNotes()[1]);
+    EXPECT_EQ(revision, o->getRevision());
+    mind.remind().reindex(o);
+    mindHtmlRepresentation->to(o, &uncached, false, false, true, true);
+    mindHtmlRepresentation->to(o, &cached, false, false, true, true, 0, true);
+    EXPECT_EQ(uncached, cached);
+}
+
+TEST(HtmlTestCase, OutlineFragments)
+{
+    string fileName{"/lib/test/resources/benchmark-repository/memory/meta.md"};
+    fileName.insert(0, getMindforgerGitHomePath());
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-htc-of.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(fileName)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind(config);
+    m8r::HtmlColorsMock dummyColors{};
+    m8r::HtmlOutlineRepresentation htmlRepresentation{mind.remind().getOntology(),dummyColors,nullptr};
+    mind.learn();
+    mind.think().get();
+
+    ASSERT_GE(mind.remind().getOutlinesCount(), 1);
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+    ASSERT_GE(o->getNotesCount(), 10);
+    m8r::HtmlCache& htmlCache = htmlRepresentation.getHtmlCache();
+
+    // fragments are disabled by default > whole O is rendered in a single pass
+    string uncached{};
+    htmlRepresentation.to(o, &uncached, false, false, true, true);
+    string cached{};
+    htmlRepresentation.to(o, &cached, false, false, true, true, 0, true);
+    EXPECT_EQ(uncached, cached);
+    EXPECT_EQ(1, htmlCache.size());
+    htmlCache.forget(o->getKey());
+
+    // whole O assembled from fragments is byte-identical to single pass rendering
+    config.setUiHtmlFragments(true);
+    htmlRepresentation.to(o, &cached, false, false, true, true, 0, true);
+    EXPECT_EQ(uncached, cached);
+    // O header and N fragments
+    EXPECT_EQ(o->getNotesCount()+1, htmlCache.size());
+
+    unsigned long misses = htmlCache.getMisses();
+    htmlRepresentation.to(o, &cached, false, false, true, true, 0, true);
+    EXPECT_EQ(uncached, cached);
+    // whole O is not cached as it is assembled from fragments
+    EXPECT_EQ(misses+1, htmlCache.getMisses());
+
+    // modified N > O header (O revision changed) and N fragments are transcoded
+    m8r::Note* n = o->getNotes()[o->getNotesCount()/2];
+    vector<string*> description{};
+    description.push_back(new string{"Only *this* fragment is transcoded."});
+    n->setDescription(description);
+    n->makeModified();
+    misses = htmlCache.getMisses();
+    htmlRepresentation.to(o, &uncached, false, false, true, true);
+    htmlRepresentation.to(o, &cached, false, false, true, true, 0, true);
+    EXPECT_EQ(uncached, cached);
+    EXPECT_EQ(misses+3, htmlCache.getMisses());
+    EXPECT_NE(std::string::npos, cached.find("Only *this* fragment is transcoded."));
+
+    // reference link definition is document global > single pass rendering
+    description.clear();
+    description.push_back(new string{"[mf]: https://www.mindforger.com"});
+    n->setDescription(description);
+    n->makeModified();
+    htmlRepresentation.to(o, &uncached, false, false, true, true);
+    htmlRepresentation.to(o, &cached, false, false, true, true, 0, true);
+    EXPECT_EQ(uncached, cached);
+    unsigned long hits = htmlCache.getHits();
+    misses = htmlCache.getMisses();
+    htmlRepresentation.to(o, &cached, false, false, true, true, 0, true);
+    EXPECT_EQ(uncached, cached);
+    EXPECT_EQ(hits+1, htmlCache.getHits());
+    EXPECT_EQ(misses, htmlCache.getMisses());
+
+    // unclosed fenced code continues in the next fragment
+    description.clear();
+    description.push_back(new string{"```"});
+    description.push_back(new string{"# not a section"});
+    n->setDescription(description);
+    n->makeModified();
+    htmlRepresentation.to(o, &uncached, false, false, true, true);
+    htmlRepresentation.to(o, &cached, false, false, true, true, 0, true);
+    EXPECT_EQ(uncached, cached);
+    hits = htmlCache.getHits();
+    htmlRepresentation.to(o, &cached, false, false, true, true, 0, true);
+    EXPECT_EQ(hits+1, htmlCache.getHits());
+
+    config.setUiHtmlFragments(m8r::Configuration::DEFAULT_UI_HTML_FRAGMENTS);
+}
+
+#ifdef MF_MD_2_HTML_CMARK
+TEST(HtmlTestCase, OutlineFragmentsCmark)
+{
+    // whole O HTML assembled from fragments MUST be byte-identical to cmark single pass rendering
+    const vector<string> repositories{
+        "autolinking-repository",
+        "basic-repository",
+        "benchmark-repository",
+        "bugs-repository",
+        "i18n-repository",
+        "links-repository",
+        "meta-repository",
+        "refactoring-repository",
+        "syntax-highlighting-repository",
+        "universe-repository"
+    };
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    for(const string& repository:repositories) {
+        string repositoryPath{"/lib/test/resources/"};
+        repositoryPath += repository;
+        repositoryPath.insert(0, getMindforgerGitHomePath());
+
+        config.clear();
+        config.setConfigFilePath("/tmp/cfg-htc-ofc.md");
+        // test resources must not be written
+        config.setRepositorySnapshot(false);
+        config.setActiveRepository(
+            config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+            repositoryConfigRepresentation
+        );
+        m8r::Mind mind(config);
+        m8r::HtmlColorsMock dummyColors{};
+        m8r::HtmlOutlineRepresentation htmlRepresentation{mind.remind().getOntology(),dummyColors,nullptr};
+        mind.learn();
+        ASSERT_LT(0, mind.remind().getOutlinesCount()) << repository;
+
+        for(m8r::Outline* o:mind.remind().getOutlines()) {
+            string singlePass{};
+            config.setUiHtmlFragments(false);
+            htmlRepresentation.to(o, &singlePass, false, false, true, true);
+
+            string fragments{};
+            config.setUiHtmlFragments(true);
+            htmlRepresentation.to(o, &fragments, false, false, true, true, 0, true);
+            EXPECT_EQ(singlePass, fragments) << o->getKey();
+            // assembled from cached fragments
+            htmlRepresentation.to(o, &fragments, false, false, true, true, 0, true);
+            EXPECT_EQ(singlePass, fragments) << o->getKey();
+        }
+    }
+
+    config.setUiHtmlFragments(m8r::Configuration::DEFAULT_UI_HTML_FRAGMENTS);
+}
+#endif // MF_MD_2_HTML_CMARK
@@ -17,6 +17,8 @@
  along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include <gtest/gtest.h>
 
 #include "../../../src/repository_indexer.h"
@@ -178,6 +180,8 @@ TEST(RepositoryIndexerTestCase, MindForgerRepository)
     delete outlineAsString;
 
     mind.remind().remember(outline);
+    // O is written behind
+    mind.remind().getPersistence().flush();
 
     outlineAsString = m8r::fileToString(outline->getKey());
     EXPECT_NE(std::string::npos, outlineAsString->find("Metadata"));
@@ -277,6 +281,8 @@ TEST(RepositoryIndexerTestCase, MarkdownRepository)
 
     outline->setName("Dirty");
     mind.remind().remember(outline);
+    // O is written behind
+    mind.remind().getPersistence().flush();
 
     outlineAsString = m8r::fileToString(outline->getKey());
     EXPECT_EQ(std::string::npos, outlineAsString->find("Metadata"));
@@ -359,6 +365,8 @@ TEST(RepositoryIndexerTestCase, MindForgerFile)
 
     outline->setName("Dirty");
     mind.remind().remember(outline);
+    // O is written behind
+    mind.remind().getPersistence().flush();
 
     outlineAsString = m8r::fileToString(outline->getKey());
     EXPECT_NE(std::string::npos, outlineAsString->find("Metadata"));
@@ -682,3 +690,78 @@ TEST(RepositoryIndexerTestCase, MakePathRelative)
 
     delete repository;
 }
+
+TEST(RepositoryIndexerTestCase, ParallelDirectoryWalk)
+{
+    EXPECT_TRUE(m8r::DirectoryWalker::matchPattern(".git", ".git"));
+    EXPECT_TRUE(m8r::DirectoryWalker::matchPattern("*.tmp", "draft.tmp"));
+    EXPECT_TRUE(m8r::DirectoryWalker::matchPattern("node_*", "node_modules"));
+    EXPECT_TRUE(m8r::DirectoryWalker::matchPattern("?.md", "a.md"));
+    EXPECT_FALSE(m8r::DirectoryWalker::matchPattern("*.tmp", "draft.md"));
+    EXPECT_FALSE(m8r::DirectoryWalker::matchPattern(".git", ".github"));
+
+    // wide (more directories than descriptors kept open) and deep tree
+    string repositoryPath{m8r::platformSpecificPath("/tmp/mf-unit-repository-walker")};
+    string memoryPath{repositoryPath + FILE_PATH_SEPARATOR + m8r::DIRNAME_MEMORY};
+    map<string,string> pathToContent;
+    pathToContent[memoryPath + FILE_PATH_SEPARATOR + "root.md"] = "# Root\n";
+    m8r::createEmptyRepository(repositoryPath, pathToContent);
+
+    vector<string> expected{memoryPath + FILE_PATH_SEPARATOR + "root.md"};
+    vector<string> ignored{};
+    for(unsigned d=0; d<m8r::DirectoryWalker::MAX_OPEN_DIRECTORIES+44; d++) {
+        string directory{memoryPath + FILE_PATH_SEPARATOR + "d" + std::to_string(d)};
+        if(d%10 == 0) {
+            directory += FILE_PATH_SEPARATOR;
+            directory += "deeper";
+            directory += FILE_PATH_SEPARATOR;
+            directory += "deepest";
+        }
+        m8r::createDirectories(directory);
+        m8r::stringToFile(directory + FILE_PATH_SEPARATOR + "o.md", "# O\n");
+        m8r::stringToFile(directory + FILE_PATH_SEPARATOR + "text.txt", "text");
+        expected.push_back(directory + FILE_PATH_SEPARATOR + "o.md");
+        expected.push_back(directory + FILE_PATH_SEPARATOR + "text.txt");
+    }
+    string git{memoryPath + FILE_PATH_SEPARATOR + ".git" + FILE_PATH_SEPARATOR + "objects"};
+    m8r::createDirectories(git);
+    m8r::stringToFile(git + FILE_PATH_SEPARATOR + "git.md", "# Git\n");
+    m8r::stringToFile(memoryPath + FILE_PATH_SEPARATOR + "draft.tmp", "draft");
+    ignored.push_back(git + FILE_PATH_SEPARATOR + "git.md");
+    ignored.push_back(memoryPath + FILE_PATH_SEPARATOR + "draft.tmp");
+
+    vector<string> all{expected};
+    all.insert(all.end(), ignored.begin(), ignored.end());
+    std::sort(all.begin(), all.end());
+    std::sort(expected.begin(), expected.end());
+
+    // deterministic sorted result regardless # of threads
+    for(unsigned threads:{1, 2, 8}) {
+        m8r::DirectoryWalker walker{threads};
+        vector<string> files{};
+        walker.walk(memoryPath, files);
+        EXPECT_EQ(all, files);
+
+        walker.setIgnorePatterns(vector<string>{".git", "*.tmp"});
+        files.clear();
+        walker.walk(memoryPath, files);
+        EXPECT_EQ(expected, files);
+    }
+
+    // indexer: the same file set as w/ sequential walk, ignored files are not (re)indexed
+    m8r::RepositoryIndexer repositoryIndexer{};
+    m8r::Repository* repository = m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath);
+    repositoryIndexer.getDirectoryWalker().setThreads(4);
+    repositoryIndexer.index(repository);
+    EXPECT_EQ(all.size(), repositoryIndexer.getAllOutlineFileNames().size());
+    EXPECT_EQ(m8r::DirectoryWalker::MAX_OPEN_DIRECTORIES+44+2, repositoryIndexer.getMarkdownFiles().size());
+
+    repositoryIndexer.getDirectoryWalker().setIgnorePatterns(vector<string>{".git", "*.tmp"});
+    repositoryIndexer.index(repository);
+    EXPECT_EQ(expected.size(), repositoryIndexer.getAllOutlineFileNames().size());
+    EXPECT_EQ(m8r::DirectoryWalker::MAX_OPEN_DIRECTORIES+44+1, repositoryIndexer.getMarkdownFiles().size());
+    EXPECT_FALSE(repositoryIndexer.addFile(git + FILE_PATH_SEPARATOR + "pack.md"));
+    EXPECT_TRUE(repositoryIndexer.addFile(memoryPath + FILE_PATH_SEPARATOR + "new.md"));
+
+    delete repository;
+}
@@ -21,6 +21,7 @@
 #include <iostream>
 #include <memory>
 #include <cstdio>
+#include <sys/stat.h>
 #ifndef _WIN32
 #  include <unistd.h>
 #endif
@@ -54,20 +55,20 @@ TEST(MarkdownParserTestCase, MarkdownLexerSections)
 
     // minimal MD
     lexer.tokenize();
-    const std::vector<MarkdownLexem*>& lexems = lexer.getLexems();
+    const std::vector<MarkdownLexem>& lexems = lexer.getLexems();
     printLexems(lexems);
 
     // asserts
-    EXPECT_EQ(MarkdownLexemType::BEGIN_DOC, lexems[0]->getType());
+    EXPECT_EQ(MarkdownLexemType::BEGIN_DOC, lexems[0].getType());
 
-    EXPECT_EQ(MarkdownLexemType::SECTION, lexems[1]->getType());
-    EXPECT_EQ(0, lexems[1]->getDepth());
+    EXPECT_EQ(MarkdownLexemType::SECTION, lexems[1].getType());
+    EXPECT_EQ(0, lexems[1].getDepth());
 
-    EXPECT_EQ(MarkdownLexemType::WHITESPACES, lexems[2]->getType());
-    EXPECT_EQ(MarkdownLexemType::TEXT, lexems[3]->getType());
-    EXPECT_EQ(0, lexems[3]->getOff());
-    EXPECT_EQ(2, lexems[3]->getIdx());
-    EXPECT_EQ(9, lexems[3]->getLng());
+    EXPECT_EQ(MarkdownLexemType::WHITESPACES, lexems[2].getType());
+    EXPECT_EQ(MarkdownLexemType::TEXT, lexems[3].getType());
+    EXPECT_EQ(0, lexems[3].getOff());
+    EXPECT_EQ(2, lexems[3].getIdx());
+    EXPECT_EQ(9, lexems[3].getLng());
 }
 
 TEST(MarkdownParserTestCase, MarkdownLexerSectionsNoMetadata)
@@ -82,6 +83,78 @@ TEST(MarkdownParserTestCase, MarkdownLexerSectionsNoMetadata)
     printLexems(lexer.getLexems());
 }
 
+TEST(MarkdownParserTestCase, MarkdownLexerSectionsInputModes)
+{
+    unique_ptr<string> fileName
+            = unique_ptr<string>(new string{"/lib/test/resources/basic-repository/memory/outline.md"});
+    fileName.get()->insert(0, getMindforgerGitHomePath());
+    MarkdownLexerSections mappedLexer(fileName.get(), MarkdownLexerInputMode::SINGLE_BUFFER);
+    MarkdownLexerSections copiesLexer(fileName.get(), MarkdownLexerInputMode::LINE_COPIES);
+
+    mappedLexer.tokenize();
+    copiesLexer.tokenize();
+
+    // asserts
+    EXPECT_LT(0, mappedLexer.getFileSize());
+    EXPECT_EQ(copiesLexer.getFileSize(), mappedLexer.getFileSize());
+    ASSERT_EQ(copiesLexer.getLines().size(), mappedLexer.getLines().size());
+    for(size_t i=0; i<mappedLexer.getLines().size(); i++) {
+        EXPECT_EQ(copiesLexer.getLines()[i].toString(), mappedLexer.getLines()[i].toString());
+    }
+    ASSERT_EQ(copiesLexer.size(), mappedLexer.size());
+    for(size_t i=0; i<mappedLexer.size(); i++) {
+        EXPECT_EQ(copiesLexer[i]->getType(), mappedLexer[i]->getType());
+        EXPECT_EQ(copiesLexer[i]->getOff(), mappedLexer[i]->getOff());
+        EXPECT_EQ(copiesLexer[i]->getIdx(), mappedLexer[i]->getIdx());
+        EXPECT_EQ(copiesLexer[i]->getLng(), mappedLexer[i]->getLng());
+
+        unique_ptr<string> mappedText{mappedLexer.getText(mappedLexer[i])};
+        unique_ptr<string> copiesText{copiesLexer.getText(copiesLexer[i])};
+        EXPECT_EQ(copiesText==nullptr, mappedText==nullptr);
+        if(mappedText && copiesText) {
+            EXPECT_EQ(*copiesText, *mappedText);
+        }
+    }
+
+    // text w/o trailing EOL
+    string content{"# Title\n\nDescription\nlast line"};
+    MarkdownLexerSections textLexer{};
+    textLexer.tokenize(&content);
+    ASSERT_EQ(4, textLexer.getLines().size());
+    EXPECT_EQ("# Title", textLexer.getLines()[0].toString());
+    EXPECT_TRUE(textLexer.getLines()[1].empty());
+    EXPECT_EQ("last line", textLexer.getLines()[3].toString());
+}
+
+TEST(MarkdownParserTestCase, MarkdownLexemArena)
+{
+    unique_ptr<string> fileName
+            = unique_ptr<string>(new string{"/lib/test/resources/basic-repository/memory/outline.md"});
+    fileName.get()->insert(0, getMindforgerGitHomePath());
+
+    size_t lexemsCount;
+    {
+        MarkdownLexerSections lexer(fileName.get());
+        lexer.tokenize();
+        lexemsCount = lexer.size();
+        ASSERT_LT(0, lexemsCount);
+
+        // nested lexer cannot lease thread's arena > it uses its own lexems
+        MarkdownLexerSections nestedLexer(fileName.get());
+        nestedLexer.tokenize();
+        EXPECT_EQ(lexemsCount, nestedLexer.size());
+        EXPECT_NE(lexer.getLexems().data(), nestedLexer.getLexems().data());
+    }
+
+    // arena is returned empty w/ capacity kept for the next file
+    MarkdownLexemArena* arena = MarkdownLexemArena::lease();
+    ASSERT_NE(nullptr, arena);
+    EXPECT_EQ(nullptr, MarkdownLexemArena::lease());
+    EXPECT_TRUE(arena->getLexems().empty());
+    EXPECT_LE(lexemsCount, arena->getLexems().capacity());
+    arena->release();
+}
+
 TEST(MarkdownParserTestCase, MarkdownLexerSectionsPreamble)
 {
     unique_ptr<string> fileName
@@ -91,16 +164,16 @@ TEST(MarkdownParserTestCase, MarkdownLexerSectionsPreamble)
 
     // tokenize
     lexer.tokenize();
-    const std::vector<MarkdownLexem*>& lexems = lexer.getLexems();
+    const std::vector<MarkdownLexem>& lexems = lexer.getLexems();
     printLexems(lexems);
 
     // asserts
-    EXPECT_EQ(MarkdownLexemType::BEGIN_DOC, lexems[0]->getType());
-    EXPECT_EQ(MarkdownLexemType::LINE, lexems[1]->getType());
-    EXPECT_EQ(MarkdownLexemType::BR, lexems[2]->getType());
-    EXPECT_EQ(MarkdownLexemType::BR, lexems[3]->getType());
-    EXPECT_EQ(MarkdownLexemType::SECTION, lexems[4]->getType());
-    EXPECT_EQ(0, lexems[4]->getDepth());
+    EXPECT_EQ(MarkdownLexemType::BEGIN_DOC, lexems[0].getType());
+    EXPECT_EQ(MarkdownLexemType::LINE, lexems[1].getType());
+    EXPECT_EQ(MarkdownLexemType::BR, lexems[2].getType());
+    EXPECT_EQ(MarkdownLexemType::BR, lexems[3].getType());
+    EXPECT_EQ(MarkdownLexemType::SECTION, lexems[4].getType());
+    EXPECT_EQ(0, lexems[4].getDepth());
 }
 
 TEST(MarkdownParserTestCase, MarkdownLexerSectionsPostDeclaredHeaders)
@@ -112,16 +185,16 @@ TEST(MarkdownParserTestCase, MarkdownLexerSectionsPostDeclaredHeaders)
 
     // tokenize
     lexer.tokenize();
-    const std::vector<MarkdownLexem*>& lexems = lexer.getLexems();
+    const std::vector<MarkdownLexem>& lexems = lexer.getLexems();
     printLexems(lexems);
 
     // asserts
-    EXPECT_EQ(MarkdownLexemType::BEGIN_DOC, lexems[0]->getType());
-    EXPECT_EQ(MarkdownLexemType::SECTION_equals, lexems[1]->getType());
-    EXPECT_EQ(MarkdownLexemType::LINE, lexems[2]->getType());
-    EXPECT_EQ(MarkdownLexemType::BR, lexems[3]->getType());
-    EXPECT_EQ(MarkdownLexemType::LINE, lexems[4]->getType());
-    EXPECT_EQ(MarkdownLexemType::BR, lexems[5]->getType());
+    EXPECT_EQ(MarkdownLexemType::BEGIN_DOC, lexems[0].getType());
+    EXPECT_EQ(MarkdownLexemType::SECTION_equals, lexems[1].getType());
+    EXPECT_EQ(MarkdownLexemType::LINE, lexems[2].getType());
+    EXPECT_EQ(MarkdownLexemType::BR, lexems[3].getType());
+    EXPECT_EQ(MarkdownLexemType::LINE, lexems[4].getType());
+    EXPECT_EQ(MarkdownLexemType::BR, lexems[5].getType());
 }
 
 TEST(MarkdownParserTestCase, MarkdownLexerSectionsPostDeclaredHeaders2)
@@ -149,17 +222,17 @@ TEST(MarkdownParserTestCase, MarkdownLexerSectionsPostDeclaredHeaders2)
 
     // tokenize
     lexer.tokenize(&content);
-    const std::vector<MarkdownLexem*>& lexems = lexer.getLexems();
+    const std::vector<MarkdownLexem>& lexems = lexer.getLexems();
     ASSERT_TRUE(lexems.size());
     printLexems(lexems);
 
     // asserts
-    EXPECT_EQ(MarkdownLexemType::BEGIN_DOC, lexems[0]->getType());
-    EXPECT_EQ(MarkdownLexemType::SECTION_equals, lexems[1]->getType());
-    EXPECT_EQ(MarkdownLexemType::LINE, lexems[2]->getType());
-    EXPECT_EQ(MarkdownLexemType::BR, lexems[3]->getType());
-    EXPECT_EQ(MarkdownLexemType::LINE, lexems[4]->getType());
-    EXPECT_EQ(MarkdownLexemType::BR, lexems[5]->getType());
+    EXPECT_EQ(MarkdownLexemType::BEGIN_DOC, lexems[0].getType());
+    EXPECT_EQ(MarkdownLexemType::SECTION_equals, lexems[1].getType());
+    EXPECT_EQ(MarkdownLexemType::LINE, lexems[2].getType());
+    EXPECT_EQ(MarkdownLexemType::BR, lexems[3].getType());
+    EXPECT_EQ(MarkdownLexemType::LINE, lexems[4].getType());
+    EXPECT_EQ(MarkdownLexemType::BR, lexems[5].getType());
 }
 
 TEST(MarkdownParserTestCase, MarkdownLexerTimeScope)
@@ -180,13 +253,13 @@ TEST(MarkdownParserTestCase, MarkdownLexerTimeScope)
 
     // tokenize
     lexer.tokenize(&content);
-    const std::vector<MarkdownLexem*>& lexems = lexer.getLexems();
+    const std::vector<MarkdownLexem>& lexems = lexer.getLexems();
     ASSERT_TRUE(lexems.size());
     printLexems(lexems);
 
     // asserts
-    EXPECT_EQ(MarkdownLexemType::BEGIN_DOC, lexems[0]->getType());
-    EXPECT_EQ(MarkdownLexemType::META_PROPERTY_scope, lexems[9]->getType());
+    EXPECT_EQ(MarkdownLexemType::BEGIN_DOC, lexems[0].getType());
+    EXPECT_EQ(MarkdownLexemType::META_PROPERTY_scope, lexems[9].getType());
 }
 
 TEST(MarkdownParserTestCase, MarkdownLexerLinks)
@@ -207,13 +280,13 @@ TEST(MarkdownParserTestCase, MarkdownLexerLinks)
 
     // tokenize
     lexer.tokenize(&content);
-    const std::vector<MarkdownLexem*>& lexems = lexer.getLexems();
+    const std::vector<MarkdownLexem>& lexems = lexer.getLexems();
     ASSERT_TRUE(lexems.size());
     printLexems(lexems);
 
     // asserts
-    EXPECT_EQ(MarkdownLexemType::BEGIN_DOC, lexems[0]->getType());
-    EXPECT_EQ(MarkdownLexemType::META_PROPERTY_links, lexems[9]->getType());
+    EXPECT_EQ(MarkdownLexemType::BEGIN_DOC, lexems[0].getType());
+    EXPECT_EQ(MarkdownLexemType::META_PROPERTY_links, lexems[9].getType());
 }
 
 TEST(MarkdownParserTestCase, MarkdownParserSections)
@@ -246,7 +319,7 @@ TEST(MarkdownParserTestCase, MarkdownParserSectionsPreamble)
     cout << endl << "- Lexer ----------------------------------------------";
     MarkdownLexerSections lexer(fileName.get());
     lexer.tokenize();
-    const std::vector<MarkdownLexem*>& lexems = lexer.getLexems();
+    const std::vector<MarkdownLexem>& lexems = lexer.getLexems();
     printLexems(lexems);
     EXPECT_EQ(62, lexems.size());
 
@@ -291,7 +364,7 @@ TEST(MarkdownParserTestCase, MarkdownParserSectionsEmptyFirstLine)
     cout << endl << "- Lexer ----------------------------------------------";
     MarkdownLexerSections lexer(&filePath);
     lexer.tokenize();
-    const std::vector<MarkdownLexem*>& lexems = lexer.getLexems();
+    const std::vector<MarkdownLexem>& lexems = lexer.getLexems();
     printLexems(lexems);
     EXPECT_EQ(31, lexems.size());
 
@@ -740,6 +813,84 @@ TEST(MarkdownParserTestCase, FileSystemPersistence)
     cout << persistence.createFileName(string("/tmp"), text.get(), m8r::filesystem::File::EXTENSION_MD_MD);
 }
 
+TEST(MarkdownParserTestCase, FileSystemPersistenceWriteBehind)
+{
+    string directory{m8r::platformSpecificPath("/tmp/mf-unit-write-behind")};
+    string path{directory + FILE_PATH_SEPARATOR + "o.md"};
+    string link{directory + FILE_PATH_SEPARATOR + "link.md"};
+    unlink(link.c_str());
+    m8r::removeDirectoryRecursively(directory.c_str());
+    m8r::createDirectory(directory);
+    m8r::stringToFile(path, "# Original\n");
+    chmod(path.c_str(), 0600);
+    ASSERT_EQ(0, symlink(path.c_str(), link.c_str()));
+
+    m8r::Ontology ontology{};
+    m8r::MarkdownOutlineRepresentation mdr{ontology, nullptr};
+    m8r::HtmlOutlineRepresentation htmlr{ontology, nullptr};
+    vector<string> written{};
+    bool replacementWritten{true};
+    {
+        m8r::FilesystemPersistence persistence{mdr, htmlr};
+        // listener is called before the file is replaced by the (complete) temporary file
+        persistence.setWriteListener([&](const string& p, const string& replacement) {
+            written.push_back(p);
+            replacementWritten = replacementWritten
+                && replacement != p
+                && m8r::isFile(replacement.c_str());
+        });
+
+        m8r::OutlineType oType{m8r::OutlineType::KeyOutline(),nullptr,m8r::Color::RED()};
+        m8r::Outline o{&oType};
+        o.setKey(path);
+
+        // repeated saves are coalesced, the last one is written
+        for(int i=0; i<100; i++) {
+            o.setName("Save " + std::to_string(i));
+            persistence.save(&o);
+        }
+        persistence.flush();
+        unique_ptr<string> content{m8r::fileToString(path)};
+        EXPECT_NE(string::npos, content->find("# Save 99"));
+        EXPECT_GE(2, written.size());
+        EXPECT_EQ(path, written.back());
+        EXPECT_TRUE(replacementWritten);
+        EXPECT_TRUE(persistence.takeFailedWrites().empty());
+
+        // file mode is preserved, no temporary file is left
+        struct stat fileStat;
+        ASSERT_EQ(0, stat(path.c_str(), &fileStat));
+        EXPECT_EQ(0600, fileStat.st_mode & 0777);
+        EXPECT_FALSE(m8r::isFile((path + m8r::FILE_EXTENSION_TEMPORARY).c_str()));
+
+        // symbolic link is written through
+        o.setKey(link);
+        o.setName("Through Link");
+        persistence.save(&o);
+        persistence.flush();
+        content.reset(m8r::fileToString(path));
+        EXPECT_NE(string::npos, content->find("# Through Link"));
+        struct stat linkStat;
+        ASSERT_EQ(0, lstat(link.c_str(), &linkStat));
+        EXPECT_TRUE(S_ISLNK(linkStat.st_mode));
+
+        // failed write is reported once
+        string missingPath{directory + FILE_PATH_SEPARATOR + "missing" + FILE_PATH_SEPARATOR + "o.md"};
+        o.setKey(missingPath);
+        persistence.save(&o);
+        persistence.flush();
+        EXPECT_EQ(vector<string>{missingPath}, persistence.takeFailedWrites());
+        EXPECT_TRUE(persistence.takeFailedWrites().empty());
+
+        // pending write is written on destruction
+        o.setKey(path);
+        o.setName("On Exit");
+        persistence.save(&o);
+    }
+    unique_ptr<string> content{m8r::fileToString(path)};
+    EXPECT_NE(string::npos, content->find("# On Exit"));
+}
+
 TEST(MarkdownParserBugsTestCase, EmptyNameSkipsEof)
 {
     string repositoryPath{"/lib/test/resources/bugs-repository"};
@@ -26,7 +26,9 @@
 #include <gtest/gtest.h>
 
 #include "../../../src/config/configuration.h"
+#include "../../../src/gear/file_utils.h"
 #include "../../../src/mind/mind.h"
+#include "../../../src/install/installer.h"
 
 extern char* getMindforgerGitHomePath();
 
@@ -94,3 +96,83 @@ TEST(FtsTestCase, FTS) {
     EXPECT_EQ(2, result->size());
     delete result;
 }
+
+TEST(FtsTestCase, FtsIndex) {
+    string repositoryDir{"/tmp/mf-unit-repository-fts"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    string oFile{repositoryDir+"/memory/o.md"};
+    string oContent{
+        "# FTS Index Test Outline"
+        "\nOutline about hashing."
+        "\n"
+        "\n# Hash Map"
+        "\nHash map looking for keys."
+        "\n"
+        "\n# Tree"
+        "\nBalanced tree with a HashCode."
+        "\n"
+        "\n## Leaf"
+        "\nLocking leaf."
+        "\n"};
+    m8r::stringToFile(oFile,oContent);
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-ftc-fi.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind{config};
+    mind.learn();
+    m8r::Outline* o = mind.remind().getOutlines().at(0);
+    EXPECT_EQ(4, mind.remind().getFtsIndex().getDocumentsCount());
+
+    // indexed search must match full scan (O scoped search)
+    vector<pair<string,m8r::FtsSearch>> queries{
+        {"hash", m8r::FtsSearch::EXACT},
+        {"Hash", m8r::FtsSearch::EXACT},
+        {"hash", m8r::FtsSearch::IGNORE_CASE},
+        {"ash m", m8r::FtsSearch::IGNORE_CASE},
+        {"lo*king", m8r::FtsSearch::REGEXP},
+        {"Hash(Code)?", m8r::FtsSearch::REGEXP},
+        {"leaf|tree", m8r::FtsSearch::REGEXP},
+        {"no such text", m8r::FtsSearch::EXACT},
+        {"ha", m8r::FtsSearch::EXACT}
+    };
+    for(auto& q:queries) {
+        vector<m8r::Note*>* indexed = mind.findNoteFts(q.first, q.second);
+        vector<m8r::Note*>* scanned = mind.findNoteFts(q.first, q.second, o);
+        cout << "'" << q.first << "'" << endl;
+        printFtsResult(indexed);
+        EXPECT_EQ(*scanned, *indexed);
+        delete indexed;
+        delete scanned;
+    }
+
+    // incremental update: new N
+    string name{"Quokka"};
+    m8r::Note* n = mind.noteNew(o->getKey(), 0, &name);
+    n->addDescriptionLine(new string{"Marsupial."});
+    mind.remember(o->getKey());
+    vector<m8r::Note*>* result = mind.findNoteFts("marsupial", m8r::FtsSearch::IGNORE_CASE);
+    EXPECT_EQ(1, result->size());
+    EXPECT_EQ(n, result->at(0));
+    delete result;
+
+    // incremental update: deleted N
+    mind.noteForget(n);
+    result = mind.findNoteFts("marsupial", m8r::FtsSearch::IGNORE_CASE);
+    EXPECT_EQ(0, result->size());
+    delete result;
+
+    // incremental update: forgotten O
+    mind.forget(o);
+    result = mind.findNoteFts("hash", m8r::FtsSearch::IGNORE_CASE);
+    EXPECT_EQ(0, result->size());
+    EXPECT_EQ(0, mind.remind().getFtsIndex().getDocumentsCount());
+    delete result;
+}
@@ -0,0 +1,153 @@
+/*
+ knowledge_graph_index_test.cpp     MindForger knowledge graph index test
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../../../src/config/configuration.h"
+#include "../../../src/gear/file_utils.h"
+#include "../../../src/mind/mind.h"
+#include "../../../src/mind/knowledge_graph_index.h"
+
+#include "../test_utils.h"
+
+using namespace std;
+
+string knowledgeGraphIndexName(const m8r::KnowledgeGraphIndex& index, m8r::KnowledgeGraphIndex::NodeId node)
+{
+    switch(index.getType(node)) {
+    case m8r::KnowledgeGraphIndex::NodeType::OUTLINE:
+        return index.getOutline(node)->getName();
+    case m8r::KnowledgeGraphIndex::NodeType::NOTE:
+        return index.getNote(node)->getName();
+    default:
+        return index.getTag(node)->getName();
+    }
+}
+
+vector<string> knowledgeGraphIndexReached(
+    const m8r::KnowledgeGraphIndex& index,
+    const vector<m8r::KnowledgeGraphIndex::Reached>& reached,
+    unsigned hops)
+{
+    vector<string> names{};
+    for(const m8r::KnowledgeGraphIndex::Reached& r:reached) {
+        if(r.hops == hops) {
+            names.push_back(knowledgeGraphIndexName(index, r.node));
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+TEST(KnowledgeGraphIndexTestCase, AdjacencyExpansionAndIncrementalUpdates) {
+    string repositoryPath{m8r::platformSpecificPath("/tmp/mf-unit-repository-knowledge-graph-index")};
+    string memoryPath{repositoryPath + FILE_PATH_SEPARATOR + m8r::DIRNAME_MEMORY + FILE_PATH_SEPARATOR};
+    map<string,string> pathToContent;
+    pathToContent[memoryPath+"cooking.md"] =
+        "# Cooking <!-- Metadata: tags: food; links: [Trip](./travel.md#rome),[Web](https://www.mindforger.com); -->"
+        "\nRecipes."
+        "\n"
+        "\n## Pizza <!-- Metadata: tags: italy; -->"
+        "\nDough."
+        "\n"
+        "\n### Margherita"
+        "\nTomatoes."
+        "\n"
+        "\n## Toast"
+        "\nBread."
+        "\n";
+    pathToContent[memoryPath+"travel.md"] =
+        "# Travel <!-- Metadata: tags: italy; -->"
+        "\nTrips."
+        "\n"
+        "\n## Rome"
+        "\nColosseum."
+        "\n";
+    m8r::createEmptyRepository(repositoryPath, pathToContent);
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-kgitc-aeaiu.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind(config);
+    mind.learn();
+    ASSERT_EQ(2, mind.remind().getOutlinesCount());
+
+    const m8r::KnowledgeGraphIndex& index = mind.remind().getGraphIndex();
+    m8r::Outline* cooking = mind.remind().getOutline(memoryPath+"cooking.md");
+    m8r::Outline* travel = mind.remind().getOutline(memoryPath+"travel.md");
+    ASSERT_NE(nullptr, cooking);
+    ASSERT_NE(nullptr, travel);
+    m8r::Note* rome = travel->getNotes()[0];
+
+    // 2 Os, 4 Ns and 2 tags; link w/ scheme is not indexed
+    EXPECT_EQ(8, index.getNodesCount());
+    m8r::KnowledgeGraphIndex::NodeId cookingNode = index.getNode(cooking);
+    m8r::KnowledgeGraphIndex::NodeId romeNode = index.getNode(rome);
+    ASSERT_NE(m8r::KnowledgeGraphIndex::NO_NODE, cookingNode);
+    ASSERT_NE(m8r::KnowledgeGraphIndex::NO_NODE, romeNode);
+    EXPECT_EQ(4, index.getDegree(cookingNode));
+
+    // link is resolved to N and can be walked back
+    bool backlink = false;
+    index.forEachAdjacent(romeNode, [&](const m8r::KnowledgeGraphIndex::Adjacent& a) {
+        if(a.node == cookingNode && a.relation == m8r::KnowledgeGraphIndex::Relation::BACKLINK) {
+            backlink = true;
+        }
+    });
+    EXPECT_TRUE(backlink);
+    EXPECT_EQ(2, index.getDegree(romeNode));
+
+    // multi-hop expansion reaches every node once by the shortest path
+    vector<m8r::KnowledgeGraphIndex::Reached> reached{};
+    index.expand(cookingNode, 1, 100, reached);
+    EXPECT_EQ((vector<string>{"Pizza", "Rome", "Toast", "food"}), knowledgeGraphIndexReached(index, reached, 1));
+    EXPECT_EQ(4, reached.size());
+    reached.clear();
+    index.expand(cookingNode, 3, 100, reached);
+    EXPECT_EQ((vector<string>{"Margherita", "Travel", "italy"}), knowledgeGraphIndexReached(index, reached, 2));
+    EXPECT_EQ(7, reached.size());
+    reached.clear();
+    index.expand(cookingNode, 3, 2, reached);
+    EXPECT_EQ(2, reached.size());
+
+    // forgotten N subtree - IDs of reindexed O are recycled
+    mind.noteForget(cooking->getNotes()[0]);
+    EXPECT_EQ(6, index.getNodesCount());
+    EXPECT_EQ(3, index.getDegree(index.getNode(cooking)));
+    EXPECT_NE(m8r::KnowledgeGraphIndex::NO_NODE, index.getNode(mind.getOntology().findOrCreateTag("italy")));
+
+    // forgotten O: link target is gone, its tag is not used anymore
+    mind.outlineForget(memoryPath+"travel.md");
+    EXPECT_EQ(3, index.getNodesCount());
+    EXPECT_EQ(2, index.getDegree(index.getNode(cooking)));
+    EXPECT_EQ(m8r::KnowledgeGraphIndex::NO_NODE, index.getNode(mind.getOntology().findOrCreateTag("italy")));
+
+    mind.amnesia();
+    EXPECT_EQ(0, index.getNodesCount());
+}
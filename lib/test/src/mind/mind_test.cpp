@@ -18,9 +18,15 @@
  */
 
 #include <stddef.h>
+#include <utime.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <iterator>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -34,6 +40,8 @@
 
 #include "../../../src/representations/markdown/markdown_outline_representation.h"
 
+#include "../test_utils.h"
+
 extern char* getMindforgerGitHomePath();
 
 using namespace std;
@@ -306,6 +314,491 @@ TEST(MindTestCase, LearnAmnesiaLearn) {
     EXPECT_EQ(17, memory.getOntology().getTags().size());
 }
 
+TEST(MindTestCase, LearnParallel) {
+    string repositoryPath{"/lib/test/resources/apiary-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-lp.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+
+    // sequential and parallel learning must produce identical memory and ontology
+    vector<vector<string>> learned{};
+    for(int threads:{1, 4}) {
+        config.setLearnThreads(threads);
+        m8r::Mind mind(config);
+        mind.learn();
+
+        vector<string> dump{};
+        for(m8r::Outline* o:mind.remind().getOutlines()) {
+            dump.push_back(o->getKey() + " " + o->getName() + " " + std::to_string(o->getNotesCount()));
+            EXPECT_EQ(o, mind.remind().getOutline(o->getKey()));
+        }
+        for(const m8r::Tag* t:mind.getOntology().getTags().values()) {
+            dump.push_back(t->getName());
+        }
+        learned.push_back(dump);
+    }
+
+    EXPECT_LT(20, learned[0].size());
+    EXPECT_EQ(learned[0], learned[1]);
+    config.setLearnThreads(m8r::Configuration::DEFAULT_LEARN_THREADS);
+}
+
+vector<string> learnRepositorySnapshotDump(m8r::Mind& mind, unsigned& restored, unsigned& parsed)
+{
+    mind.learn();
+    restored = mind.remind().getSnapshot().getRestoredCount();
+    parsed = mind.remind().getSnapshot().getParsedCount();
+
+    m8r::MarkdownOutlineRepresentation mdr{mind.getOntology(), nullptr};
+    vector<string> dump{};
+    for(m8r::Outline* o:mind.remind().getOutlines()) {
+        string* md = mdr.to(o);
+        dump.push_back(o->getKey() + " " + std::to_string(o->getBytesize()) + " " + std::to_string(o->getModified()) + "\n" + *md);
+        delete md;
+    }
+    std::sort(dump.begin(), dump.end());
+    mind.amnesia();
+    return dump;
+}
+
+TEST(MindTestCase, LearnFromRepositorySnapshot) {
+    string repositoryPath{m8r::platformSpecificPath("/tmp/mf-unit-repository-snapshot")};
+    string memoryPath{repositoryPath + FILE_PATH_SEPARATOR + m8r::DIRNAME_MEMORY + FILE_PATH_SEPARATOR};
+    map<string,string> pathToContent;
+    pathToContent[memoryPath+"universe.md"] =
+        "Preamble line."
+        "\n"
+        "\n# Universe <!-- Metadata: tags: COOL, science; type: Grow; created: 2015-05-30 21:30:28; reads: 55; read: 2016-10-15 13:54:45; revision: 3; modified: 2016-03-31 13:54:45; importance: 4/5; urgency: 2/5; progress: 20%; scope: 1y2m3d4h5m; links: [Galaxies](galaxies.md); -->"
+        "\nUniverse description."
+        "\n"
+        "\n## Galaxies <!-- Metadata: tags: hash, additivity; type: Question; created: 2016-03-31 13:54:45; reads: 7; read: 2016-03-31 13:54:45; revision: 3; modified: 2016-03-31 13:54:45; deadline: 2020-01-01 10:00:00; -->"
+        "\nMilky way."
+        "\n"
+        "\nPost declared"
+        "\n-------------"
+        "\nBelow the line."
+        "\n";
+    pathToContent[memoryPath+"plain.md"] =
+        "# Plain Markdown ###"
+        "\nNo metadata."
+        "\n"
+        "\n### Deeper"
+        "\nText w/o EOL";
+    pathToContent[memoryPath+"touched.md"] =
+        "# Touched"
+        "\nSame content, new modification time."
+        "\n";
+    m8r::createEmptyRepository(repositoryPath, pathToContent);
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-lfrs.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+    config.setLearnThreads(1);
+    // snapshot is kept in cache (not in repository) and it outlives repository > cold start
+    string snapshotPath{m8r::RepositorySnapshot::path(config.getCachePath(), config.getActiveRepository()->getDir())};
+    EXPECT_EQ(0, snapshotPath.find(config.getCachePath()));
+    remove(snapshotPath.c_str());
+    m8r::Mind mind(config);
+    unsigned restored, parsed;
+
+    // 1/5 cold start: parse all files and create snapshot
+    vector<string> cold = learnRepositorySnapshotDump(mind, restored, parsed);
+    EXPECT_EQ(0, restored);
+    EXPECT_EQ(3, parsed);
+    EXPECT_EQ(3, cold.size());
+    EXPECT_TRUE(m8r::isFile(snapshotPath.c_str()));
+
+    // 2/5 warm start: everything restored, model identical to parsed one (sequential and parallel)
+    for(int threads:{1, 4}) {
+        config.setLearnThreads(threads);
+        vector<string> warm = learnRepositorySnapshotDump(mind, restored, parsed);
+        EXPECT_EQ(3, restored);
+        EXPECT_EQ(0, parsed);
+        EXPECT_EQ(cold, warm);
+    }
+    config.setLearnThreads(1);
+
+    // 3/5 changed file is parsed, touched file is restored (content hash), removed file is forgotten
+    m8r::stringToFile(memoryPath+"plain.md", "# Plain Markdown\nChanged.\n");
+    struct utimbuf times{0, 1000000000};
+    utime((memoryPath+"touched.md").c_str(), &times);
+    remove((memoryPath+"universe.md").c_str());
+    vector<string> changed = learnRepositorySnapshotDump(mind, restored, parsed);
+    EXPECT_EQ(1, restored);
+    EXPECT_EQ(1, parsed);
+    ASSERT_EQ(2, changed.size());
+    EXPECT_NE(string::npos, changed[0].find("Changed."));
+    EXPECT_NE(string::npos, changed[1].find("Same content"));
+
+    // 4/5 racy file: same size & modification time, but snapshot written in the same timestamp granule
+    struct stat plainStat;
+    stat((memoryPath+"plain.md").c_str(), &plainStat);
+    m8r::stringToFile(memoryPath+"plain.md", "# Plain Markdown\nRacy!!!!\n");
+    struct timespec racyTimes[2]{plainStat.st_mtim, plainStat.st_mtim};
+    utimensat(AT_FDCWD, (memoryPath+"plain.md").c_str(), racyTimes, 0);
+    utimensat(AT_FDCWD, snapshotPath.c_str(), racyTimes, 0);
+    vector<string> racy = learnRepositorySnapshotDump(mind, restored, parsed);
+    EXPECT_EQ(1, restored);
+    EXPECT_EQ(1, parsed);
+    ASSERT_EQ(2, racy.size());
+    EXPECT_NE(string::npos, racy[0].find("Racy!!!!"));
+    changed = racy;
+
+    // 5/5 broken snapshot is ignored
+    m8r::stringToFile(snapshotPath, "M8RS broken snapshot");
+    vector<string> broken = learnRepositorySnapshotDump(mind, restored, parsed);
+    EXPECT_EQ(0, restored);
+    EXPECT_EQ(2, parsed);
+    EXPECT_EQ(changed, broken);
+
+    config.setLearnThreads(m8r::Configuration::DEFAULT_LEARN_THREADS);
+}
+
+unsigned waitForRepositoryChanges(m8r::Mind& mind, int millis=3000, vector<string>* keys=nullptr)
+{
+    m8r::Mind::RepositoryChanges changes{};
+    unsigned count{};
+    for(int i=0; i<millis/50 && !count; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        count = mind.learnRepositoryChanges(changes);
+        EXPECT_FALSE(changes.rescan);
+    }
+    EXPECT_EQ(count, changes.outlineKeys.size());
+    if(keys) {
+        *keys = changes.outlineKeys;
+        std::sort(keys->begin(), keys->end());
+    }
+    return count;
+}
+
+TEST(MindTestCase, LearnRepositoryChanges) {
+    if(!m8r::RepositoryWatcher::isSupported()) {
+        return;
+    }
+
+    string repositoryPath{m8r::platformSpecificPath("/tmp/mf-unit-repository-watcher")};
+    string memoryPath{repositoryPath + FILE_PATH_SEPARATOR + m8r::DIRNAME_MEMORY};
+    map<string,string> pathToContent;
+    pathToContent[memoryPath+FILE_PATH_SEPARATOR+"modified.md"] = "# Modified\nOriginal.\n";
+    pathToContent[memoryPath+FILE_PATH_SEPARATOR+"remembered.md"] = "# Remembered\nKept.\n";
+    pathToContent[memoryPath+FILE_PATH_SEPARATOR+"removed.md"] = "# Removed\nGone soon.\n";
+    m8r::createEmptyRepository(repositoryPath, pathToContent);
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-lrc.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+    config.setLearnThreads(1);
+    m8r::Mind mind(config);
+    mind.learn();
+    ASSERT_EQ(3, mind.remind().getOutlinesCount());
+    ASSERT_TRUE(mind.remind().getRepositoryWatcher().isWatching());
+    m8r::Mind::RepositoryChanges changes{};
+    EXPECT_EQ(0, mind.learnRepositoryChanges(changes));
+
+    // 1/4 files created, modified and removed by other application are (re)learned/forgotten
+    m8r::stringToFile(memoryPath+FILE_PATH_SEPARATOR+"created.md", "# Created\nNew.\n");
+    m8r::stringToFile(memoryPath+FILE_PATH_SEPARATOR+"modified.md", "# Modified Outside\nChanged.\n");
+    remove((memoryPath+FILE_PATH_SEPARATOR+"removed.md").c_str());
+    vector<string> keys{};
+    EXPECT_EQ(3, waitForRepositoryChanges(mind, 3000, &keys));
+    EXPECT_EQ(
+        (vector<string>{
+            memoryPath+FILE_PATH_SEPARATOR+"created.md",
+            memoryPath+FILE_PATH_SEPARATOR+"modified.md",
+            memoryPath+FILE_PATH_SEPARATOR+"removed.md"}),
+        keys);
+    EXPECT_EQ(3, mind.remind().getOutlinesCount());
+    EXPECT_NE(nullptr, mind.remind().getOutline(memoryPath+FILE_PATH_SEPARATOR+"created.md"));
+    EXPECT_EQ(nullptr, mind.remind().getOutline(memoryPath+FILE_PATH_SEPARATOR+"removed.md"));
+    m8r::Outline* o = mind.remind().getOutline(memoryPath+FILE_PATH_SEPARATOR+"modified.md");
+    ASSERT_NE(nullptr, o);
+    EXPECT_EQ("Modified Outside", o->getName());
+
+    // 2/4 O written by MindForger is NOT relearned
+    o = mind.remind().getOutline(memoryPath+FILE_PATH_SEPARATOR+"remembered.md");
+    ASSERT_NE(nullptr, o);
+    o->setName("Remembered by MindForger");
+    mind.remember(o);
+    EXPECT_TRUE(mind.remind().flush().empty());
+    EXPECT_FALSE(o->isDirty());
+    EXPECT_EQ(0, waitForRepositoryChanges(mind, 1000));
+    EXPECT_EQ(o, mind.remind().getOutline(memoryPath+FILE_PATH_SEPARATOR+"remembered.md"));
+
+    // 3/4 new directory is watched
+    string directoryPath{memoryPath+FILE_PATH_SEPARATOR+"directory"};
+    m8r::createDirectory(directoryPath);
+    m8r::stringToFile(directoryPath+FILE_PATH_SEPARATOR+"nested.md", "# Nested\nDeeper.\n");
+    EXPECT_EQ(1, waitForRepositoryChanges(mind));
+    EXPECT_EQ(4, mind.remind().getOutlinesCount());
+    m8r::stringToFile(directoryPath+FILE_PATH_SEPARATOR+"nested.md", "# Nested Again\nDeeper.\n");
+    EXPECT_EQ(1, waitForRepositoryChanges(mind));
+    o = mind.remind().getOutline(directoryPath+FILE_PATH_SEPARATOR+"nested.md");
+    ASSERT_NE(nullptr, o);
+    EXPECT_EQ("Nested Again", o->getName());
+
+    // 4/4 Os of removed directory are forgotten
+    m8r::removeDirectoryRecursively(directoryPath.c_str());
+    EXPECT_EQ(1, waitForRepositoryChanges(mind));
+    EXPECT_EQ(3, mind.remind().getOutlinesCount());
+    EXPECT_EQ(nullptr, mind.remind().getOutline(directoryPath+FILE_PATH_SEPARATOR+"nested.md"));
+
+    mind.amnesia();
+    EXPECT_FALSE(mind.remind().getRepositoryWatcher().isWatching());
+    config.setLearnThreads(m8r::Configuration::DEFAULT_LEARN_THREADS);
+}
+
+TEST(MindTestCase, StatisticsJournal) {
+    string repositoryPath{m8r::platformSpecificPath("/tmp/mf-unit-repository-journal")};
+    string outlinePath{repositoryPath + FILE_PATH_SEPARATOR + m8r::DIRNAME_MEMORY + FILE_PATH_SEPARATOR + "journal.md"};
+    string journalPath{repositoryPath + FILE_PATH_SEPARATOR + m8r::FILENAME_STATISTICS_JOURNAL};
+    string outlineContent{
+        "# Journal <!-- Metadata: reads: 3; read: 2016-10-15 13:54:45; -->"
+        "\nO."
+        "\n"
+        "\n## Twin <!-- Metadata: reads: 1; read: 2016-10-15 13:54:45; -->"
+        "\nN1."
+        "\n"
+        "\n## Twin <!-- Metadata: reads: 5; read: 2016-10-15 13:54:45; -->"
+        "\nN2."
+        "\n"};
+    map<string,string> pathToContent;
+    pathToContent[outlinePath] = outlineContent;
+    m8r::createEmptyRepository(repositoryPath, pathToContent);
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-sj.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+    config.setLearnThreads(1);
+    config.setStatisticsJournal(true);
+    m8r::Mind mind(config);
+    mind.learn();
+    ASSERT_TRUE(mind.remind().getStatisticsJournal().isOpen());
+
+    // 1/4 reads are journaled w/o rewriting Markdown file
+    m8r::Outline* o = mind.remind().getOutline(outlinePath);
+    ASSERT_NE(nullptr, o);
+    ASSERT_EQ(2, o->getNotesCount());
+    mind.remind().read(o);
+    mind.remind().read(o);
+    for(int i=0; i<3; i++) {
+        mind.remind().read(o->getNotes()[1]);
+    }
+    EXPECT_EQ(5, o->getReads());
+    EXPECT_EQ(8, o->getNotes()[1]->getReads());
+    EXPECT_EQ(5, mind.remind().getStatisticsJournal().getRecordsCount());
+    EXPECT_EQ(1, mind.remind().getStatisticsJournal().getJournaledOutlinesCount());
+    mind.remind().getPersistence().flush();
+    string* content = m8r::fileToString(outlinePath);
+    EXPECT_EQ(outlineContent, *content);
+    delete content;
+    string* journal = m8r::fileToString(journalPath);
+    ASSERT_NE(nullptr, journal);
+    EXPECT_EQ(0, journal->find("M8RJ 1\n"));
+    EXPECT_EQ(6, std::count(journal->begin(), journal->end(), '\n'));
+
+    // 2/4 journal is folded to Markdown file on amnesia (Ns w/ the same name don't collide)
+    mind.amnesia();
+    EXPECT_FALSE(m8r::isFile(journalPath.c_str()));
+    content = m8r::fileToString(outlinePath);
+    EXPECT_NE(outlineContent, *content);
+    size_t firstTwin = content->find("## Twin");
+    size_t secondTwin = content->find("## Twin", firstTwin+1);
+    ASSERT_NE(std::string::npos, secondTwin);
+    EXPECT_LT(content->find("reads: 5;"), firstTwin);
+    EXPECT_LT(content->find("reads: 1;", firstTwin), secondTwin);
+    EXPECT_NE(std::string::npos, content->find("reads: 8;", secondTwin));
+    delete content;
+    mind.learn();
+    o = mind.remind().getOutline(outlinePath);
+    ASSERT_NE(nullptr, o);
+    EXPECT_EQ(5, o->getReads());
+    EXPECT_EQ(1, o->getNotes()[0]->getReads());
+    EXPECT_EQ(8, o->getNotes()[1]->getReads());
+
+    // 3/4 journal of crashed MindForger is replayed on learn (records of moved N and truncated record are skipped)
+    mind.amnesia();
+    m8r::stringToFile(outlinePath, outlineContent);
+    m8r::stringToFile(
+        journalPath,
+        *journal
+        + "R\t99\t1476532485\t" + m8r::DIRNAME_MEMORY + FILE_PATH_SEPARATOR + "journal.md\t0\tMoved\n"
+        + "R\t9");
+    delete journal;
+    mind.learn();
+    o = mind.remind().getOutline(outlinePath);
+    ASSERT_NE(nullptr, o);
+    EXPECT_EQ(5, o->getReads());
+    EXPECT_EQ(1, o->getNotes()[0]->getReads());
+    EXPECT_EQ(8, o->getNotes()[1]->getReads());
+    EXPECT_EQ(7, mind.remind().getStatisticsJournal().getRecordsCount());
+
+    // 4/4 compaction keeps the latest record of every journaled thing, saved O is dropped
+    string compactedPath{repositoryPath + FILE_PATH_SEPARATOR + "compacted-journal"};
+    m8r::StatisticsJournal compacted{4};
+    compacted.open(compactedPath, repositoryPath);
+    compacted.read(o);
+    compacted.read(o->getNotes()[0]);
+    compacted.read(o->getNotes()[0]);
+    EXPECT_FALSE(compacted.isCompactionNeeded());
+    o->getNotes()[0]->makeRead();
+    compacted.read(o->getNotes()[0]);
+    ASSERT_TRUE(compacted.isCompactionNeeded());
+    compacted.compact();
+    EXPECT_EQ(2, compacted.getRecordsCount());
+    EXPECT_FALSE(compacted.isCompactionNeeded());
+    journal = m8r::fileToString(compactedPath);
+    ASSERT_NE(nullptr, journal);
+    EXPECT_EQ(3, std::count(journal->begin(), journal->end(), '\n'));
+    EXPECT_NE(std::string::npos, journal->find("R\t2\t"));
+    delete journal;
+    compacted.forget(o);
+    compacted.compact();
+    EXPECT_EQ(0, compacted.getRecordsCount());
+    compacted.close();
+
+    mind.amnesia();
+    config.setStatisticsJournal(m8r::Configuration::DEFAULT_STATISTICS_JOURNAL);
+    config.setLearnThreads(m8r::Configuration::DEFAULT_LEARN_THREADS);
+}
+
+void expectMemoryStatisticsAsScanned(m8r::Mind& mind)
+{
+    unsigned notes{}, bytes{};
+    u_int32_t maxOutlineReads{}, maxNoteWrites{};
+    map<const m8r::Tag*,int> tags{};
+    for(m8r::Outline* o:mind.remind().getOutlines()) {
+        notes += o->getNotesCount();
+        bytes += o->getBytesize();
+        maxOutlineReads = std::max(maxOutlineReads, o->getReads());
+        for(const m8r::Tag* t:*o->getTags()) tags[t]++;
+        for(m8r::Note* n:o->getNotes()) {
+            maxNoteWrites = std::max(maxNoteWrites, n->getRevision());
+            for(const m8r::Tag* t:*n->getTags()) tags[t]++;
+        }
+    }
+    const m8r::MemoryStatistics& statistics = mind.remind().getStatistics();
+    EXPECT_EQ(notes, mind.remind().getNotesCount());
+    EXPECT_EQ(bytes, mind.remind().getOutlineMarkdownsSize());
+    ASSERT_NE(nullptr, statistics.getMostReadOutline());
+    EXPECT_EQ(maxOutlineReads, statistics.getMostReadOutline()->getReads());
+    ASSERT_NE(nullptr, statistics.getMostWrittenNote());
+    EXPECT_EQ(maxNoteWrites, statistics.getMostWrittenNote()->getRevision());
+    for(const auto& t:tags) {
+        EXPECT_EQ(static_cast<u_int32_t>(t.second), statistics.getTagCardinality(t.first));
+    }
+}
+
+TEST(MindTestCase, IncrementalStatistics) {
+    string repositoryPath{m8r::platformSpecificPath("/tmp/mf-unit-repository-statistics")};
+    string memoryPath{repositoryPath + FILE_PATH_SEPARATOR + m8r::DIRNAME_MEMORY + FILE_PATH_SEPARATOR};
+    map<string,string> pathToContent;
+    pathToContent[memoryPath+"physics.md"] =
+        "# Physics <!-- Metadata: tags: science; reads: 10; revision: 2; -->"
+        "\nMatter."
+        "\n"
+        "\n## Gravity <!-- Metadata: tags: science, force; reads: 4; revision: 9; -->"
+        "\nApples."
+        "\n"
+        "\n## Magnetism <!-- Metadata: tags: force; reads: 3; revision: 1; -->"
+        "\nCompass."
+        "\n";
+    pathToContent[memoryPath+"history.md"] =
+        "# History <!-- Metadata: tags: humanities; reads: 20; revision: 1; -->"
+        "\nPast."
+        "\n"
+        "\n## Rome <!-- Metadata: tags: humanities; reads: 30; revision: 3; -->"
+        "\nEmpire."
+        "\n";
+    m8r::createEmptyRepository(repositoryPath, pathToContent);
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-is.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind(config);
+    mind.learn();
+    const m8r::MemoryStatistics& statistics = mind.remind().getStatistics();
+    m8r::Ontology& ontology = mind.getOntology();
+    const m8r::Tag* science = ontology.findOrCreateTag("science");
+    const m8r::Tag* force = ontology.findOrCreateTag("force");
+
+    // learned
+    EXPECT_EQ(3, mind.remind().getNotesCount());
+    EXPECT_EQ("History", statistics.getMostReadOutline()->getName());
+    EXPECT_EQ("Physics", statistics.getMostWrittenOutline()->getName());
+    EXPECT_EQ("Rome", statistics.getMostReadNote()->getName());
+    EXPECT_EQ("Gravity", statistics.getMostWrittenNote()->getName());
+    EXPECT_EQ(2, statistics.getTagCardinality(science));
+    expectMemoryStatisticsAsScanned(mind);
+
+    // N created, tagged and remembered
+    m8r::Outline* physics = mind.remind().getOutline(memoryPath+"physics.md");
+    ASSERT_NE(nullptr, physics);
+    string name{"Friction"};
+    vector<const m8r::Tag*> tags{force};
+    m8r::Note* friction = mind.noteNew(physics->getKey(), 0, &name, nullptr, 0, &tags);
+    EXPECT_EQ(4, mind.remind().getNotesCount());
+    EXPECT_EQ(3, statistics.getTagCardinality(force));
+    EXPECT_EQ(force, statistics.getMostUsedTag());
+    friction->addTag(science);
+    mind.remember(physics);
+    EXPECT_EQ(3, statistics.getTagCardinality(science));
+    expectMemoryStatisticsAsScanned(mind);
+
+    // N read
+    for(int i=0; i<50; i++) {
+        mind.remind().read(physics->getNotes()[2]);
+    }
+    EXPECT_EQ(physics->getNotes()[2], statistics.getMostReadNote());
+
+    // O read
+    for(int i=0; i<15; i++) {
+        mind.remind().read(physics);
+    }
+    EXPECT_EQ(physics, statistics.getMostReadOutline());
+    expectMemoryStatisticsAsScanned(mind);
+
+    // N and O forgotten
+    mind.noteForget(physics->getNotes()[1]);
+    EXPECT_EQ(3, mind.remind().getNotesCount());
+    expectMemoryStatisticsAsScanned(mind);
+    mind.outlineForget(memoryPath+"history.md");
+    EXPECT_EQ(2, mind.remind().getNotesCount());
+    EXPECT_EQ("Physics", statistics.getMostReadOutline()->getName());
+    EXPECT_EQ(0, statistics.getTagCardinality(ontology.findOrCreateTag("humanities")));
+    expectMemoryStatisticsAsScanned(mind);
+
+    mind.amnesia();
+    EXPECT_EQ(0, mind.remind().getNotesCount());
+    EXPECT_EQ(nullptr, statistics.getMostReadNote());
+}
+
 TEST(MindTestCase, CommonWordsBlacklist) {
     m8r::CommonWordsBlacklist blacklist{};
 
@@ -17,6 +17,8 @@
  along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -275,3 +277,284 @@ TEST(OutlineTestCase, DirectOutlineNoteChildren) {
     EXPECT_EQ("4", directChildren[2]->getName());
     EXPECT_EQ("6", directChildren[3]->getName());
 }
+
+TEST(OutlineTestCase, NoteAndOutlineNameLookups) {
+    string repositoryDir{"/tmp/mf-unit-repository-o-names"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    string oFile{repositoryDir+"/memory/o.md"};
+    string twinFile{repositoryDir+"/memory/twin.md"};
+    m8r::stringToFile(oFile,
+        "# Twins"
+        "\nO."
+        "\n## First Note"
+        "\nT1."
+        "\n## Second: Note"
+        "\nT2."
+        "\n## First Note"
+        "\nDuplicate."
+        "\n");
+    m8r::stringToFile(twinFile, "# Twins\nTwin.\n");
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-otc-nonl.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind{config};
+    mind.learn();
+
+    // O key and name
+    m8r::Outline* o = mind.findOutlineByKey(oFile);
+    ASSERT_NE(nullptr, o);
+    EXPECT_EQ(nullptr, mind.findOutlineByKey(repositoryDir+"/memory/missing.md"));
+    EXPECT_EQ(2, mind.findOutlineByNameFts("Twins")->size());
+    o->setName("Renamed");
+    mind.remember(o);
+    EXPECT_EQ(1, mind.findOutlineByNameFts("Twins")->size());
+    ASSERT_EQ(1, mind.findOutlineByNameFts("Renamed")->size());
+    EXPECT_EQ(o, mind.findOutlineByNameFts("Renamed")->at(0));
+    mind.outlineForget(twinFile);
+    EXPECT_EQ(0, mind.findOutlineByNameFts("Twins")->size());
+
+    // N name and mangled name - the first N wins
+    ASSERT_EQ(3, o->getNotesCount());
+    m8r::Note* first = o->getNotes()[0];
+    m8r::Note* second = o->getNotes()[1];
+    EXPECT_EQ(first, o->getNoteByName("First Note"));
+    EXPECT_EQ(first, o->getNoteByMangledName("first-note"));
+    EXPECT_EQ(second, o->getNoteByMangledName("second--note"));
+    EXPECT_EQ(second, o->getNoteByName("Second"));
+    EXPECT_EQ(nullptr, o->getNoteByMangledName("third-note"));
+
+    // indices follow N rename, move and removal
+    first->setName("Third Note");
+    EXPECT_EQ(first, o->getNoteByMangledName("third-note"));
+    EXPECT_EQ(o->getNotes()[2], o->getNoteByMangledName("first-note"));
+    o->moveNoteToFirst(second);
+    EXPECT_EQ(second, o->getNotes()[0]);
+    o->forgetNote(o->getNotes()[2]);
+    EXPECT_EQ(nullptr, o->getNoteByMangledName("first-note"));
+    EXPECT_EQ(nullptr, o->getNoteByName("First"));
+}
+
+/*
+ * Reference (scan based) implementations of N hierarchy queries.
+ */
+
+size_t structureDescendants(const vector<m8r::Note*>& ns, size_t offset)
+{
+    size_t i = offset+1;
+    while(i<ns.size() && ns[i]->getDepth() > ns[offset]->getDepth()) {
+        i++;
+    }
+    return i-offset-1;
+}
+
+int structureSibling(const vector<m8r::Note*>& ns, int offset, int step)
+{
+    for(int o=offset+step; o>=0 && o<static_cast<int>(ns.size()); o+=step) {
+        if(ns[o]->getDepth() == ns[offset]->getDepth()) {
+            return o;
+        }
+        if(ns[o]->getDepth() < ns[offset]->getDepth()) {
+            break;
+        }
+    }
+    return m8r::Outline::NO_SIBLING;
+}
+
+int structureParent(const vector<m8r::Note*>& ns, int offset)
+{
+    for(int o=offset-1; o>=0; o--) {
+        if(ns[o]->getDepth() < ns[offset]->getDepth()) {
+            return o;
+        }
+    }
+    return -1;
+}
+
+vector<m8r::Note*> structureDirectChildren(const vector<m8r::Note*>& ns, int offset)
+{
+    vector<m8r::Note*> children{};
+    size_t end = offset<0 ? ns.size() : offset+structureDescendants(ns, offset)+1;
+    u_int16_t minDepth = static_cast<u_int16_t>(1 << 15);
+    for(size_t i=offset+1; i<end; i++) {
+        if(minDepth >= ns[i]->getDepth()) {
+            children.push_back(ns[i]);
+            minDepth = ns[i]->getDepth();
+        }
+    }
+    return children;
+}
+
+TEST(OutlineTestCase, NoteStructureIndex) {
+    // GIVEN O w/ random hierarchy (incl. depth gaps)
+    m8r::OutlineType oType{m8r::OutlineType::KeyOutline(),nullptr,m8r::Color::RED()};
+    m8r::NoteType nType{"Note",nullptr,m8r::Color::RED()};
+    m8r::Outline* o = new m8r::Outline{&oType};
+    o->setName("Structure");
+    std::mt19937 random{2018};
+    u_int16_t depth = 0;
+    for(int i=0; i<200; i++) {
+        m8r::Note* n = new m8r::Note{&nType, o};
+        n->setName(std::to_string(i));
+        n->setDepth(depth);
+        o->addNote(n);
+        depth = static_cast<u_int16_t>(random() % (depth+3));
+    }
+    vector<m8r::Note*> expected = o->getNotes();
+
+    // WHEN Ns are randomly moved, promoted, demoted, added and removed
+    m8r::Outline::Patch patch{m8r::Outline::Patch::Diff::NO,0,0};
+    for(int step=0; step<2000; step++) {
+        int offset = static_cast<int>(random() % expected.size());
+        m8r::Note* n = expected[offset];
+        size_t descendants = structureDescendants(expected, offset);
+        int sibling;
+        switch(random() % 9) {
+        case 0:
+            o->moveNoteUp(n, &patch);
+            sibling = structureSibling(expected, offset, -1);
+            if(sibling != m8r::Outline::NO_SIBLING) {
+                EXPECT_EQ(sibling, patch.start);
+                std::rotate(expected.begin()+sibling, expected.begin()+offset, expected.begin()+offset+descendants+1);
+            }
+            break;
+        case 1:
+            o->moveNoteDown(n, &patch);
+            sibling = structureSibling(expected, offset, 1);
+            if(sibling != m8r::Outline::NO_SIBLING) {
+                EXPECT_EQ(offset, patch.start);
+                std::rotate(expected.begin()+offset, expected.begin()+sibling, expected.begin()+sibling+structureDescendants(expected, sibling)+1);
+            }
+            break;
+        case 2:
+            o->moveNoteToFirst(n, &patch);
+            sibling = offset;
+            while(structureSibling(expected, sibling, -1) != m8r::Outline::NO_SIBLING) {
+                sibling = structureSibling(expected, sibling, -1);
+            }
+            std::rotate(expected.begin()+sibling, expected.begin()+offset, expected.begin()+offset+descendants+1);
+            break;
+        case 3:
+            o->moveNoteToLast(n, &patch);
+            sibling = offset;
+            while(structureSibling(expected, sibling, 1) != m8r::Outline::NO_SIBLING) {
+                sibling = structureSibling(expected, sibling, 1);
+            }
+            std::rotate(expected.begin()+offset, expected.begin()+offset+descendants+1, expected.begin()+sibling+structureDescendants(expected, sibling)+1);
+            break;
+        case 4:
+            o->promoteNote(n, &patch);
+            break;
+        case 5:
+            o->demoteNote(n, &patch);
+            if(n->getDepth()) {
+                EXPECT_EQ(offset, patch.start);
+                EXPECT_EQ(descendants, patch.count);
+            }
+            break;
+        case 6:
+            // N w/o O as depth change would invalidate the index
+            n = new m8r::Note{&nType, nullptr};
+            n->setName(std::to_string(1000+step));
+            n->setDepth(static_cast<u_int16_t>(random() % 6));
+            if(random() % 4) {
+                o->addNote(n, offset);
+                expected.insert(expected.begin()+offset, n);
+            } else {
+                o->addNote(n);
+                expected.push_back(n);
+            }
+            break;
+        case 7:
+            if(expected.size() > descendants+50) {
+                o->forgetNote(n);
+                expected.erase(expected.begin()+offset, expected.begin()+offset+descendants+1);
+            }
+            break;
+        default:
+            if(expected.size() > descendants+50) {
+                // forgotten N w/ forgotten descendant
+                m8r::Note* last = expected.back();
+                vector<m8r::Note*> forgotten{n};
+                if(descendants) {
+                    forgotten.push_back(expected[offset+1]);
+                }
+                expected.erase(expected.begin()+offset, expected.begin()+offset+descendants+1);
+                if(std::find(expected.begin(), expected.end(), last) != expected.end()) {
+                    forgotten.push_back(last);
+                    expected.pop_back();
+                }
+                o->forgetNotes(forgotten);
+            }
+        }
+
+        // THEN the index gives the same answers as scans
+        ASSERT_EQ(expected, o->getNotes());
+        vector<m8r::Note*> topLevel{};
+        o->getDirectNoteChildren(topLevel);
+        EXPECT_EQ(structureDirectChildren(expected, -1), topLevel);
+        for(size_t i=0; i<expected.size(); i++) {
+            int s;
+            EXPECT_EQ(static_cast<int>(i), o->getNoteOffset(expected[i]));
+            vector<m8r::Note*> children{};
+            o->getAllNoteChildren(expected[i], &children);
+            EXPECT_EQ(structureDescendants(expected, i), children.size());
+            EXPECT_EQ(structureDirectChildren(expected, i).size(), o->getDirectNoteChildrenCount(expected[i]));
+            s = structureParent(expected, i);
+            EXPECT_EQ(s<0 ? nullptr : expected[s], o->getNoteParent(expected[i]));
+            vector<int> parents{};
+            o->getNotePathToRoot(i, parents);
+            for(int p:parents) {
+                EXPECT_EQ(s, p);
+                s = structureParent(expected, p);
+            }
+            EXPECT_EQ(-1, s);
+        }
+    }
+
+    // WHEN N w/ children is removed
+    size_t count = o->getNotesCount();
+    size_t descendants = structureDescendants(expected, 1);
+    o->forgetNote(expected[1]);
+
+    // THEN
+    EXPECT_EQ(count-descendants-1, o->getNotesCount());
+    EXPECT_EQ(1, o->getNoteOffset(o->getNotes()[1]));
+
+    delete o;
+}
+
+TEST(OutlineTestCase, ForgetNotes) {
+    // GIVEN O w/ Ns 0, 1, 1.1, 1.2, 2, 3, 3.1
+    m8r::OutlineType oType{m8r::OutlineType::KeyOutline(),nullptr,m8r::Color::RED()};
+    m8r::NoteType nType{"Note",nullptr,m8r::Color::RED()};
+    m8r::Outline* o = new m8r::Outline{&oType};
+    vector<m8r::Note*> ns{};
+    for(auto d:vector<pair<string,u_int16_t>>{{"0",0},{"1",0},{"1.1",1},{"1.2",1},{"2",0},{"3",0},{"3.1",1}}) {
+        m8r::Note* n = new m8r::Note{&nType, o};
+        n->setName(d.first);
+        n->setDepth(d.second);
+        o->addNote(n);
+        ns.push_back(n);
+    }
+
+    // WHEN Ns (incl. child of forgotten N) are forgotten in batch
+    o->forgetNotes(vector<m8r::Note*>{ns[6], ns[1], ns[2]});
+
+    // THEN forgotten Ns and their children are removed
+    ASSERT_EQ(3, o->getNotesCount());
+    EXPECT_EQ("0", o->getNotes()[0]->getName());
+    EXPECT_EQ("2", o->getNotes()[1]->getName());
+    EXPECT_EQ("3", o->getNotes()[2]->getName());
+    EXPECT_EQ(nullptr, o->getNoteByName("1.2"));
+    EXPECT_EQ(0, o->getDirectNoteChildrenCount(ns[5]));
+
+    delete o;
+}
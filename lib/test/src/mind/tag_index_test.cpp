@@ -0,0 +1,229 @@
+/*
+ tag_index_test.cpp     MindForger tag index test
+
+ Copyright (C) 2016-2025 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../../../src/config/configuration.h"
+#include "../../../src/gear/file_utils.h"
+#include "../../../src/mind/mind.h"
+#include "../../../src/mind/tag_index.h"
+
+#include "../test_utils.h"
+
+using namespace std;
+
+vector<uint32_t> tagIndexBitsetToVector(const m8r::TagIndex::Bitset& bitset)
+{
+    vector<uint32_t> ids{};
+    bitset.forEach([&](uint32_t id) { ids.push_back(id); });
+    return ids;
+}
+
+TEST(TagIndexTestCase, Bitset) {
+    m8r::TagIndex::Bitset a{}, b{};
+    for(uint32_t id:{0, 1, 63, 64, 200, 1000, 70000}) {
+        a.set(id);
+    }
+    a.set(64);
+    for(uint32_t id:{1, 2, 64, 999, 1000, 90000}) {
+        b.set(id);
+    }
+    EXPECT_EQ(7, a.size());
+    EXPECT_TRUE(a.test(63));
+    EXPECT_FALSE(a.test(62));
+    EXPECT_EQ((vector<uint32_t>{0, 1, 63, 64, 200, 1000, 70000}), tagIndexBitsetToVector(a));
+
+    m8r::TagIndex::Bitset u{};
+    u |= a;
+    u |= b;
+    EXPECT_EQ((vector<uint32_t>{0, 1, 2, 63, 64, 200, 999, 1000, 70000, 90000}), tagIndexBitsetToVector(u));
+    EXPECT_EQ(10, u.size());
+
+    a &= b;
+    EXPECT_EQ((vector<uint32_t>{1, 64, 1000}), tagIndexBitsetToVector(a));
+    EXPECT_EQ(3, a.size());
+
+    a.reset(64);
+    a.reset(65);
+    EXPECT_EQ((vector<uint32_t>{1, 1000}), tagIndexBitsetToVector(a));
+    EXPECT_EQ(2, a.size());
+}
+
+template<typename T> vector<string> tagIndexNames(const vector<T*>& things)
+{
+    vector<string> names{};
+    for(T* t:things) {
+        names.push_back(t->getName());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+TEST(TagIndexTestCase, TagQueriesAndCardinalities) {
+    string repositoryPath{m8r::platformSpecificPath("/tmp/mf-unit-repository-tag-index")};
+    string memoryPath{repositoryPath + FILE_PATH_SEPARATOR + m8r::DIRNAME_MEMORY + FILE_PATH_SEPARATOR};
+    map<string,string> pathToContent;
+    pathToContent[memoryPath+"cooking.md"] =
+        "# Cooking <!-- Metadata: tags: food, home; -->"
+        "\nRecipes."
+        "\n"
+        "\n## Pizza <!-- Metadata: tags: food, italy; -->"
+        "\nDough."
+        "\n"
+        "\n## Pasta <!-- Metadata: tags: food, italy, quick; -->"
+        "\nBoil."
+        "\n"
+        "\n## Toast <!-- Metadata: tags: food, quick; -->"
+        "\nBread."
+        "\n";
+    pathToContent[memoryPath+"travel.md"] =
+        "# Travel <!-- Metadata: tags: italy; -->"
+        "\nTrips."
+        "\n"
+        "\n## Rome <!-- Metadata: tags: italy, history; -->"
+        "\nColosseum."
+        "\n";
+    m8r::createEmptyRepository(repositoryPath, pathToContent);
+
+    m8r::MarkdownRepositoryConfigurationRepresentation repositoryConfigRepresentation{};
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-titc-tqac.md");
+    config.setActiveRepository(
+        config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)),
+        repositoryConfigRepresentation
+    );
+    m8r::Mind mind(config);
+    mind.learn();
+    ASSERT_EQ(2, mind.remind().getOutlinesCount());
+
+    m8r::Ontology& ontology = mind.getOntology();
+    const m8r::Tag* food = ontology.findOrCreateTag("food");
+    const m8r::Tag* italy = ontology.findOrCreateTag("italy");
+    const m8r::Tag* quick = ontology.findOrCreateTag("quick");
+    const m8r::Tag* home = ontology.findOrCreateTag("home");
+    const m8r::Tag* history = ontology.findOrCreateTag("history");
+
+    // AND queries
+    vector<m8r::Note*> notes{};
+    mind.findNotesByTags(vector<const m8r::Tag*>{food, italy}, notes);
+    EXPECT_EQ((vector<string>{"Pasta", "Pizza"}), tagIndexNames(notes));
+    notes.clear();
+    mind.findNotesByTags(vector<const m8r::Tag*>{italy}, notes);
+    EXPECT_EQ((vector<string>{"Pasta", "Pizza", "Rome"}), tagIndexNames(notes));
+    notes.clear();
+    mind.findNotesByTags(vector<const m8r::Tag*>{home, quick}, notes);
+    EXPECT_TRUE(notes.empty());
+    vector<m8r::Outline*> outlines{};
+    mind.findOutlinesByTags(vector<const m8r::Tag*>{italy}, outlines);
+    EXPECT_EQ((vector<string>{"Travel"}), tagIndexNames(outlines));
+
+    // OR query
+    const m8r::TagIndex& tagIndex = mind.remind().getTagIndex();
+    m8r::TagIndex::Bitset things{};
+    tagIndex.findAny(vector<const m8r::Tag*>{home, history}, things);
+    EXPECT_EQ(2, things.size());
+    EXPECT_EQ(6, tagIndex.getThingsCount());
+
+    // cardinalities
+    map<const m8r::Tag*,int> cardinalities{};
+    mind.getTagsCardinality(cardinalities);
+    EXPECT_EQ(4, cardinalities[food]);
+    EXPECT_EQ(4, cardinalities[italy]);
+    EXPECT_EQ(2, cardinalities[quick]);
+    EXPECT_EQ(1, cardinalities[home]);
+    EXPECT_EQ(1, cardinalities[history]);
+    EXPECT_EQ(4, tagIndex.getCardinality(italy));
+
+    // incremental update on tag edit and N forget
+    m8r::Outline* cooking = mind.remind().getOutline(memoryPath+"cooking.md");
+    ASSERT_NE(nullptr, cooking);
+    m8r::Note* toast = cooking->getNotes()[2];
+    ASSERT_EQ("Toast", toast->getName());
+    toast->addTag(italy);
+    mind.remember(cooking);
+    EXPECT_EQ(5, tagIndex.getCardinality(italy));
+    mind.noteForget(cooking->getNotes()[0]);
+    EXPECT_EQ(4, tagIndex.getCardinality(italy));
+    EXPECT_EQ(3, tagIndex.getCardinality(food));
+    notes.clear();
+    mind.findNotesByTags(vector<const m8r::Tag*>{italy, quick}, notes);
+    EXPECT_EQ((vector<string>{"Pasta", "Toast"}), tagIndexNames(notes));
+
+    // tag scope: Ns are NOT scoped by tags of their Os, Os are found regardless of scope
+    mind.getTagsScopeAspect().setTags(vector<const m8r::Tag*>{home});
+    notes.clear();
+    mind.findNotesByTags(vector<const m8r::Tag*>{italy}, notes);
+    EXPECT_EQ((vector<string>{"Pasta", "Rome", "Toast"}), tagIndexNames(notes));
+    outlines.clear();
+    mind.findOutlinesByTags(vector<const m8r::Tag*>{italy}, outlines);
+    EXPECT_EQ((vector<string>{"Travel"}), tagIndexNames(outlines));
+    cardinalities.clear();
+    mind.getTagsCardinality(cardinalities);
+    EXPECT_EQ(2, cardinalities[italy]);
+    EXPECT_EQ(0, cardinalities[history]);
+    mind.getTagsScopeAspect().reset();
+
+    // forgotten O
+    mind.outlineForget(memoryPath+"travel.md");
+    EXPECT_EQ(2, tagIndex.getCardinality(italy));
+    EXPECT_EQ(0, tagIndex.getCardinality(history));
+
+    // Ns and Os are found in Memory order although ids of forgotten things are recycled
+    m8r::stringToFile(
+        memoryPath+"alps.md",
+        "# Alps <!-- Metadata: tags: italy; -->"
+        "\nMountains."
+        "\n"
+        "\n## Dolomites <!-- Metadata: tags: italy; -->"
+        "\nPeaks."
+        "\n");
+    m8r::Outline* alps = mind.remind().relearn(memoryPath+"alps.md");
+    ASSERT_NE(nullptr, alps);
+    m8r::stringToFile(
+        memoryPath+"cooking.md",
+        "# Cooking <!-- Metadata: tags: food, home; -->"
+        "\nRecipes."
+        "\n"
+        "\n## Pasta <!-- Metadata: tags: food, italy, quick; -->"
+        "\nBoil."
+        "\n"
+        "\n## Lasagna <!-- Metadata: tags: food, italy; -->"
+        "\nBake."
+        "\n");
+    cooking = mind.remind().relearn(memoryPath+"cooking.md");
+    ASSERT_NE(nullptr, cooking);
+    notes.clear();
+    mind.findNotesByTags(vector<const m8r::Tag*>{italy}, notes);
+    ASSERT_EQ(3, notes.size());
+    EXPECT_EQ("Dolomites", notes[0]->getName());
+    EXPECT_EQ("Pasta", notes[1]->getName());
+    EXPECT_EQ("Lasagna", notes[2]->getName());
+    outlines.clear();
+    mind.findOutlinesByTags(vector<const m8r::Tag*>{}, outlines);
+    EXPECT_EQ((vector<m8r::Outline*>{alps, cooking}), outlines);
+
+    mind.amnesia();
+    EXPECT_EQ(0, tagIndex.getThingsCount());
+}
@@ -130,7 +130,11 @@ SOURCES += \
     ../benchmark/markdown_benchmark.cpp \
     ../benchmark/html_benchmark.cpp \
     ../benchmark/trie_benchmark.cpp \
+    ../benchmark/aho_corasick_benchmark.cpp \
     ../benchmark/ai_benchmark.cpp \
+    ../benchmark/repository_snapshot_benchmark.cpp \
+    ../benchmark/outlines_map_benchmark.cpp \
+    ../benchmark/force_layout_benchmark.cpp \
     ./ai/nlp_test.cpp \
     ./ai/autolinking_test.cpp \
     ./ai/autolinking_cmark_test.cpp \
@@ -138,6 +142,9 @@ SOURCES += \
     ./gear/string_utils_test.cpp \
     ./gear/file_utils_test.cpp \
     ./gear/trie_test.cpp \
+    ./gear/aho_corasick_test.cpp \
+    ./gear/task_scheduler_test.cpp \
+    ./gear/force_layout_test.cpp \
     ./mind/fts_test.cpp \
     ./mind/memory_test.cpp \
     ./mind/mind_test.cpp \
@@ -145,6 +152,8 @@ SOURCES += \
     ./mindforger_lib_unit_tests.cpp \
     ./mind/organizer_test.cpp \
     ./mind/outline_test.cpp \
+    ./mind/tag_index_test.cpp \
+    ./mind/knowledge_graph_index_test.cpp \
     ./mind/filesystem_information_test.cpp
 
 HEADERS += \
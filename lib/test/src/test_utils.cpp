@@ -218,20 +218,20 @@ void printLexemType(MarkdownLexemType type)
     }
 }
 
-void printLexems(const vector<MarkdownLexem*>& lexems)
+void printLexems(const vector<MarkdownLexem>& lexems)
 {
     cout << endl << "LEXEMs:";
     if(!lexems.empty()) {
         cout << " (" << lexems.size() << ")";
         for(unsigned long i=0; i<lexems.size(); ++i) {
             cout << endl << "  #" << i << " ";
-            printLexemType(lexems.at(i)->getType());
-            if(lexems.at(i)->getType() == MarkdownLexemType::SECTION) {
-                cout << " " << lexems.at(i)->getDepth();
+            printLexemType(lexems.at(i).getType());
+            if(lexems.at(i).getType() == MarkdownLexemType::SECTION) {
+                cout << " " << lexems.at(i).getDepth();
             } else {
-                cout << " " << lexems.at(i)->getOff();
-                cout << " " << lexems.at(i)->getIdx();
-                cout << " " << (lexems.at(i)->getLng()==MarkdownLexem::WHOLE_LINE?"*":std::to_string(lexems.at(i)->getLng()));
+                cout << " " << lexems.at(i).getOff();
+                cout << " " << lexems.at(i).getIdx();
+                cout << " " << (lexems.at(i).getLng()==MarkdownLexem::WHOLE_LINE?"*":std::to_string(lexems.at(i).getLng()));
             }
         }
     } else {